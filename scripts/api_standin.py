@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""Local stand-in for the transit and weather APIs, with fault injection.
+
+Serves recorded Golemio, BVG, Open-Meteo (or GTFS-RT) responses over plain
+HTTP, with scriptable latency, bandwidth caps, error statuses, connection
+resets, hangs and truncated or slow-drip bodies. Point the firmware at it
+with the API Server Override in the web UI, or the host build with
+--server:
+
+    scripts/api_standin.py --port 8080 \\
+        --route api.golemio.cz=rec/golemio-rush.json \\
+        --route v6.bvg.transport.rest/stops/900013102=rec/bvg-alex.json \\
+        --route api.open-meteo.com=rec/weather.json \\
+        --latency 150 --jitter 100 --fault 429:0.2 --fault reset:0.05
+
+    .pio/build/native/program --city Prague --stops U693Z2P \\
+        --server http://127.0.0.1:8080 --repeat 50
+
+Requests arrive as /<host><path> (https://<host><path> on the live service).
+Each --route maps a <host>[<path prefix>] to a recorded body; the longest
+matching prefix wins and unmatched requests get 404. Record bodies with
+curl, e.g. curl -H "X-Access-Token: $KEY" "https://api.golemio.cz/v2/..."
+
+Outcomes (for --fault KIND:PROBABILITY and --sequence KIND,KIND,...):
+    ok         the recorded body
+    <status>   that HTTP status with a short body (429 adds Retry-After: 1)
+    reset      close the connection with a TCP RST instead of responding
+    timeout    read the request, then send nothing for --hang seconds
+    truncate   send the full Content-Length but only half the body, then close
+    drip       send the body at --drip-rate bytes per second
+
+--sequence plays its outcomes in order (per host), then serves ok, or starts
+over with --loop; otherwise each request draws from the --fault table.
+GET /_stats returns the outcome counts as JSON; they are also printed on exit.
+"""
+
+import argparse
+import json
+import random
+import socket
+import struct
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+CONTENT_TYPES = {".json": "application/json", ".pb": "application/x-protobuf"}
+SPECIAL = ("ok", "reset", "timeout", "truncate", "drip")
+
+
+def parse_outcome(text):
+    if text in SPECIAL:
+        return text
+    if text.isdigit() and 100 <= int(text) <= 599:
+        return int(text)
+    raise argparse.ArgumentTypeError(f"unknown outcome: {text}")
+
+
+def parse_route(text):
+    prefix, sep, path = text.partition("=")
+    if not sep or not prefix:
+        raise argparse.ArgumentTypeError(f"expected HOST[/PATH]=FILE: {text}")
+    with open(path, "rb") as f:
+        body = f.read()
+    content_type = next((t for ext, t in CONTENT_TYPES.items() if path.endswith(ext)),
+                        "application/octet-stream")
+    return prefix.lstrip("/"), body, content_type
+
+
+def parse_fault(text):
+    kind, sep, probability = text.rpartition(":")
+    if not sep:
+        raise argparse.ArgumentTypeError(f"expected KIND:PROBABILITY: {text}")
+    return parse_outcome(kind), float(probability)
+
+
+class StandIn:
+    """Routes, fault plan and counters shared by all handler threads"""
+
+    def __init__(self, args):
+        self.args = args
+        self.routes = sorted(args.route, key=lambda r: len(r[0]), reverse=True)
+        self.random = random.Random(args.seed)
+        self.positions = {}
+        self.stats = {}
+        self.lock = threading.Lock()
+
+    def find_route(self, target):
+        for prefix, body, content_type in self.routes:
+            if target.startswith(prefix):
+                return body, content_type
+        return None
+
+    def next_outcome(self, host):
+        with self.lock:
+            sequence = self.args.sequence
+            if sequence:
+                position = self.positions.get(host, 0)
+                self.positions[host] = position + 1
+                if position < len(sequence) or self.args.loop:
+                    return sequence[position % len(sequence)]
+                return "ok"
+
+            draw = self.random.random()
+            for outcome, probability in self.args.fault:
+                if draw < probability:
+                    return outcome
+                draw -= probability
+            return "ok"
+
+    def count(self, host, outcome):
+        with self.lock:
+            per_host = self.stats.setdefault(host, {})
+            per_host[str(outcome)] = per_host.get(str(outcome), 0) + 1
+
+
+class Server(ThreadingHTTPServer):
+    daemon_threads = True
+
+    def __init__(self, address, standin):
+        super().__init__(address, Handler)
+        self.standin = standin
+        self.resets = set()
+        self.resets_lock = threading.Lock()
+
+    def shutdown_request(self, request):
+        # A plain shutdown() would send FIN first; close() with SO_LINGER 0 sends RST
+        with self.resets_lock:
+            reset = request in self.resets
+            self.resets.discard(request)
+        if reset:
+            request.close()
+        else:
+            super().shutdown_request(request)
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # Keep-alive, like the live services
+
+    def do_GET(self):
+        standin = self.server.standin
+        if self.path == "/_stats":
+            with standin.lock:
+                self.send_body(200, json.dumps(standin.stats, indent=2).encode(), "application/json")
+            return
+
+        target = self.path.lstrip("/")
+        host = target.split("/", 1)[0].split("?", 1)[0]
+        route = standin.find_route(target)
+        outcome = standin.next_outcome(host) if route else 404
+        standin.count(host, outcome)
+        started = time.monotonic()
+
+        args = standin.args
+        delay_ms = args.latency + (standin.random.uniform(0, args.jitter) if args.jitter else 0)
+        time.sleep(delay_ms / 1000.0)
+
+        if outcome == "reset":
+            self.connection.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+            with self.server.resets_lock:
+                self.server.resets.add(self.connection)
+            self.close_connection = True
+        elif outcome == "timeout":
+            time.sleep(args.hang)
+            self.close_connection = True
+        elif isinstance(outcome, int):
+            self.send_error_status(outcome)
+        else:
+            body, content_type = route
+            if outcome == "truncate":
+                self.send_body(200, body, content_type, len(body) // 2)
+                self.close_connection = True
+            else:
+                rate = args.drip_rate if outcome == "drip" else args.bandwidth
+                self.send_body(200, body, content_type, rate=rate)
+
+        if not args.quiet:
+            sys.stderr.write(f"{host} {outcome} {(time.monotonic() - started) * 1000:.0f}ms {self.path}\n")
+
+    def send_error_status(self, status):
+        body = json.dumps({"error": f"stand-in {status}"}).encode()
+        extra = {"Retry-After": "1"} if status == 429 else {}
+        self.send_body(status, body, "application/json", headers=extra)
+
+    def send_body(self, status, body, content_type, limit=None, rate=0, headers=None):
+        self.send_response(status)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.end_headers()
+
+        data = body if limit is None else body[:limit]
+        if rate <= 0:
+            self.wfile.write(data)
+            return
+
+        # Bandwidth cap: one slice every 100ms
+        step = max(1, rate // 10)
+        for offset in range(0, len(data), step):
+            self.wfile.write(data[offset:offset + step])
+            self.wfile.flush()
+            time.sleep(0.1)
+
+    def log_message(self, format, *args):
+        pass  # do_GET logs one line per request
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__.split("\n\n")[0],
+        epilog="See the top of this file for the request layout and outcomes.")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--bind", default="0.0.0.0", help="address to listen on (default: all)")
+    parser.add_argument("--route", type=parse_route, action="append", default=[], required=True,
+                        metavar="HOST[/PATH]=FILE", help="answer matching requests with FILE")
+    parser.add_argument("--latency", type=float, default=0, help="delay before each response, ms")
+    parser.add_argument("--jitter", type=float, default=0, help="extra random delay up to this many ms")
+    parser.add_argument("--bandwidth", type=int, default=0, help="body rate cap in bytes/s (0 = none)")
+    parser.add_argument("--fault", type=parse_fault, action="append", default=[],
+                        metavar="KIND:PROBABILITY", help="inject an outcome at random")
+    parser.add_argument("--sequence", type=lambda s: [parse_outcome(k) for k in s.split(",")],
+                        metavar="KIND,KIND,...", help="play these outcomes in order, per host")
+    parser.add_argument("--loop", action="store_true", help="repeat --sequence instead of serving ok after it")
+    parser.add_argument("--hang", type=float, default=30, help="seconds a timeout outcome stays silent")
+    parser.add_argument("--drip-rate", type=int, default=256, help="bytes/s of a drip outcome")
+    parser.add_argument("--seed", type=int, help="random seed for faults and jitter (repeatable runs)")
+    parser.add_argument("--quiet", action="store_true", help="no per-request log")
+    args = parser.parse_args()
+
+    if sum(p for _, p in args.fault) > 1:
+        parser.error("fault probabilities add up to more than 1")
+
+    standin = StandIn(args)
+    server = Server((args.bind, args.port), standin)
+    print(f"Stand-in API server on http://{args.bind}:{args.port} "
+          f"({len(args.route)} route(s)) - set it as the API Server Override", file=sys.stderr)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.server_close()
+        print(json.dumps(standin.stats, indent=2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""Build the offline timetable image for the spiffs partition.
+
+Reads a GTFS static feed (zip) and writes the scheduled departures of the
+configured stops in the binary layout documented in src/api/StaticSchedule.h.
+The firmware maps the image and shows it while live data is stale.
+
+Usage:
+    scripts/build_schedule.py feed.zip --stops U693Z2P,U693Z1P -o schedule.bin
+    scripts/build_schedule.py vbb.zip --stops 900013102=de:11000:900013102 -o schedule.bin
+
+Each --stops entry is a stop ID exactly as entered in the web UI, optionally
+followed by "=" and the GTFS stop_id(s) it stands for ("+"-separated), for
+networks whose API IDs differ from their GTFS IDs. A GTFS station
+(location_type 1) includes all its platforms.
+
+Flash the image with:
+    esptool.py --chip esp32s3 write_flash <spiffs offset> schedule.bin
+"""
+
+import argparse
+import csv
+import io
+import os
+import struct
+import sys
+import zipfile
+from datetime import date, datetime, timedelta
+
+MAGIC = 0x54545053  # "SPTT"
+VERSION = 1
+MAX_STOPS = 127     # Image stop indices are int8_t on the device
+HEADER = struct.Struct("<IHHiHHIIIII")
+DAY_ENTRY = struct.Struct("<II")
+DEPARTURE = struct.Struct("<IHHHH")
+
+
+def hash_trip_id(trip_id):
+    """FNV-1a, same as hashTripId() in DepartureData.cpp"""
+    value = 2166136261
+    for byte in trip_id.encode("utf-8"):
+        value ^= byte
+        value = (value * 16777619) & 0xFFFFFFFF
+    return value or 1
+
+
+def read_table(feed, name, required=True):
+    if name not in feed.namelist():
+        if required:
+            sys.exit(f"GTFS feed has no {name}")
+        return
+    with feed.open(name) as raw:
+        yield from csv.DictReader(io.TextIOWrapper(raw, encoding="utf-8-sig"))
+
+
+def parse_date(text):
+    return datetime.strptime(text, "%Y%m%d").date()
+
+
+def parse_minutes(text):
+    hours, minutes, _ = text.strip().split(":")
+    return int(hours) * 60 + int(minutes)
+
+
+def spiffs_partition(project_dir):
+    """(offset, size) of the spiffs partition in partitions_custom.csv"""
+    path = os.path.join(project_dir, "partitions_custom.csv")
+    with open(path) as f:
+        for line in f:
+            fields = [field.strip() for field in line.split("#")[0].split(",")]
+            if len(fields) >= 5 and fields[2] == "spiffs":
+                return int(fields[3], 0), int(fields[4], 0)
+    return None, None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build the SpojBoard offline timetable image")
+    parser.add_argument("feed", help="GTFS static zip")
+    parser.add_argument("--stops", required=True, help="Comma-separated stop IDs as configured on the board")
+    parser.add_argument("--start", help="First service date, YYYY-MM-DD (default: today)")
+    parser.add_argument("--days", type=int, default=60, help="Number of service days (default: 60)")
+    parser.add_argument("-o", "--output", default="schedule.bin", help="Output image (default: schedule.bin)")
+    args = parser.parse_args()
+
+    start = date.fromisoformat(args.start) if args.start else date.today()
+    dates = [start + timedelta(days=i) for i in range(args.days)]
+
+    # Board stop IDs and the GTFS stop_ids behind each of them
+    board_stops = []
+    aliases = []
+    for entry in args.stops.split(","):
+        entry = entry.strip()
+        if not entry:
+            continue
+        board_id, _, gtfs_ids = entry.partition("=")
+        board_stops.append(board_id)
+        aliases.append(gtfs_ids.split("+") if gtfs_ids else [board_id])
+    if not board_stops or len(board_stops) > MAX_STOPS:
+        sys.exit(f"Need 1-{MAX_STOPS} stops")
+
+    feed = zipfile.ZipFile(args.feed)
+
+    children = {}
+    for stop in read_table(feed, "stops.txt"):
+        parent = stop.get("parent_station", "")
+        if parent:
+            children.setdefault(parent, []).append(stop["stop_id"])
+    board_index = {}
+    for index, gtfs_ids in enumerate(aliases):
+        for gtfs_id in gtfs_ids:
+            for stop_id in [gtfs_id] + children.get(gtfs_id, []):
+                board_index[stop_id] = index
+
+    routes = {}
+    for route in read_table(feed, "routes.txt"):
+        routes[route["route_id"]] = route.get("route_short_name") or route.get("route_long_name", "")
+
+    trips = {}
+    for trip in read_table(feed, "trips.txt"):
+        trips[trip["trip_id"]] = (routes.get(trip["route_id"], ""), trip["service_id"], trip.get("trip_headsign", ""))
+
+    # Services running on each date (calendar.txt, then calendar_dates.txt exceptions)
+    weekdays = ["monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday"]
+    running = [set() for _ in dates]
+    for service in read_table(feed, "calendar.txt", required=False):
+        first, last = parse_date(service["start_date"]), parse_date(service["end_date"])
+        for i, day in enumerate(dates):
+            if first <= day <= last and service[weekdays[day.weekday()]] == "1":
+                running[i].add(service["service_id"])
+    for exception in read_table(feed, "calendar_dates.txt", required=False):
+        day = parse_date(exception["date"])
+        i = (day - start).days
+        if 0 <= i < len(dates):
+            if exception["exception_type"] == "1":
+                running[i].add(exception["service_id"])
+            else:
+                running[i].discard(exception["service_id"])
+
+    # Stop times at the configured stops; the last stop of each trip names
+    # the destination when the feed has no headsign
+    stop_names = {stop["stop_id"]: stop.get("stop_name", "") for stop in read_table(feed, "stops.txt")}
+    calls = []
+    last_stop = {}
+    for row in read_table(feed, "stop_times.txt"):
+        trip_id = row["trip_id"]
+        trip = trips.get(trip_id)
+        if trip is None:
+            continue
+        if not trip[2]:
+            sequence = int(row["stop_sequence"])
+            if sequence >= last_stop.get(trip_id, (-1, ""))[0]:
+                last_stop[trip_id] = (sequence, row["stop_id"])
+        index = board_index.get(row["stop_id"])
+        if index is None or row.get("pickup_type", "") == "1" or not row.get("departure_time"):
+            continue
+        calls.append((index, parse_minutes(row["departure_time"]), trip_id, row.get("stop_headsign", "")))
+
+    # Runs per (day, stop), shared between days with the same timetable
+    strings = {}
+    blob = bytearray()
+
+    def string_offset(text):
+        if text not in strings:
+            strings[text] = len(blob)
+            blob.extend(text.encode("utf-8") + b"\0")
+        return strings[text]
+
+    for board_id in board_stops:
+        string_offset(board_id)
+
+    calls_by_stop = [[] for _ in board_stops]
+    for index, minute, trip_id, headsign in calls:
+        line, service, trip_headsign = trips[trip_id]
+        destination = headsign or trip_headsign or stop_names.get(last_stop.get(trip_id, (0, ""))[1], "")
+        calls_by_stop[index].append((minute, service, hash_trip_id(trip_id), line, destination))
+    for stop_calls in calls_by_stop:
+        stop_calls.sort()
+
+    departures = []
+    runs = {}
+    day_table = []
+    for i in range(len(dates)):
+        for stop_calls in calls_by_stop:
+            run = tuple((minute, key, line, destination)
+                        for minute, service, key, line, destination in stop_calls if service in running[i])
+            if run not in runs:
+                runs[run] = len(departures)
+                departures.extend(run)
+            day_table.append((runs[run], len(run)))
+
+    records = bytearray()
+    for minute, key, line, destination in departures:
+        records += DEPARTURE.pack(key, min(minute, 0xFFFF), string_offset(line), string_offset(destination), 0)
+    if len(blob) > 0xFFFF:
+        sys.exit("Too many distinct lines and destinations (string offsets are 16-bit)")
+
+    stop_table = b"".join(struct.pack("<I", strings[board_id]) for board_id in board_stops)
+    day_table_offset = HEADER.size + len(stop_table)
+    day_table_offset += -day_table_offset % 4
+    departure_offset = day_table_offset + len(day_table) * DAY_ENTRY.size
+    string_offset_start = departure_offset + len(records)
+    total_size = string_offset_start + len(blob)
+
+    image = bytearray(HEADER.pack(MAGIC, VERSION, len(board_stops), (start - date(1970, 1, 1)).days,
+                                  len(dates), 0, day_table_offset, departure_offset, len(departures),
+                                  string_offset_start, total_size))
+    image += stop_table
+    image += bytes(day_table_offset - len(image))
+    for first, count in day_table:
+        image += DAY_ENTRY.pack(first, count)
+    image += records
+    image += blob
+    assert len(image) == total_size
+
+    offset, size = spiffs_partition(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+    if size is not None and total_size > size:
+        sys.exit(f"Image ({total_size} bytes) does not fit the spiffs partition ({size} bytes)")
+
+    with open(args.output, "wb") as f:
+        f.write(image)
+
+    for board_id, stop_calls in zip(board_stops, calls_by_stop):
+        print(f"  {board_id}: {len(stop_calls)} stop times")
+    print(f"✓ {args.output}: {len(dates)} days from {start}, {len(runs)} distinct timetables, "
+          f"{len(departures)} departures, {total_size} bytes")
+    if offset is not None:
+        print(f"  Flash with: esptool.py --chip esp32s3 write_flash 0x{offset:x} {args.output}")
+
+
+if __name__ == "__main__":
+    main()
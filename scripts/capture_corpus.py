@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Capture the payload corpus of the native tests from the live APIs.
+
+Requests the same paths the firmware builds (GolemioAPI::buildQueryPath,
+BvgAPI::querySingleStop, WeatherAPI::fetchWeather) and writes the bodies to
+test/corpus/, with corpus.json recording when and for which stops:
+
+    GOLEMIO_API_KEY=... scripts/capture_corpus.py
+
+    golemio-quiet.json      one platform of a quiet stop
+    golemio-rush.json       all platforms of a hub, in one batched request
+    golemio-truncated.json  the first half of golemio-rush.json
+    golemio-oversized.json  the hub with total= and minutesAfter= far above
+                            what the firmware asks for
+    bvg-*.json              the same four for BVG (results=, duration=)
+    weather*.json           a forecast, its first half and 16 days of it
+
+Run it at rush hour (about 07:30-08:30 or 16:00-18:00 local time), so the
+hub responses are as large as the firmware will see. The truncated bodies
+are what a connection dropped mid-transfer delivers; the oversized ones are
+real responses of the same endpoints, only with larger limits.
+
+The suites set their clock to the capture time and their stops from
+corpus.json, so a new capture needs no test changes. test_corpus reports
+each response's document use against its provider's JSON_BUFFER_SIZE.
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+import urllib.request
+
+GOLEMIO = "https://api.golemio.cz"
+BVG = "https://v6.bvg.transport.rest"
+WEATHER = "https://api.open-meteo.com"
+
+MAX_DEPARTURES = 12  # DepartureData.h
+
+
+def fetch(url, headers=None):
+    request = urllib.request.Request(url, headers=headers or {})
+    with urllib.request.urlopen(request, timeout=60) as response:
+        body = response.read()
+    print(f"{len(body):8d} bytes  {url}", file=sys.stderr)
+    return body
+
+
+def golemio_path(stop_ids, total, minutes_after):
+    ids = "".join(f"ids={stop_id}&" for stop_id in stop_ids.split(","))
+    return (f"/v2/pid/departureboards?{ids}total={total}&preferredTimezone=Europe/Prague"
+            f"&minutesBefore=0&minutesAfter={minutes_after}")
+
+
+def bvg_path(stop_id, now, results, duration):
+    return f"/stops/{stop_id}/departures?duration={duration}&results={results}&when={now + 90}"
+
+
+def weather_path(latitude, longitude, hours):
+    return (f"/v1/forecast?latitude={latitude:.4f}&longitude={longitude:.4f}"
+            f"&hourly=temperature_2m,weathercode&forecast_hours={hours}&timezone=auto")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--out", default="test/corpus", help="corpus directory")
+    parser.add_argument("--golemio-quiet", default="U1072Z1P", help="quiet Prague platform")
+    parser.add_argument("--golemio-rush", default=",".join(f"U1040Z{n}P" for n in range(1, 13)),
+                        help="platforms of a Prague hub (at most MAX_BATCH_STOPS)")
+    parser.add_argument("--bvg-quiet", default="900083102", help="quiet Berlin stop")
+    parser.add_argument("--bvg-rush", default="900100003", help="Berlin hub")
+    parser.add_argument("--latitude", type=float, default=50.08)
+    parser.add_argument("--longitude", type=float, default=14.42)
+    args = parser.parse_args()
+
+    key = os.environ.get("GOLEMIO_API_KEY")
+    if not key:
+        parser.error("set GOLEMIO_API_KEY to a Golemio API token")
+    golemio_headers = {"x-access-token": key, "Content-Type": "application/json"}
+
+    now = int(time.time())
+    bodies = {
+        "golemio-quiet.json": fetch(GOLEMIO + golemio_path(args.golemio_quiet, MAX_DEPARTURES, 120),
+                                    golemio_headers),
+        "golemio-rush.json": fetch(GOLEMIO + golemio_path(args.golemio_rush, MAX_DEPARTURES, 120),
+                                   golemio_headers),
+        "golemio-oversized.json": fetch(GOLEMIO + golemio_path(args.golemio_rush, 1000, 720), golemio_headers),
+        "bvg-quiet.json": fetch(BVG + bvg_path(args.bvg_quiet, now, MAX_DEPARTURES, 120)),
+        "bvg-rush.json": fetch(BVG + bvg_path(args.bvg_rush, now, MAX_DEPARTURES, 120)),
+        "bvg-oversized.json": fetch(BVG + bvg_path(args.bvg_rush, now, 200, 720)),
+        "weather.json": fetch(WEATHER + weather_path(args.latitude, args.longitude, 3)),
+        "weather-oversized.json": fetch(WEATHER + weather_path(args.latitude, args.longitude, 384)),
+    }
+    for provider, full in (("golemio", "golemio-rush.json"), ("bvg", "bvg-rush.json"), ("weather", "weather.json")):
+        bodies[f"{provider}-truncated.json"] = bodies[full][:len(bodies[full]) // 2]
+
+    os.makedirs(args.out, exist_ok=True)
+    for name, body in bodies.items():
+        with open(os.path.join(args.out, name), "wb") as f:
+            f.write(body)
+
+    manifest = {
+        "source": "captured",
+        "captured": now,
+        "golemio": {"quiet": args.golemio_quiet, "rush": args.golemio_rush},
+        "bvg": {"quiet": args.bvg_quiet, "rush": args.bvg_rush},
+        "weather": {"latitude": args.latitude, "longitude": args.longitude},
+    }
+    with open(os.path.join(args.out, "corpus.json"), "w") as f:
+        json.dump(manifest, f, indent=2)
+        f.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,14 @@
+Import("env")
+
+# Host build (env:native): compile the Adafruit GFX Library's drawing code
+# only. Its SPI TFT and grayscale OLED drivers need SPI.h/Wire.h and Adafruit
+# BusIO, none of which exist on a PC; returning None drops a file from the build.
+GFX_DRIVERS = ("Adafruit_SPITFT.cpp", "Adafruit_GrayOLED.cpp")
+
+
+def skip_driver(env, node):
+    return None
+
+
+for name in GFX_DRIVERS:
+    env.AddBuildMiddleware(skip_driver, "*/Adafruit GFX Library/" + name)
@@ -1,6 +1,10 @@
 #include "BvgAPI.h"
 #include "../utils/Logger.h"
-#include <HTTPClient.h>
+#include "../utils/TimeUtils.h"
+#include "../utils/Metrics.h"
+#include "../hal/Clock.h"
+#include "DestinationShortener.h"
+#include "../network/HttpConnectionManager.h"
 #include <ArduinoJson.h>
 #include <time.h>
 #include <cstring>
@@ -26,6 +30,7 @@ TransitAPI::APIResult BvgAPI::fetchDepartures(const Config &config)
     result.hasError = false;
     result.stopName[0] = '\0';
     result.errorMsg[0] = '\0';
+    result.refreshedStop = -1;
 
     // Validate inputs (use Berlin-specific field)
     if (strlen(config.berlinStopIds) == 0)
@@ -39,84 +44,52 @@ TransitAPI::APIResult BvgAPI::fetchDepartures(const Config &config)
     debugPrintln("BVG API: Fetching departures...");
     logMemory("bvg_api_start");
 
-    // Temporary array to collect all departures from all stops
-    // IMPORTANT: Static to avoid stack overflow (~2KB array)
-    static Departure tempDepartures[MAX_TEMP_DEPARTURES];
-    int tempCount = 0;
+    // Abbreviations for this fetch (automaton is only rebuilt when the dictionary changed)
+    DestinationShortener::getInstance().configure(DestinationShortener::CITY_BERLIN, config.berlinAbbreviations);
+
+    // Keeps the soonest MAX_DEPARTURES across all stops (minimum departure time applied on insert)
+    collector.reset(config.minDepartureTime);
 
     // Parse comma-separated stop IDs (use Berlin-specific field)
-    char stopIdsCopy[128];
+    char stopIdsCopy[sizeof(config.berlinStopIds)];
     strlcpy(stopIdsCopy, config.berlinStopIds, sizeof(stopIdsCopy));
 
-    char *stopId = strtok(stopIdsCopy, ",");
+    const char *stopIds[MAX_CONFIG_STOPS];
+    int stopCount = splitStopIds(stopIdsCopy, stopIds, MAX_CONFIG_STOPS);
     bool firstStop = true;
-    int stopIndex = 0;
 
-    while (stopId != NULL && tempCount < MAX_TEMP_DEPARTURES)
+    for (int stopIndex = 0; stopIndex < stopCount; stopIndex++)
     {
-        // Trim whitespace
-        while (*stopId == ' ')
-            stopId++;
-
-        if (strlen(stopId) == 0)
-        {
-            stopId = strtok(NULL, ",");
-            continue;
-        }
-
-        int countBefore = tempCount;
-        querySingleStop(stopId, config, tempDepartures, tempCount, result.stopName, firstStop, stopIndex);
+        int offeredBefore = collector.getOfferedCount();
+        unsigned long startMs = clockMillis();
+        querySingleStop(stopIds[stopIndex], config, collector, result.stopName, firstStop, stopIndex);
+        Metrics::getInstance().recordFetch(stopIndex, clockMillis() - startMs);
 
         // If we got new departures and have a callback, send partial results immediately
-        if (tempCount > countBefore && partialResultsCallback)
+        if (collector.getOfferedCount() > offeredBefore && collector.size() > 0 && partialResultsCallback)
         {
-            // Sort current results
-            qsort(tempDepartures, tempCount, sizeof(Departure), compareDepartures);
-
-            // Copy top departures to result for callback (apply min departure filter)
-            result.departureCount = 0;
-            for (int i = 0; i < tempCount && result.departureCount < MAX_DEPARTURES; i++)
-            {
-                if (tempDepartures[i].eta >= config.minDepartureTime)
-                {
-                    result.departures[result.departureCount] = tempDepartures[i];
-                    result.departureCount++;
-                }
-            }
+            result.departureCount = collector.copySorted(result.departures, result.strings);
 
             logTimestamp();
             char msg[64];
             snprintf(msg, sizeof(msg), "Partial results: %d departures, triggering display", result.departureCount);
             debugPrintln(msg);
 
-            partialResultsCallback(result.departures, result.departureCount, result.stopName);
+            partialResultsCallback(result.departures, result.strings, result.departureCount, result.stopName);
         }
 
         // Rate limiting: 1-second delay between API calls
-        delay(1000);
-
-        stopId = strtok(NULL, ",");
-        stopIndex++;
-    }
-
-    // Sort all collected departures by ETA (ascending)
-    qsort(tempDepartures, tempCount, sizeof(Departure), compareDepartures);
-
-    // Filter by minimum departure time and copy to final array (up to MAX_DEPARTURES for caching)
-    // Note: config.numDepartures is used for display only, not for limiting cache size
-    result.departureCount = 0;
-    for (int i = 0; i < tempCount && result.departureCount < MAX_DEPARTURES; i++)
-    {
-        // Skip departures below minimum departure time
-        if (tempDepartures[i].eta < config.minDepartureTime)
+        if (stopIndex + 1 < stopCount)
         {
-            continue;
+            clockDelay(1000);
         }
-
-        result.departures[result.departureCount] = tempDepartures[i];
-        result.departureCount++;
     }
 
+    // Copy the soonest MAX_DEPARTURES across all stops, sorted by departure time
+    // Note: config.numDepartures is used for display only, not for limiting cache size
+    result.departureCount = collector.copySorted(result.departures, result.strings);
+    result.truncated = collector.isTruncated();
+
     if (result.departureCount == 0)
     {
         result.hasError = true;
@@ -132,51 +105,95 @@ TransitAPI::APIResult BvgAPI::fetchDepartures(const Config &config)
     return result;
 }
 
+TransitAPI::APIResult BvgAPI::fetchStopDepartures(const Config &config, int stopIndex)
+{
+    TransitAPI::APIResult result = {};
+    result.refreshedStop = stopIndex;
+
+    char stopIdsCopy[sizeof(config.berlinStopIds)];
+    strlcpy(stopIdsCopy, config.berlinStopIds, sizeof(stopIdsCopy));
+
+    const char *stopIds[MAX_CONFIG_STOPS];
+    int stopCount = splitStopIds(stopIdsCopy, stopIds, MAX_CONFIG_STOPS);
+
+    if (stopIndex < 0 || stopIndex >= stopCount)
+    {
+        result.hasError = true;
+        strlcpy(result.errorMsg, "Missing stop ID", sizeof(result.errorMsg));
+        return result;
+    }
+
+    DestinationShortener::getInstance().configure(DestinationShortener::CITY_BERLIN, config.berlinAbbreviations);
+    collector.reset(config.minDepartureTime);
+
+    // Stop name comes from the first configured stop only
+    bool firstStop = (stopIndex == 0);
+    char unusedName[64];
+    unsigned long startMs = clockMillis();
+    bool queried = querySingleStop(stopIds[stopIndex], config, collector,
+                                   firstStop ? result.stopName : unusedName, firstStop, stopIndex);
+    Metrics::getInstance().recordFetch(stopIndex, clockMillis() - startMs);
+
+    result.departureCount = collector.copySorted(result.departures, result.strings);
+    result.truncated = collector.isTruncated();
+
+    // An empty board is valid here - other stops may still fill the cache
+    if (!queried)
+    {
+        result.hasError = true;
+        strlcpy(result.errorMsg, "Stop query failed", sizeof(result.errorMsg));
+    }
+
+    logTimestamp();
+    char msg[64];
+    snprintf(msg, sizeof(msg), "BVG API: Stop %d refreshed, %d departures", stopIndex, result.departureCount);
+    debugPrintln(msg);
+
+    return result;
+}
+
 bool BvgAPI::querySingleStop(const char *stopId, const Config &config,
-                             Departure *tempDepartures, int &tempCount,
+                             DepartureCollector &collector,
                              char *stopName, bool &isFirstStop, int stopIndex)
 {
-    // Build URL with 'when' parameter to offset query time by minDepartureTime
-    // Format: https://v6.bvg.transport.rest/stops/{stopId}/departures?duration=120&results=12&when={unix_timestamp}
-    char url[256];
+    // Build path with 'when' parameter to offset query time by minDepartureTime
+    // Format: /stops/{stopId}/departures?duration=120&results=12&when={unix_timestamp}
+    char path[256];
 
     // Calculate offset time: current time + minDepartureTime (in seconds)
     // BVG API accepts Unix timestamps (seconds since epoch)
     // Add 90-second buffer: BVG API returns departures ~80s before 'when' time + HTTP latency
-    time_t now = time(nullptr);
+    time_t now = getCurrentEpochTime();
     time_t whenTime = now + (config.minDepartureTime * 60) + 90;
 
-    snprintf(url, sizeof(url),
-             "https://v6.bvg.transport.rest/stops/%s/departures?duration=120&results=12&when=%ld",
+    snprintf(path, sizeof(path),
+             "/stops/%s/departures?duration=120&results=12&when=%ld",
              stopId, (long)whenTime);
 
-    HTTPClient http;
-    http.setTimeout(HTTP_TIMEOUT_MS);
+    // Shared keep-alive connection to v6.bvg.transport.rest (reused across the stops of one refresh)
+    HttpConnectionManager &connections = HttpConnectionManager::getInstance();
+    const HttpConnectionManager::Host host = HttpConnectionManager::HOST_BVG;
+    const char *headers[] = {"Content-Type", "application/json"};
 
     logTimestamp();
     debugPrint("BVG API: Querying stop ");
     debugPrintln(stopId);
     logTimestamp();
     char debugMsg[128];
-    snprintf(debugMsg, sizeof(debugMsg), "BVG API: URL: %s (now=%ld, when=%ld, offset=%d min)",
-             url, (long)now, (long)whenTime, config.minDepartureTime);
+    snprintf(debugMsg, sizeof(debugMsg), "BVG API: Path: %s (now=%ld, when=%ld, offset=%d min)",
+             path, (long)now, (long)whenTime, config.minDepartureTime);
     debugPrintln(debugMsg);
 
     bool success = false;
     int httpCode = 0;
 
     // Retry logic: 3 attempts with exponential backoff
-    // IMPORTANT: http.begin() must be called for each attempt, and http.end()
-    // must be called before retrying to avoid socket leaks (TIME_WAIT accumulation)
+    // The connection manager transparently reconnects if the kept-alive socket died
     // NOTE: Status callback NOT called during retries - errors shown in status bar
     //       via the apiError mechanism, keeping departures visible
     for (int attempt = 1; attempt <= 3; attempt++)
     {
-        // Establish connection for this attempt
-        http.begin(url);
-        http.addHeader("Content-Type", "application/json");
-
-        httpCode = http.GET();
+        httpCode = connections.get(host, path, headers, 1, HTTP_TIMEOUT_MS);
 
         if (httpCode == HTTP_CODE_OK)
         {
@@ -185,8 +202,8 @@ bool BvgAPI::querySingleStop(const char *stopId, const Config &config,
         }
         else
         {
-            // Close connection BEFORE logging or retrying to free socket immediately
-            http.end();
+            // Finish this response before logging or retrying (socket kept if reusable)
+            connections.end(host);
 
             logTimestamp();
             char errMsg[128];
@@ -209,33 +226,36 @@ bool BvgAPI::querySingleStop(const char *stopId, const Config &config,
                 char retryMsg[64];
                 snprintf(retryMsg, sizeof(retryMsg), "BVG API: Retry %d/3 after %dms", attempt + 1, delayMs);
                 debugPrintln(retryMsg);
-                delay(delayMs);
+                clockDelay(delayMs);
             }
         }
     }
 
     if (!success)
     {
-        // http.end() already called in the loop on failure
+        // connections.end() already called in the loop on failure
         logTimestamp();
         debugPrintln("BVG API: Failed after retries");
         return false;
     }
 
-    // Parse JSON response
-    String payload = http.getString();
-    http.end();
-
+    // Parse JSON response straight from the connection (no intermediate String copy)
     DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, payload);
+    unsigned long parseStartMs = clockMillis();
+    DeserializationError error = deserializeJson(doc, connections.getBodyStream(host));
+    Metrics::getInstance().recordParse(clockMillis() - parseStartMs);
+    Metrics::getInstance().recordJsonDocument(Metrics::JSON_DOC_BVG, doc.memoryUsage(), JSON_BUFFER_SIZE,
+                                              doc.overflowed() || error == DeserializationError::NoMemory);
 
     if (error)
     {
+        connections.drop(host);  // Stream position unknown after a parse error
         logTimestamp();
         debugPrint("BVG API: JSON parse error: ");
         debugPrintln(error.c_str());
         return false;
     }
+    connections.end(host);
 
     // BVG API returns: {"departures": [...]}
     JsonArray departures = doc["departures"].as<JsonArray>();
@@ -267,28 +287,33 @@ bool BvgAPI::querySingleStop(const char *stopId, const Config &config,
         isFirstStop = false;
     }
 
+    // results= limit reached - later departures were not returned
+    if ((int)departures.size() >= MAX_DEPARTURES)
+    {
+        collector.markSourceCapped();
+    }
+
     // Parse each departure
-    int beforeParse = tempCount;
+    int beforeParse = collector.getOfferedCount();
     for (JsonObject depJson : departures)
     {
-        if (tempCount >= MAX_TEMP_DEPARTURES)
-            break;
-
-        parseDepartureObject(depJson, tempDepartures, tempCount, stopIndex);
+        parseDepartureObject(depJson, collector, stopIndex);
     }
 
     logTimestamp();
-    int parsedCount = tempCount - beforeParse;
-    snprintf(countMsg, sizeof(countMsg), "BVG API: Parsed %d departures (total now: %d)", parsedCount, tempCount);
+    int parsedCount = collector.getOfferedCount() - beforeParse;
+    snprintf(countMsg, sizeof(countMsg), "BVG API: Parsed %d departures (kept now: %d)", parsedCount, collector.size());
     debugPrintln(countMsg);
 
     return true;
 }
 
-void BvgAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartures, int &tempCount, int stopIndex)
+void BvgAPI::parseDepartureObject(JsonObject depJson, DepartureCollector &collector, int stopIndex)
 {
+    Departure dep = {};
+
     // Set stop index
-    tempDepartures[tempCount].stopIndex = stopIndex;
+    dep.stopIndex = stopIndex;
 
     // Extract line name (from line.name)
     if (!depJson.containsKey("line") || !depJson["line"].containsKey("name"))
@@ -306,7 +331,8 @@ void BvgAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartures,
         return;
     }
 
-    strlcpy(tempDepartures[tempCount].line, lineName, sizeof(tempDepartures[tempCount].line));
+    // Trip identity (matches the same vehicle run across refreshes)
+    dep.tripKey = hashTripId(depJson["tripId"].as<const char*>());
 
     // Extract direction (destination)
     const char *direction = depJson["direction"].as<const char*>();
@@ -317,27 +343,10 @@ void BvgAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartures,
         return; // Skip if no destination
     }
 
-    // Extract platform and append to destination if present
-    // const char *platform = depJson["platform"].as<const char*>();
-    // if (platform && strlen(platform) > 0)
-    // {
-    //     // Parse platform: if it contains a space (e.g., "Gleis 12"), use only the part after the space
-    //     // Otherwise use the entire string (e.g., "12", "A", "1a")
-    //     const char *platformDisplay = platform;
-    //     const char *spacePos = strchr(platform, ' ');
-    //     if (spacePos != nullptr)
-    //     {
-    //         platformDisplay = spacePos + 1;  // Use part after space
-    //     }
-
-    //     // Format: "Destination <Pl>"
-    //     snprintf(tempDepartures[tempCount].destination, sizeof(tempDepartures[tempCount].destination),
-    //              "%s %s", direction, platformDisplay);
-    // }
-    // else
-    // {
-        strlcpy(tempDepartures[tempCount].destination, direction, sizeof(tempDepartures[tempCount].destination));
-    // }
+    char destination[2 * MAX_DESTINATION_LENGTH]; // UTF-8, converted and truncated by setLabels()
+
+    // Abbreviate before truncating to the field size (e.g. "S+U Hauptbahnhof" -> "Hbf")
+    DestinationShortener::getInstance().shorten(direction, destination, sizeof(destination));
 
     // Parse ISO 8601 timestamp from "when" field
     const char *when = depJson["when"].as<const char*>();
@@ -348,13 +357,8 @@ void BvgAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartures,
         return; // Skip if no timestamp
     }
 
-    // Parse: "2026-01-11T14:30:00+01:00"
-    struct tm tm;
-    memset(&tm, 0, sizeof(tm));
-
-    // Note: strptime doesn't handle timezone offset well on ESP32, so we parse basic format
-    // and ignore timezone (Berlin is always CET/CEST which matches Prague)
-    if (strptime(when, "%Y-%m-%dT%H:%M:%S", &tm) == NULL)
+    // Parse: "2026-01-11T14:30:00+01:00" (offset applied, result is UTC)
+    if (!parseISO8601(when, &dep.departureTime))
     {
         logTimestamp();
         debugPrint("BVG API: Skipping departure - failed to parse timestamp: ");
@@ -362,14 +366,9 @@ void BvgAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartures,
         return; // Skip if timestamp parse fails
     }
 
-    // Tell mktime to auto-determine DST
-    tm.tm_isdst = -1;
-
-    tempDepartures[tempCount].departureTime = mktime(&tm);
-
     // Calculate ETA (minutes from now)
-    time_t now = time(nullptr);
-    int etaSeconds = tempDepartures[tempCount].departureTime - now;
+    time_t now = getCurrentEpochTime();
+    int etaSeconds = dep.departureTime - now;
 
     // Skip departures that are in the past (negative or zero etaSeconds)
     // Must check BEFORE division because -4/60 = 0 (integer division rounds toward zero)
@@ -382,15 +381,15 @@ void BvgAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartures,
         return;
     }
 
-    tempDepartures[tempCount].eta = etaSeconds / 60;
+    dep.eta = etaSeconds / 60;
 
     // Debug log for first few departures
-    if (tempCount < 16)
+    if (collector.getOfferedCount() < 16)
     {
         logTimestamp();
         char debugMsg[128];
         snprintf(debugMsg, sizeof(debugMsg), "BVG API: Line %s to %s - ETA: %d min (when: %s, now: %ld, dep: %ld)",
-                 lineName, direction, tempDepartures[tempCount].eta, when, (long)now, (long)tempDepartures[tempCount].departureTime);
+                 lineName, direction, dep.eta, when, (long)now, (long)dep.departureTime);
         debugPrintln(debugMsg);
     }
 
@@ -398,17 +397,23 @@ void BvgAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartures,
     if (!depJson["delay"].isNull())
     {
         int delaySec = depJson["delay"] | 0;
-        tempDepartures[tempCount].delayMinutes = delaySec / 60;
-        tempDepartures[tempCount].isDelayed = (delaySec >= 60);  // Only flag if ≥1 minute
+        dep.delayMinutes = delaySec / 60;
+        dep.isDelayed = (delaySec >= 60);  // Only flag if ≥1 minute
     }
     else
     {
-        tempDepartures[tempCount].delayMinutes = 0;
-        tempDepartures[tempCount].isDelayed = false;
+        dep.delayMinutes = 0;
+        dep.isDelayed = false;
     }
 
     // BVG API doesn't provide AC info
-    tempDepartures[tempCount].hasAC = false;
+    dep.hasAC = false;
+
+    // Strings are interned - the record only keeps their indices
+    if (!collector.setLabels(dep, lineName, destination))
+    {
+        return;
+    }
 
-    tempCount++;
+    collector.add(dep);
 }
@@ -3,6 +3,7 @@
 
 #include "TransitAPI.h"
 #include "DepartureData.h"
+#include "DepartureCollector.h"
 #include "../config/AppConfig.h"
 #include <ArduinoJson.h>
 
@@ -38,36 +39,44 @@ public:
      */
     virtual APIResult fetchDepartures(const Config &config) override;
 
+    /**
+     * Fetch departures of a single configured Berlin stop
+     * @param config Configuration with stop IDs and filters
+     * @param stopIndex Index of the stop in config.berlinStopIds
+     * @return APIResult with this stop's departures only
+     */
+    virtual APIResult fetchStopDepartures(const Config &config, int stopIndex) override;
+
 private:
     APIStatusCallback statusCallback;
     APIPartialResultsCallback partialResultsCallback;
-    static constexpr int MAX_TEMP_DEPARTURES = MAX_DEPARTURES * 12;  // Buffer for up to 12 stops at full capacity
+    static constexpr int MAX_CONFIG_STOPS = sizeof(Config::berlinStopIds) / 2;  // Upper bound of "A,B,..." in the config string
+
+    DepartureCollector collector;  // Soonest departures across all stops (bounded, O(MAX_DEPARTURES))
     static constexpr int JSON_BUFFER_SIZE = 24576;  // 24KB - BVG API returns verbose responses (~1.7KB per departure)
     static constexpr int HTTP_TIMEOUT_MS = 10000;
 
     /**
-     * Query a single stop and add results to temp array
+     * Query a single stop and offer its departures to the collector
      * @param stopId Stop ID to query
      * @param config Configuration
-     * @param tempDepartures Temporary array to fill
-     * @param tempCount Current count in temp array
+     * @param collector Collector keeping the soonest departures
      * @param stopName Output: stop name (from first stop only)
      * @param isFirstStop Whether this is the first stop being queried
      * @param stopIndex Index of the stop (0, 1, 2, ...)
      * @return true if query succeeded
      */
     bool querySingleStop(const char *stopId, const Config &config,
-                         Departure *tempDepartures, int &tempCount,
+                         DepartureCollector &collector,
                          char *stopName, bool &isFirstStop, int stopIndex);
 
     /**
-     * Parse departure JSON object and add to temp array
+     * Parse departure JSON object and offer it to the collector
      * @param depJson JSON object for single departure
-     * @param tempDepartures Array to add to
-     * @param tempCount Current count (will be incremented)
+     * @param collector Collector keeping the soonest departures
      * @param stopIndex Index of the stop this departure is from
      */
-    void parseDepartureObject(JsonObject depJson, Departure *tempDepartures, int &tempCount, int stopIndex);
+    void parseDepartureObject(JsonObject depJson, DepartureCollector &collector, int stopIndex);
 };
 
 #endif // BVGAPI_H
@@ -0,0 +1,142 @@
+#include "DepartureCollector.h"
+#include "../utils/Logger.h"
+#include "../utils/gfxlatin2.h"
+
+DepartureCollector::DepartureCollector()
+    : count(0), offered(0), minEta(0), evicted(false), sourceCapped(false)
+{
+}
+
+void DepartureCollector::reset(int minEtaMinutes)
+{
+    count = 0;
+    offered = 0;
+    minEta = minEtaMinutes;
+    evicted = false;
+    sourceCapped = false;
+    strings.reset();
+}
+
+bool DepartureCollector::setLabels(Departure &dep, const char *line, const char *destination)
+{
+    // Converted once here, so every redraw can print the stored bytes as they are
+    char lineText[MAX_LINE_LENGTH];
+    char destinationText[MAX_DESTINATION_LENGTH];
+    utf8ToGfxLatin2(line ? line : "", lineText, sizeof(lineText));
+    utf8ToGfxLatin2(destination ? destination : "", destinationText, sizeof(destinationText));
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        dep.lineId = strings.intern(lineText, MAX_LINE_LENGTH);
+        dep.destinationId = strings.intern(destinationText, MAX_DESTINATION_LENGTH);
+        if (dep.lineId != ParseStrings::NONE && dep.destinationId != ParseStrings::NONE)
+        {
+            return true;
+        }
+
+        // Full of strings from evicted departures - keep only those still referenced
+        compactStrings();
+    }
+
+    logTimestamp();
+    debugPrintln("Collector: String table full, departure skipped");
+    return false;
+}
+
+bool DepartureCollector::add(const Departure &dep)
+{
+    offered++;
+
+    if (dep.eta < minEta)
+    {
+        return false;
+    }
+
+    if (count < MAX_DEPARTURES)
+    {
+        heap[count] = dep;
+        siftUp(count);
+        count++;
+        return true;
+    }
+
+    // Full: only a departure earlier than the latest one kept gets in
+    evicted = true;
+    if (dep.departureTime >= heap[0].departureTime)
+    {
+        return false;
+    }
+
+    heap[0] = dep;
+    siftDown(0);
+    return true;
+}
+
+int DepartureCollector::copySorted(Departure *out, DepartureStrings &outStrings) const
+{
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = heap[i];
+    }
+    sortDepartureRun(out, count);
+
+    outStrings.reset();
+    reinternDepartures(out, count, strings, outStrings);
+    return count;
+}
+
+void DepartureCollector::compactStrings()
+{
+    // Static: only ever used from the single fetch context
+    static DepartureStrings live;
+    live.reset();
+    reinternDepartures(heap, count, strings, live);
+
+    strings.reset();
+    reinternDepartures(heap, count, live, strings);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Collector: Compacted string table to %d entries", strings.size());
+    logTimestamp();
+    debugPrintln(msg);
+}
+
+void DepartureCollector::siftUp(int index)
+{
+    Departure moving = heap[index];
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (heap[parent].departureTime >= moving.departureTime)
+        {
+            break;
+        }
+        heap[index] = heap[parent];
+        index = parent;
+    }
+    heap[index] = moving;
+}
+
+void DepartureCollector::siftDown(int index)
+{
+    Departure moving = heap[index];
+    for (;;)
+    {
+        int child = 2 * index + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && heap[child + 1].departureTime > heap[child].departureTime)
+        {
+            child++;
+        }
+        if (moving.departureTime >= heap[child].departureTime)
+        {
+            break;
+        }
+        heap[index] = heap[child];
+        index = child;
+    }
+    heap[index] = moving;
+}
@@ -0,0 +1,98 @@
+#ifndef DEPARTURECOLLECTOR_H
+#define DEPARTURECOLLECTOR_H
+
+#include "DepartureData.h"
+
+// ============================================================================
+// Bounded Top-K Departure Collector
+// ============================================================================
+
+/**
+ * Keeps the MAX_DEPARTURES soonest departures offered to it.
+ *
+ * Backed by a fixed-size max-heap on departureTime: the root is the latest
+ * departure kept, so a new one either replaces it or is rejected in
+ * O(log K). Memory stays at K entries no matter how many stops or
+ * departures are fed in, and the minimum departure time filter is applied
+ * at insertion so filtered entries never take a slot.
+ *
+ * Line and destination strings are converted to the display's GFX Latin 2
+ * encoding and interned into a per-fetch table while parsing; copySorted()
+ * hands them over in a board-sized DepartureStrings.
+ */
+class DepartureCollector
+{
+public:
+    DepartureCollector();
+
+    /**
+     * Start a new collection (also resets the string table)
+     * @param minEtaMinutes Departures with a smaller ETA are rejected
+     */
+    void reset(int minEtaMinutes);
+
+    /**
+     * Convert a parsed departure's line and destination to GFX Latin 2 and
+     * intern them into the collector's table
+     * Compacts the table to the strings of kept departures if it fills up
+     * @param dep Departure to label (lineId/destinationId set)
+     * @param line UTF-8 line label (truncated to MAX_LINE_LENGTH after conversion)
+     * @param destination UTF-8 destination (truncated to MAX_DESTINATION_LENGTH after conversion)
+     * @return false if the strings could not be stored
+     */
+    bool setLabels(Departure& dep, const char* line, const char* destination);
+
+    /**
+     * Offer a departure
+     * @param dep Parsed departure (eta and departureTime set)
+     * @return true if it is currently among the soonest K
+     */
+    bool add(const Departure& dep);
+
+    /**
+     * Copy kept departures to an array, sorted by departure time
+     * Non-destructive, so it can be used for partial results mid-collection
+     * @param out Destination (room for MAX_DEPARTURES entries)
+     * @param outStrings Receives the strings of the copied departures
+     * @return Number of departures copied
+     */
+    int copySorted(Departure* out, DepartureStrings& outStrings) const;
+
+    int size() const { return count; }
+
+    /**
+     * Record that a response was cut off by the API's result limit
+     */
+    void markSourceCapped() { sourceCapped = true; }
+
+    /**
+     * Whether departures later than the last kept one may be missing
+     * (evicted by the K limit, or never returned by a capped response)
+     */
+    bool isTruncated() const { return evicted || sourceCapped; }
+
+    /**
+     * Number of departures offered since reset(), including rejected ones
+     */
+    int getOfferedCount() const { return offered; }
+
+private:
+    // Distinct lines + destinations seen in one fetch at large interchanges
+    static constexpr int MAX_PARSE_STRINGS = 128;
+    static constexpr int PARSE_POOL_BYTES = 2048;
+    typedef StringPool<MAX_PARSE_STRINGS, PARSE_POOL_BYTES> ParseStrings;
+
+    Departure heap[MAX_DEPARTURES];
+    ParseStrings strings;
+    int count;
+    int offered;
+    int minEta;
+    bool evicted;
+    bool sourceCapped;
+
+    void compactStrings();
+    void siftUp(int index);
+    void siftDown(int index);
+};
+
+#endif // DEPARTURECOLLECTOR_H
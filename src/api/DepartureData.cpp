@@ -3,53 +3,270 @@
 #include <string.h>
 
 // ============================================================================
-// String Shortening for Display
+// Departure Sorting Helper
+// ============================================================================
+
+int compareDepartures(const void *a, const void *b)
+{
+    Departure *depA = (Departure *)a;
+    Departure *depB = (Departure *)b;
+    return depA->eta - depB->eta; // Sort by ETA ascending
+}
+
+// ============================================================================
+// Sorted Run Merging
 // ============================================================================
 
-struct StringReplacement
+void sortDepartureRun(Departure *run, int count)
+{
+    for (int i = 1; i < count; i++)
+    {
+        if (run[i].departureTime >= run[i - 1].departureTime)
+        {
+            continue; // Already in order (the common case)
+        }
+
+        Departure moving = run[i];
+        int j = i - 1;
+        while (j >= 0 && run[j].departureTime > moving.departureTime)
+        {
+            run[j + 1] = run[j];
+            j--;
+        }
+        run[j + 1] = moving;
+    }
+}
+
+int mergeDepartureRun(Departure *top, int topCount, int capacity, const Departure *run, int runCount)
 {
-    const char *search;
-    const char *replace;
-};
-
-// Common Czech words to shorten for display space
-// Note: Strings are in UTF-8 format (before conversion to ISO-8859-2)
-static const StringReplacement replacements[] = {
-    {"Nádraží", "Nádr."},
-    {"Sídliště", "Sídl."},
-    {"Nemocnice", "Nem."},
-    {"nádraží", "nádr."},
-};
-static const int replacementCount = sizeof(replacements) / sizeof(replacements[0]);
-
-void shortenDestination(char *destination)
+    int total = topCount + runCount;
+    int newCount = (total < capacity) ? total : capacity;
+    int toDrop = total - newCount;
+
+    // Merge from the back so no scratch buffer is needed: the write position
+    // never overtakes the unread part of top. The latest departures of both
+    // inputs are consumed first and simply skipped until only newCount remain.
+    int i = topCount - 1;
+    int j = runCount - 1;
+    int w = newCount - 1;
+
+    while (j >= 0)
+    {
+        const Departure *next;
+        if (i >= 0 && top[i].departureTime > run[j].departureTime)
+        {
+            next = &top[i--];
+        }
+        else
+        {
+            next = &run[j--];
+        }
+
+        if (toDrop > 0)
+        {
+            toDrop--;
+            continue;
+        }
+        top[w--] = *next;
+    }
+
+    // Whatever is left of top is already in place (only trim the excess)
+    return newCount;
+}
+
+int replaceStopDepartures(Departure *cache, DepartureStrings &cacheStrings, int count, int stopIndex,
+                          const Departure *run, const DepartureStrings &runStrings, int runCount,
+                          uint32_t &trimmedStops)
 {
-    for (int i = 0; i < replacementCount; i++)
+    // Both boards' strings fit here, so the merge can use one set of indices
+    static StringPool<4 * MAX_DEPARTURES, 2 * MAX_DEPARTURES * (MAX_LINE_LENGTH + MAX_DESTINATION_LENGTH)> merged;
+    static Departure runCopy[MAX_DEPARTURES];
+    merged.reset();
+
+    trimmedStops = 0;
+
+    // Drop the stop's previous entries (order of the rest is preserved)
+    int kept = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (cache[i].stopIndex != stopIndex)
+        {
+            cache[kept++] = cache[i];
+        }
+    }
+    reinternDepartures(cache, kept, cacheStrings, merged);
+
+    if (runCount > MAX_DEPARTURES)
     {
-        char *pos = strstr(destination, replacements[i].search);
-        if (pos != NULL)
+        runCount = MAX_DEPARTURES;
+    }
+    memcpy(runCopy, run, runCount * sizeof(Departure));
+    reinternDepartures(runCopy, runCount, runStrings, merged);
+
+    // Walk the latest entries the merge will trim, same order as mergeDepartureRun()
+    int toDrop = kept + runCount - MAX_DEPARTURES;
+    int i = kept - 1;
+    int j = runCount - 1;
+    while (toDrop-- > 0)
+    {
+        const Departure *dropped;
+        if (j < 0 || (i >= 0 && cache[i].departureTime > runCopy[j].departureTime))
+        {
+            dropped = &cache[i--];
+        }
+        else
+        {
+            dropped = &runCopy[j--];
+        }
+
+        if (dropped->stopIndex >= 0 && dropped->stopIndex < 32)
         {
-            int searchLen = strlen(replacements[i].search);
-            int replaceLen = strlen(replacements[i].replace);
-            int tailLen = strlen(pos + searchLen);
-
-            // Copy replacement
-            memcpy(pos, replacements[i].replace, replaceLen);
-            // Shift remaining text
-            memmove(pos + replaceLen, pos + searchLen, tailLen + 1); // +1 for null terminator
+            trimmedStops |= (uint32_t)1 << dropped->stopIndex;
         }
     }
+
+    int newCount = mergeDepartureRun(cache, kept, MAX_DEPARTURES, runCopy, runCount);
+
+    // Keep only the strings the merged board still references
+    cacheStrings.reset();
+    reinternDepartures(cache, newCount, merged, cacheStrings);
+    return newCount;
 }
 
 // ============================================================================
-// Departure Sorting Helper
+// Trip Identity Deltas
 // ============================================================================
 
-int compareDepartures(const void *a, const void *b)
+uint32_t hashTripId(const char *tripId)
 {
-    Departure *depA = (Departure *)a;
-    Departure *depB = (Departure *)b;
-    return depA->eta - depB->eta; // Sort by ETA ascending
+    if (tripId == nullptr || *tripId == '\0')
+    {
+        return 0;
+    }
+
+    uint32_t hash = 2166136261u;
+    while (*tripId)
+    {
+        hash ^= (uint8_t)*tripId++;
+        hash *= 16777619u;
+    }
+    return hash ? hash : 1; // 0 is reserved for "no trip ID"
+}
+
+static bool isSameTrip(const Departure &a, const DepartureStrings &aStrings,
+                       const Departure &b, const DepartureStrings &bStrings)
+{
+    if (a.stopIndex != b.stopIndex || a.tripKey != b.tripKey)
+    {
+        return false;
+    }
+
+    // Without a trip ID only an identical departure is recognised
+    if (a.tripKey == 0)
+    {
+        return a.departureTime == b.departureTime &&
+               strcmp(aStrings.get(a.lineId), bStrings.get(b.lineId)) == 0 &&
+               strcmp(aStrings.get(a.destinationId), bStrings.get(b.destinationId)) == 0;
+    }
+    return true;
+}
+
+static bool hasTripChanged(const Departure &a, const DepartureStrings &aStrings,
+                           const Departure &b, const DepartureStrings &bStrings)
+{
+    return a.departureTime != b.departureTime ||
+           a.isDelayed != b.isDelayed ||
+           a.delayMinutes != b.delayMinutes ||
+           a.hasAC != b.hasAC ||
+           a.isScheduled != b.isScheduled ||
+           strcmp(aStrings.get(a.lineId), bStrings.get(b.lineId)) != 0 ||
+           strcmp(aStrings.get(a.destinationId), bStrings.get(b.destinationId)) != 0;
+}
+
+static_assert(MAX_DEPARTURES <= 32, "applyDepartureDelta() tracks matches in a 32-bit mask");
+
+int applyDepartureDelta(Departure *cache, DepartureStrings &cacheStrings, int count,
+                        const Departure *next, const DepartureStrings &nextStrings, int nextCount,
+                        DepartureDelta &delta)
+{
+    delta.added = 0;
+    delta.removed = 0;
+    delta.changed = 0;
+
+    // Match each new entry to an unused old one (the same trip can serve several stops)
+    uint32_t matched = 0;
+    for (int j = 0; j < nextCount; j++)
+    {
+        int found = -1;
+        for (int i = 0; i < count; i++)
+        {
+            if (!(matched & ((uint32_t)1 << i)) && isSameTrip(cache[i], cacheStrings, next[j], nextStrings))
+            {
+                found = i;
+                break;
+            }
+        }
+
+        if (found < 0)
+        {
+            delta.added++;
+        }
+        else
+        {
+            matched |= (uint32_t)1 << found;
+            if (hasTripChanged(cache[found], cacheStrings, next[j], nextStrings))
+            {
+                delta.changed++;
+            }
+        }
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (!(matched & ((uint32_t)1 << i)))
+        {
+            delta.removed++;
+        }
+    }
+
+    // Rewrite only the slots whose contents moved or changed
+    for (int j = 0; j < nextCount; j++)
+    {
+        if (j >= count || memcmp(&cache[j], &next[j], sizeof(Departure)) != 0)
+        {
+            cache[j] = next[j];
+        }
+    }
+    if (&cacheStrings != &nextStrings)
+    {
+        cacheStrings = nextStrings;
+    }
+
+    return nextCount;
+}
+
+// ============================================================================
+// Stop ID List Parsing
+// ============================================================================
+
+int splitStopIds(char *buffer, const char **ids, int maxIds)
+{
+    int count = 0;
+    char *saveptr = nullptr;
+    char *token = strtok_r(buffer, ",", &saveptr);
+    while (token != NULL && count < maxIds)
+    {
+        // Trim whitespace
+        while (*token == ' ')
+            token++;
+
+        if (*token != '\0')
+        {
+            ids[count++] = token;
+        }
+
+        token = strtok_r(NULL, ",", &saveptr);
+    }
+    return count;
 }
 
 // ============================================================================
@@ -2,23 +2,54 @@
 #define DEPARTUREDATA_H
 
 #include <time.h>
+#include <stdint.h>
+#include "../utils/StringPool.h"
 
 // ============================================================================
 // Departure Data Structures
 // ============================================================================
 
 #define MAX_DEPARTURES 12  // Increased for better caching with filtering
+#define MAX_LINE_LENGTH 8          // Line label field size, including terminator
+#define MAX_DESTINATION_LENGTH 32  // Destination field size, including terminator
 
+/**
+ * Interned line and destination strings of one departure board
+ * Sized so any MAX_DEPARTURES records fit even if no string repeats
+ */
+typedef StringPool<2 * MAX_DEPARTURES,
+                   MAX_DEPARTURES * (MAX_LINE_LENGTH + MAX_DESTINATION_LENGTH)> DepartureStrings;
+
+/**
+ * Compact departure record (24 bytes with a 64-bit time_t)
+ * Line and destination are indices into the DepartureStrings table of the
+ * board (cache, API result or collector) the record belongs to.
+ */
 struct Departure
 {
-    char line[8];         // Line number (e.g., "31", "A", "S9")
-    char destination[32]; // Destination/headsign
-    int eta;              // Minutes until departure (recalculated from departureTime)
-    time_t departureTime; // Unix timestamp of departure (from API)
-    bool hasAC;           // Air conditioning
-    bool isDelayed;       // Has delay
-    int delayMinutes;     // Delay in minutes
-    int stopIndex;        // Which stop this departure is from (0, 1, 2, ...)
+    time_t departureTime;  // Unix timestamp of departure (from API)
+    uint32_t tripKey;      // Hash of the provider's trip ID (0 = unknown, see hashTripId())
+    int16_t eta;           // Minutes until departure (recalculated from departureTime)
+    int16_t delayMinutes;  // Delay in minutes
+    int8_t stopIndex;      // Which stop this departure is from (0, 1, 2, ...; -1 = unknown)
+    uint8_t lineId;        // Line number (e.g., "31", "A", "S9") in the board's strings
+    uint8_t destinationId; // Destination/headsign in the board's strings
+    bool hasAC;            // Air conditioning
+    bool isDelayed;        // Has delay
+    bool isScheduled;      // From the offline timetable, not live data (see StaticSchedule)
+};
+
+/**
+ * Difference between two departure lists, matched by trip identity
+ * A departure is the same trip if tripKey and stopIndex match
+ */
+struct DepartureDelta
+{
+    uint8_t added;   // Trips not in the previous list
+    uint8_t removed; // Trips no longer in the list
+    uint8_t changed; // Same trip with a new time, delay or label
+
+    bool isEmpty() const { return added == 0 && removed == 0 && changed == 0; }
 };
 
 // ============================================================================
@@ -34,11 +65,99 @@ struct Departure
 int compareDepartures(const void* a, const void* b);
 
 /**
- * Shorten long destination names to fit on display
- * Modifies the string in-place
- * @param destination UTF-8 string to shorten (will be modified in-place)
+ * Sort one stop's departures by departure time (insertion sort)
+ * API responses are already in time order, so this is linear in practice
+ * @param run Departures to sort in place
+ * @param count Number of departures in run
+ */
+void sortDepartureRun(Departure* run, int count);
+
+/**
+ * Merge a time-sorted run into a time-sorted top-N list, in place
+ * Keeps only the earliest `capacity` departures of both inputs, so merging
+ * k stops one after another costs O(k * capacity) instead of re-sorting
+ * everything collected so far. Ties keep entries already in top first.
+ * @param top Sorted list with room for capacity entries
+ * @param topCount Number of entries currently in top
+ * @param capacity Maximum number of entries to keep
+ * @param run Sorted run to merge (must not overlap top)
+ * @param runCount Number of entries in run
+ * @return New number of entries in top
+ */
+int mergeDepartureRun(Departure* top, int topCount, int capacity, const Departure* run, int runCount);
+
+/**
+ * Replace one stop's departures in a time-sorted cache with a fresh run
+ * Entries of other stops are kept; the union is trimmed to MAX_DEPARTURES.
+ * The cache's string table is rebuilt to hold only strings still referenced.
+ * @param cache Sorted cache with room for MAX_DEPARTURES entries
+ * @param cacheStrings String table of cache (rebuilt)
+ * @param count Number of entries currently in cache
+ * @param stopIndex Stop whose entries are replaced
+ * @param run Sorted departures just fetched for stopIndex
+ * @param runStrings String table of run
+ * @param runCount Number of entries in run
+ * @param trimmedStops Output: bit i set if stop i lost departures to the capacity trim (stops 0-31)
+ * @return New number of entries in cache
+ */
+int replaceStopDepartures(Departure* cache, DepartureStrings& cacheStrings, int count, int stopIndex,
+                          const Departure* run, const DepartureStrings& runStrings, int runCount,
+                          uint32_t& trimmedStops);
+
+/**
+ * Move departures' strings from one table to another, rewriting their indices
+ * @param deps Departures to rewrite
+ * @param count Number of departures
+ * @param from Table the indices currently refer to
+ * @param to Table to intern into (not reset)
+ * @return false if to ran out of space (affected labels become "")
+ */
+template <class FromStrings, class ToStrings>
+bool reinternDepartures(Departure* deps, int count, const FromStrings& from, ToStrings& to)
+{
+    bool ok = true;
+    for (int i = 0; i < count; i++)
+    {
+        deps[i].lineId = to.intern(from.get(deps[i].lineId), MAX_LINE_LENGTH);
+        deps[i].destinationId = to.intern(from.get(deps[i].destinationId), MAX_DESTINATION_LENGTH);
+        ok = ok && deps[i].lineId != ToStrings::NONE && deps[i].destinationId != ToStrings::NONE;
+    }
+    return ok;
+}
+
+/**
+ * Hash a provider trip ID into a stable key (FNV-1a)
+ * @param tripId Trip ID string from the API (may be nullptr)
+ * @return Non-zero key, or 0 if tripId is missing or empty
+ */
+uint32_t hashTripId(const char* tripId);
+
+/**
+ * Apply a new departure list to the cache in place and report what changed
+ * Trips are matched by tripKey and stopIndex; departures without a key match
+ * only an identical entry. Only cache slots that differ are rewritten.
+ * @param cache Cache to update (room for MAX_DEPARTURES entries)
+ * @param cacheStrings String table of cache (replaced by nextStrings)
+ * @param count Number of entries currently in cache
+ * @param next New list, sorted the way the cache should be
+ * @param nextStrings String table of next
+ * @param nextCount Number of entries in next (at most MAX_DEPARTURES)
+ * @param delta Output: added, removed and changed trips
+ * @return New number of entries in cache
+ */
+int applyDepartureDelta(Departure* cache, DepartureStrings& cacheStrings, int count,
+                        const Departure* next, const DepartureStrings& nextStrings, int nextCount,
+                        DepartureDelta& delta);
+
+/**
+ * Split a comma-separated stop ID list in place
+ * Whitespace before each ID is skipped and empty entries are ignored
+ * @param buffer Writable copy of the list (commas are replaced by terminators)
+ * @param ids Output: pointers into buffer
+ * @param maxIds Capacity of ids
+ * @return Number of IDs found (at most maxIds)
  */
-void shortenDestination(char* destination);
+int splitStopIds(char* buffer, const char** ids, int maxIds);
 
 /**
  * Calculate ETA in minutes from departure timestamp
@@ -0,0 +1,283 @@
+#include "DepartureSnapshot.h"
+#include "../utils/Logger.h"
+#include "../hal/Clock.h"
+#include "../hal/Storage.h"
+#include <string.h>
+
+// ============================================================================
+// Format
+// ============================================================================
+
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x4E535053;  // "SPSN"
+static constexpr uint8_t SNAPSHOT_VERSION = 1;
+static constexpr unsigned long SNAPSHOT_MIN_INTERVAL_MS = 10UL * 60 * 1000;  // ~144 writes/day at most
+
+static constexpr uint8_t FLAG_AC = 0x01;
+static constexpr uint8_t FLAG_DELAYED = 0x02;
+static constexpr uint8_t FLAG_SCHEDULED = 0x04;
+
+struct SnapshotHeader
+{
+    uint32_t magic;
+    uint8_t version;
+    uint8_t departureCount;
+    uint16_t payloadSize;  // Bytes after the header
+    uint32_t checksum;     // FNV-1a of the payload
+    uint32_t stopsKey;     // getSnapshotStopsKey() of the board's stops
+    uint32_t savedAt;      // Unix time of the write
+};
+
+struct SnapshotDeparture
+{
+    uint32_t departureTime;
+    uint32_t tripKey;
+    int16_t delayMinutes;
+    int8_t stopIndex;
+    uint8_t lineId;
+    uint8_t destinationId;
+    uint8_t flags;
+    uint16_t reserved;
+};
+
+struct SnapshotWeather
+{
+    int16_t temperature;
+    uint8_t weatherCode;
+    uint8_t valid;
+    uint32_t timestamp;
+};
+
+static_assert(sizeof(SnapshotHeader) == 20, "Snapshot header layout is part of the stored format");
+static_assert(sizeof(SnapshotDeparture) == 16, "Snapshot record layout is part of the stored format");
+static_assert(sizeof(SnapshotWeather) == 8, "Snapshot weather layout is part of the stored format");
+
+// Largest blob: full board, stop name and a full string table
+static constexpr size_t SNAPSHOT_MAX_SIZE = sizeof(SnapshotHeader) + MAX_DEPARTURES * sizeof(SnapshotDeparture) +
+                                            sizeof(SnapshotWeather) + 64 +
+                                            2 * MAX_DEPARTURES * (MAX_LINE_LENGTH + MAX_DESTINATION_LENGTH);
+
+static uint8_t snapshotBuffer[SNAPSHOT_MAX_SIZE];  // Static to keep it off the loop stack
+static uint32_t lastChecksum = 0;     // Payload last written (or loaded), to skip identical writes
+static unsigned long lastSaveMs = 0;
+static bool saved = false;
+
+static uint32_t fnv1a(const uint8_t* data, size_t size, uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t appendString(uint8_t* out, size_t used, size_t capacity, const char* str)
+{
+    size_t length = strlen(str) + 1;
+    if (used + length > capacity)
+    {
+        return 0;
+    }
+    memcpy(out + used, str, length);
+    return used + length;
+}
+
+uint32_t getSnapshotStopsKey(const char* city, const char* stopIds)
+{
+    uint32_t hash = fnv1a((const uint8_t*)city, strlen(city) + 1);
+    return fnv1a((const uint8_t*)stopIds, strlen(stopIds), hash);
+}
+
+// ============================================================================
+// Save
+// ============================================================================
+
+bool saveDepartureSnapshot(const Departure* departures, const DepartureStrings& strings, int count,
+                           const char* stopName, const WeatherData& weather, uint32_t stopsKey, time_t now)
+{
+    if (saved && clockMillis() - lastSaveMs < SNAPSHOT_MIN_INTERVAL_MS)
+    {
+        return false;
+    }
+
+    if (count > MAX_DEPARTURES)
+    {
+        count = MAX_DEPARTURES;
+    }
+
+    SnapshotHeader header = {};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.departureCount = (uint8_t)count;
+    header.stopsKey = stopsKey;
+    header.savedAt = (uint32_t)now;
+
+    size_t used = sizeof(SnapshotHeader);
+    for (int i = 0; i < count; i++)
+    {
+        const Departure& dep = departures[i];
+        SnapshotDeparture record = {};
+        record.departureTime = (uint32_t)dep.departureTime;
+        record.tripKey = dep.tripKey;
+        record.delayMinutes = dep.delayMinutes;
+        record.stopIndex = dep.stopIndex;
+        record.lineId = dep.lineId;
+        record.destinationId = dep.destinationId;
+        record.flags = (dep.hasAC ? FLAG_AC : 0) | (dep.isDelayed ? FLAG_DELAYED : 0) |
+                       (dep.isScheduled ? FLAG_SCHEDULED : 0);
+        memcpy(snapshotBuffer + used, &record, sizeof(record));
+        used += sizeof(record);
+    }
+
+    SnapshotWeather storedWeather = {};
+    if (!weather.hasError && weather.timestamp != 0)
+    {
+        storedWeather.temperature = (int16_t)weather.temperature;
+        storedWeather.weatherCode = (uint8_t)weather.weatherCode;
+        storedWeather.valid = 1;
+        storedWeather.timestamp = (uint32_t)weather.timestamp;
+    }
+    memcpy(snapshotBuffer + used, &storedWeather, sizeof(storedWeather));
+    used += sizeof(storedWeather);
+
+    // Strings in index order, so interning them again on load gives the same indices
+    char name[64];
+    strlcpy(name, stopName ? stopName : "", sizeof(name));
+    used = appendString(snapshotBuffer, used, sizeof(snapshotBuffer), name);
+    for (int i = 0; used > 0 && i < strings.size(); i++)
+    {
+        used = appendString(snapshotBuffer, used, sizeof(snapshotBuffer), strings.get(i));
+    }
+    if (used == 0)
+    {
+        return false;
+    }
+
+    header.payloadSize = (uint16_t)(used - sizeof(SnapshotHeader));
+    header.checksum = fnv1a(snapshotBuffer + sizeof(SnapshotHeader), header.payloadSize);
+
+    // Same board as in flash (no change since the last fetch) - spare the write
+    if (header.checksum == lastChecksum)
+    {
+        return false;
+    }
+    memcpy(snapshotBuffer, &header, sizeof(header));
+
+    size_t written = storagePut("snapshot", "board", snapshotBuffer, used);
+
+    lastSaveMs = clockMillis();
+    saved = true;
+    if (written != used)
+    {
+        logTimestamp();
+        debugPrintln("Snapshot: Write failed");
+        return false;
+    }
+    lastChecksum = header.checksum;
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Snapshot: Saved %d departures (%u bytes)", count, (unsigned)used);
+    logTimestamp();
+    debugPrintln(msg);
+    return true;
+}
+
+// ============================================================================
+// Load
+// ============================================================================
+
+bool loadDepartureSnapshot(Departure* departures, DepartureStrings& strings, int& count,
+                           char* stopName, size_t stopNameSize, WeatherData& weather,
+                           uint32_t stopsKey, time_t& savedAt)
+{
+    count = 0;
+
+    size_t size = storageGetSize("snapshot", "board");
+    if (size < sizeof(SnapshotHeader) || size > sizeof(snapshotBuffer) ||
+        storageGet("snapshot", "board", snapshotBuffer, sizeof(snapshotBuffer)) != size)
+    {
+        return false;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, snapshotBuffer, sizeof(header));
+    const uint8_t* payload = snapshotBuffer + sizeof(SnapshotHeader);
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.payloadSize != size - sizeof(SnapshotHeader) || header.departureCount > MAX_DEPARTURES ||
+        fnv1a(payload, header.payloadSize) != header.checksum)
+    {
+        logTimestamp();
+        debugPrintln("Snapshot: Stored board invalid, ignored");
+        return false;
+    }
+    if (header.stopsKey != stopsKey)
+    {
+        logTimestamp();
+        debugPrintln("Snapshot: Stored board is for other stops, ignored");
+        return false;
+    }
+
+    size_t fixedSize = header.departureCount * sizeof(SnapshotDeparture) + sizeof(SnapshotWeather);
+    if (header.payloadSize <= fixedSize || payload[header.payloadSize - 1] != '\0')
+    {
+        return false;
+    }
+
+    // Strings: stop name, then the board's table in index order
+    const char* text = (const char*)payload + fixedSize;
+    const char* textEnd = (const char*)payload + header.payloadSize;
+    strlcpy(stopName, text, stopNameSize);
+    text += strlen(text) + 1;
+    strings.reset();
+    while (text < textEnd)
+    {
+        if (strings.intern(text, MAX_DESTINATION_LENGTH) == DepartureStrings::NONE)
+        {
+            return false;
+        }
+        text += strlen(text) + 1;
+    }
+
+    for (int i = 0; i < header.departureCount; i++)
+    {
+        SnapshotDeparture record;
+        memcpy(&record, payload + i * sizeof(SnapshotDeparture), sizeof(record));
+        if (record.lineId >= strings.size() || record.destinationId >= strings.size())
+        {
+            return false;
+        }
+
+        Departure dep = {};
+        dep.departureTime = (time_t)record.departureTime;
+        dep.tripKey = record.tripKey;
+        dep.delayMinutes = record.delayMinutes;
+        dep.stopIndex = record.stopIndex;
+        dep.lineId = record.lineId;
+        dep.destinationId = record.destinationId;
+        dep.hasAC = (record.flags & FLAG_AC) != 0;
+        dep.isDelayed = (record.flags & FLAG_DELAYED) != 0;
+        dep.isScheduled = (record.flags & FLAG_SCHEDULED) != 0;
+        departures[i] = dep;
+    }
+    count = header.departureCount;
+
+    SnapshotWeather storedWeather;
+    memcpy(&storedWeather, payload + header.departureCount * sizeof(SnapshotDeparture), sizeof(storedWeather));
+    if (storedWeather.valid)
+    {
+        weather.temperature = storedWeather.temperature;
+        weather.weatherCode = storedWeather.weatherCode;
+        weather.timestamp = (time_t)storedWeather.timestamp;
+        weather.hasError = false;
+        weather.errorMsg[0] = '\0';
+    }
+
+    savedAt = (time_t)header.savedAt;
+    lastChecksum = header.checksum;
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "Snapshot: Loaded %d departures saved at %lu", count, (unsigned long)savedAt);
+    logTimestamp();
+    debugPrintln(msg);
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef DEPARTURESNAPSHOT_H
+#define DEPARTURESNAPSHOT_H
+
+#include "DepartureData.h"
+#include "WeatherAPI.h"
+#include <stddef.h>
+#include <time.h>
+
+// ============================================================================
+// Last-Good Departure Snapshot (NVS)
+// ============================================================================
+
+/**
+ * The departure cache of the last successful fetch, kept in NVS so the
+ * board can be drawn right after boot instead of after WiFi, NTP and a
+ * full fetch.
+ *
+ * Departures keep their absolute departureTime, so the ETAs are simply
+ * recalculated once the clock is plausible. The blob is versioned and
+ * checksummed, and tied to the city and stop IDs it was fetched for.
+ *
+ * Format v1 (little-endian): 20-byte header, then per departure a 16-byte
+ * record, an 8-byte weather record and the strings (stop name first, then
+ * the board's lines and destinations in index order, NUL-terminated).
+ */
+
+/**
+ * Persist the board if it changed, at most once per SNAPSHOT_MIN_INTERVAL_MS
+ * @param departures Departure cache
+ * @param strings String table of departures
+ * @param count Number of departures
+ * @param stopName Current stop name
+ * @param weather Current weather (stored if it has no error)
+ * @param stopsKey Identity of the configured stops (see getSnapshotStopsKey())
+ * @param now Current Unix time
+ * @return true if the snapshot was written
+ */
+bool saveDepartureSnapshot(const Departure* departures, const DepartureStrings& strings, int count,
+                           const char* stopName, const WeatherData& weather, uint32_t stopsKey, time_t now);
+
+/**
+ * Load the persisted board
+ * @param departures Receives departures (room for MAX_DEPARTURES)
+ * @param strings Receives their strings
+ * @param count Receives the number of departures
+ * @param stopName Receives the stop name
+ * @param stopNameSize Size of stopName
+ * @param weather Receives the weather, if one was stored (otherwise unchanged)
+ * @param stopsKey Identity of the configured stops; a snapshot of other stops is ignored
+ * @param savedAt Receives the Unix time the snapshot was written
+ * @return false if there is no valid snapshot for these stops
+ */
+bool loadDepartureSnapshot(Departure* departures, DepartureStrings& strings, int& count,
+                           char* stopName, size_t stopNameSize, WeatherData& weather,
+                           uint32_t stopsKey, time_t& savedAt);
+
+/**
+ * Identity of a city and its stop list, stored with the snapshot
+ * @param city Configured city
+ * @param stopIds Configured stop IDs of that city
+ */
+uint32_t getSnapshotStopsKey(const char* city, const char* stopIds);
+
+#endif // DEPARTURESNAPSHOT_H
@@ -0,0 +1,332 @@
+#include "DestinationShortener.h"
+#include "../utils/Logger.h"
+#include <string.h>
+
+// ============================================================================
+// Built-in Abbreviations (UTF-8, as returned by the APIs)
+// ============================================================================
+
+const DestinationShortener::Abbreviation DestinationShortener::PRAGUE_ABBREVIATIONS[] = {
+    {"Nádraží", "Nádr."},
+    {"nádraží", "nádr."},
+    {"Sídliště", "Sídl."},
+    {"Nemocnice", "Nem."},
+    {"Náměstí", "Nám."},
+    {"náměstí", "nám."},
+};
+const int DestinationShortener::PRAGUE_COUNT = sizeof(PRAGUE_ABBREVIATIONS) / sizeof(PRAGUE_ABBREVIATIONS[0]);
+
+const DestinationShortener::Abbreviation DestinationShortener::BERLIN_ABBREVIATIONS[] = {
+    {"Hauptbahnhof", "Hbf"},
+    {"Bahnhof", "Bhf"},
+    {"bahnhof", "bhf"},
+    {"S+U ", ""},
+    {"Straße", "Str."},
+    {"straße", "str."},
+    {"Platz", "Pl."},
+    {"platz", "pl."},
+    {" (Berlin)", ""},
+};
+const int DestinationShortener::BERLIN_COUNT = sizeof(BERLIN_ABBREVIATIONS) / sizeof(BERLIN_ABBREVIATIONS[0]);
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+DestinationShortener& DestinationShortener::getInstance()
+{
+    static DestinationShortener instance;
+    return instance;
+}
+
+DestinationShortener::DestinationShortener()
+    : nodeCount(0), patternCount(0), activeCity(CITY_PRAGUE), built(false)
+{
+    userSource[0] = '\0';
+    userEntries[0] = '\0';
+}
+
+void DestinationShortener::configure(City city, const char* userDictionary)
+{
+    if (userDictionary == nullptr)
+    {
+        userDictionary = "";
+    }
+
+    if (built && city == activeCity && strncmp(userSource, userDictionary, sizeof(userSource) - 1) == 0)
+    {
+        return; // Automaton already matches
+    }
+
+    activeCity = city;
+    strlcpy(userSource, userDictionary, sizeof(userSource));
+    build();
+}
+
+int DestinationShortener::countEntries(const char* dictionary)
+{
+    int count = 0;
+    const char* entry = dictionary;
+    while (entry && *entry)
+    {
+        while (*entry == ' ')
+            entry++;
+
+        const char* end = strchr(entry, ',');
+        int length = end ? (int)(end - entry) : (int)strlen(entry);
+        if (length > 0)
+        {
+            const char* equals = (const char*)memchr(entry, '=', length);
+            if (equals == nullptr || equals == entry)
+            {
+                return -1; // Missing '=' or empty search text
+            }
+            count++;
+        }
+
+        entry = end ? end + 1 : nullptr;
+    }
+    return count;
+}
+
+// ============================================================================
+// Automaton Build
+// ============================================================================
+
+void DestinationShortener::build()
+{
+    nodeCount = 1;
+    patternCount = 0;
+    nodes[0] = {NO_NODE, NO_NODE, 0, NO_NODE, 0, NO_PATTERN};
+    built = true;
+
+    const Abbreviation* builtIn = (activeCity == CITY_BERLIN) ? BERLIN_ABBREVIATIONS : PRAGUE_ABBREVIATIONS;
+    int builtInCount = (activeCity == CITY_BERLIN) ? BERLIN_COUNT : PRAGUE_COUNT;
+    for (int i = 0; i < builtInCount; i++)
+    {
+        addPattern(builtIn[i].search, strlen(builtIn[i].search), builtIn[i].replace);
+    }
+
+    // User entries: split in place so replacements can point into userEntries
+    strlcpy(userEntries, userSource, sizeof(userEntries));
+    int userCount = 0;
+    char* entry = userEntries;
+    while (entry && *entry)
+    {
+        while (*entry == ' ')
+            entry++;
+
+        char* end = strchr(entry, ',');
+        if (end)
+        {
+            *end = '\0';
+        }
+
+        char* equals = strchr(entry, '=');
+        if (equals && equals != entry)
+        {
+            *equals = '\0';
+            if (addPattern(entry, equals - entry, equals + 1))
+            {
+                userCount++;
+            }
+        }
+
+        entry = end ? end + 1 : nullptr;
+    }
+
+    linkFailures();
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "Shortener: %d abbreviations (%d custom), %d nodes",
+             patternCount, userCount, nodeCount);
+    logTimestamp();
+    debugPrintln(msg);
+}
+
+bool DestinationShortener::addPattern(const char* search, int length, const char* replace)
+{
+    if (length <= 0 || length > MAX_INPUT_LENGTH)
+    {
+        return false;
+    }
+
+    uint16_t node = 0;
+    for (int i = 0; i < length; i++)
+    {
+        uint8_t byte = (uint8_t)search[i];
+        uint16_t child = findChild(node, byte);
+        if (child == NO_NODE)
+        {
+            if (nodeCount >= MAX_NODES)
+            {
+                logTimestamp();
+                debugPrintln("Shortener: Dictionary too large, remaining entries ignored");
+                return false;
+            }
+            child = nodeCount++;
+            nodes[child] = {NO_NODE, nodes[node].firstChild, 0, NO_NODE, byte, NO_PATTERN};
+            nodes[node].firstChild = child;
+        }
+        node = child;
+    }
+
+    // Same search text again (user entry over a built-in): the later one wins
+    if (nodes[node].pattern != NO_PATTERN)
+    {
+        replacement[nodes[node].pattern] = replace;
+        return true;
+    }
+
+    if (patternCount >= MAX_PATTERNS)
+    {
+        return false;
+    }
+
+    nodes[node].pattern = patternCount;
+    patternLength[patternCount] = length;
+    replacement[patternCount] = replace;
+    patternCount++;
+    return true;
+}
+
+uint16_t DestinationShortener::findChild(uint16_t node, uint8_t byte) const
+{
+    for (uint16_t child = nodes[node].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+    {
+        if (nodes[child].byte == byte)
+        {
+            return child;
+        }
+    }
+    return NO_NODE;
+}
+
+void DestinationShortener::linkFailures()
+{
+    // Breadth-first, so every fail target is finished before it is used
+    static uint16_t queue[MAX_NODES];
+    int head = 0;
+    int tail = 0;
+
+    for (uint16_t child = nodes[0].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+    {
+        nodes[child].fail = 0;
+        nodes[child].outputLink = NO_NODE;
+        queue[tail++] = child;
+    }
+
+    while (head < tail)
+    {
+        uint16_t node = queue[head++];
+        for (uint16_t child = nodes[node].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+        {
+            uint16_t fail = step(nodes[node].fail, nodes[child].byte);
+            nodes[child].fail = fail;
+            nodes[child].outputLink = (nodes[fail].pattern != NO_PATTERN) ? fail : nodes[fail].outputLink;
+            queue[tail++] = child;
+        }
+    }
+}
+
+uint16_t DestinationShortener::step(uint16_t state, uint8_t byte) const
+{
+    for (;;)
+    {
+        uint16_t child = findChild(state, byte);
+        if (child != NO_NODE)
+        {
+            return child;
+        }
+        if (state == 0)
+        {
+            return 0;
+        }
+        state = nodes[state].fail;
+    }
+}
+
+// ============================================================================
+// Matching
+// ============================================================================
+
+void DestinationShortener::shorten(const char* destination, char* out, size_t outSize) const
+{
+    if (outSize == 0)
+    {
+        return;
+    }
+
+    // Longest match starting at each position (one scan, all patterns at once)
+    uint8_t bestPattern[MAX_INPUT_LENGTH];
+    int length = 0;
+    uint16_t state = 0;
+    for (; length < MAX_INPUT_LENGTH && destination[length] != '\0'; length++)
+    {
+        bestPattern[length] = NO_PATTERN;
+        if (!built)
+        {
+            continue;
+        }
+
+        state = step(state, (uint8_t)destination[length]);
+        uint16_t match = (nodes[state].pattern != NO_PATTERN) ? state : nodes[state].outputLink;
+        for (; match != NO_NODE; match = nodes[match].outputLink)
+        {
+            uint8_t pattern = nodes[match].pattern;
+            int start = length + 1 - patternLength[pattern];
+            uint8_t current = bestPattern[start];
+            if (current == NO_PATTERN || patternLength[current] < patternLength[pattern])
+            {
+                bestPattern[start] = pattern;
+            }
+        }
+    }
+
+    // Emit left to right, skipping over replaced spans
+    size_t used = 0;
+    for (int i = 0; i < length;)
+    {
+        const char* piece;
+        int pieceLength;
+        if (bestPattern[i] != NO_PATTERN)
+        {
+            piece = replacement[bestPattern[i]];
+            pieceLength = strlen(piece);
+            i += patternLength[bestPattern[i]];
+        }
+        else
+        {
+            piece = destination + i;
+            pieceLength = 1;
+            i++;
+        }
+
+        if (used + pieceLength >= outSize)
+        {
+            pieceLength = outSize - 1 - used;
+            memcpy(out + used, piece, pieceLength);
+            used += pieceLength;
+            break;
+        }
+        memcpy(out + used, piece, pieceLength);
+        used += pieceLength;
+    }
+
+    // Don't leave half a UTF-8 character behind after truncation
+    if (used > 0 && ((uint8_t)out[used - 1] & 0x80))
+    {
+        size_t lead = used - 1;
+        while (lead > 0 && ((uint8_t)out[lead] & 0xC0) == 0x80)
+        {
+            lead--;
+        }
+        uint8_t first = (uint8_t)out[lead];
+        size_t expected = (first >= 0xF0) ? 4 : (first >= 0xE0) ? 3 : (first >= 0xC0) ? 2 : 1;
+        if (used - lead < expected)
+        {
+            used = lead;
+        }
+    }
+    out[used] = '\0';
+}
@@ -0,0 +1,117 @@
+#ifndef DESTINATIONSHORTENER_H
+#define DESTINATIONSHORTENER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../config/AppConfig.h"
+
+// ============================================================================
+// Destination Shortening (Aho-Corasick)
+// ============================================================================
+
+/**
+ * Abbreviates long words in destination names so more of them fit in the
+ * regular font.
+ *
+ * All abbreviations of the active city (built-in list plus the user's
+ * dictionary from the config) are compiled into one Aho-Corasick automaton.
+ * shorten() then makes a single pass over the UTF-8 name, so the cost per
+ * departure grows with the name length, not with the dictionary size.
+ * Overlapping matches resolve leftmost-longest ("Hauptbahnhof" wins over
+ * "bahnhof"). Matching is case-sensitive.
+ *
+ * User dictionary format: "search=replace" pairs separated by commas, e.g.
+ * "Hauptbahnhof=Hbf,Krankenhaus=KH". Spaces after a comma are skipped; an
+ * empty replacement deletes the match. User entries override built-ins.
+ *
+ * Not thread-safe: configure() and shorten() both run on the fetch task.
+ */
+class DestinationShortener
+{
+public:
+    enum City
+    {
+        CITY_PRAGUE = 0,
+        CITY_BERLIN,
+        CITY_COUNT
+    };
+
+    static DestinationShortener& getInstance();
+
+    /**
+     * Select the city and user dictionary, rebuilding the automaton if either changed
+     * @param city City whose built-in abbreviations apply
+     * @param userDictionary User entries from the config (may be empty)
+     */
+    void configure(City city, const char* userDictionary);
+
+    /**
+     * Write the abbreviated form of a destination
+     * Output is truncated at a UTF-8 character boundary if it does not fit.
+     * @param destination UTF-8 name from the API (inputs over MAX_INPUT_LENGTH are cut first)
+     * @param out Output buffer (must not overlap destination)
+     * @param outSize Size of out
+     */
+    void shorten(const char* destination, char* out, size_t outSize) const;
+
+    int getPatternCount() const { return patternCount; }
+
+    /**
+     * Count well-formed entries in a user dictionary (for validating web input)
+     * @return Number of "search=replace" entries, or -1 if an entry is malformed
+     */
+    static int countEntries(const char* dictionary);
+
+private:
+    DestinationShortener();
+    DestinationShortener(const DestinationShortener&) = delete;
+    DestinationShortener& operator=(const DestinationShortener&) = delete;
+
+    static constexpr int DICTIONARY_SIZE = sizeof(Config::pragueAbbreviations);
+    static constexpr int MAX_PATTERNS = 80;      // Built-ins + user entries
+    static constexpr int MAX_NODES = 448;        // Total pattern bytes (built-ins + full user dictionary) + root
+    static constexpr int MAX_INPUT_LENGTH = 96;  // Longest destination scanned
+    static constexpr uint16_t NO_NODE = 0xFFFF;
+    static constexpr uint8_t NO_PATTERN = 0xFF;
+
+    struct Abbreviation
+    {
+        const char* search;
+        const char* replace;
+    };
+
+    // Trie node with Aho-Corasick links; children are kept as a sibling list
+    struct Node
+    {
+        uint16_t firstChild;
+        uint16_t nextSibling;
+        uint16_t fail;        // Longest proper suffix that is also a trie path
+        uint16_t outputLink;  // Nearest node on the fail chain that ends a pattern
+        uint8_t byte;         // Byte on the edge from the parent
+        uint8_t pattern;      // Pattern ending here, or NO_PATTERN
+    };
+
+    Node nodes[MAX_NODES];
+    int nodeCount;
+    uint8_t patternLength[MAX_PATTERNS];
+    const char* replacement[MAX_PATTERNS];
+    int patternCount;
+
+    City activeCity;
+    char userSource[DICTIONARY_SIZE];  // Dictionary the automaton was built from
+    char userEntries[DICTIONARY_SIZE]; // Tokenised copy; user replacements point into it
+    bool built;
+
+    static const Abbreviation PRAGUE_ABBREVIATIONS[];
+    static const Abbreviation BERLIN_ABBREVIATIONS[];
+    static const int PRAGUE_COUNT;
+    static const int BERLIN_COUNT;
+
+    void build();
+    bool addPattern(const char* search, int length, const char* replace);
+    uint16_t findChild(uint16_t node, uint8_t byte) const;
+    uint16_t step(uint16_t state, uint8_t byte) const;
+    void linkFailures();
+};
+
+#endif // DESTINATIONSHORTENER_H
@@ -0,0 +1,316 @@
+#include "FetchTask.h"
+#include "../utils/Logger.h"
+#include <string.h>
+
+#if !defined(MATRIX_PORTAL_M4)
+    #include "../network/HttpConnectionManager.h"
+#endif
+
+FetchTask* FetchTask::instance = nullptr;
+
+FetchTask::FetchTask()
+    : transitAPI(nullptr), weatherAPI(nullptr),
+      buffers(), frontIndex(0), departuresReady(false), frontIsFinal(false),
+      weatherReady(false),
+      departuresRequested(false), pendingStop(-1), weatherRequested(false),
+      pendingLatitude(0.0f), pendingLongitude(0.0f),
+      busy(false)
+#if !defined(MATRIX_PORTAL_M4)
+      , taskHandle(nullptr), lock(nullptr)
+#endif
+{
+    memset(&weatherResult, 0, sizeof(weatherResult));
+    memset(&pendingConfig, 0, sizeof(pendingConfig));
+}
+
+bool FetchTask::begin(TransitAPI* transit, WeatherAPI* weather)
+{
+    transitAPI = transit;
+    weatherAPI = weather;
+    instance = this;
+
+    if (transitAPI)
+    {
+        transitAPI->setPartialResultsCallback(onPartialResults);
+    }
+
+#if defined(MATRIX_PORTAL_M4)
+    return true;
+#else
+    if (taskHandle != nullptr)
+    {
+        return true; // Already running
+    }
+
+    lock = xSemaphoreCreateMutex();
+    if (lock == nullptr)
+    {
+        logTimestamp();
+        debugPrintln("FetchTask: Failed to create mutex");
+        return false;
+    }
+
+    BaseType_t created = xTaskCreatePinnedToCore(taskEntry, "fetch", TASK_STACK_SIZE, this,
+                                                 TASK_PRIORITY, &taskHandle, TASK_CORE);
+    if (created != pdPASS)
+    {
+        taskHandle = nullptr;
+        logTimestamp();
+        debugPrintln("FetchTask: Failed to create task");
+        return false;
+    }
+
+    logTimestamp();
+    debugPrintln("FetchTask: Started on network core");
+    return true;
+#endif
+}
+
+void FetchTask::requestDepartures(const Config& config)
+{
+#if defined(MATRIX_PORTAL_M4)
+    runDepartures(config, -1);
+#else
+    xSemaphoreTake(lock, portMAX_DELAY);
+    pendingConfig = config;
+    pendingStop = -1;
+    departuresRequested = true;
+    xSemaphoreGive(lock);
+    xTaskNotifyGive(taskHandle);
+#endif
+}
+
+void FetchTask::requestStopDepartures(const Config& config, int stopIndex)
+{
+#if defined(MATRIX_PORTAL_M4)
+    runDepartures(config, stopIndex);
+#else
+    xSemaphoreTake(lock, portMAX_DELAY);
+    pendingConfig = config;
+    if (!departuresRequested)
+    {
+        pendingStop = stopIndex;
+    }
+    departuresRequested = true;
+    xSemaphoreGive(lock);
+    xTaskNotifyGive(taskHandle);
+#endif
+}
+
+void FetchTask::requestWeather(float latitude, float longitude)
+{
+#if defined(MATRIX_PORTAL_M4)
+    runWeather(latitude, longitude);
+#else
+    xSemaphoreTake(lock, portMAX_DELAY);
+    pendingLatitude = latitude;
+    pendingLongitude = longitude;
+    weatherRequested = true;
+    xSemaphoreGive(lock);
+    xTaskNotifyGive(taskHandle);
+#endif
+}
+
+bool FetchTask::takeDepartures(TransitAPI::APIResult& out, bool& isFinal)
+{
+    if (!departuresReady)
+    {
+        return false;
+    }
+
+#if !defined(MATRIX_PORTAL_M4)
+    xSemaphoreTake(lock, portMAX_DELAY);
+#endif
+    out = buffers[frontIndex];
+    isFinal = frontIsFinal;
+    departuresReady = false;
+#if !defined(MATRIX_PORTAL_M4)
+    xSemaphoreGive(lock);
+#endif
+    return true;
+}
+
+bool FetchTask::takeWeather(WeatherData& out)
+{
+    if (!weatherReady)
+    {
+        return false;
+    }
+
+#if !defined(MATRIX_PORTAL_M4)
+    xSemaphoreTake(lock, portMAX_DELAY);
+#endif
+    out = weatherResult;
+    weatherReady = false;
+#if !defined(MATRIX_PORTAL_M4)
+    xSemaphoreGive(lock);
+#endif
+    return true;
+}
+
+void FetchTask::publish(const TransitAPI::APIResult& result, bool isFinal)
+{
+    // A final result stays latched until the main loop takes it: the partials of
+    // the next fetch must not replace it, or the scheduler never sees it complete.
+    // Only this task sets frontIsFinal, and the main loop only clears departuresReady.
+    if (!isFinal && departuresReady && frontIsFinal)
+    {
+        return;
+    }
+
+    // Fill the back buffer without holding the lock - the main loop only reads the front
+    int backIndex = 1 - frontIndex;
+    buffers[backIndex] = result;
+
+#if !defined(MATRIX_PORTAL_M4)
+    xSemaphoreTake(lock, portMAX_DELAY);
+#endif
+    frontIndex = backIndex;
+    frontIsFinal = isFinal;
+    departuresReady = true;
+#if !defined(MATRIX_PORTAL_M4)
+    xSemaphoreGive(lock);
+#endif
+}
+
+void FetchTask::onPartialResults(const Departure* departures, const DepartureStrings& strings,
+                                 int count, const char* stopName)
+{
+    if (instance == nullptr)
+    {
+        return;
+    }
+
+    // Static to keep the ~1KB snapshot off the fetch task's stack
+    static TransitAPI::APIResult partial;
+    partial.departureCount = (count > MAX_DEPARTURES) ? MAX_DEPARTURES : count;
+    memcpy(partial.departures, departures, partial.departureCount * sizeof(Departure));
+    partial.strings = strings;
+    strlcpy(partial.stopName, stopName ? stopName : "", sizeof(partial.stopName));
+    partial.hasError = false;
+    partial.errorMsg[0] = '\0';
+    partial.refreshedStop = -1;
+    partial.truncated = true;
+
+    instance->publish(partial, false);
+}
+
+void FetchTask::runDepartures(const Config& config, int stopIndex)
+{
+    if (transitAPI == nullptr)
+    {
+        return;
+    }
+
+    busy = true;
+    unsigned long start = millis();
+
+#if !defined(MATRIX_PORTAL_M4)
+    // Applied here so a saved override takes effect on this task's connections
+    HttpConnectionManager::getInstance().setBaseUrl(config.apiBaseUrl);
+#endif
+
+    TransitAPI::APIResult result = (stopIndex < 0) ? transitAPI->fetchDepartures(config)
+                                                   : transitAPI->fetchStopDepartures(config, stopIndex);
+    publish(result, true);
+
+    busy = false;
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "FetchTask: Departures fetched in %lums", millis() - start);
+    logTimestamp();
+    debugPrintln(msg);
+}
+
+void FetchTask::runWeather(float latitude, float longitude)
+{
+    if (weatherAPI == nullptr)
+    {
+        return;
+    }
+
+    busy = true;
+    WeatherData data = weatherAPI->fetchWeather(latitude, longitude);
+
+#if !defined(MATRIX_PORTAL_M4)
+    xSemaphoreTake(lock, portMAX_DELAY);
+#endif
+    weatherResult = data;
+    weatherReady = true;
+#if !defined(MATRIX_PORTAL_M4)
+    xSemaphoreGive(lock);
+#endif
+    busy = false;
+}
+
+#if !defined(MATRIX_PORTAL_M4)
+void FetchTask::taskEntry(void* param)
+{
+    static_cast<FetchTask*>(param)->taskLoop();
+}
+
+void FetchTask::taskLoop()
+{
+    // Static so the config snapshot doesn't eat into the task stack
+    static Config config;
+
+    for (;;)
+    {
+        // Sleep until the main loop queues a request, waking periodically
+        // to release TLS buffers of connections the server has closed by now
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IDLE_CHECK_MS)) == 0)
+        {
+            HttpConnectionManager::getInstance().closeIdle();
+            continue;
+        }
+
+        for (;;)
+        {
+            bool doDepartures = false;
+            int stopIndex = -1;
+            bool doWeather = false;
+            float latitude = 0.0f;
+            float longitude = 0.0f;
+
+            xSemaphoreTake(lock, portMAX_DELAY);
+            if (departuresRequested)
+            {
+                config = pendingConfig;
+                stopIndex = pendingStop;
+                departuresRequested = false;
+                doDepartures = true;
+            }
+            if (weatherRequested)
+            {
+                latitude = pendingLatitude;
+                longitude = pendingLongitude;
+                weatherRequested = false;
+                doWeather = true;
+            }
+            xSemaphoreGive(lock);
+
+            if (!doDepartures && !doWeather)
+            {
+                break;
+            }
+
+            if (doDepartures)
+            {
+                runDepartures(config, stopIndex);
+            }
+            if (doWeather)
+            {
+                runWeather(latitude, longitude);
+            }
+
+            HttpConnectionManager::getInstance().logStats();
+
+            char stackMsg[64];
+            snprintf(stackMsg, sizeof(stackMsg), "FetchTask: Stack headroom %u bytes",
+                     (unsigned)uxTaskGetStackHighWaterMark(nullptr));
+            logTimestamp();
+            debugPrintln(stackMsg);
+        }
+    }
+}
+#endif
@@ -0,0 +1,129 @@
+#ifndef FETCHTASK_H
+#define FETCHTASK_H
+
+#include "TransitAPI.h"
+#include "WeatherAPI.h"
+#include "../config/AppConfig.h"
+
+#if !defined(MATRIX_PORTAL_M4)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#endif
+
+// ============================================================================
+// Background Fetch Task
+// ============================================================================
+
+/**
+ * Runs transit and weather fetches off the main loop.
+ *
+ * On ESP32 the fetches execute in a dedicated FreeRTOS task pinned to the
+ * network core, so retries and backoff delays never stall loop(). Completed
+ * (and partial) departure results are published into a double buffer; the
+ * main loop picks up the latest snapshot with takeDepartures().
+ *
+ * On M4 there is no second core, so requests run synchronously inside
+ * request*() and are handed back through the same take*() interface.
+ */
+class FetchTask
+{
+public:
+    FetchTask();
+
+    /**
+     * Start the fetch task
+     * @param transit Active transit API (Golemio or BVG)
+     * @param weather Weather API client
+     * @return true if the task was started
+     */
+    bool begin(TransitAPI* transit, WeatherAPI* weather);
+
+    /**
+     * Queue a departure fetch (returns immediately on ESP32)
+     * @param config Configuration snapshot used for this fetch
+     */
+    void requestDepartures(const Config& config);
+
+    /**
+     * Queue a fetch of a single stop (returns immediately on ESP32)
+     * A pending all-stops request takes precedence
+     * @param config Configuration snapshot used for this fetch
+     * @param stopIndex Index of the stop in the configured stop list
+     */
+    void requestStopDepartures(const Config& config, int stopIndex);
+
+    /**
+     * Queue a weather fetch (returns immediately on ESP32)
+     * @param latitude Location latitude
+     * @param longitude Location longitude
+     */
+    void requestWeather(float latitude, float longitude);
+
+    /**
+     * Take the most recently published departure snapshot
+     * @param out Receives the snapshot
+     * @param isFinal Set to false for partial (per-stop) results
+     * @return true if a new snapshot was available
+     */
+    bool takeDepartures(TransitAPI::APIResult& out, bool& isFinal);
+
+    /**
+     * Take the most recently fetched weather data
+     * @param out Receives the weather data
+     * @return true if new weather data was available
+     */
+    bool takeWeather(WeatherData& out);
+
+    /**
+     * Check whether a fetch is currently running
+     */
+    bool isBusy() const { return busy; }
+
+private:
+    TransitAPI* transitAPI;
+    WeatherAPI* weatherAPI;
+
+    // Double buffer: the task fills buffers[1 - frontIndex], then flips frontIndex
+    TransitAPI::APIResult buffers[2];
+    volatile int frontIndex;
+    volatile bool departuresReady;
+    volatile bool frontIsFinal;    // Front holds a final result (not replaced by partials until taken)
+
+    WeatherData weatherResult;
+    volatile bool weatherReady;
+
+    // Pending requests (written by main loop, consumed by task)
+    Config pendingConfig;
+    volatile bool departuresRequested;
+    int pendingStop;  // -1 = all stops
+    volatile bool weatherRequested;
+    float pendingLatitude;
+    float pendingLongitude;
+
+    volatile bool busy;
+
+    static FetchTask* instance;
+
+    void runDepartures(const Config& config, int stopIndex);
+    void runWeather(float latitude, float longitude);
+    void publish(const TransitAPI::APIResult& result, bool isFinal);
+
+    static void onPartialResults(const Departure* departures, const DepartureStrings& strings,
+                                 int count, const char* stopName);
+
+#if !defined(MATRIX_PORTAL_M4)
+    static constexpr uint32_t TASK_STACK_SIZE = 16384;  // TLS handshake + JSON parse run on this stack
+    static constexpr UBaseType_t TASK_PRIORITY = 1;
+    static constexpr BaseType_t TASK_CORE = 0;          // Network core (Arduino loop runs on core 1)
+    static constexpr uint32_t IDLE_CHECK_MS = 30000;    // Interval for closing stale keep-alive connections
+
+    TaskHandle_t taskHandle;
+    SemaphoreHandle_t lock;
+
+    static void taskEntry(void* param);
+    void taskLoop();
+#endif
+};
+
+#endif // FETCHTASK_H
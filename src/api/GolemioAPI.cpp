@@ -1,40 +1,18 @@
 #include "GolemioAPI.h"
+#include "DestinationShortener.h"
 #include "../utils/Logger.h"
+#include "../utils/TimeUtils.h"
+#include "../utils/Metrics.h"
+#include "../hal/Clock.h"
 #include <ArduinoJson.h>
 #include <time.h>
 
-// Simple ISO8601 timestamp parser (strptime replacement for platforms without it)
-// Parses format: "YYYY-MM-DDTHH:MM:SS"
-static bool parseISO8601(const char* timestamp, struct tm* tm)
-{
-    if (timestamp == nullptr || tm == nullptr) return false;
-
-    memset(tm, 0, sizeof(struct tm));
-
-    // Parse: YYYY-MM-DDTHH:MM:SS
-    int year, month, day, hour, minute, second;
-    if (sscanf(timestamp, "%d-%d-%dT%d:%d:%d", &year, &month, &day, &hour, &minute, &second) != 6)
-    {
-        return false;
-    }
-
-    tm->tm_year = year - 1900;  // Years since 1900
-    tm->tm_mon = month - 1;     // Months since January (0-11)
-    tm->tm_mday = day;
-    tm->tm_hour = hour;
-    tm->tm_min = minute;
-    tm->tm_sec = second;
-    tm->tm_isdst = -1;          // Let mktime determine DST
-
-    return true;
-}
-
 // Platform-specific HTTP client includes
 #if defined(MATRIX_PORTAL_M4)
     #include <WiFiNINA.h>
     #include <ArduinoHttpClient.h>
 #else
-    #include <HTTPClient.h>
+    #include "../network/HttpConnectionManager.h"
 #endif
 
 GolemioAPI::GolemioAPI() : statusCallback(nullptr), partialResultsCallback(nullptr)
@@ -58,6 +36,7 @@ TransitAPI::APIResult GolemioAPI::fetchDepartures(const Config &config)
     result.hasError = false;
     result.stopName[0] = '\0';
     result.errorMsg[0] = '\0';
+    result.refreshedStop = -1;
 
     // Validate inputs (use Prague-specific fields)
     if (strlen(config.pragueApiKey) == 0 || strlen(config.pragueStopIds) == 0)
@@ -71,86 +50,51 @@ TransitAPI::APIResult GolemioAPI::fetchDepartures(const Config &config)
     debugPrintln("API: Fetching departures...");
     logMemory("api_start");
 
-    // Temporary array to collect all departures from all stops
-    // IMPORTANT: Static to avoid stack overflow (~2KB array)
-    static Departure tempDepartures[MAX_TEMP_DEPARTURES];
-    int tempCount = 0;
+    // Abbreviations for this fetch (automaton is only rebuilt when the dictionary changed)
+    DestinationShortener::getInstance().configure(DestinationShortener::CITY_PRAGUE, config.pragueAbbreviations);
+
+    // Keeps the soonest MAX_DEPARTURES across all stops (minimum departure time applied on insert)
+    // Golemio keeps departures strictly later than minDepartureTime
+    collector.reset(config.minDepartureTime + 1);
 
     // Parse comma-separated stop IDs (use Prague-specific field)
-    char stopIdsCopy[128];
+    // Pointers reference stopIdsCopy, which stays alive for the whole fetch
+    char stopIdsCopy[sizeof(config.pragueStopIds)];
     strlcpy(stopIdsCopy, config.pragueStopIds, sizeof(stopIdsCopy));
 
-    char *stopId = strtok(stopIdsCopy, ",");
-    bool firstStop = true;
-    int stopIndex = 0;
+    const char *stopIds[MAX_CONFIG_STOPS];
+    int stopCount = splitStopIds(stopIdsCopy, stopIds, MAX_CONFIG_STOPS);
 
-    while (stopId != NULL && tempCount < MAX_TEMP_DEPARTURES)
+    // Up to MAX_BATCH_STOPS stops per request - departures are attributed back to their stop by ID
+    for (int first = 0; first < stopCount; first += MAX_BATCH_STOPS)
     {
-        // Trim whitespace
-        while (*stopId == ' ')
-            stopId++;
-
-        if (strlen(stopId) == 0)
+        if (first > 0)
         {
-            stopId = strtok(NULL, ",");
-            continue;
+            clockDelay(1000); // Rate limiting between batches
         }
 
-        int countBefore = tempCount;
-        querySingleStop(stopId, config, tempDepartures, tempCount, result.stopName, firstStop, stopIndex);
-
-        // If we got new departures and have a callback, send partial results immediately
-        if (tempCount > countBefore && partialResultsCallback)
+        int batchCount = stopCount - first;
+        if (batchCount > MAX_BATCH_STOPS)
         {
-            // Sort current results
-            qsort(tempDepartures, tempCount, sizeof(Departure), compareDepartures);
-
-            // Copy top departures to result for callback (apply minDepartureTime filter)
-            result.departureCount = 0;
-            for (int i = 0; i < tempCount && result.departureCount < MAX_DEPARTURES; i++)
-            {
-                if (tempDepartures[i].eta > config.minDepartureTime)
-                {
-                    result.departures[result.departureCount] = tempDepartures[i];
-                    result.departureCount++;
-                }
-            }
-
-            logTimestamp();
-            char msg[64];
-            snprintf(msg, sizeof(msg), "Partial results: %d departures, triggering display", result.departureCount);
-            debugPrintln(msg);
-
-            partialResultsCallback(result.departures, result.departureCount, result.stopName);
+            batchCount = MAX_BATCH_STOPS;
         }
 
-        delay(1000);
-
-        stopId = strtok(NULL, ",");
-        stopIndex++;
+        queryStops(stopIds + first, batchCount, first, stopCount, config, collector,
+                   first == 0 ? result.stopName : nullptr);
     }
 
-    // Sort all collected departures by ETA
-    if (tempCount > 0)
+    int collectedCount = collector.getOfferedCount();
+    if (collectedCount > 0)
     {
-        qsort(tempDepartures, tempCount, sizeof(Departure), compareDepartures);
-
         char msg[64];
-        snprintf(msg, sizeof(msg), "Collected %d departures from all stops", tempCount);
+        snprintf(msg, sizeof(msg), "Collected %d departures from all stops", collectedCount);
         logTimestamp();
         debugPrintln(msg);
     }
 
-    // Filter by minimum departure time and copy to final array
-    result.departureCount = 0;
-    for (int i = 0; i < tempCount && result.departureCount < MAX_DEPARTURES; i++)
-    {
-        if (tempDepartures[i].eta > config.minDepartureTime)
-        {
-            result.departures[result.departureCount] = tempDepartures[i];
-            result.departureCount++;
-        }
-    }
+    // Soonest departures, sorted by departure time
+    result.departureCount = collector.copySorted(result.departures, result.strings);
+    result.truncated = collector.isTruncated();
 
     char filterMsg[64];
     snprintf(filterMsg, sizeof(filterMsg), "Final departures after filtering: %d", result.departureCount);
@@ -158,7 +102,7 @@ TransitAPI::APIResult GolemioAPI::fetchDepartures(const Config &config)
     debugPrintln(filterMsg);
 
     // Set error status if no departures found
-    if (tempCount == 0)
+    if (collectedCount == 0)
     {
         result.hasError = true;
         strlcpy(result.errorMsg, "No departures", sizeof(result.errorMsg));
@@ -169,26 +113,89 @@ TransitAPI::APIResult GolemioAPI::fetchDepartures(const Config &config)
     return result;
 }
 
-bool GolemioAPI::querySingleStop(const char *stopId, const Config &config,
-                                 Departure *tempDepartures, int &tempCount,
-                                 char *stopName, bool &isFirstStop, int stopIndex)
+TransitAPI::APIResult GolemioAPI::fetchStopDepartures(const Config &config, int stopIndex)
+{
+    TransitAPI::APIResult result = {};
+    result.refreshedStop = stopIndex;
+
+    char stopIdsCopy[sizeof(config.pragueStopIds)];
+    strlcpy(stopIdsCopy, config.pragueStopIds, sizeof(stopIdsCopy));
+
+    const char *stopIds[MAX_CONFIG_STOPS];
+    int stopCount = splitStopIds(stopIdsCopy, stopIds, MAX_CONFIG_STOPS);
+
+    if (strlen(config.pragueApiKey) == 0 || stopIndex < 0 || stopIndex >= stopCount)
+    {
+        result.hasError = true;
+        strlcpy(result.errorMsg, "Missing API key or stop ID", sizeof(result.errorMsg));
+        return result;
+    }
+
+    DestinationShortener::getInstance().configure(DestinationShortener::CITY_PRAGUE, config.pragueAbbreviations);
+    collector.reset(config.minDepartureTime + 1);
+
+    // Stop name comes from the first configured stop only
+    bool queried = queryStops(stopIds + stopIndex, 1, stopIndex, stopCount, config, collector,
+                              stopIndex == 0 ? result.stopName : nullptr);
+
+    result.departureCount = collector.copySorted(result.departures, result.strings);
+    result.truncated = collector.isTruncated();
+
+    // An empty board is valid here - other stops may still fill the cache
+    if (!queried)
+    {
+        result.hasError = true;
+        strlcpy(result.errorMsg, "Stop query failed", sizeof(result.errorMsg));
+    }
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "API: Stop %d refreshed, %d departures", stopIndex, result.departureCount);
+    logTimestamp();
+    debugPrintln(msg);
+
+    return result;
+}
+
+bool GolemioAPI::queryStops(const char *const *stopIds, int stopCount, int firstStopIndex, int totalStops,
+                            const Config &config, DepartureCollector &collector, char *stopName)
 {
+    if (stopCount == 0)
+    {
+        return false;
+    }
+
+    // Build the path for the API request - one ids= parameter per stop
+    char path[512];
+    int pathStops = buildQueryPath(path, sizeof(path), stopIds, stopCount, config);
+    if (pathStops == 0)
+    {
+        logTimestamp();
+        debugPrintln("API: Stop ID too long for a request");
+        return false;
+    }
+    if (pathStops < stopCount)
+    {
+        // Query string full - the remaining stops go into a follow-up request
+        char splitMsg[64];
+        snprintf(splitMsg, sizeof(splitMsg), "API: Splitting %d stop(s) after %d", stopCount, pathStops);
+        logTimestamp();
+        debugPrintln(splitMsg);
+
+        bool queried = queryStops(stopIds, pathStops, firstStopIndex, totalStops, config, collector, stopName);
+        clockDelay(1000); // Rate limiting between requests
+        return queryStops(stopIds + pathStops, stopCount - pathStops, firstStopIndex + pathStops, totalStops,
+                          config, collector, nullptr) && queried;
+    }
+
     char queryMsg[96];
-    snprintf(queryMsg, sizeof(queryMsg), "API: Querying stop %s", stopId);
+    snprintf(queryMsg, sizeof(queryMsg), "API: Querying %d stop(s) in one request", stopCount);
     logTimestamp();
     debugPrintln(queryMsg);
 
-    // Build the path for the API request
-    char path[256];
-    snprintf(path, sizeof(path),
-             "/v2/pid/departureboards?ids=%s&total=%d&preferredTimezone=Europe/Prague&minutesBefore=%d&minutesAfter=120",
-             stopId,
-             MAX_DEPARTURES,
-             config.minDepartureTime > 0 ? config.minDepartureTime * -1 : 0);
-
     const int MAX_RETRIES = 3;
     int httpCode = -1;
-    String payload;
+    bool parsed = false;
+    unsigned long startMs = clockMillis();
 
 #if defined(MATRIX_PORTAL_M4)
     // M4 uses ArduinoHttpClient with WiFiSSLClient
@@ -208,7 +215,7 @@ bool GolemioAPI::querySingleStop(const char *stopId, const Config &config,
             snprintf(retryMsg, sizeof(retryMsg), "API: Retry %d/%d after %dms", retry + 1, MAX_RETRIES, delayMs);
             logTimestamp();
             debugPrintln(retryMsg);
-            delay(delayMs);
+            clockDelay(delayMs);
         }
 
         logTimestamp();
@@ -232,35 +239,14 @@ bool GolemioAPI::querySingleStop(const char *stopId, const Config &config,
 
         if (httpCode == 200)
         {
-            logTimestamp();
-            debugPrintln("API: Reading response body...");
-
-            // Get content length and pre-allocate (much faster than growing String)
-            int contentLen = http.contentLength();
-            if (contentLen > 0 && contentLen < JSON_BUFFER_SIZE)
-            {
-                payload.reserve(contentLen + 1);
-            }
-
-            // Read in chunks (much faster than responseBody()'s character-by-character)
-            char buffer[512];
-            while (http.available())
-            {
-                int bytesRead = http.read((uint8_t *)buffer, sizeof(buffer) - 1);
-                if (bytesRead > 0)
-                {
-                    buffer[bytesRead] = '\0';
-                    payload += buffer;
-                }
-            }
+            // Parse straight off the socket (HttpClient decodes chunked bodies itself)
+            http.skipResponseHeaders();
+            unsigned long parseStartMs = clockMillis();
+            parsed = parseDepartureStream(http, stopIds, stopCount, firstStopIndex, totalStops, collector, stopName);
+            Metrics::getInstance().recordParse(clockMillis() - parseStartMs);
 
             // Close connection to free socket
             http.stop();
-
-            logTimestamp();
-            char bodyMsg[64];
-            snprintf(bodyMsg, sizeof(bodyMsg), "API: Response body length: %d", payload.length());
-            debugPrintln(bodyMsg);
             break;
         }
 
@@ -281,14 +267,15 @@ bool GolemioAPI::querySingleStop(const char *stopId, const Config &config,
     http.stop();
 
 #else
-    // ESP32 uses native HTTPClient
-    HTTPClient http;
-    char url[512];
-    snprintf(url, sizeof(url), "https://api.golemio.cz%s", path);
-    http.setTimeout(HTTP_TIMEOUT_MS);
-
-    // Retry logic: establish fresh connection for each attempt
-    // IMPORTANT: http.end() must be called before retrying to avoid socket leaks
+    // ESP32 uses the shared keep-alive connection to api.golemio.cz
+    HttpConnectionManager &connections = HttpConnectionManager::getInstance();
+    const HttpConnectionManager::Host host = HttpConnectionManager::HOST_GOLEMIO;
+    const char *headers[] = {
+        "x-access-token", config.pragueApiKey,
+        "Content-Type", "application/json",
+    };
+
+    // Retry logic: the connection manager reconnects if the kept-alive socket died
     // NOTE: Status callback NOT called during retries - errors shown in status bar
     //       via the apiError mechanism, keeping departures visible
     for (int retry = 0; retry < MAX_RETRIES; retry++)
@@ -301,25 +288,31 @@ bool GolemioAPI::querySingleStop(const char *stopId, const Config &config,
             snprintf(retryMsg, sizeof(retryMsg), "API: Retry %d/%d after %dms", retry + 1, MAX_RETRIES, delayMs);
             logTimestamp();
             debugPrintln(retryMsg);
-            delay(delayMs);
+            clockDelay(delayMs);
         }
 
-        // Establish connection for this attempt
-        http.begin(url);
-        http.addHeader("x-access-token", config.pragueApiKey);
-        http.addHeader("Content-Type", "application/json");
+        httpCode = connections.get(host, path, headers, 2, HTTP_TIMEOUT_MS);
 
-        httpCode = http.GET();
-
-        // Success - break out of retry loop
+        // Success - parse directly from the socket and break out of retry loop
         if (httpCode == HTTP_CODE_OK)
         {
-            payload = http.getString();
+            unsigned long parseStartMs = clockMillis();
+            parsed = parseDepartureStream(connections.getBodyStream(host), stopIds, stopCount,
+                                          firstStopIndex, totalStops, collector, stopName);
+            Metrics::getInstance().recordParse(clockMillis() - parseStartMs);
+            if (parsed)
+            {
+                connections.end(host);   // Keep connection for the next refresh
+            }
+            else
+            {
+                connections.drop(host);  // Stream position unknown after a parse error
+            }
             break;
         }
 
-        // Close connection BEFORE logging or retrying to free socket immediately
-        http.end();
+        // Finish this response (error bodies are drained, socket kept if reusable)
+        connections.end(host);
 
         // Don't retry on 4xx errors (client errors - won't fix with retry)
         if (httpCode >= 400 && httpCode < 500)
@@ -351,99 +344,177 @@ bool GolemioAPI::querySingleStop(const char *stopId, const Config &config,
     }
 #endif
 
+    // Batched queries are one request for several stops
+    Metrics::getInstance().recordFetch(stopCount == 1 ? firstStopIndex : -1, clockMillis() - startMs);
+
 #if defined(MATRIX_PORTAL_M4)
-    if (httpCode == 200)
+    if (httpCode != 200)
 #else
-    if (httpCode == HTTP_CODE_OK)
+    if (httpCode != HTTP_CODE_OK)
 #endif
     {
-        DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-        DeserializationError error = deserializeJson(doc, payload);
+        char failMsg[128];
+        snprintf(failMsg, sizeof(failMsg), "API: Failed after %d attempts for %d stop(s) - HTTP %d",
+                 MAX_RETRIES, stopCount, httpCode);
+        logTimestamp();
+        debugPrintln(failMsg);
+        return false;
+    }
 
-        if (error)
+    return parsed;
+}
+
+int GolemioAPI::buildQueryPath(char *path, size_t size, const char *const *stopIds, int stopCount,
+                               const Config &config)
+{
+    char query[128];
+    int queryLen = snprintf(query, sizeof(query),
+                            "total=%d&preferredTimezone=Europe/Prague&minutesBefore=%d&minutesAfter=120",
+                            MAX_DEPARTURES,
+                            config.minDepartureTime > 0 ? config.minDepartureTime * -1 : 0);
+
+    int pathLen = snprintf(path, size, "/v2/pid/departureboards?");
+    int fitted = 0;
+    while (fitted < stopCount)
+    {
+        // "ids=" + ID + "&", leaving room for the query parameters and the terminator
+        int idLen = 5 + (int)strlen(stopIds[fitted]);
+        if (pathLen + idLen + queryLen >= (int)size)
         {
-            char jsonErrMsg[128];
-            snprintf(jsonErrMsg, sizeof(jsonErrMsg), "JSON Parse Error for stop %s: %s", stopId, error.c_str());
-            logTimestamp();
-            debugPrintln(jsonErrMsg);
-#if !defined(MATRIX_PORTAL_M4)
-            http.end();
-#endif
-            return false;
+            break;
         }
+        pathLen += snprintf(path + pathLen, size - pathLen, "ids=%s&", stopIds[fitted]);
+        fitted++;
+    }
+
+    if (fitted > 0)
+    {
+        strlcpy(path + pathLen, query, size - pathLen);
+    }
+    return fitted;
+}
+
+bool GolemioAPI::parseDepartureStream(Stream &stream, const char *const *stopIds, int stopCount,
+                                      int firstStopIndex, int totalStops,
+                                      DepartureCollector &collector, char *stopName)
+{
+    // Filter keeps only the fields parseDepartureObject() reads, so the document
+    // never holds vehicle, platform or last_stop data from the raw response.
+    // Built once - the filter document is constant across requests.
+    static StaticJsonDocument<512> filter;
+    if (filter.isNull())
+    {
+        filter["stops"][0]["stop_id"] = true;
+        filter["stops"][0]["stop_name"] = true;
+
+        JsonObject depFilter = filter["departures"].createNestedObject();
+        depFilter["route"]["short_name"] = true;
+        depFilter["trip"]["id"] = true;
+        depFilter["trip"]["headsign"] = true;
+        depFilter["trip"]["is_air_conditioned"] = true;
+        depFilter["departure_timestamp"]["predicted"] = true;
+        depFilter["departure_timestamp"]["scheduled"] = true;
+        depFilter["delay"]["minutes"] = true;
+        depFilter["stop"]["id"] = true;
+    }
+
+    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    DeserializationError error = deserializeJson(doc, stream, DeserializationOption::Filter(filter));
+    Metrics::getInstance().recordJsonDocument(Metrics::JSON_DOC_GOLEMIO, doc.memoryUsage(), JSON_BUFFER_SIZE,
+                                              doc.overflowed() || error == DeserializationError::NoMemory);
+
+    if (error)
+    {
+        char jsonErrMsg[128];
+        snprintf(jsonErrMsg, sizeof(jsonErrMsg), "JSON Parse Error for %d stop(s): %s", stopCount, error.c_str());
+        logTimestamp();
+        debugPrintln(jsonErrMsg);
+        return false;
+    }
+
+    char docMsg[64];
+    snprintf(docMsg, sizeof(docMsg), "API: Filtered document uses %u/%d bytes",
+             (unsigned)doc.memoryUsage(), JSON_BUFFER_SIZE);
+    logTimestamp();
+    debugPrintln(docMsg);
 
-        // Get stop name from first stop (for display)
-        if (isFirstStop && doc.containsKey("stops") && doc["stops"].size() > 0)
+    // Stop name for display: the first configured stop, falling back to the first returned
+    JsonArray stops = doc["stops"];
+    const char *name = nullptr;
+    for (JsonObject stop : stops)
+    {
+        const char *id = stop["stop_id"];
+        if (stopName && id && strcmp(id, stopIds[0]) == 0)
         {
-            const char *name = doc["stops"][0]["stop_name"];
-            if (name)
-            {
-                strlcpy(stopName, name, 64);
-                // Note: UTF-8 to ISO-8859-2 conversion now handled by DisplayManager
-            }
-            isFirstStop = false;
+            name = stop["stop_name"];
+            break;
         }
+    }
+    if (stopName && !name && stops.size() > 0)
+    {
+        name = stops[0]["stop_name"];
+    }
+    if (name)
+    {
+        strlcpy(stopName, name, 64);
+        // Stays UTF-8 (shown in the web UI); departure strings are converted in setLabels()
+    }
 
-        // Parse departures from this stop
-        if (doc.containsKey("departures"))
+    // Parse departures, attributing each to its configured stop
+    JsonArray deps = doc["departures"];
+    if ((int)deps.size() >= MAX_DEPARTURES)
+    {
+        collector.markSourceCapped(); // total= limit reached - later departures not returned
+    }
+    for (JsonObject dep : deps)
+    {
+        int stopIndex = 0;
+        if (totalStops > 1)
         {
-            JsonArray deps = doc["departures"];
-
-            for (JsonObject dep : deps)
+            stopIndex = -1;  // Unknown stop - drawn without a direction indicator
+            const char *depStopId = dep["stop"]["id"];
+            for (int i = 0; depStopId && i < stopCount; i++)
             {
-                if (tempCount >= MAX_TEMP_DEPARTURES)
+                if (strcmp(depStopId, stopIds[i]) == 0)
+                {
+                    stopIndex = firstStopIndex + i;
                     break;
-
-                parseDepartureObject(dep, tempDepartures, tempCount, stopIndex);
+                }
             }
         }
 
-#if !defined(MATRIX_PORTAL_M4)
-        http.end();
-#endif
-        return true;
-    }
-    else
-    {
-        char failMsg[128];
-        snprintf(failMsg, sizeof(failMsg), "API: Failed after %d attempts for stop %s - HTTP %d",
-                 MAX_RETRIES, stopId, httpCode);
-        logTimestamp();
-        debugPrintln(failMsg);
-#if !defined(MATRIX_PORTAL_M4)
-        http.end();
-#endif
-        return false;
+        parseDepartureObject(dep, collector, stopIndex);
     }
+
+    return true;
 }
 
-void GolemioAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartures, int &tempCount, int stopIndex)
+void GolemioAPI::parseDepartureObject(JsonObject depJson, DepartureCollector &collector, int stopIndex)
 {
+    Departure dep = {};
+
     // Set stop index
-    tempDepartures[tempCount].stopIndex = stopIndex;
+    dep.stopIndex = stopIndex;
 
     // Route/Line info
     const char *line = depJson["route"]["short_name"];
-    if (line)
-    {
-        strlcpy(tempDepartures[tempCount].line, line, sizeof(tempDepartures[0].line));
-    }
-    else
-    {
-        tempDepartures[tempCount].line[0] = '\0';
-    }
 
-    // Destination/Headsign
+    // Trip identity (matches the same vehicle run across refreshes)
+    dep.tripKey = hashTripId(depJson["trip"]["id"].as<const char*>());
+
+    // Destination/Headsign, abbreviated while still UTF-8. The buffer has room for
+    // two bytes per character; setLabels() converts to one byte each and truncates.
+    char destination[2 * MAX_DESTINATION_LENGTH] = "";
     const char *headsign = depJson["trip"]["headsign"];
     if (headsign)
     {
-        strlcpy(tempDepartures[tempCount].destination, headsign, sizeof(tempDepartures[0].destination));
-        shortenDestination(tempDepartures[tempCount].destination); // Shorten while still UTF-8
-        // Note: UTF-8 to ISO-8859-2 conversion now handled by DisplayManager
+        DestinationShortener::getInstance().shorten(headsign, destination, sizeof(destination));
     }
-    else
+
+    // Strings are interned - the record only keeps their indices
+    if (!collector.setLabels(dep, line, destination))
     {
-        tempDepartures[tempCount].destination[0] = '\0';
+        return;
     }
 
     // Parse and store departure timestamp
@@ -453,38 +524,35 @@ void GolemioAPI::parseDepartureObject(JsonObject depJson, Departure *tempDepartu
         timestamp = depJson["departure_timestamp"]["scheduled"];
     }
 
-    if (timestamp)
+    time_t depTime;
+    if (timestamp && parseISO8601(timestamp, &depTime))
     {
-        struct tm tm;
-        parseISO8601(timestamp, &tm);
-        time_t depTime = mktime(&tm);
-
         // Store timestamp for future recalculation
-        tempDepartures[tempCount].departureTime = depTime;
+        dep.departureTime = depTime;
 
         // Calculate initial ETA for sorting/filtering
-        tempDepartures[tempCount].eta = calculateETA(depTime);
+        dep.eta = calculateETA(depTime);
     }
     else
     {
-        tempDepartures[tempCount].departureTime = 0;
-        tempDepartures[tempCount].eta = 0;
+        dep.departureTime = 0;
+        dep.eta = 0;
     }
 
     // Air conditioning
-    tempDepartures[tempCount].hasAC = depJson["trip"]["is_air_conditioned"] | false;
+    dep.hasAC = depJson["trip"]["is_air_conditioned"] | false;
 
     // Delay info
     if (depJson.containsKey("delay") && !depJson["delay"].isNull())
     {
-        tempDepartures[tempCount].isDelayed = true;
-        tempDepartures[tempCount].delayMinutes = depJson["delay"]["minutes"] | 0;
+        dep.isDelayed = true;
+        dep.delayMinutes = depJson["delay"]["minutes"] | 0;
     }
     else
     {
-        tempDepartures[tempCount].isDelayed = false;
-        tempDepartures[tempCount].delayMinutes = 0;
+        dep.isDelayed = false;
+        dep.delayMinutes = 0;
     }
 
-    tempCount++;
+    collector.add(dep);
 }
@@ -3,7 +3,9 @@
 
 #include "TransitAPI.h"
 #include "DepartureData.h"
+#include "DepartureCollector.h"
 #include "../config/AppConfig.h"
+#include <Arduino.h>
 #include <ArduinoJson.h>
 
 // ============================================================================
@@ -38,36 +40,74 @@ public:
      */
     virtual APIResult fetchDepartures(const Config &config) override;
 
+    /**
+     * Fetch departures of a single configured Prague stop
+     * @param config Configuration with API key, stop IDs, and filters
+     * @param stopIndex Index of the stop in config.pragueStopIds
+     * @return APIResult with this stop's departures only
+     */
+    virtual APIResult fetchStopDepartures(const Config &config, int stopIndex) override;
+
 private:
     APIStatusCallback statusCallback;
     APIPartialResultsCallback partialResultsCallback;
-    static constexpr int MAX_TEMP_DEPARTURES = MAX_DEPARTURES * 12;  // Buffer for up to 12 stops at full capacity
-    static constexpr int JSON_BUFFER_SIZE = 12288;  // 12KB - handles busy stops with many departures
+    static constexpr int MAX_BATCH_STOPS = 12;  // Stops queried together in one request (more are split into batches)
+    static constexpr int MAX_CONFIG_STOPS = sizeof(Config::pragueStopIds) / 2;  // Upper bound of "A,B,..." in the config string
+    static constexpr int JSON_BUFFER_SIZE = 12288;  // 12KB - filtered; keep until measured on a batched rush-hour capture (test_corpus)
     static constexpr int HTTP_TIMEOUT_MS = 60000;  // 60s - M4's WiFiNINA + SSL is slow
 
+    DepartureCollector collector;  // Soonest departures across all stops (bounded, O(MAX_DEPARTURES))
+
     /**
-     * Query a single stop and add results to temp array
-     * @param stopId Stop ID to query
+     * Query a batch of stops in a single departureboards request and offer results to the collector
+     * (split into several requests if the IDs don't fit into one query string)
+     * @param stopIds Stop IDs to query (one ids= parameter each)
+     * @param stopCount Number of stop IDs in this batch
+     * @param firstStopIndex stopIndex of stopIds[0] within the configured stops
+     * @param totalStops Number of configured stops across all batches
      * @param config Configuration
-     * @param tempDepartures Temporary array to fill
-     * @param tempCount Current count in temp array
-     * @param stopName Output: stop name (from first stop only)
-     * @param isFirstStop Whether this is the first stop being queried
-     * @param stopIndex Index of the stop (0, 1, 2, ...)
+     * @param collector Collector keeping the soonest departures
+     * @param stopName Output: stop name (of the first configured stop), or nullptr to skip
      * @return true if query succeeded
      */
-    bool querySingleStop(const char *stopId, const Config &config,
-                         Departure *tempDepartures, int &tempCount,
-                         char *stopName, bool &isFirstStop, int stopIndex);
+    bool queryStops(const char *const *stopIds, int stopCount, int firstStopIndex, int totalStops,
+                    const Config &config, DepartureCollector &collector, char *stopName);
+
+    /**
+     * Build the departureboards request path for as many of the stops as fit
+     * @param path Output buffer
+     * @param size Size of path
+     * @param stopIds Stop IDs to query (one ids= parameter each)
+     * @param stopCount Number of stop IDs
+     * @param config Configuration (minimum departure time)
+     * @return Number of stops in the path (0 if not even the first one fits)
+     */
+    static int buildQueryPath(char *path, size_t size, const char *const *stopIds, int stopCount,
+                              const Config &config);
+
+    /**
+     * Deserialize a departure board directly from the HTTP stream
+     * Applies a field filter so only the values we display are stored in the document
+     * @param stream Response body stream (positioned after the headers)
+     * @param stopIds Queried stop IDs, used to attribute departures to a stopIndex
+     * @param stopCount Number of stop IDs
+     * @param firstStopIndex stopIndex of stopIds[0] within the configured stops
+     * @param totalStops Number of configured stops across all batches
+     * @param collector Collector keeping the soonest departures
+     * @param stopName Output: stop name (of the first configured stop), or nullptr to skip
+     * @return true if the response was parsed
+     */
+    bool parseDepartureStream(Stream &stream, const char *const *stopIds, int stopCount,
+                              int firstStopIndex, int totalStops,
+                              DepartureCollector &collector, char *stopName);
 
     /**
-     * Parse departure JSON object and add to temp array
+     * Parse departure JSON object and offer it to the collector
      * @param depJson JSON object for single departure
-     * @param tempDepartures Array to add to
-     * @param tempCount Current count (will be incremented)
+     * @param collector Collector keeping the soonest departures
      * @param stopIndex Index of the stop this departure is from
      */
-    void parseDepartureObject(JsonObject depJson, Departure *tempDepartures, int &tempCount, int stopIndex);
+    void parseDepartureObject(JsonObject depJson, DepartureCollector &collector, int stopIndex);
 };
 
 #endif // GOLEMIOAPI_H
@@ -0,0 +1,535 @@
+#include "GtfsRtAPI.h"
+#include "../utils/Logger.h"
+#include "../utils/TimeUtils.h"
+#include "../utils/Metrics.h"
+#include "../hal/Clock.h"
+#include "../network/HttpConnectionManager.h"
+#include <time.h>
+#include <cstring>
+
+// ============================================================================
+// GTFS-Realtime field numbers (gtfs-realtime.proto)
+// ============================================================================
+
+namespace
+{
+    // FeedMessage
+    constexpr uint32_t FEED_ENTITY = 2;
+    // FeedEntity
+    constexpr uint32_t ENTITY_IS_DELETED = 2;
+    constexpr uint32_t ENTITY_TRIP_UPDATE = 3;
+    // TripUpdate
+    constexpr uint32_t TRIP_UPDATE_TRIP = 1;
+    constexpr uint32_t TRIP_UPDATE_STOP_TIME_UPDATE = 2;
+    constexpr uint32_t TRIP_UPDATE_VEHICLE = 3;
+    constexpr uint32_t TRIP_UPDATE_DELAY = 5;
+    // TripDescriptor
+    constexpr uint32_t TRIP_TRIP_ID = 1;
+    constexpr uint32_t TRIP_SCHEDULE_RELATIONSHIP = 4;
+    constexpr uint32_t TRIP_ROUTE_ID = 5;
+    constexpr uint64_t TRIP_CANCELED = 3;
+    // VehicleDescriptor
+    constexpr uint32_t VEHICLE_LABEL = 2;
+    // StopTimeUpdate
+    constexpr uint32_t STOP_TIME_ARRIVAL = 2;
+    constexpr uint32_t STOP_TIME_DEPARTURE = 3;
+    constexpr uint32_t STOP_TIME_STOP_ID = 4;
+    constexpr uint32_t STOP_TIME_SCHEDULE_RELATIONSHIP = 5;
+    constexpr uint64_t STOP_TIME_SCHEDULED = 0;
+    // StopTimeEvent
+    constexpr uint32_t EVENT_DELAY = 1;
+    constexpr uint32_t EVENT_TIME = 2;
+}
+
+GtfsRtAPI::GtfsRtAPI() : statusCallback(nullptr), partialResultsCallback(nullptr)
+{
+}
+
+void GtfsRtAPI::setStatusCallback(APIStatusCallback callback)
+{
+    statusCallback = callback;
+}
+
+void GtfsRtAPI::setPartialResultsCallback(APIPartialResultsCallback callback)
+{
+    partialResultsCallback = callback;
+}
+
+// ============================================================================
+// Fetching
+// ============================================================================
+
+TransitAPI::APIResult GtfsRtAPI::fetchDepartures(const Config &config)
+{
+    TransitAPI::APIResult result = {};
+    result.refreshedStop = -1;
+
+    if (strlen(config.gtfsRtFeedUrl) == 0 || strlen(config.gtfsRtStopIds) == 0)
+    {
+        result.hasError = true;
+        strlcpy(result.errorMsg, "Missing feed URL or stop IDs", sizeof(result.errorMsg));
+        return result;
+    }
+
+    logTimestamp();
+    debugPrintln("GTFS-RT: Fetching departures...");
+    logMemory("gtfsrt_api_start");
+
+    char stopIdsCopy[sizeof(config.gtfsRtStopIds)];
+    strlcpy(stopIdsCopy, config.gtfsRtStopIds, sizeof(stopIdsCopy));
+    const char *stopIds[MAX_CONFIG_STOPS];
+    int stopCount = splitStopIds(stopIdsCopy, stopIds, MAX_CONFIG_STOPS);
+    if (stopCount == 0)
+    {
+        result.hasError = true;
+        strlcpy(result.errorMsg, "Missing stop IDs", sizeof(result.errorMsg));
+        return result;
+    }
+
+    // The feed has no stop names - show the first configured ID
+    strlcpy(result.stopName, stopIds[0], sizeof(result.stopName));
+
+    collector.reset(config.minDepartureTime);
+    int matched = queryFeed(config, stopIds, stopCount, -1, result.errorMsg, sizeof(result.errorMsg));
+
+    result.departureCount = collector.copySorted(result.departures, result.strings);
+    result.truncated = collector.isTruncated();
+
+    if (matched < 0)
+    {
+        result.hasError = true;
+    }
+    else if (result.departureCount == 0)
+    {
+        result.hasError = true;
+        strlcpy(result.errorMsg, "No departures", sizeof(result.errorMsg));
+    }
+
+    logTimestamp();
+    char msg[64];
+    snprintf(msg, sizeof(msg), "GTFS-RT: Fetched %d departures", result.departureCount);
+    debugPrintln(msg);
+    logMemory("gtfsrt_api_end");
+
+    return result;
+}
+
+TransitAPI::APIResult GtfsRtAPI::fetchStopDepartures(const Config &config, int stopIndex)
+{
+    TransitAPI::APIResult result = {};
+    result.refreshedStop = stopIndex;
+
+    char stopIdsCopy[sizeof(config.gtfsRtStopIds)];
+    strlcpy(stopIdsCopy, config.gtfsRtStopIds, sizeof(stopIdsCopy));
+    const char *stopIds[MAX_CONFIG_STOPS];
+    int stopCount = splitStopIds(stopIdsCopy, stopIds, MAX_CONFIG_STOPS);
+
+    if (stopIndex < 0 || stopIndex >= stopCount || strlen(config.gtfsRtFeedUrl) == 0)
+    {
+        result.hasError = true;
+        strlcpy(result.errorMsg, "Missing stop ID", sizeof(result.errorMsg));
+        return result;
+    }
+
+    if (stopIndex == 0)
+    {
+        strlcpy(result.stopName, stopIds[0], sizeof(result.stopName));
+    }
+
+    collector.reset(config.minDepartureTime);
+    int matched = queryFeed(config, stopIds, stopCount, stopIndex, result.errorMsg, sizeof(result.errorMsg));
+
+    result.departureCount = collector.copySorted(result.departures, result.strings);
+    result.truncated = collector.isTruncated();
+
+    // An empty board is valid here - other stops may still fill the cache
+    if (matched < 0)
+    {
+        result.hasError = true;
+    }
+
+    logTimestamp();
+    char msg[64];
+    snprintf(msg, sizeof(msg), "GTFS-RT: Stop %d refreshed, %d departures", stopIndex, result.departureCount);
+    debugPrintln(msg);
+
+    return result;
+}
+
+int GtfsRtAPI::queryFeed(const Config &config, const char *const *stopIds, int stopCount, int onlyStop,
+                         char *errorMsg, size_t errorSize)
+{
+    // "https://host/path?query" - the connection manager keeps the host, the request uses the rest
+    static const char SCHEME[] = "https://";
+    if (strncmp(config.gtfsRtFeedUrl, SCHEME, sizeof(SCHEME) - 1) != 0)
+    {
+        strlcpy(errorMsg, "Feed URL must start with https://", errorSize);
+        return -1;
+    }
+
+    const char *hostStart = config.gtfsRtFeedUrl + sizeof(SCHEME) - 1;
+    const char *path = strchr(hostStart, '/');
+    char hostName[64];
+    size_t hostLength = path ? (size_t)(path - hostStart) : strlen(hostStart);
+    if (hostLength == 0 || hostLength >= sizeof(hostName))
+    {
+        strlcpy(errorMsg, "Invalid feed URL", errorSize);
+        return -1;
+    }
+    memcpy(hostName, hostStart, hostLength);
+    hostName[hostLength] = '\0';
+
+    HttpConnectionManager &connections = HttpConnectionManager::getInstance();
+    const HttpConnectionManager::Host host = HttpConnectionManager::HOST_GTFS_RT;
+    const char *headers[] = {"Accept", "application/x-protobuf"};
+    connections.setServer(host, hostName);
+
+    // One download serves every stop
+    unsigned long fetchStartMs = clockMillis();
+    int httpCode = 0;
+    for (int attempt = 1; attempt <= 3; attempt++)
+    {
+        httpCode = connections.get(host, path ? path : "/", headers, 1, HTTP_TIMEOUT_MS);
+        if (httpCode == HTTP_CODE_OK)
+        {
+            break;
+        }
+
+        connections.end(host);
+
+        logTimestamp();
+        char errMsg[96];
+        snprintf(errMsg, sizeof(errMsg), "GTFS-RT: HTTP %d (%s) attempt %d/3",
+                 httpCode, httpErrorToString(httpCode), attempt);
+        debugPrintln(errMsg);
+        logNetworkDiagnostics();
+
+        // Don't retry on 4xx client errors
+        if (httpCode >= 400 && httpCode < 500)
+        {
+            break;
+        }
+        if (attempt < 3)
+        {
+            clockDelay(attempt * 2000); // 2s, 4s
+        }
+    }
+
+    if (httpCode != HTTP_CODE_OK)
+    {
+        Metrics::getInstance().recordFetch(-1, clockMillis() - fetchStartMs);
+        snprintf(errorMsg, errorSize, "HTTP %d", httpCode);
+        return -1;
+    }
+
+    // Decode straight from the socket - the feed is never held in memory
+    unsigned long startMs = clockMillis();
+    ProtobufReader reader(connections.getBodyStream(host), connections.getBodySize(host));
+    int matched = parseFeed(reader, stopIds, stopCount, onlyStop, getCurrentEpochTime(), collector);
+    Metrics::getInstance().recordParse(clockMillis() - startMs);
+    Metrics::getInstance().recordFetch(-1, clockMillis() - fetchStartMs);
+
+    if (matched < 0)
+    {
+        connections.drop(host);  // Stream position unknown after a decode error
+        strlcpy(errorMsg, "Feed decode error", errorSize);
+    }
+    else
+    {
+        connections.end(host);
+    }
+
+    logTimestamp();
+    char msg[112];
+    snprintf(msg, sizeof(msg), "GTFS-RT: %lu bytes decoded in %lu ms, %d stop updates matched (kept now: %d)",
+             (unsigned long)reader.getPosition(), clockMillis() - startMs, matched, collector.size());
+    debugPrintln(msg);
+
+    return matched;
+}
+
+// ============================================================================
+// Feed Decoding
+// ============================================================================
+
+int GtfsRtAPI::parseFeed(ProtobufReader &reader, const char *const *stopIds, int stopCount,
+                         int onlyStop, time_t now, DepartureCollector &collector)
+{
+    int matched = 0;
+    uint32_t field;
+    uint8_t wireType;
+    while (reader.nextField(ProtobufReader::UNBOUNDED, field, wireType))
+    {
+        uint32_t end;
+        if (field == FEED_ENTITY && wireType == ProtobufReader::WIRE_LENGTH && reader.enterMessage(end))
+        {
+            parseEntity(reader, end, stopIds, stopCount, onlyStop, now, collector, matched);
+        }
+        else
+        {
+            reader.skipField(wireType);
+        }
+    }
+
+    return reader.hasError() ? -1 : matched;
+}
+
+bool GtfsRtAPI::parseEntity(ProtobufReader &reader, uint32_t end, const char *const *stopIds, int stopCount,
+                            int onlyStop, time_t now, DepartureCollector &collector, int &matched)
+{
+    TripState trip;
+    trip.tripId[0] = '\0';
+    trip.routeId[0] = '\0';
+    trip.label[0] = '\0';
+    trip.lastStopId[0] = '\0';
+    trip.canceled = false;
+    trip.delaySeconds = 0;
+    trip.hasDelay = false;
+    trip.matchCount = 0;
+
+    bool deleted = false;
+    uint32_t field;
+    uint8_t wireType;
+    while (reader.nextField(end, field, wireType))
+    {
+        uint32_t nestedEnd;
+        uint64_t value;
+        if (field == ENTITY_IS_DELETED && wireType == ProtobufReader::WIRE_VARINT && reader.readVarint(value))
+        {
+            deleted = (value != 0);
+        }
+        else if (field == ENTITY_TRIP_UPDATE && wireType == ProtobufReader::WIRE_LENGTH &&
+                 reader.enterMessage(nestedEnd))
+        {
+            parseTripUpdate(reader, nestedEnd, trip, stopIds, stopCount, onlyStop);
+        }
+        else
+        {
+            reader.skipField(wireType);
+        }
+    }
+
+    if (reader.hasError() || deleted || trip.canceled)
+    {
+        return false;
+    }
+
+    matched += trip.matchCount;
+    emitTrip(trip, now, collector);
+    return true;
+}
+
+void GtfsRtAPI::parseTripUpdate(ProtobufReader &reader, uint32_t end, TripState &trip,
+                                const char *const *stopIds, int stopCount, int onlyStop)
+{
+    uint32_t field;
+    uint8_t wireType;
+    while (reader.nextField(end, field, wireType))
+    {
+        uint32_t nestedEnd;
+        uint64_t value;
+        if (wireType == ProtobufReader::WIRE_LENGTH &&
+            (field == TRIP_UPDATE_TRIP || field == TRIP_UPDATE_STOP_TIME_UPDATE || field == TRIP_UPDATE_VEHICLE))
+        {
+            if (!reader.enterMessage(nestedEnd))
+            {
+                return;
+            }
+
+            if (field == TRIP_UPDATE_TRIP)
+            {
+                parseTripDescriptor(reader, nestedEnd, trip);
+            }
+            else if (field == TRIP_UPDATE_STOP_TIME_UPDATE)
+            {
+                parseStopTimeUpdate(reader, nestedEnd, trip, stopIds, stopCount, onlyStop);
+            }
+            else
+            {
+                uint32_t vehicleField;
+                uint8_t vehicleWire;
+                while (reader.nextField(nestedEnd, vehicleField, vehicleWire))
+                {
+                    if (vehicleField == VEHICLE_LABEL && vehicleWire == ProtobufReader::WIRE_LENGTH)
+                    {
+                        reader.readString(trip.label, sizeof(trip.label));
+                    }
+                    else
+                    {
+                        reader.skipField(vehicleWire);
+                    }
+                }
+            }
+        }
+        else if (field == TRIP_UPDATE_DELAY && wireType == ProtobufReader::WIRE_VARINT && reader.readVarint(value))
+        {
+            trip.delaySeconds = (int32_t)value;
+            trip.hasDelay = true;
+        }
+        else
+        {
+            reader.skipField(wireType);
+        }
+    }
+}
+
+void GtfsRtAPI::parseTripDescriptor(ProtobufReader &reader, uint32_t end, TripState &trip)
+{
+    uint32_t field;
+    uint8_t wireType;
+    while (reader.nextField(end, field, wireType))
+    {
+        uint64_t value;
+        if (field == TRIP_TRIP_ID && wireType == ProtobufReader::WIRE_LENGTH)
+        {
+            reader.readString(trip.tripId, sizeof(trip.tripId));
+        }
+        else if (field == TRIP_ROUTE_ID && wireType == ProtobufReader::WIRE_LENGTH)
+        {
+            reader.readString(trip.routeId, sizeof(trip.routeId));
+        }
+        else if (field == TRIP_SCHEDULE_RELATIONSHIP && wireType == ProtobufReader::WIRE_VARINT &&
+                 reader.readVarint(value))
+        {
+            trip.canceled = (value == TRIP_CANCELED);
+        }
+        else
+        {
+            reader.skipField(wireType);
+        }
+    }
+}
+
+void GtfsRtAPI::parseStopTimeUpdate(ProtobufReader &reader, uint32_t end, TripState &trip,
+                                    const char *const *stopIds, int stopCount, int onlyStop)
+{
+    char stopId[MAX_ID_LENGTH] = "";
+    time_t arrival = 0;
+    time_t departure = 0;
+    int32_t arrivalDelay = 0;
+    int32_t departureDelay = 0;
+    bool hasArrivalDelay = false;
+    bool hasDepartureDelay = false;
+    uint64_t relationship = STOP_TIME_SCHEDULED;
+
+    uint32_t field;
+    uint8_t wireType;
+    while (reader.nextField(end, field, wireType))
+    {
+        uint32_t nestedEnd;
+        if (field == STOP_TIME_STOP_ID && wireType == ProtobufReader::WIRE_LENGTH)
+        {
+            reader.readString(stopId, sizeof(stopId));
+        }
+        else if (field == STOP_TIME_ARRIVAL && wireType == ProtobufReader::WIRE_LENGTH &&
+                 reader.enterMessage(nestedEnd))
+        {
+            parseStopTimeEvent(reader, nestedEnd, arrival, arrivalDelay, hasArrivalDelay);
+        }
+        else if (field == STOP_TIME_DEPARTURE && wireType == ProtobufReader::WIRE_LENGTH &&
+                 reader.enterMessage(nestedEnd))
+        {
+            parseStopTimeEvent(reader, nestedEnd, departure, departureDelay, hasDepartureDelay);
+        }
+        else if (field == STOP_TIME_SCHEDULE_RELATIONSHIP && wireType == ProtobufReader::WIRE_VARINT)
+        {
+            reader.readVarint(relationship);
+        }
+        else
+        {
+            reader.skipField(wireType);
+        }
+    }
+
+    if (stopId[0] == '\0')
+    {
+        return;
+    }
+
+    // Updates are ordered by stop_sequence, so the last one is the furthest stop known
+    strlcpy(trip.lastStopId, stopId, sizeof(trip.lastStopId));
+
+    // Skipped stops and NO_DATA updates have no usable time
+    if (relationship != STOP_TIME_SCHEDULED || trip.matchCount >= MAX_TRIP_MATCHES)
+    {
+        return;
+    }
+
+    for (int i = 0; i < stopCount; i++)
+    {
+        if ((onlyStop >= 0 && i != onlyStop) || strcmp(stopId, stopIds[i]) != 0)
+        {
+            continue;
+        }
+
+        // Departure time, or arrival time at a trip's last stop
+        bool useDeparture = (departure != 0);
+        time_t time = useDeparture ? departure : arrival;
+        if (time == 0)
+        {
+            return; // Delay-only update: the scheduled time is in the static GTFS
+        }
+
+        StopMatch &match = trip.matches[trip.matchCount++];
+        match.time = time;
+        match.delaySeconds = useDeparture ? departureDelay : arrivalDelay;
+        match.hasDelay = useDeparture ? hasDepartureDelay : hasArrivalDelay;
+        match.stopIndex = (int8_t)i;
+        return;
+    }
+}
+
+void GtfsRtAPI::parseStopTimeEvent(ProtobufReader &reader, uint32_t end, time_t &time,
+                                   int32_t &delaySeconds, bool &hasDelay)
+{
+    uint32_t field;
+    uint8_t wireType;
+    while (reader.nextField(end, field, wireType))
+    {
+        uint64_t value;
+        if (field == EVENT_TIME && wireType == ProtobufReader::WIRE_VARINT && reader.readVarint(value))
+        {
+            time = (time_t)(int64_t)value;
+        }
+        else if (field == EVENT_DELAY && wireType == ProtobufReader::WIRE_VARINT && reader.readVarint(value))
+        {
+            delaySeconds = (int32_t)value;
+            hasDelay = true;
+        }
+        else
+        {
+            reader.skipField(wireType);
+        }
+    }
+}
+
+void GtfsRtAPI::emitTrip(const TripState &trip, time_t now, DepartureCollector &collector)
+{
+    const char *destination = trip.label[0] ? trip.label : trip.lastStopId;
+
+    for (int i = 0; i < trip.matchCount; i++)
+    {
+        const StopMatch &match = trip.matches[i];
+        if (match.time < now)
+        {
+            continue; // Already departed
+        }
+
+        Departure dep = {};
+        dep.stopIndex = match.stopIndex;
+        dep.tripKey = hashTripId(trip.tripId);
+        dep.departureTime = match.time;
+        dep.eta = (int16_t)((match.time - now) / 60);
+        dep.hasAC = false;  // Not part of GTFS-Realtime
+
+        int32_t delaySeconds = match.hasDelay ? match.delaySeconds : trip.delaySeconds;
+        dep.isDelayed = match.hasDelay || trip.hasDelay;
+        dep.delayMinutes = dep.isDelayed ? (int16_t)(delaySeconds / 60) : 0;
+
+        if (!collector.setLabels(dep, trip.routeId, destination))
+        {
+            return;
+        }
+        collector.add(dep);
+    }
+}
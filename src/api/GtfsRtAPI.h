@@ -0,0 +1,126 @@
+#ifndef GTFSRTAPI_H
+#define GTFSRTAPI_H
+
+#include "TransitAPI.h"
+#include "DepartureData.h"
+#include "DepartureCollector.h"
+#include "../config/AppConfig.h"
+#include "../utils/ProtobufReader.h"
+
+// ============================================================================
+// GTFS-Realtime API Client
+// ============================================================================
+
+/**
+ * Client for GTFS-Realtime TripUpdates feeds (protobuf).
+ *
+ * The whole feed is streamed through a ProtobufReader once per fetch; only
+ * stop_time_updates of the configured stop IDs are kept, so memory use does
+ * not depend on the feed size. Works with any agency publishing TripUpdates
+ * with absolute times (e.g. VBB, PID via Golemio).
+ *
+ * GTFS-Realtime carries no route names or headsigns (those live in the
+ * static GTFS): the line shows the route_id, the destination the vehicle
+ * label, or the last stop_id the trip lists when the feed has no labels.
+ */
+class GtfsRtAPI : public TransitAPI
+{
+public:
+    GtfsRtAPI();
+
+    /**
+     * Set callback for API status updates
+     * @param callback Function to call with status messages
+     */
+    virtual void setStatusCallback(APIStatusCallback callback) override;
+
+    /**
+     * Set callback for partial results
+     * Not called - the feed is a single response
+     * @param callback Function to call with current departures
+     */
+    virtual void setPartialResultsCallback(APIPartialResultsCallback callback) override;
+
+    /**
+     * Fetch the feed and collect departures of all configured stops
+     * @param config Configuration with feed URL, stop IDs and filters
+     * @return APIResult with departures, count, and error status
+     */
+    virtual APIResult fetchDepartures(const Config &config) override;
+
+    /**
+     * Fetch the feed and collect departures of a single configured stop
+     * Downloads the whole feed all the same, so the scheduler prefers full refreshes
+     * @param config Configuration with feed URL, stop IDs and filters
+     * @param stopIndex Index of the stop in config.gtfsRtStopIds
+     * @return APIResult with this stop's departures only
+     */
+    virtual APIResult fetchStopDepartures(const Config &config, int stopIndex) override;
+
+    /**
+     * Collect departures from an encoded FeedMessage
+     * Public so a recorded .pb feed can be replayed without a network
+     * @param reader Reader positioned at the start of the FeedMessage
+     * @param stopIds Configured stop IDs
+     * @param stopCount Number of stop IDs
+     * @param onlyStop Stop index to keep, or -1 for all stops
+     * @param now Current Unix time (departures before it are dropped)
+     * @param collector Collector keeping the soonest departures
+     * @return Number of matching stop_time_updates, or -1 if the feed is malformed
+     */
+    static int parseFeed(ProtobufReader &reader, const char *const *stopIds, int stopCount,
+                         int onlyStop, time_t now, DepartureCollector &collector);
+
+private:
+    APIStatusCallback statusCallback;
+    APIPartialResultsCallback partialResultsCallback;
+    static constexpr int MAX_CONFIG_STOPS = sizeof(Config::gtfsRtStopIds) / 2;  // Upper bound of "A,B,..." in the config string
+
+    DepartureCollector collector;  // Soonest departures across all stops (bounded, O(MAX_DEPARTURES))
+    static constexpr int HTTP_TIMEOUT_MS = 15000;  // Whole-network feeds take a while to stream
+
+    static constexpr int MAX_ID_LENGTH = 64;          // trip_id, stop_id
+    static constexpr int MAX_TRIP_MATCHES = 4;        // Configured stops one trip can serve (loops)
+
+    // Matched stop of the trip being decoded, emitted once the whole TripUpdate is read
+    struct StopMatch
+    {
+        time_t time;
+        int32_t delaySeconds;
+        bool hasDelay;
+        int8_t stopIndex;
+    };
+
+    struct TripState
+    {
+        char tripId[MAX_ID_LENGTH];
+        char routeId[2 * MAX_LINE_LENGTH];
+        char label[2 * MAX_DESTINATION_LENGTH];
+        char lastStopId[MAX_ID_LENGTH];
+        bool canceled;
+        int32_t delaySeconds;  // TripUpdate.delay, used when a stop has none
+        bool hasDelay;
+        StopMatch matches[MAX_TRIP_MATCHES];
+        int matchCount;
+    };
+
+    /**
+     * Download the feed and run parseFeed() on it
+     * @return Number of matching stop_time_updates, or -1 on error (errorMsg set)
+     */
+    int queryFeed(const Config &config, const char *const *stopIds, int stopCount, int onlyStop,
+                  char *errorMsg, size_t errorSize);
+
+    static bool parseEntity(ProtobufReader &reader, uint32_t end, const char *const *stopIds, int stopCount,
+                            int onlyStop, time_t now, DepartureCollector &collector, int &matched);
+    static void parseTripUpdate(ProtobufReader &reader, uint32_t end, TripState &trip,
+                                const char *const *stopIds, int stopCount, int onlyStop);
+    static void parseTripDescriptor(ProtobufReader &reader, uint32_t end, TripState &trip);
+    static void parseStopTimeUpdate(ProtobufReader &reader, uint32_t end, TripState &trip,
+                                    const char *const *stopIds, int stopCount, int onlyStop);
+    static void parseStopTimeEvent(ProtobufReader &reader, uint32_t end, time_t &time,
+                                   int32_t &delaySeconds, bool &hasDelay);
+    static void emitTrip(const TripState &trip, time_t now, DepartureCollector &collector);
+};
+
+#endif // GTFSRTAPI_H
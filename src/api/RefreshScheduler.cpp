@@ -0,0 +1,323 @@
+#include "RefreshScheduler.h"
+#include <string.h>
+
+RefreshScheduler::RefreshScheduler()
+    : fullDue(true), perStop(false), inFlight(false), inFlightMs(0), inFlightTimeoutMs(0),
+      stopCount(0), lastFullMs(0), fullDelayMs(0), fullReason(REASON_INITIAL),
+      fullFailures(0), fullCoverageUntil(0)
+{
+    memset(stops, 0, sizeof(stops));
+}
+
+void RefreshScheduler::forceRefresh()
+{
+    fullDue = true;
+    fullReason = REASON_FORCED;
+}
+
+int RefreshScheduler::nextDue(unsigned long nowMs) const
+{
+    if (fullDue)
+    {
+        return ALL_STOPS;
+    }
+
+    // One fetch at a time - unless the result never arrived
+    if (inFlight && nowMs - inFlightMs < inFlightTimeoutMs)
+    {
+        return NONE;
+    }
+
+    if (!perStop)
+    {
+        return (nowMs - lastFullMs >= fullDelayMs) ? ALL_STOPS : NONE;
+    }
+
+    // Most overdue stop first
+    int best = NONE;
+    unsigned long bestOverdue = 0;
+    for (int i = 0; i < stopCount; i++)
+    {
+        unsigned long elapsed = nowMs - stops[i].lastFetchMs;
+        if (elapsed < stops[i].delayMs)
+        {
+            continue;
+        }
+
+        unsigned long overdue = elapsed - stops[i].delayMs;
+        if (best == NONE || overdue > bestOverdue)
+        {
+            best = i;
+            bestOverdue = overdue;
+        }
+    }
+    return best;
+}
+
+void RefreshScheduler::onFetchStarted(const Config &config, int target, unsigned long nowMs)
+{
+    unsigned long maxMs = (unsigned long)config.refreshInterval * 1000;
+
+    inFlight = true;
+    inFlightMs = nowMs;
+    inFlightTimeoutMs = maxMs;
+
+    if (target == ALL_STOPS)
+    {
+        // Stop list may have changed since the last full refresh
+        char stopIdsCopy[sizeof(config.pragueStopIds)];
+        bool isBerlin = (strcmp(config.city, "Berlin") == 0);
+        bool isFeed = (strcmp(config.city, "GTFS-RT") == 0);
+        strlcpy(stopIdsCopy, isBerlin ? config.berlinStopIds : isFeed ? config.gtfsRtStopIds : config.pragueStopIds,
+                sizeof(stopIdsCopy));
+        const char *ids[sizeof(stopIdsCopy) / 2];
+        stopCount = splitStopIds(stopIdsCopy, ids, sizeof(ids) / sizeof(ids[0]));
+
+        // A GTFS-Realtime feed is downloaded whole for any stop, so one full refresh is cheapest
+        perStop = config.adaptiveRefresh && !isFeed && stopCount > 0 && stopCount <= MAX_STOPS;
+        if (stopCount > MAX_STOPS)
+        {
+            stopCount = MAX_STOPS;
+        }
+
+        fullDue = false;
+        lastFullMs = nowMs;
+        fullDelayMs = maxMs;
+        fullReason = config.adaptiveRefresh ? REASON_MAX_INTERVAL : REASON_FIXED;
+
+        for (int i = 0; i < stopCount; i++)
+        {
+            stops[i].lastFetchMs = nowMs;
+            stops[i].delayMs = maxMs;
+            stops[i].coverageUntil = 0;
+            stops[i].failures = 0;
+            stops[i].reason = REASON_MAX_INTERVAL;
+        }
+    }
+    else if (target >= 0 && target < stopCount)
+    {
+        stops[target].lastFetchMs = nowMs;
+        stops[target].delayMs = maxMs;
+    }
+}
+
+void RefreshScheduler::onFetchCompleted(const Config &config, int target, bool hasError,
+                                        bool truncated, time_t lastFetched, uint32_t trimmedStops,
+                                        const Departure *cache, int count, time_t nowEpoch, unsigned long nowMs)
+{
+    inFlight = false;
+
+    // Data of a truncated result is only complete up to its last departure
+    time_t coverage = (truncated && lastFetched != 0) ? lastFetched : 0;
+
+    if (!perStop)
+    {
+        if (!config.adaptiveRefresh)
+        {
+            // Fixed interval for all stops together
+            fullDelayMs = (unsigned long)config.refreshInterval * 1000;
+            fullReason = REASON_FIXED;
+            return;
+        }
+
+        // All stops share one deadline, planned from the whole cache
+        fullFailures = hasError ? (uint8_t)(fullFailures + 1) : 0;
+        if (!hasError)
+        {
+            fullCoverageUntil = coverage;
+        }
+        fullDelayMs = planDelay(config, ALL_STOPS, fullFailures, fullCoverageUntil, nowMs - lastFullMs,
+                                cache, count, nowEpoch, fullReason);
+        return;
+    }
+
+    for (int i = 0; i < stopCount; i++)
+    {
+        if (target != ALL_STOPS && target != i)
+        {
+            continue;
+        }
+
+        stops[i].failures = hasError ? (uint8_t)(stops[i].failures + 1) : 0;
+        if (!hasError)
+        {
+            stops[i].coverageUntil = coverage;
+        }
+    }
+
+    // Stops that lost departures to the cache capacity are only complete up to its last entry
+    if (trimmedStops != 0 && count > 0)
+    {
+        time_t cutoff = cache[count - 1].departureTime;
+        for (int i = 0; i < stopCount; i++)
+        {
+            if ((trimmedStops & ((uint32_t)1 << i)) &&
+                (stops[i].coverageUntil == 0 || cutoff < stops[i].coverageUntil))
+            {
+                stops[i].coverageUntil = cutoff;
+            }
+        }
+    }
+
+    // The cache changed for everyone, so replan every stop
+    for (int i = 0; i < stopCount; i++)
+    {
+        planStop(i, config, cache, count, nowEpoch, nowMs);
+    }
+}
+
+void RefreshScheduler::planStop(int stopIndex, const Config &config, const Departure *cache, int count,
+                                time_t nowEpoch, unsigned long nowMs)
+{
+    StopState &stop = stops[stopIndex];
+    stop.delayMs = planDelay(config, stopIndex, stop.failures, stop.coverageUntil, nowMs - stop.lastFetchMs,
+                             cache, count, nowEpoch, stop.reason);
+}
+
+unsigned long RefreshScheduler::planDelay(const Config &config, int target, uint8_t failures,
+                                          time_t coverageUntil, unsigned long elapsedMs,
+                                          const Departure *cache, int count, time_t nowEpoch,
+                                          Reason &reason) const
+{
+    unsigned long maxMs = (unsigned long)config.refreshInterval * 1000;
+    unsigned long minMs = (unsigned long)config.minRefreshInterval * 1000;
+    if (minMs > maxMs)
+    {
+        minMs = maxMs;
+    }
+
+    if (failures > 0)
+    {
+        // Exponential backoff for this target only
+        int shift = failures - 1;
+        if (shift > MAX_BACKOFF_SHIFT)
+        {
+            shift = MAX_BACKOFF_SHIFT;
+        }
+        unsigned long backoffMs = minMs << shift;
+        reason = REASON_ERROR_RETRY;
+        return (backoffMs < maxMs) ? backoffMs : maxMs;
+    }
+
+    // Candidates are measured from the target's fetch start (elapsedMs ago), like the delay
+    unsigned long next = maxMs;
+    Reason nextReason = REASON_MAX_INTERVAL;
+
+    // Cache drain: only departures up to the target's coverage are known to be complete.
+    // recalculateETAs() drops a departure once eta <= minDepartureTime, i.e. less than
+    // (minDepartureTime + 1) minutes before it leaves. Find when fewer than
+    // numDepartures + margin of those remain. Complete (untruncated) data has
+    // nothing more to offer - polling sooner won't help.
+    if (coverageUntil != 0)
+    {
+        int known = 0;
+        while (known < count && cache[known].departureTime <= coverageUntil)
+        {
+            known++;
+        }
+
+        int needed = config.numDepartures + CACHE_SAFETY_MARGIN;
+        unsigned long drainMs = elapsedMs;
+        if (known >= needed)
+        {
+            time_t dropTime = cache[known - needed].departureTime - (time_t)(config.minDepartureTime + 1) * 60;
+            long secondsLeft = (long)(dropTime - nowEpoch);
+            drainMs += (secondsLeft > 0) ? (unsigned long)secondsLeft * 1000 : 0;
+        }
+
+        if (drainMs < next)
+        {
+            next = drainMs;
+            nextReason = REASON_CACHE_LOW;
+        }
+    }
+
+    // Staleness: only worth polling faster while one of the target's displayed rows is about to leave
+    for (int i = 0; i < count && i < config.numDepartures; i++)
+    {
+        if ((target == ALL_STOPS || cache[i].stopIndex == target) && cache[i].eta <= IMMINENT_ETA_MIN &&
+            STALE_PREDICTION_MS < next)
+        {
+            next = STALE_PREDICTION_MS;
+            nextReason = REASON_STALE;
+            break;
+        }
+    }
+
+    reason = nextReason;
+    return (next < minMs) ? minMs : next;
+}
+
+int RefreshScheduler::earliestStop(unsigned long nowMs, unsigned long &remainingMs) const
+{
+    int earliest = NONE;
+    remainingMs = 0;
+    for (int i = 0; i < stopCount; i++)
+    {
+        unsigned long elapsed = nowMs - stops[i].lastFetchMs;
+        unsigned long remaining = (elapsed >= stops[i].delayMs) ? 0 : stops[i].delayMs - elapsed;
+        if (earliest == NONE || remaining < remainingMs)
+        {
+            earliest = i;
+            remainingMs = remaining;
+        }
+    }
+    return earliest;
+}
+
+int RefreshScheduler::getNextTarget(unsigned long nowMs) const
+{
+    if (fullDue || !perStop)
+    {
+        return ALL_STOPS;
+    }
+
+    unsigned long remainingMs;
+    int stop = earliestStop(nowMs, remainingMs);
+    return (stop == NONE) ? ALL_STOPS : stop;
+}
+
+RefreshScheduler::Reason RefreshScheduler::getReason(unsigned long nowMs) const
+{
+    if (fullDue || !perStop)
+    {
+        return fullReason;
+    }
+
+    unsigned long remainingMs;
+    int stop = earliestStop(nowMs, remainingMs);
+    return (stop == NONE) ? fullReason : stops[stop].reason;
+}
+
+unsigned long RefreshScheduler::getSecondsUntilNextFetch(unsigned long nowMs) const
+{
+    if (fullDue)
+    {
+        return 0;
+    }
+
+    if (!perStop)
+    {
+        unsigned long elapsed = nowMs - lastFullMs;
+        return (elapsed >= fullDelayMs) ? 0 : (fullDelayMs - elapsed) / 1000;
+    }
+
+    unsigned long remainingMs;
+    earliestStop(nowMs, remainingMs);
+    return remainingMs / 1000;
+}
+
+const char *RefreshScheduler::reasonToString(Reason reason)
+{
+    switch (reason)
+    {
+        case REASON_INITIAL: return "initial";
+        case REASON_FORCED: return "forced";
+        case REASON_FIXED: return "fixed interval";
+        case REASON_MAX_INTERVAL: return "max interval";
+        case REASON_CACHE_LOW: return "cache low";
+        case REASON_STALE: return "stale prediction";
+        case REASON_ERROR_RETRY: return "error retry";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,164 @@
+#ifndef REFRESHSCHEDULER_H
+#define REFRESHSCHEDULER_H
+
+#include "DepartureData.h"
+#include "../config/AppConfig.h"
+#include <time.h>
+
+// ============================================================================
+// Adaptive Refresh Scheduler
+// ============================================================================
+
+/**
+ * Decides when the next departure fetch is due, and for which stop.
+ *
+ * A full refresh (all stops) runs at boot and after forceRefresh(). With
+ * config.adaptiveRefresh enabled, every stop then gets its own deadline,
+ * derived from the cached departures instead of a fixed interval:
+ * - CACHE_LOW: the stop's data is cut off (API result limit or cache
+ *   capacity) and the departures known up to that cut-off would fall
+ *   below numDepartures + margin (busy stops drain fast)
+ * - STALE: one of the stop's departures is displayed and imminent, so its
+ *   delay prediction should not get older than STALE_PREDICTION_MS
+ * - MAX_INTERVAL: nothing happens sooner (quiet stops poll rarely)
+ * Each deadline is clamped to [minRefreshInterval, refreshInterval]. Failed
+ * stops back off exponentially from minRefreshInterval without holding up
+ * the others. Only the most overdue stop is fetched at a time, so requests
+ * are spread out instead of arriving in bursts.
+ *
+ * Where per-stop deadlines don't apply (GTFS-RT feeds, more than MAX_STOPS
+ * stops), the full refresh gets the same treatment over the whole cache:
+ * cache drain, staleness and error backoff.
+ *
+ * With adaptive refresh disabled, all stops are refreshed together every
+ * refreshInterval (previous behaviour).
+ *
+ * Delays are measured from the start of each fetch, so millis()
+ * wraparound is handled by unsigned subtraction.
+ */
+class RefreshScheduler
+{
+public:
+    enum Reason
+    {
+        REASON_INITIAL = 0,   // No fetch yet
+        REASON_FORCED,        // Config saved, manual refresh, demo ended
+        REASON_FIXED,         // Adaptive refresh disabled
+        REASON_MAX_INTERVAL,  // Upper bound reached
+        REASON_CACHE_LOW,     // Cache would run below display rows + margin
+        REASON_STALE,         // Imminent departure's prediction getting old
+        REASON_ERROR_RETRY    // Last fetch failed
+    };
+
+    static constexpr int NONE = -2;          // nextDue(): nothing to fetch
+    static constexpr int ALL_STOPS = -1;     // nextDue(): full refresh
+    static constexpr int MAX_STOPS = 32;     // Stops with their own deadline (more fall back to full refreshes)
+
+    RefreshScheduler();
+
+    /**
+     * Make the next nextDue() request a full refresh
+     */
+    void forceRefresh();
+
+    /**
+     * Find the fetch to start now
+     * @param nowMs Current millis()
+     * @return ALL_STOPS, a stop index, or NONE
+     */
+    int nextDue(unsigned long nowMs) const;
+
+    /**
+     * Record that a fetch was started
+     * Schedules a fallback at the maximum interval until the result arrives
+     * @param config Current configuration
+     * @param target ALL_STOPS or the stop index being fetched
+     * @param nowMs Current millis()
+     */
+    void onFetchStarted(const Config &config, int target, unsigned long nowMs);
+
+    /**
+     * Plan the next fetches after a result was applied to the cache
+     * @param config Current configuration
+     * @param target ALL_STOPS or the stop index that was fetched
+     * @param hasError Whether the fetch failed
+     * @param truncated Departures after the result's last one may be missing
+     * @param lastFetched departureTime of the result's last departure
+     * @param trimmedStops Stops (bitmask) that lost departures to the cache capacity
+     * @param cache Cached departures, sorted by departure time
+     * @param count Number of cached departures
+     * @param nowEpoch Current Unix time
+     * @param nowMs Current millis()
+     */
+    void onFetchCompleted(const Config &config, int target, bool hasError,
+                          bool truncated, time_t lastFetched, uint32_t trimmedStops,
+                          const Departure *cache, int count, time_t nowEpoch, unsigned long nowMs);
+
+    /**
+     * Stop of the next scheduled fetch
+     * @param nowMs Current millis()
+     * @return ALL_STOPS or a stop index
+     */
+    int getNextTarget(unsigned long nowMs) const;
+
+    /**
+     * Reason of the next scheduled fetch
+     * @param nowMs Current millis()
+     */
+    Reason getReason(unsigned long nowMs) const;
+
+    /**
+     * Seconds until the next fetch is due (0 if due now)
+     * @param nowMs Current millis()
+     */
+    unsigned long getSecondsUntilNextFetch(unsigned long nowMs) const;
+
+    static const char *reasonToString(Reason reason);
+
+private:
+    static constexpr int CACHE_SAFETY_MARGIN = 2;                 // Departures beyond the displayed rows
+    static constexpr unsigned long STALE_PREDICTION_MS = 120000;  // Max prediction age for imminent departures
+    static constexpr int IMMINENT_ETA_MIN = 10;                   // Delay changes matter within this ETA
+    static constexpr int MAX_BACKOFF_SHIFT = 5;                   // Error backoff up to 32x minRefreshInterval
+
+    struct StopState
+    {
+        unsigned long lastFetchMs; // millis() when this stop was last fetched
+        unsigned long delayMs;     // Next fetch at lastFetchMs + delayMs
+        time_t coverageUntil;      // Departures after this may be missing (0 = complete)
+        uint8_t failures;          // Consecutive failed fetches
+        Reason reason;
+    };
+
+    bool fullDue;                  // Forced or never fetched
+    bool perStop;                  // Per-stop deadlines active (adaptive, <= MAX_STOPS stops)
+    bool inFlight;                 // A fetch is running
+    unsigned long inFlightMs;      // millis() when the running fetch started
+    unsigned long inFlightTimeoutMs; // Give up waiting for its result after this
+    int stopCount;
+    unsigned long lastFullMs;      // millis() of the last full refresh (fixed mode + fallback)
+    unsigned long fullDelayMs;
+    Reason fullReason;
+    uint8_t fullFailures;          // Consecutive failed full refreshes (adaptive, per-stop inactive)
+    time_t fullCoverageUntil;      // Like StopState::coverageUntil, for the full refresh
+    StopState stops[MAX_STOPS];
+
+    void planStop(int stopIndex, const Config &config, const Departure *cache, int count,
+                  time_t nowEpoch, unsigned long nowMs);
+
+    /**
+     * Delay of the next fetch of a stop or of all stops, measured from its last fetch start
+     * @param target Stop index, or ALL_STOPS (every cached departure counts)
+     * @param failures Consecutive failed fetches of the target
+     * @param coverageUntil Departures after this may be missing (0 = complete)
+     * @param elapsedMs Time since the target's last fetch started
+     * @param reason Output: why the fetch is due then
+     * @return Delay clamped to [minRefreshInterval, refreshInterval]
+     */
+    unsigned long planDelay(const Config &config, int target, uint8_t failures, time_t coverageUntil,
+                            unsigned long elapsedMs, const Departure *cache, int count, time_t nowEpoch,
+                            Reason &reason) const;
+    int earliestStop(unsigned long nowMs, unsigned long &remainingMs) const;
+};
+
+#endif // REFRESHSCHEDULER_H
@@ -0,0 +1,254 @@
+#include "StaticSchedule.h"
+#include "../utils/Logger.h"
+#include "../utils/TimeUtils.h"
+#include "../hal/Storage.h"
+#include <string.h>
+
+static constexpr long SECONDS_PER_DAY = 86400;
+
+// Image structs are read in place from flash
+static_assert(sizeof(StaticSchedule::Header) == 36, "Header layout must match scripts/build_schedule.py");
+static_assert(sizeof(StaticSchedule::DayEntry) == 8, "DayEntry layout must match scripts/build_schedule.py");
+static_assert(sizeof(StaticSchedule::ScheduledDeparture) == 12,
+              "ScheduledDeparture layout must match scripts/build_schedule.py");
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+StaticSchedule& StaticSchedule::getInstance()
+{
+    static StaticSchedule instance;
+    return instance;
+}
+
+StaticSchedule::StaticSchedule()
+    : header(nullptr), stopTable(nullptr), dayTable(nullptr), departureTable(nullptr),
+      strings(nullptr), stringSize(0), configuredStops(0), matchedStops(0)
+{
+}
+
+bool StaticSchedule::begin()
+{
+    size_t partitionSize = storageDataSize();
+    if (partitionSize == 0)
+    {
+        logTimestamp();
+        debugPrintln("Schedule: No spiffs partition");
+        return false;
+    }
+
+    // Check the header before mapping anything
+    Header probe;
+    if (!storageReadData(0, &probe, sizeof(probe)) || probe.magic != MAGIC)
+    {
+        logTimestamp();
+        debugPrintln("Schedule: No timetable image in spiffs partition");
+        return false;
+    }
+    if (probe.totalSize < sizeof(Header) || probe.totalSize > partitionSize)
+    {
+        logTimestamp();
+        debugPrintln("Schedule: Timetable image larger than its partition");
+        return false;
+    }
+
+    const uint8_t* mapped = storageMapData(probe.totalSize);
+    if (mapped == nullptr)
+    {
+        logTimestamp();
+        debugPrintln("Schedule: Failed to map timetable image");
+        return false;
+    }
+
+    return attach(mapped, probe.totalSize);
+}
+
+bool StaticSchedule::attach(const uint8_t* data, size_t size)
+{
+    header = nullptr;
+    matchedStops = 0;
+
+    const Header* image = (const Header*)data;
+    if (size < sizeof(Header) || image->magic != MAGIC || image->version != VERSION || image->totalSize > size)
+    {
+        logTimestamp();
+        debugPrintln("Schedule: Invalid timetable image");
+        return false;
+    }
+
+    // Every table must lie inside the image, in the order documented in the header
+    uint32_t stopTableEnd = sizeof(Header) + image->stopCount * sizeof(uint32_t);
+    uint64_t dayTableEnd = image->dayTableOffset + (uint64_t)image->dayCount * image->stopCount * sizeof(DayEntry);
+    uint64_t departuresEnd = image->departureOffset + (uint64_t)image->departureCount * sizeof(ScheduledDeparture);
+    if ((image->dayTableOffset | image->departureOffset) % 4 != 0 ||
+        image->dayTableOffset < stopTableEnd || dayTableEnd > image->departureOffset ||
+        departuresEnd > image->stringOffset || image->stringOffset >= image->totalSize ||
+        data[image->totalSize - 1] != '\0')
+    {
+        logTimestamp();
+        debugPrintln("Schedule: Corrupt timetable image");
+        return false;
+    }
+
+    header = image;
+    stopTable = (const uint32_t*)(data + sizeof(Header));
+    dayTable = (const DayEntry*)(data + image->dayTableOffset);
+    departureTable = (const ScheduledDeparture*)(data + image->departureOffset);
+    strings = (const char*)(data + image->stringOffset);
+    stringSize = image->totalSize - image->stringOffset;
+
+    time_t firstDay = (time_t)image->firstDay * SECONDS_PER_DAY;
+    struct tm first;
+    gmtime_r(&firstDay, &first);
+    char msg[112];
+    snprintf(msg, sizeof(msg), "Schedule: %u stops, %u days from %04d-%02d-%02d, %lu departures (%lu bytes)",
+             image->stopCount, image->dayCount, first.tm_year + 1900, first.tm_mon + 1, first.tm_mday,
+             (unsigned long)image->departureCount, (unsigned long)image->totalSize);
+    logTimestamp();
+    debugPrintln(msg);
+    return true;
+}
+
+int StaticSchedule::setStops(const char* stopIds)
+{
+    matchedStops = 0;
+    configuredStops = 0;
+    if (header == nullptr || stopIds == nullptr)
+    {
+        return 0;
+    }
+
+    char buffer[256];
+    strlcpy(buffer, stopIds, sizeof(buffer));
+    const char* ids[MAX_STOPS];
+    configuredStops = splitStopIds(buffer, ids, MAX_STOPS);
+
+    for (int i = 0; i < configuredStops; i++)
+    {
+        imageStop[i] = -1;
+        for (int s = 0; s < header->stopCount && s < 128; s++)
+        {
+            if (strcmp(getString(stopTable[s]), ids[i]) == 0)
+            {
+                imageStop[i] = (int8_t)s;
+                matchedStops++;
+                break;
+            }
+        }
+    }
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Schedule: %d of %d configured stops in timetable", matchedStops, configuredStops);
+    logTimestamp();
+    debugPrintln(msg);
+    return matchedStops;
+}
+
+const char* StaticSchedule::getString(uint32_t offset) const
+{
+    return (offset < stringSize) ? strings + offset : "";
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+int StaticSchedule::collect(time_t now, const time_t* after, DepartureCollector& collector) const
+{
+    if (!isAvailable())
+    {
+        return 0;
+    }
+
+    // Service days are local calendar days; a trip may run past midnight
+    // (GTFS times above 24:00), so yesterday's timetable is searched too
+    time_t localNow = now + getUtcOffset(now);
+    long today = (long)(localNow / SECONDS_PER_DAY) - (localNow % SECONDS_PER_DAY < 0 ? 1 : 0);
+    int minuteNow = (int)((localNow - (time_t)today * SECONDS_PER_DAY) / 60);
+
+    int offered = 0;
+    for (int i = 0; i < configuredStops; i++)
+    {
+        if (imageStop[i] < 0)
+        {
+            continue;
+        }
+
+        time_t cutoff = (after != nullptr && after[i] > now) ? after[i] : now;
+        for (int dayDelta = -1; dayDelta <= 1; dayDelta++)
+        {
+            offered += collectRun((int)(today + dayDelta - header->firstDay), imageStop[i], i,
+                                  minuteNow - dayDelta * 1440, cutoff, now, collector);
+        }
+    }
+    return offered;
+}
+
+int StaticSchedule::collectRun(int day, int stop, int configuredStop, int minMinute, time_t after,
+                               time_t now, DepartureCollector& collector) const
+{
+    if (day < 0 || day >= header->dayCount)
+    {
+        return 0;
+    }
+
+    const DayEntry& entry = dayTable[day * header->stopCount + stop];
+    if (entry.count == 0 || entry.first > header->departureCount || entry.count > header->departureCount - entry.first)
+    {
+        return 0;
+    }
+
+    // Minute of the cut-off in this service day's terms (local midnight of the day)
+    time_t localMidnight = (time_t)(header->firstDay + day) * SECONDS_PER_DAY;
+    long afterMinute = (long)((after + getUtcOffset(after) - localMidnight) / 60);
+    if (afterMinute > minMinute)
+    {
+        minMinute = (int)afterMinute;
+    }
+
+    // First departure at or after minMinute (lower bound)
+    const ScheduledDeparture* run = departureTable + entry.first;
+    uint32_t low = 0;
+    uint32_t high = entry.count;
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if ((int)run[mid].minute < minMinute)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    int offered = 0;
+    for (uint32_t i = low; i < entry.count && offered < MAX_DEPARTURES; i++)
+    {
+        const ScheduledDeparture& scheduled = run[i];
+
+        // Local wall time to UTC; the second lookup settles days with a DST switch
+        time_t local = localMidnight + (time_t)scheduled.minute * 60;
+        time_t departureTime = local - getUtcOffset(local - getUtcOffset(local));
+        if (departureTime <= after)
+        {
+            continue;
+        }
+
+        Departure dep = {};
+        dep.departureTime = departureTime;
+        dep.tripKey = scheduled.tripKey;
+        dep.eta = (int16_t)((departureTime - now) / 60);
+        dep.stopIndex = (int8_t)configuredStop;
+        dep.isScheduled = true;
+        if (!collector.setLabels(dep, getString(scheduled.lineOffset), getString(scheduled.destinationOffset)))
+        {
+            break;
+        }
+        collector.add(dep);
+        offered++;
+    }
+    return offered;
+}
@@ -0,0 +1,130 @@
+#ifndef STATICSCHEDULE_H
+#define STATICSCHEDULE_H
+
+#include "DepartureData.h"
+#include "DepartureCollector.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+// ============================================================================
+// Offline Static Schedule (timetable in the spiffs partition)
+// ============================================================================
+
+/**
+ * Scheduled departures of the configured stops, read from a timetable image
+ * flashed raw into the (otherwise unused) spiffs partition.
+ *
+ * The image is built on a PC from GTFS static by scripts/build_schedule.py
+ * and written with esptool (see docs/ARCHITECTURE.md). The partition is
+ * memory-mapped, so a lookup is a binary search over flash - no file
+ * system, no copies, nothing allocated.
+ *
+ * Image layout (little-endian, offsets from the image start, 4-byte aligned):
+ *
+ *   Header            36 bytes (see below)
+ *   Stop table        uint32 stopIdOffset[stopCount]  (into the string blob)
+ *   Day table         DayEntry[dayCount][stopCount]
+ *   Departures        ScheduledDeparture[departureCount]
+ *   String blob       NUL-terminated UTF-8 strings
+ *
+ * A DayEntry is the run of departures one stop has on one service day,
+ * sorted by minute. Days with the same timetable share their run, so the
+ * image holds each distinct timetable once.
+ */
+class StaticSchedule
+{
+public:
+    static constexpr uint32_t MAGIC = 0x54545053;  // "SPTT"
+    static constexpr uint16_t VERSION = 1;
+    static constexpr int MAX_STOPS = 32;            // Configured stops matched against the image
+
+    struct Header
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t stopCount;
+        int32_t firstDay;          // Service date of day 0, in days since 1970-01-01
+        uint16_t dayCount;
+        uint16_t reserved;
+        uint32_t dayTableOffset;
+        uint32_t departureOffset;
+        uint32_t departureCount;
+        uint32_t stringOffset;
+        uint32_t totalSize;        // Whole image, header included
+    };
+
+    struct DayEntry
+    {
+        uint32_t first;  // Index of the first departure
+        uint32_t count;
+    };
+
+    struct ScheduledDeparture
+    {
+        uint32_t tripKey;            // hashTripId() of the GTFS trip_id
+        uint16_t minute;             // GTFS departure_time in minutes (can exceed 24 h)
+        uint16_t lineOffset;         // route_short_name in the string blob
+        uint16_t destinationOffset;  // trip_headsign in the string blob
+        uint16_t reserved;
+    };
+
+    static StaticSchedule& getInstance();
+
+    /**
+     * Map the data partition (spiffs, or $SPOJBOARD_DATA on the host) and validate the image
+     * @return false if the partition holds no valid timetable
+     */
+    bool begin();
+
+    /**
+     * Use an image that is already in memory
+     * Public so a generated image can be checked on a PC
+     * @param data Image start
+     * @param size Bytes available at data
+     * @return false if the image is invalid
+     */
+    bool attach(const uint8_t* data, size_t size);
+
+    /**
+     * Match the configured stop IDs against the image's stops
+     * @param stopIds Comma-separated configured stop IDs
+     * @return Number of configured stops found in the image
+     */
+    int setStops(const char* stopIds);
+
+    /**
+     * Whether an image is mapped and at least one configured stop is in it
+     */
+    bool isAvailable() const { return header != nullptr && matchedStops > 0; }
+
+    /**
+     * Offer the scheduled departures after a time to a collector
+     * O(log n) per stop and service day; at most MAX_DEPARTURES records are
+     * read per run, since the collector keeps no more than that.
+     * @param now Current Unix time
+     * @param after Per-stop cut-off (Unix time; only later departures are offered), or nullptr
+     * @param collector Collector (already reset), receives departures marked isScheduled
+     * @return Number of departures offered
+     */
+    int collect(time_t now, const time_t* after, DepartureCollector& collector) const;
+
+private:
+    StaticSchedule();
+
+    const Header* header;
+    const uint32_t* stopTable;
+    const DayEntry* dayTable;
+    const ScheduledDeparture* departureTable;
+    const char* strings;
+    uint32_t stringSize;
+    int8_t imageStop[MAX_STOPS];  // Image stop index per configured stop, -1 if missing
+    int configuredStops;
+    int matchedStops;
+
+    const char* getString(uint32_t offset) const;
+    int collectRun(int day, int stop, int configuredStop, int minMinute, time_t after,
+                   time_t now, DepartureCollector& collector) const;
+};
+
+#endif // STATICSCHEDULE_H
@@ -18,14 +18,18 @@ public:
     struct APIResult
     {
         Departure departures[MAX_DEPARTURES];
+        DepartureStrings strings;  // Lines and destinations referenced by departures
         int departureCount;
         char stopName[64];
         bool hasError;
         char errorMsg[64];
+        int refreshedStop;  // Stop index for fetchStopDepartures() results, -1 for all stops
+        bool truncated;     // Departures after the last one returned may be missing
     };
 
     typedef void (*APIStatusCallback)(const char* message);
-    typedef void (*APIPartialResultsCallback)(const Departure* departures, int count, const char* stopName);
+    typedef void (*APIPartialResultsCallback)(const Departure* departures, const DepartureStrings& strings,
+                                              int count, const char* stopName);
 
     virtual ~TransitAPI() = default;
 
@@ -48,6 +52,15 @@ public:
      * @return APIResult with departures, count, and error status
      */
     virtual APIResult fetchDepartures(const Config &config) = 0;
+
+    /**
+     * Fetch departures of a single configured stop
+     * Used for staggered per-stop refreshes; the result is merged into the cache
+     * @param config Configuration with API key, stop IDs, and filters
+     * @param stopIndex Index of the stop in the configured stop ID list
+     * @return APIResult with this stop's departures only (refreshedStop = stopIndex)
+     */
+    virtual APIResult fetchStopDepartures(const Config &config, int stopIndex) = 0;
 };
 
 #endif // TRANSITAPI_H
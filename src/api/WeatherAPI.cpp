@@ -1,5 +1,8 @@
 #include "WeatherAPI.h"
 #include "../utils/Logger.h"
+#include "../utils/TimeUtils.h"
+#include "../utils/Metrics.h"
+#include "../hal/Clock.h"
 #include <ArduinoJson.h>
 
 // Platform-specific HTTP client includes
@@ -7,7 +10,7 @@
     #include <WiFiNINA.h>
     #include <ArduinoHttpClient.h>
 #else
-    #include <HTTPClient.h>
+    #include "../network/HttpConnectionManager.h"
 #endif
 
 WeatherAPI::WeatherAPI()
@@ -20,7 +23,7 @@ WeatherData WeatherAPI::fetchWeather(float latitude, float longitude)
     result.hasError = false;
     result.temperature = 0;
     result.weatherCode = 0;
-    time(&result.timestamp);
+    result.timestamp = getCurrentEpochTime();
 
     logTimestamp();
     debugPrintln("Weather: Starting fetch...");
@@ -67,7 +70,7 @@ WeatherData WeatherAPI::fetchWeather(float latitude, float longitude)
             char retryMsg[64];
             snprintf(retryMsg, sizeof(retryMsg), "Weather: Retry %d/%d after %dms", attempt, MAX_RETRIES, delayMs);
             debugPrintln(retryMsg);
-            delay(delayMs);
+            clockDelay(delayMs);
         }
 
         logTimestamp();
@@ -135,10 +138,9 @@ WeatherData WeatherAPI::fetchWeather(float latitude, float longitude)
     http.stop();
 
 #else
-    // ESP32 uses native HTTPClient
-    HTTPClient http;
-    char url[256];
-    snprintf(url, sizeof(url), "https://api.open-meteo.com%s", path);
+    // ESP32 uses native HTTPClient over a shared keep-alive connection
+    HttpConnectionManager &connections = HttpConnectionManager::getInstance();
+    const HttpConnectionManager::Host host = HttpConnectionManager::HOST_OPEN_METEO;
 
     // Retry logic (up to MAX_RETRIES attempts)
     for (int attempt = 1; attempt <= MAX_RETRIES; attempt++)
@@ -151,16 +153,13 @@ WeatherData WeatherAPI::fetchWeather(float latitude, float longitude)
             debugPrint(String(attempt - 1).c_str());
             debugPrint("/");
             debugPrintln(String(MAX_RETRIES - 1).c_str());
-            delay(delayMs);
+            clockDelay(delayMs);
         }
 
-        http.begin(url);
-        http.setTimeout(HTTP_TIMEOUT_MS);
-
         logTimestamp();
         debugPrintln("Weather: Sending HTTP GET...");
 
-        httpCode = http.GET();
+        httpCode = connections.get(host, path, nullptr, 0, HTTP_TIMEOUT_MS);
 
         logTimestamp();
         debugPrint("Weather: HTTP code: ");
@@ -168,12 +167,12 @@ WeatherData WeatherAPI::fetchWeather(float latitude, float longitude)
 
         if (httpCode == HTTP_CODE_OK)
         {
-            payload = http.getString();
-            http.end();
+            payload = connections.getBodyString(host);
+            connections.end(host);
             break;
         }
 
-        http.end();
+        connections.end(host);
 
         // Don't retry on 4xx client errors
         if (httpCode >= 400 && httpCode < 500)
@@ -205,6 +204,8 @@ WeatherData WeatherAPI::fetchWeather(float latitude, float longitude)
     // Parse JSON response
     DynamicJsonDocument doc(JSON_BUFFER_SIZE);
     DeserializationError error = deserializeJson(doc, payload);
+    Metrics::getInstance().recordJsonDocument(Metrics::JSON_DOC_WEATHER, doc.memoryUsage(), JSON_BUFFER_SIZE,
+                                              doc.overflowed() || error == DeserializationError::NoMemory);
 
     if (error)
     {
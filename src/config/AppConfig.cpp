@@ -16,7 +16,7 @@
 
 // Storage signature for validation
 // Bump this value to invalidate stored configs and force fresh defaults
-#define CONFIG_SIGNATURE 0x53504F4C  // Bumped to change minDepartureTime default
+#define CONFIG_SIGNATURE 0x53504F50  // Bumped for the API base URL override
 
 struct StoredConfig {
     uint32_t signature;
@@ -42,6 +42,8 @@ void loadConfig(Config& config)
         strlcpy(config.pragueStopIds, DEFAULT_PRAGUE_STOP_IDS, sizeof(config.pragueStopIds));
         strlcpy(config.city, "Prague", sizeof(config.city));
         config.refreshInterval = 300;
+        config.adaptiveRefresh = true;
+        config.minRefreshInterval = 30;
         config.numDepartures = 3;
         config.minDepartureTime = 3;
         config.brightness = 45;
@@ -86,9 +88,18 @@ void loadConfig(Config& config)
     Serial.println(config.pragueStopIds);
     Serial.print("  Berlin Stops: ");
     Serial.println(strlen(config.berlinStopIds) > 0 ? config.berlinStopIds : "Not set");
+    Serial.print("  GTFS-RT Feed: ");
+    Serial.println(strlen(config.gtfsRtFeedUrl) > 0 ? config.gtfsRtFeedUrl : "Not set");
     Serial.print("  Refresh: ");
     Serial.print(config.refreshInterval);
-    Serial.println("s");
+    Serial.print("s");
+    if (config.adaptiveRefresh)
+    {
+        Serial.print(" (adaptive, min ");
+        Serial.print(config.minRefreshInterval);
+        Serial.print("s)");
+    }
+    Serial.println();
     Serial.print("  Weather: ");
     Serial.print(config.weatherEnabled ? "Enabled" : "Disabled");
     Serial.print(" (");
@@ -144,6 +155,10 @@ void loadConfig(Config& config)
     strlcpy(config.pragueApiKey, preferences.getString("pragueApiKey", "").c_str(), sizeof(config.pragueApiKey));
     strlcpy(config.pragueStopIds, preferences.getString("pragueStopIds", DEFAULT_PRAGUE_STOP_IDS).c_str(), sizeof(config.pragueStopIds));
     strlcpy(config.berlinStopIds, preferences.getString("berlinStopIds", "").c_str(), sizeof(config.berlinStopIds));
+    strlcpy(config.pragueAbbreviations, preferences.getString("pragueAbbrev", "").c_str(), sizeof(config.pragueAbbreviations));
+    strlcpy(config.berlinAbbreviations, preferences.getString("berlinAbbrev", "").c_str(), sizeof(config.berlinAbbreviations));
+    strlcpy(config.gtfsRtFeedUrl, preferences.getString("gtfsRtUrl", "").c_str(), sizeof(config.gtfsRtFeedUrl));
+    strlcpy(config.gtfsRtStopIds, preferences.getString("gtfsRtStops", "").c_str(), sizeof(config.gtfsRtStopIds));
 
     // Backward compatibility: Migrate old config format to new per-city fields
     // If old fields exist and new fields are empty, migrate the data
@@ -171,6 +186,8 @@ void loadConfig(Config& config)
     }
 
     config.refreshInterval = preferences.getInt("refresh", 300);
+    config.adaptiveRefresh = preferences.getBool("adaptRefresh", true);  // Default: schedule from cache
+    config.minRefreshInterval = preferences.getInt("minRefresh", 30);
     config.numDepartures = preferences.getInt("numDeps", 3);     // Display rows (1-3)
     config.minDepartureTime = preferences.getInt("minDepTime", 3);
     config.brightness = preferences.getInt("brightness", 90);
@@ -178,6 +195,7 @@ void loadConfig(Config& config)
     strlcpy(config.city, preferences.getString("city", "Prague").c_str(), sizeof(config.city));  // Default: Prague for backward compatibility
     config.debugMode = preferences.getBool("debugMode", false);  // Default: disabled
     config.noApFallback = preferences.getBool("noApFallback", true);  // Default: keep retrying WiFi
+    strlcpy(config.apiBaseUrl, preferences.getString("apiBaseUrl", "").c_str(), sizeof(config.apiBaseUrl));
 
     // Load weather configuration
     config.weatherEnabled = preferences.getBool("weatherEnable", false);  // Default: disabled
@@ -202,9 +220,23 @@ void loadConfig(Config& config)
     Serial.println(config.pragueStopIds);
     Serial.print("  Berlin Stops: ");
     Serial.println(strlen(config.berlinStopIds) > 0 ? config.berlinStopIds : "Not set");
+    Serial.print("  GTFS-RT Feed: ");
+    Serial.println(strlen(config.gtfsRtFeedUrl) > 0 ? config.gtfsRtFeedUrl : "Not set");
     Serial.print("  Refresh: ");
     Serial.print(config.refreshInterval);
-    Serial.println("s");
+    Serial.print("s");
+    if (config.adaptiveRefresh)
+    {
+        Serial.print(" (adaptive, min ");
+        Serial.print(config.minRefreshInterval);
+        Serial.print("s)");
+    }
+    Serial.println();
+    if (strlen(config.apiBaseUrl) > 0)
+    {
+        Serial.print("  API Server Override: ");
+        Serial.println(config.apiBaseUrl);
+    }
     Serial.print("  Configured: ");
     Serial.println(config.configured ? "Yes" : "No");
 }
@@ -221,6 +253,10 @@ void saveConfig(const Config& config)
     preferences.putString("pragueApiKey", config.pragueApiKey);
     preferences.putString("pragueStopIds", config.pragueStopIds);
     preferences.putString("berlinStopIds", config.berlinStopIds);
+    preferences.putString("pragueAbbrev", config.pragueAbbreviations);
+    preferences.putString("berlinAbbrev", config.berlinAbbreviations);
+    preferences.putString("gtfsRtUrl", config.gtfsRtFeedUrl);
+    preferences.putString("gtfsRtStops", config.gtfsRtStopIds);
 
     // Remove old keys if they exist (cleanup after migration)
     if (preferences.isKey("apiKey"))
@@ -233,6 +269,8 @@ void saveConfig(const Config& config)
     }
 
     preferences.putInt("refresh", config.refreshInterval);
+    preferences.putBool("adaptRefresh", config.adaptiveRefresh);
+    preferences.putInt("minRefresh", config.minRefreshInterval);
     preferences.putInt("numDeps", config.numDepartures);
     preferences.putInt("minDepTime", config.minDepartureTime);
     preferences.putInt("brightness", config.brightness);
@@ -240,6 +278,7 @@ void saveConfig(const Config& config)
     preferences.putString("city", config.city);
     preferences.putBool("debugMode", config.debugMode);
     preferences.putBool("noApFallback", config.noApFallback);
+    preferences.putString("apiBaseUrl", config.apiBaseUrl);
 
     // Save weather configuration
     preferences.putBool("weatherEnable", config.weatherEnabled);
@@ -30,6 +30,18 @@
 #define PANEL_HEIGHT 32
 #define PANELS_NUMBER 2 // 128x32 total
 
+// Double-buffered HUB75 output (ESP32-S3): frames are composed in a second DMA
+// buffer and shown by an atomic buffer flip, so no partial frame is ever visible.
+// Costs a second frame buffer of internal SRAM; if less than that plus the
+// reserve is free at boot, the display falls back to a single buffer.
+// Enable with -DDISPLAY_DOUBLE_BUFFER=1 in build_flags. The M4 is always double-buffered.
+#ifndef DISPLAY_DOUBLE_BUFFER
+#define DISPLAY_DOUBLE_BUFFER 0
+#endif
+#ifndef DISPLAY_DOUBLE_BUFFER_RESERVE
+#define DISPLAY_DOUBLE_BUFFER_RESERVE (96 * 1024) // Internal SRAM left for WiFi, TLS and JSON
+#endif
+
 // Pin Mapping for Adafruit MatrixPortal ESP32-S3
 #define R1_PIN 42
 #define G1_PIN 40
@@ -65,16 +77,23 @@ struct Config
     char pragueApiKey[300];    // Golemio API key for Prague
     char pragueStopIds[128];   // Prague stop IDs (e.g., "U693Z2P,U693Z1P")
     char berlinStopIds[128];   // Berlin stop IDs (e.g., "900013102")
+    char pragueAbbreviations[256]; // Extra destination abbreviations (format: "Nádraží=Nádr.,Sídliště=Sídl.")
+    char berlinAbbreviations[256]; // Same for Berlin (format: "Hauptbahnhof=Hbf,S+U =")
     // Note: Berlin BVG API requires no authentication
+    char gtfsRtFeedUrl[160];   // GTFS-Realtime TripUpdates feed (https://, any key as a query parameter)
+    char gtfsRtStopIds[128];   // GTFS stop_id values to show from that feed
 
-    int refreshInterval;    // Seconds between API calls
+    int refreshInterval;    // Seconds between API calls (upper bound when adaptiveRefresh is on)
+    bool adaptiveRefresh;   // Schedule fetches from cached departures (see RefreshScheduler)
+    int minRefreshInterval; // Lower bound in seconds for adaptive refresh
     int numDepartures;      // Number of departures to display (1-3 rows on LED matrix)
     int minDepartureTime;   // Minimum departure time in minutes (filter out departures < this)
     int brightness;         // Display brightness (0-255)
     char lineColorMap[256]; // Line color mappings (format: "A=GREEN,B=YELLOW,9*=CYAN")
-    char city[16];          // Transit city: "Prague" or "Berlin"
+    char city[16];          // Transit city: "Prague", "Berlin" or "GTFS-RT"
     bool debugMode;         // Enable telnet logging and verbose output
     bool noApFallback;      // If true, keep retrying WiFi instead of falling back to AP mode
+    char apiBaseUrl[64];    // Stand-in API server (scripts/api_standin.py), empty = live services (ESP32 only)
 
     // Weather configuration
     bool weatherEnabled;        // Enable weather display
@@ -2,7 +2,6 @@
 #define DISPLAYCOLORS_H
 
 #include <stdint.h>
-#include <Adafruit_GFX.h>
 
 // ============================================================================
 // Color Definitions (RGB565 format)
@@ -1,13 +1,15 @@
 #include "DisplayManager.h"
 #include "../utils/TimeUtils.h"
 #include "../utils/gfxlatin2.h"
+#include "../hal/Clock.h"
 #include <Arduino.h>
 
 // Platform-specific includes
 #if defined(MATRIX_PORTAL_M4)
     #include <WiFiNINA.h>
-#else
+#elif !defined(NATIVE_HOST)
     #include <WiFi.h>
+    #include <esp_heap_caps.h>
 #endif
 
 // Font references from src/fonts/ directory
@@ -18,10 +20,19 @@
 
 // WeatherAPI for data structure
 #include "../api/WeatherAPI.h"
+#include "../utils/Metrics.h"
+#include "../utils/Logger.h"
 
 DisplayManager::DisplayManager()
-    : display(nullptr), isDrawing(false), screenOff(false), forceRedraw(false), config(nullptr), weatherData(nullptr)
+    : display(nullptr), isDrawing(false), screenOff(false), forceRedraw(false), config(nullptr), weatherData(nullptr),
+      backBuffer(0), nextFrame(0), doubleBuffered(false), framePeriodMs(0), lastFramePixels(0)
 {
+    for (int i = 0; i < DISPLAY_FRAME_SLOTS; i++)
+    {
+        frameItemCount[i] = 0;
+    }
+    bufferFrame[0] = -1;
+    bufferFrame[1] = -1;
     fontSmall = &DepartureMono_Regular4pt8b;
     fontMedium = &DepartureMono_Regular5pt8b;
     fontCondensed = &DepartureMono_Condensed5pt8b;
@@ -73,6 +84,11 @@ bool DisplayManager::begin(int brightness)
     display->fillScreen(0);
     display->show();
 
+#elif defined(NATIVE_HOST)
+    doubleBuffered = DISPLAY_DOUBLE_BUFFER != 0;
+    display = new FrameCanvas(PANEL_WIDTH * PANELS_NUMBER, PANEL_HEIGHT, doubleBuffered);
+    display->setBrightness8(brightness);
+
 #else
     // ESP32-S3 pin configuration for I2S DMA
     HUB75_I2S_CFG::i2s_pins _pins = {
@@ -89,16 +105,64 @@ bool DisplayManager::begin(int brightness)
     mxconfig.clkphase = false;
     mxconfig.i2sspeed = HUB75_I2S_CFG::HZ_10M;
 
+    // One DMA frame buffer: a 16-bit word per pixel and colour bit plane for each row pair
+    // (8 bit planes is the library default)
+    size_t bufferBytes = (size_t)PANEL_WIDTH * PANELS_NUMBER * (PANEL_HEIGHT / 2) * 8 * sizeof(uint16_t);
+    char msg[128];
+
+    doubleBuffered = DISPLAY_DOUBLE_BUFFER != 0;
+    if (doubleBuffered)
+    {
+        size_t freeDma = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+        if (freeDma < 2 * bufferBytes + DISPLAY_DOUBLE_BUFFER_RESERVE)
+        {
+            snprintf(msg, sizeof(msg), "DISPLAY: %u bytes of DMA SRAM free, double buffer needs %u + %u reserve - single buffer",
+                     (unsigned)freeDma, (unsigned)(2 * bufferBytes), (unsigned)DISPLAY_DOUBLE_BUFFER_RESERVE);
+            logTimestamp();
+            debugPrintln(msg);
+            doubleBuffered = false;
+        }
+    }
+
+    size_t freeBefore = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    mxconfig.double_buff = doubleBuffered;
     display = new MatrixPanel_I2S_DMA(mxconfig);
+    bool started = display->begin();
+
+    if (!started && doubleBuffered)
+    {
+        // Enough SRAM in total, but too fragmented for the second buffer
+        logTimestamp();
+        debugPrintln("DISPLAY: Double-buffered init failed - single buffer");
+        delete display;
+        doubleBuffered = false;
+        mxconfig.double_buff = false;
+        display = new MatrixPanel_I2S_DMA(mxconfig);
+        started = display->begin();
+    }
 
-    if (!display->begin())
+    if (!started)
     {
         Serial.println("Display FAILED!");
         return false;
     }
 
+    size_t freeAfter = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    snprintf(msg, sizeof(msg), "DISPLAY: %s buffer, %u bytes of internal SRAM (%u left)",
+             doubleBuffered ? "Double" : "Single", (unsigned)(freeBefore - freeAfter), (unsigned)freeAfter);
+    logTimestamp();
+    debugPrintln(msg);
+
+    // The driver refreshes at least min_refresh_rate times a second (60 by default)
+    framePeriodMs = 1000 / mxconfig.min_refresh_rate + 1;
+
     display->setBrightness8(brightness);
     display->fillScreen(0);
+    if (doubleBuffered)
+    {
+        showFrame();
+        display->fillScreen(0);
+    }
 #endif
 
     // Initialize color constants (platform-independent)
@@ -124,12 +188,12 @@ void DisplayManager::setBrightness(int brightness)
 void DisplayManager::turnOff()
 {
     screenOff = true;
+    invalidateFrame();
     if (display)
     {
         display->fillScreen(0);
-#if defined(MATRIX_PORTAL_M4)
-        display->show();
-#else
+        showFrame();
+#if !defined(MATRIX_PORTAL_M4)
         display->setBrightness8(0);
 #endif
     }
@@ -149,61 +213,356 @@ void DisplayManager::turnOn()
 
 const char* DisplayManager::getLocalIPString()
 {
+#if defined(NATIVE_HOST)
+    strlcpy(ipStringBuffer, "192.168.1.50", sizeof(ipStringBuffer));  // Fixed for reproducible frames
+#else
     IPAddress ip = WiFi.localIP();
     sprintf(ipStringBuffer, "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+#endif
     return ipStringBuffer;
 }
 
-void DisplayManager::drawDeparture(int row, const Departure &dep)
+// ============================================================================
+// Frame Model
+// ============================================================================
+
+void DisplayManager::beginFrame()
+{
+    // Any slot not held by a frame buffer
+    nextFrame = 0;
+    while (nextFrame == bufferFrame[0] || nextFrame == bufferFrame[1])
+    {
+        nextFrame++;
+    }
+    frameItemCount[nextFrame] = 0;
+}
+
+int16_t DisplayManager::addText(const GFXfont* font, uint16_t color, int16_t x, int16_t y, const char* text)
+{
+    int& count = frameItemCount[nextFrame];
+    if (text[0] == '\0' || count >= MAX_DISPLAY_ITEMS)
+    {
+        return x;  // Nothing to draw (the limit is sized for the largest screen)
+    }
+
+    DisplayItem& item = frameItems[nextFrame][count++];
+    item.font = font;
+    item.x = x;
+    item.y = y;
+    item.color = color;
+    strlcpy(item.text, text, sizeof(item.text));
+
+    // Same wrapping rules as print(), so the box covers every glyph drawn
+    int16_t x1, y1;
+    uint16_t w, h;
+    display->setFont(font);
+    display->getTextBounds(item.text, x, y, &x1, &y1, &w, &h);
+    item.boxX = x1;
+    item.boxY = y1;
+    item.boxW = w;
+    item.boxH = h;
+
+    // Cursor after the text (for runs continuing in another font or color)
+    for (const char* c = item.text; *c; c++)
+    {
+        uint8_t ch = (uint8_t)*c;
+        if (ch >= font->first && ch <= font->last)
+        {
+            x += pgm_read_byte(&font->glyph[ch - font->first].xAdvance);
+        }
+    }
+    return x;
+}
+
+void DisplayManager::addFill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    int& count = frameItemCount[nextFrame];
+    if (count >= MAX_DISPLAY_ITEMS)
+    {
+        return;
+    }
+
+    DisplayItem& item = frameItems[nextFrame][count++];
+    item.font = nullptr;
+    item.x = x;
+    item.y = y;
+    item.color = color;
+    item.boxX = x;
+    item.boxY = y;
+    item.boxW = w;
+    item.boxH = h;
+    item.text[0] = '\0';
+}
+
+struct DirtyRect
+{
+    int16_t x0, y0, x1, y1;  // Exclusive end
+};
+
+// Item box clipped to the panel; false if nothing of it is visible
+static bool clipBox(const DisplayItem& item, int16_t width, int16_t height, DirtyRect& rect)
+{
+    rect.x0 = item.boxX < 0 ? 0 : item.boxX;
+    rect.y0 = item.boxY < 0 ? 0 : item.boxY;
+    rect.x1 = item.boxX + item.boxW > width ? width : item.boxX + item.boxW;
+    rect.y1 = item.boxY + item.boxH > height ? height : item.boxY + item.boxH;
+    return rect.x0 < rect.x1 && rect.y0 < rect.y1;
+}
+
+static bool overlaps(const DirtyRect& a, const DirtyRect& b)
+{
+    return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+}
+
+// Add a box to the dirty area unless an earlier box already covers it; false if it was covered
+static bool addDirty(DirtyRect* dirty, int& count, const DirtyRect& rect)
+{
+    for (int d = 0; d < count; d++)
+    {
+        if (dirty[d].x0 <= rect.x0 && dirty[d].y0 <= rect.y0 && dirty[d].x1 >= rect.x1 && dirty[d].y1 >= rect.y1)
+        {
+            return false;
+        }
+    }
+    dirty[count++] = rect;
+    return true;
+}
+
+static bool sameItem(const DisplayItem& a, const DisplayItem& b)
+{
+    return a.font == b.font && a.x == b.x && a.y == b.y && a.color == b.color && a.boxX == b.boxX &&
+           a.boxY == b.boxY && a.boxW == b.boxW && a.boxH == b.boxH && strcmp(a.text, b.text) == 0;
+}
+
+static bool sameFrame(const DisplayItem* a, int countA, const DisplayItem* b, int countB)
+{
+    if (countA != countB)
+    {
+        return false;
+    }
+    for (int i = 0; i < countA; i++)
+    {
+        if (!sameItem(a[i], b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Items of a frame are mostly unchanged and in the same slot, so look there first
+static bool containsItem(const DisplayItem* items, int count, int slot, const DisplayItem& item)
+{
+    if (slot < count && sameItem(items[slot], item))
+    {
+        return true;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (sameItem(items[i], item))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DisplayManager::drawItem(const DisplayItem& item)
+{
+    if (item.font == nullptr)
+    {
+        display->fillRect(item.boxX, item.boxY, item.boxW, item.boxH, item.color);
+        return;
+    }
+
+    display->setFont(item.font);
+    display->setTextColor(item.color);
+    display->setCursor(item.x, item.y);
+    display->print(item.text);
+}
+
+void DisplayManager::showFrame()
+{
+#if defined(MATRIX_PORTAL_M4)
+    display->show();
+#else
+    // The flip takes effect at the end of the DMA frame being output: until then
+    // the new back buffer is still on the panel. The driver has no public
+    // frame-done state, so wait out one refresh before anything draws into it.
+    if (doubleBuffered)
+    {
+        display->flipDMABuffer();
+        clockDelay(framePeriodMs);
+    }
+#endif
+}
+
+void DisplayManager::paintFrame()
+{
+    const DisplayItem* next = frameItems[nextFrame];
+    int nextCount = frameItemCount[nextFrame];
+
+    // Nothing to do if the panel already shows this frame (double-buffered, the
+    // buffer drawn into may still hold an older one)
+    int shownSlot = bufferFrame[doubleBuffered ? 1 - backBuffer : backBuffer];
+    if (shownSlot >= 0 && sameFrame(frameItems[shownSlot], frameItemCount[shownSlot], next, nextCount))
+    {
+        lastFramePixels = 0;
+        Metrics::getInstance().recordFrame(0, false);
+        return;
+    }
+
+    int drawnSlot = bufferFrame[backBuffer];
+    const DisplayItem* drawn = frameItems[drawnSlot < 0 ? nextFrame : drawnSlot];
+    int drawnCount = drawnSlot < 0 ? 0 : frameItemCount[drawnSlot];
+    int16_t width = display->width();
+    int16_t height = display->height();
+
+    DirtyRect dirty[2 * MAX_DISPLAY_ITEMS];
+    int dirtyCount = 0;
+    bool redraw[MAX_DISPLAY_ITEMS];
+    DirtyRect rect;
+    uint32_t pixels = 0;
+    bool fullRedraw = drawnSlot < 0;
+
+    if (!fullRedraw)
+    {
+        // Removed items leave their box to clear, new or changed items need theirs
+        for (int i = 0; i < drawnCount; i++)
+        {
+            if (!containsItem(next, nextCount, i, drawn[i]) && clipBox(drawn[i], width, height, rect))
+            {
+                addDirty(dirty, dirtyCount, rect);
+            }
+        }
+        for (int i = 0; i < nextCount; i++)
+        {
+            redraw[i] = !containsItem(drawn, drawnCount, i, next[i]);
+            if (redraw[i] && clipBox(next[i], width, height, rect))
+            {
+                addDirty(dirty, dirtyCount, rect);
+            }
+        }
+
+        // Unchanged items overlapping a dirty box lose pixels to the clear:
+        // redraw them too, and grow the dirty area by their box so the redraw
+        // cannot paint over a later item outside it
+        bool grown = dirtyCount > 0;
+        while (grown)
+        {
+            grown = false;
+            for (int i = 0; i < nextCount; i++)
+            {
+                if (redraw[i] || !clipBox(next[i], width, height, rect))
+                {
+                    continue;
+                }
+                for (int d = 0; d < dirtyCount; d++)
+                {
+                    if (overlaps(rect, dirty[d]))
+                    {
+                        redraw[i] = true;
+                        addDirty(dirty, dirtyCount, rect);
+                        grown = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Area cleared and redrawn (overlapping boxes count twice until it adds up to the panel)
+        for (int d = 0; d < dirtyCount; d++)
+        {
+            pixels += (uint32_t)(dirty[d].x1 - dirty[d].x0) * (dirty[d].y1 - dirty[d].y0);
+        }
+
+        // A new screen clears more than the panel in overlapping boxes: one fill is cheaper
+        fullRedraw = pixels >= (uint32_t)width * height;
+        for (int d = 0; d < dirtyCount && !fullRedraw; d++)
+        {
+            display->fillRect(dirty[d].x0, dirty[d].y0, dirty[d].x1 - dirty[d].x0, dirty[d].y1 - dirty[d].y0,
+                              COLOR_BLACK);
+        }
+    }
+
+    if (fullRedraw)
+    {
+        display->fillScreen(0);
+        pixels = (uint32_t)width * height;
+        for (int i = 0; i < nextCount; i++)
+        {
+            redraw[i] = true;
+        }
+    }
+
+    if (pixels > 0)
+    {
+        clockDelay(1);
+        for (int i = 0; i < nextCount; i++)
+        {
+            if (redraw[i])
+            {
+                drawItem(next[i]);
+            }
+        }
+        clockDelay(1);
+    }
+
+    // The buffer may already have held this frame while the panel showed another: flip anyway
+    bufferFrame[backBuffer] = nextFrame;
+    if (pixels > 0 || doubleBuffered)
+    {
+        showFrame();
+    }
+    if (doubleBuffered)
+    {
+        backBuffer = 1 - backBuffer;
+    }
+    lastFramePixels = pixels;
+    Metrics::getInstance().recordFrame(pixels, fullRedraw);
+}
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+void DisplayManager::layoutDeparture(int row, const Departure &dep, const DepartureStrings &strings)
 {
     int y = row * 8; // Each row is 8 pixels
 
-    // Convert line number and destination to ISO-8859-2 (in-place)
-    char lineConverted[8];
-    char destConverted[32];
-    strlcpy(lineConverted, dep.line, sizeof(lineConverted));
-    strlcpy(destConverted, dep.destination, sizeof(destConverted));
-    utf8tocp(lineConverted);
-    utf8tocp(destConverted);
+    // Strings are already GFX Latin 2 (converted when the departure was parsed)
+    const char *line = strings.get(dep.lineId);
+    const char *destination = strings.get(dep.destinationId);
 
     // Draw line number background - always black (fixed width for all routes)
-    uint16_t lineColor = getLineColorWithConfig(dep.line, config ? config->lineColorMap : "");
+    uint16_t lineColor = getLineColorWithConfig(line, config ? config->lineColorMap : "");
     int bgWidth = 18; // Fixed width to fit up to 3 characters
-    display->fillRect(1, y + 1, bgWidth, 7, COLOR_BLACK);
-
-    // Line number text - colored text on black background
-    display->setTextColor(lineColor);
-    display->setFont(fontMedium);
+    addFill(1, y + 1, bgWidth, 7, COLOR_BLACK);
 
     // Center the line number text within the background rectangle
     int16_t x1, y1;
     uint16_t w, h;
-    display->getTextBounds(lineConverted, 0, 0, &x1, &y1, &w, &h);
+    display->setFont(fontMedium);
+    display->getTextBounds(line, 0, 0, &x1, &y1, &w, &h);
     // Account for font's left bearing offset (x1) when centering
     int textX = 1 + (bgWidth - w) / 2 - x1;
-    // Align baseline with destination (y + 7)
-    display->setCursor(textX, y + 7);
-    display->print(lineConverted);
+    // Line number text - colored text on black background, baseline aligned with destination (y + 7)
+    addText(fontMedium, lineColor, textX, y + 7, line);
 
     // Direction indicator (R/L) before destination based on stop index
     int destX = 20; // Fixed position for all destinations (18px max route width + 2px gap)
+    bool hasIndicator = (dep.stopIndex == 0 || dep.stopIndex == 1);
     if (dep.stopIndex == 0) {
-        display->setTextColor(COLOR_GREEN);
-        display->setCursor(destX, y + 7);
-        display->print("R");
+        addText(fontMedium, COLOR_GREEN, destX, y + 7, "R");
         destX += 8;
     } else if (dep.stopIndex == 1) {
-        display->setTextColor(COLOR_BLUE);
-        display->setCursor(destX, y + 7);
-        display->print("L");
+        addText(fontMedium, COLOR_BLUE, destX, y + 7, "L");
         destX += 8;
     }
 
     // Destination - use condensed font for long names, always white
-    display->setTextColor(COLOR_WHITE);
-
-    int destLen = strlen(destConverted);
-    int normalMaxChars = (dep.stopIndex <= 1) ? 15 : 16;
+    int destLen = strlen(destination);
+    int normalMaxChars = hasIndicator ? 15 : 16;
     const GFXfont* destFont;
     int maxChars;
 
@@ -214,7 +573,7 @@ void DisplayManager::drawDeparture(int row, const Departure &dep)
         // Long destination - use condensed font
         destFont = fontCondensed;
         int condensedMax = (dep.eta >= 10 || dep.eta < 1) ? 23 : 24;
-        maxChars = (dep.stopIndex <= 1) ? condensedMax - 1 : condensedMax;
+        maxChars = hasIndicator ? condensedMax - 1 : condensedMax;
     }
     else
     {
@@ -223,14 +582,11 @@ void DisplayManager::drawDeparture(int row, const Departure &dep)
         maxChars = normalMaxChars;
     }
 
-    display->setFont(destFont);
-    display->setCursor(destX, y + 7);
-
     // Truncate destination if needed
-    char destTrunc[24];
-    strncpy(destTrunc, destConverted, maxChars);
+    char destTrunc[25];
+    strncpy(destTrunc, destination, maxChars);
     destTrunc[maxChars] = '\0';
-    display->print(destTrunc);
+    addText(destFont, COLOR_WHITE, destX, y + 7, destTrunc);
 
     // ETA display
     int etaCursor = 117;
@@ -239,138 +595,123 @@ void DisplayManager::drawDeparture(int row, const Departure &dep)
         etaCursor = 111;
     }
 
-    display->setFont(fontMedium);
-    display->setCursor(etaCursor, y + 7);
-
-    // ETA color based on time
-    if (dep.eta <= 5)
+    // ETA color based on time; timetable fallback entries are always cyan
+    uint16_t etaColor;
+    if (dep.isScheduled)
+    {
+        etaColor = COLOR_CYAN;
+    }
+    else if (dep.eta <= 5)
     {
-        display->setTextColor(COLOR_RED);
+        etaColor = COLOR_RED;
     }
     else if (dep.eta == 6)
     {
-        display->setTextColor(COLOR_ORANGE);
+        etaColor = COLOR_ORANGE;
     }
     else
     {
-        display->setTextColor(COLOR_WHITE);
+        etaColor = COLOR_WHITE;
     }
 
     if (dep.eta < 1)
     {
-        display->print("<1'");
+        addText(fontMedium, etaColor, etaCursor, y + 7, "<1'");
     }
     else if (dep.eta >= 60)
     {
-        display->setCursor(etaCursor - 2, y + 7);
-        display->print(">");
-        display->setCursor(etaCursor + 6, y + 7);
-        display->print("1");
-        display->setFont(fontCondensed);
-        display->print("h");
-        display->setFont(fontMedium);
+        addText(fontMedium, etaColor, etaCursor - 2, y + 7, ">");
+        int16_t hourX = addText(fontMedium, etaColor, etaCursor + 6, y + 7, "1");
+        addText(fontCondensed, etaColor, hourX, y + 7, "h");
     }
     else
     {
-        display->print(dep.eta);
-        display->print("'");
+        char etaStr[8];
+        snprintf(etaStr, sizeof(etaStr), "%d'", dep.eta);
+        addText(fontMedium, etaColor, etaCursor, y + 7, etaStr);
     }
 }
 
-void DisplayManager::drawDateTime()
+void DisplayManager::layoutDateTime()
 {
     int y = 24; // Bottom row
 
     struct tm timeinfo;
     if (!getCurrentTime(&timeinfo))
     {
-        display->setTextColor(COLOR_RED);
-        display->setFont(fontSmall);
-        display->setCursor(2, y + 7);
-        display->print("Time Sync...");
+        addText(fontSmall, COLOR_RED, 2, y + 7, "Time Sync...");
         return;
     }
 
-    display->setFont(fontSmall);
-    display->setTextColor(COLOR_WHITE);
-
     // Day of week
     char dayStr[6];
     strftime(dayStr, 6, "%a ", &timeinfo);
     utf8tocp(dayStr); // Convert Czech day names
-    display->setCursor(2, y + 7);
-    display->print(dayStr);
+    addText(fontSmall, COLOR_WHITE, 2, y + 7, dayStr);
 
     // Date
     char dateStr[7];
     strftime(dateStr, 7, "%b %d", &timeinfo);
     utf8tocp(dateStr); // Convert Czech month names
-    display->setCursor(21, y + 7);
-    display->print(dateStr);
+    addText(fontSmall, COLOR_WHITE, 21, y + 7, dateStr);
 
     // Weather (only if enabled and valid data)
     if (config && config->weatherEnabled && weatherData && !weatherData->hasError)
     {
-        time_t now;
-        time(&now);
+        time_t now = getCurrentEpochTime();
 
         // Only show if data is fresh (< 30 min old)
         if (difftime(now, weatherData->timestamp) < 1800)
         {
-            // Switch to weather font
-            display->setFont(fontWeather);
-
-            // Get icon character and color for this weather code
-            char iconCode = mapWeatherCodeToIcon(weatherData->weatherCode);
-            uint16_t iconColor = getWeatherColor(weatherData->weatherCode);
+            // Icon at fixed left position (X=65, panel 2 start); letter 'a'-'t' renders as weather icon
+            char iconStr[2] = {mapWeatherCodeToIcon(weatherData->weatherCode), '\0'};
+            addText(fontWeather, getWeatherColor(weatherData->weatherCode), 65, y + 7, iconStr);
 
-            // Draw icon at fixed left position (X=65, panel 2 start)
-            display->setTextColor(iconColor);
-            display->setCursor(65, y + 7);
-            display->print(iconCode); // Letter 'a'-'t' renders as weather icon
-
-            // Draw temperature right-aligned to degree symbol at X=93
-            // with its own color
-            display->setTextColor(getTemperatureColor(weatherData->temperature));
+            // Temperature with degree symbol, in its own color
             char tempStr[8];
             snprintf(tempStr, sizeof(tempStr), "%d\xB0", weatherData->temperature);
 
             // Calculate text width and right-align to degree anchor (X=93)
             int16_t x1, y1;
             uint16_t w, h;
+            display->setFont(fontWeather);
             display->getTextBounds(tempStr, 0, 0, &x1, &y1, &w, &h);
             int tempX = 88 - w + x1; // Right-align to X=93, compensate for x1 offset
-
-            display->setCursor(tempX, y + 7);
-            display->print(tempStr); // Temperature with degree symbol
-
-            // Switch back to small font for time display
-            display->setFont(fontSmall);
-            display->setTextColor(COLOR_WHITE);
+            addText(fontWeather, getTemperatureColor(weatherData->temperature), tempX, y + 7, tempStr);
         }
     }
 
     // Time
     char timeStr[6];
     strftime(timeStr, 6, "%H:%M", &timeinfo);
-    display->setCursor(102, y + 7);
-    display->print(timeStr);
+    addText(fontSmall, COLOR_WHITE, 102, y + 7, timeStr);
 }
 
-void DisplayManager::drawErrorBar(const char *errorMsg)
+void DisplayManager::layoutErrorBar(const char *errorMsg)
 {
     int y = 24; // Bottom row
-    display->fillRect(0, y, 128, 8, COLOR_BLACK); // Clear bottom row
+    addFill(0, y, 128, 8, COLOR_BLACK); // Clear bottom row
 
-    display->setFont(fontSmall);
-    display->setTextColor(COLOR_RED);
-    display->setCursor(2, y + 7);
-    display->print("ERR: ");
-    display->print(errorMsg);
+    char errorStr[DISPLAY_ITEM_TEXT];
+    snprintf(errorStr, sizeof(errorStr), "ERR: %s", errorMsg);
+    addText(fontSmall, COLOR_RED, 2, y + 7, errorStr);
+}
+
+void DisplayManager::layoutStatus(const char *line1, const char *line2, uint16_t color)
+{
+    if (line1)
+    {
+        addText(fontMedium, color, 2, 12, line1);
+    }
+    if (line2)
+    {
+        addText(fontMedium, color, 2, 24, line2);
+    }
 }
 
 void DisplayManager::drawStatus(const char *line1, const char *line2, uint16_t color)
 {
+    invalidateFrame();
     display->fillScreen(0);
     display->setTextColor(color);
     display->setFont(fontMedium);
@@ -386,9 +727,7 @@ void DisplayManager::drawStatus(const char *line1, const char *line2, uint16_t c
         display->print(line2);
     }
 
-#if defined(MATRIX_PORTAL_M4)
-    display->show();
-#endif
+    showFrame();
 }
 
 void DisplayManager::drawOTAProgress(size_t progress, size_t total)
@@ -398,6 +737,7 @@ void DisplayManager::drawOTAProgress(size_t progress, size_t total)
 
     isDrawing = true;
 
+    invalidateFrame();
     display->fillScreen(0);
 
     // Title
@@ -434,8 +774,8 @@ void DisplayManager::drawOTAProgress(size_t progress, size_t total)
     // Display percentage text
     display->setFont(fontMedium);
     display->setTextColor(COLOR_WHITE);
-    char percentStr[8];
-    sprintf(percentStr, "%d%%", percentage);
+    char percentStr[16];
+    snprintf(percentStr, sizeof(percentStr), "%d%%", percentage);
 
     // Center the percentage text at the bottom
     int16_t x1, y1;
@@ -446,45 +786,30 @@ void DisplayManager::drawOTAProgress(size_t progress, size_t total)
     display->setCursor(textX, 31);
     display->print(percentStr);
 
-#if defined(MATRIX_PORTAL_M4)
-    display->show();
-#endif
+    showFrame();
 
     isDrawing = false;
 }
 
-void DisplayManager::drawAPMode(const char *ssid, const char *password)
+void DisplayManager::layoutAPMode(const char *ssid, const char *password)
 {
-    display->setFont(fontSmall);
-
     // Title
-    display->setTextColor(COLOR_CYAN);
-    display->setCursor(2, 7);
-    display->print("WiFi Setup Mode");
+    addText(fontSmall, COLOR_CYAN, 2, 7, "WiFi Setup Mode");
 
     // SSID
-    display->setTextColor(COLOR_WHITE);
-    display->setCursor(2, 15);
-    display->print("SSID:");
-    display->setTextColor(COLOR_YELLOW);
-    display->setCursor(32, 15);
-    display->print(ssid);
+    addText(fontSmall, COLOR_WHITE, 2, 15, "SSID:");
+    addText(fontSmall, COLOR_YELLOW, 32, 15, ssid);
 
     // Password
-    display->setTextColor(COLOR_WHITE);
-    display->setCursor(2, 23);
-    display->print("Pass:");
-    display->setTextColor(COLOR_GREEN);
-    display->setCursor(32, 23);
-    display->print(password);
+    addText(fontSmall, COLOR_WHITE, 2, 23, "Pass:");
+    addText(fontSmall, COLOR_GREEN, 32, 23, password);
 
     // IP
-    display->setTextColor(COLOR_WHITE);
-    display->setCursor(2, 31);
-    display->print("Go to: 192.168.4.1");
+    addText(fontSmall, COLOR_WHITE, 2, 31, "Go to: 192.168.4.1");
 }
 
-void DisplayManager::updateDisplay(const Departure *departures, int departureCount, int numToDisplay,
+void DisplayManager::updateDisplay(const Departure *departures, const DepartureStrings &strings,
+                                   int departureCount, int numToDisplay,
                                    bool wifiConnected, bool apModeActive,
                                    const char *apSSID, const char *apPassword,
                                    bool apiError, const char *apiErrorMsg,
@@ -499,124 +824,97 @@ void DisplayManager::updateDisplay(const Departure *departures, int departureCou
         return;
 
     isDrawing = true;
-    display->fillScreen(0);
-    delay(1);
+    beginFrame();
+
+    // Timetable fallback entries are worth showing while offline, live ones are not
+    bool hasScheduled = false;
+    for (int i = 0; i < departureCount && !hasScheduled; i++)
+    {
+        hasScheduled = departures[i].isScheduled;
+    }
+
+    // Rows to draw (top 3 rows, or fewer if numToDisplay is less)
+    int rowsToDraw = (departureCount < numToDisplay) ? departureCount : numToDisplay;
+    if (rowsToDraw > 3)
+        rowsToDraw = 3; // Maximum 3 rows on display
 
     // Demo mode has highest priority - bypass all status screens
     // and show demo departures regardless of WiFi/API/config state
     if (demoModeActive)
     {
-        // Draw demo departures directly
-        int rowsToDraw = (departureCount < numToDisplay) ? departureCount : numToDisplay;
-        if (rowsToDraw > 3)
-            rowsToDraw = 3; // Maximum 3 rows on display
-
         for (int i = 0; i < rowsToDraw; i++)
         {
-            drawDeparture(i, departures[i]);
-            delay(1);
+            layoutDeparture(i, departures[i], strings);
         }
-
-        drawDateTime();
-        delay(1);
-
-#if defined(MATRIX_PORTAL_M4)
-        display->show();
-#endif
-
-        isDrawing = false;
-        return;
+        layoutDateTime();
     }
-
-    // AP Mode - Show credentials
-    if (apModeActive)
+    else if (apModeActive)
     {
-        drawAPMode(apSSID, apPassword);
-#if defined(MATRIX_PORTAL_M4)
-        display->show();
-#endif
-        isDrawing = false;
-        return;
+        // AP Mode - Show credentials
+        layoutAPMode(apSSID, apPassword);
     }
-
-    if (!wifiConnected)
+    else if (!wifiConnected && !hasScheduled)
     {
         // We don't have access to config here, so just show generic message
-        drawStatus("WiFi Connecting...", "", COLOR_YELLOW);
-        isDrawing = false;
-        return;
+        layoutStatus("WiFi Connecting...", "", COLOR_YELLOW);
     }
-
-    if (!apiKeyConfigured)
+    else if (!apiKeyConfigured)
     {
         char ipStr[32];
-        sprintf(ipStr, "http://%s", getLocalIPString());
-        drawStatus("Setup Required", ipStr, COLOR_CYAN);
-        isDrawing = false;
-        return;
+        snprintf(ipStr, sizeof(ipStr), "http://%s", getLocalIPString());
+        layoutStatus("Setup Required", ipStr, COLOR_CYAN);
     }
-
-    if (departureCount == 0 && !apiError)
+    else if (departureCount == 0 && !apiError)
     {
-        drawStatus("No Departures", stopName[0] ? stopName : "Waiting...", COLOR_YELLOW);
-        drawDateTime();
-        isDrawing = false;
-        return;
-    }
-
-    // Draw departures (top 3 rows, or fewer if numToDisplay is less)
-    int rowsToDraw = (departureCount < numToDisplay) ? departureCount : numToDisplay;
-    if (rowsToDraw > 3)
-        rowsToDraw = 3; // Maximum 3 rows on display
-
-    for (int i = 0; i < rowsToDraw; i++)
-    {
-        drawDeparture(i, departures[i]);
-        delay(1);
-    }
-
-    // Show error in status bar if API error, otherwise show date/time
-    if (apiError)
-    {
-        drawErrorBar(apiErrorMsg);
+        layoutStatus("No Departures", stopName[0] ? stopName : "Waiting...", COLOR_YELLOW);
+        layoutDateTime();
     }
     else
     {
-        drawDateTime();
+        for (int i = 0; i < rowsToDraw; i++)
+        {
+            layoutDeparture(i, departures[i], strings);
+        }
+
+        // Show error in status bar if API error, otherwise show date/time
+        if (apiError)
+        {
+            layoutErrorBar(apiErrorMsg);
+        }
+        else if (!wifiConnected)
+        {
+            layoutErrorBar("WiFi offline");
+        }
+        else
+        {
+            layoutDateTime();
+        }
     }
-    delay(1);
 
-#if defined(MATRIX_PORTAL_M4)
-    display->show();
-#endif
+    // Most 10 s ticks change nothing, or one ETA and the clock
+    paintFrame();
 
     isDrawing = false;
 }
 
-void DisplayManager::drawDemo(const Departure* departures, int departureCount, const char* stopName)
+void DisplayManager::drawDemo(const Departure* departures, const DepartureStrings& strings, int departureCount)
 {
     if (isDrawing)
         return;
 
     isDrawing = true;
-    display->fillScreen(0);
-    delay(1);
+    beginFrame();
 
     // Draw sample departures (top 1-3 rows)
     int rowsToDraw = (departureCount < 3) ? departureCount : 3;
     for (int i = 0; i < rowsToDraw; i++)
     {
-        drawDeparture(i, departures[i]);
-        delay(1);
+        layoutDeparture(i, departures[i], strings);
     }
 
     // Draw date/time status bar
-    drawDateTime();
-    delay(1);
-
-#if defined(MATRIX_PORTAL_M4)
-    display->show();
-#endif
+    layoutDateTime();
+    paintFrame();
 
     isDrawing = false;
 }
@@ -677,6 +975,7 @@ uint16_t DisplayManager::getTemperatureColor(int temperature)
 
 void DisplayManager::drawWeatherDebug()
 {
+    invalidateFrame();
     display->fillScreen(COLOR_BLACK);
 
     // Row 1: Weather icons with labels (y=7)
@@ -804,7 +1103,5 @@ void DisplayManager::drawWeatherDebug()
     display->setCursor(30, y);
     display->print("Weather Debug");
 
-#if defined(MATRIX_PORTAL_M4)
-    display->show();
-#endif
+    showFrame();
 }
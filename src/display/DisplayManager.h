@@ -10,6 +10,9 @@
 #if defined(MATRIX_PORTAL_M4)
     #include <Adafruit_Protomatter.h>
     typedef Adafruit_Protomatter DisplayType;
+#elif defined(NATIVE_HOST)
+    #include "../hal/native/FrameCanvas.h"
+    typedef FrameCanvas DisplayType;  // In-memory RGB565 panel
 #else
     #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
     typedef MatrixPanel_I2S_DMA DisplayType;
@@ -24,6 +27,38 @@ extern const GFXfont DepartureWeather_Regular4pt8b;  // Weather icon font
 // Forward declaration for WeatherData
 struct WeatherData;
 
+// ============================================================================
+// Frame Model
+// ============================================================================
+
+#define MAX_DISPLAY_ITEMS 32   // Text runs and fills per frame (departure board: up to 26)
+#define DISPLAY_ITEM_TEXT 48   // Enough for every visible character, incl. a wrapped line
+
+// Item lists: one per frame buffer, plus the frame being laid out
+#if DISPLAY_DOUBLE_BUFFER && !defined(MATRIX_PORTAL_M4)
+#define DISPLAY_FRAME_SLOTS 3
+#else
+#define DISPLAY_FRAME_SLOTS 2
+#endif
+
+/**
+ * One text run or filled rectangle of a frame, as drawn by updateDisplay().
+ * The box holds every pixel the item can touch (glyph boxes, or the
+ * rectangle itself), clipped to the panel.
+ */
+struct DisplayItem
+{
+    const GFXfont* font;  // nullptr: filled rectangle
+    int16_t x;            // Text cursor (baseline); unused for rectangles
+    int16_t y;
+    uint16_t color;
+    int16_t boxX;
+    int16_t boxY;
+    int16_t boxW;
+    int16_t boxH;
+    char text[DISPLAY_ITEM_TEXT];
+};
+
 // ============================================================================
 // Display Manager Class
 // ============================================================================
@@ -50,6 +85,7 @@ public:
     /**
      * Update display with current state
      * @param departures Array of departures to display
+     * @param strings Lines and destinations referenced by departures
      * @param departureCount Number of valid departures
      * @param numToDisplay Number of departures to show (1-3)
      * @param wifiConnected WiFi connection status
@@ -62,7 +98,8 @@ public:
      * @param apiKeyConfigured Whether API key is configured
      * @param demoModeActive Whether demo mode is active (has highest priority, overrides ALL status screens)
      */
-    void updateDisplay(const Departure* departures, int departureCount, int numToDisplay,
+    void updateDisplay(const Departure* departures, const DepartureStrings& strings,
+                      int departureCount, int numToDisplay,
                       bool wifiConnected, bool apModeActive,
                       const char* apSSID, const char* apPassword,
                       bool apiError, const char* apiErrorMsg,
@@ -110,10 +147,10 @@ public:
      * Draw demo mode display (repurposed from drawFontTest)
      * Shows sample departure data for customization testing
      * @param departures Array of sample departures to display
+     * @param strings Lines and destinations of the sample departures
      * @param departureCount Number of departures (1-3)
-     * @param stopName Stop name to display
      */
-    void drawDemo(const Departure* departures, int departureCount, const char* stopName);
+    void drawDemo(const Departure* departures, const DepartureStrings& strings, int departureCount);
 
     /**
      * Turn screen off (fill black, pause updates)
@@ -134,6 +171,26 @@ public:
     bool isScreenOff() const { return screenOff; }
     bool needsRedraw() { bool r = forceRedraw; forceRedraw = false; return r; }
 
+    /**
+     * Forget what is on the panel: the next updateDisplay() clears the whole
+     * screen and draws every item. Called by every function that draws
+     * outside the frame model (status, OTA, debug screens, screen off).
+     */
+    void invalidateFrame() { bufferFrame[0] = bufferFrame[1] = -1; }
+
+    /**
+     * Whether frames are drawn into a second DMA buffer and shown by a flip
+     * (DISPLAY_DOUBLE_BUFFER with enough SRAM; the M4 composes in Protomatter's
+     * canvas and shows it with show() instead)
+     */
+    bool isDoubleBuffered() const { return doubleBuffered; }
+
+    /**
+     * Area cleared and redrawn by the last updateDisplay()/drawDemo(), in pixels
+     * (0: nothing changed; width * height: full redraw)
+     */
+    uint32_t getLastFramePixels() const { return lastFramePixels; }
+
 private:
     DisplayType* display;
     bool isDrawing;
@@ -150,11 +207,42 @@ private:
     // Weather data pointer
     const WeatherData* weatherData;
 
-    // Drawing functions
-    void drawDeparture(int row, const Departure& dep);
-    void drawDateTime();
-    void drawErrorBar(const char* errorMsg);
-    void drawAPMode(const char* ssid, const char* password);
+    // Frame model: the items in each frame buffer and the frame being laid out.
+    // Double-buffered, the buffer drawn into holds the frame before the one shown.
+    DisplayItem frameItems[DISPLAY_FRAME_SLOTS][MAX_DISPLAY_ITEMS];
+    int frameItemCount[DISPLAY_FRAME_SLOTS];
+    int bufferFrame[2];   // Slot whose items are in frame buffer 0/1; -1: unknown, repaint everything
+    int backBuffer;       // Frame buffer drawn into (always 0 when single-buffered)
+    int nextFrame;        // Slot being laid out
+    bool doubleBuffered;
+    unsigned long framePeriodMs;  // One panel refresh, waited out after a flip (0: flips are immediate)
+    uint32_t lastFramePixels;
+
+    // Layout functions (add items to the next frame)
+    void beginFrame();
+    int16_t addText(const GFXfont* font, uint16_t color, int16_t x, int16_t y, const char* text);
+    void addFill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void layoutDeparture(int row, const Departure& dep, const DepartureStrings& strings);
+    void layoutDateTime();
+    void layoutErrorBar(const char* errorMsg);
+    void layoutAPMode(const char* ssid, const char* password);
+    void layoutStatus(const char* line1, const char* line2, uint16_t color);
+
+    /**
+     * Bring the frame buffer from its frame to the laid-out one: clear and
+     * redraw only the boxes of items that changed, plus any unchanged item
+     * overlapping them (glyphs reach into neighbouring rows), in layout
+     * order - the result is pixel-identical to a full redraw
+     */
+    void paintFrame();
+    void drawItem(const DisplayItem& item);
+
+    /**
+     * Make the frame drawn so far visible: show() on the M4, a DMA buffer
+     * flip when double-buffered on the ESP32 (returns once the panel outputs
+     * it), nothing otherwise
+     */
+    void showFrame();
 
     // Weather helper functions
     char mapWeatherCodeToIcon(int wmoCode);
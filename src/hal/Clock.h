@@ -0,0 +1,59 @@
+#ifndef HAL_CLOCK_H
+#define HAL_CLOCK_H
+
+#include <time.h>
+
+// ============================================================================
+// Clock HAL - Monotonic time and delays for the portable modules
+// ============================================================================
+// api/ and utils/ call these instead of millis()/micros()/delay() so they
+// also build on the host (env:native). On the boards they are the Arduino
+// functions; the host implementation can run on a manual clock.
+
+#if defined(NATIVE_HOST)
+
+/**
+ * Milliseconds since start (wraps like millis())
+ */
+unsigned long clockMillis();
+
+/**
+ * Microseconds since start (wraps like micros())
+ */
+unsigned long clockMicros();
+
+/**
+ * Wait, or advance the manual clock without waiting
+ * @param ms Duration in milliseconds
+ */
+void clockDelay(unsigned long ms);
+
+/**
+ * Wall-clock time in UTC seconds (host clock, or the manual clock if set)
+ */
+time_t clockEpoch();
+
+/**
+ * Switch to a manual clock: time stands still except for clockDelay() and
+ * clockAdvance(), so retry backoff costs no real time and runs repeat exactly
+ * @param epoch Wall-clock time to start from (UTC seconds)
+ */
+void clockSetManual(time_t epoch);
+
+/**
+ * Move the manual clock forward (ignored on the host clock)
+ * @param ms Duration in milliseconds
+ */
+void clockAdvance(unsigned long ms);
+
+#else
+
+#include <Arduino.h>
+
+inline unsigned long clockMillis() { return millis(); }
+inline unsigned long clockMicros() { return micros(); }
+inline void clockDelay(unsigned long ms) { delay(ms); }
+
+#endif // NATIVE_HOST
+
+#endif // HAL_CLOCK_H
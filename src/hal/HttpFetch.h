@@ -0,0 +1,66 @@
+#ifndef HAL_HTTPFETCH_H
+#define HAL_HTTPFETCH_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// HTTP Fetch HAL - Transport behind HttpConnectionManager on the host
+// ============================================================================
+// On ESP32 HttpConnectionManager owns its TLS connections; the host build of
+// HttpConnectionManager (hal/native/NativeHttp.cpp) sends every request
+// through an HttpFetch instead, e.g. one that replays recorded responses.
+
+#if defined(NATIVE_HOST)
+// Same values as the ESP32 HTTPClient, so status handling is shared
+#define HTTP_CODE_OK 200
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+#endif
+
+/**
+ * One request at a time: get(), read the body, end().
+ */
+class HttpFetch
+{
+public:
+    virtual ~HttpFetch() = default;
+
+    /**
+     * Send a GET request and read the response head
+     * @param server Host name without scheme (e.g. "api.golemio.cz")
+     * @param path Request path including query string
+     * @param headers Flat array of header name/value pairs (may be nullptr)
+     * @param headerPairs Number of name/value pairs in headers
+     * @param timeoutMs Read timeout in milliseconds
+     * @return HTTP status code, or negative HTTPC_ERROR_* code
+     */
+    virtual int get(const char* server, const char* path, const char* const* headers, int headerPairs,
+                    int timeoutMs) = 0;
+
+    /**
+     * Body of the last response (chunked encoding already decoded)
+     */
+    virtual Stream& getBody() = 0;
+
+    /**
+     * Content-Length of the last response, or -1 if unknown
+     */
+    virtual int getBodySize() = 0;
+
+    /**
+     * Finish the last response
+     * @param keepAlive false to close the connection (body state unknown)
+     */
+    virtual void end(bool keepAlive) = 0;
+};
+
+#endif // HAL_HTTPFETCH_H
@@ -0,0 +1,32 @@
+#ifndef HAL_LOGSINK_H
+#define HAL_LOGSINK_H
+
+// ============================================================================
+// Log Sink HAL - Where Logger output goes
+// ============================================================================
+// Serial on the boards, stdout on the host. Telnet mirroring stays in Logger.
+
+#if defined(NATIVE_HOST)
+
+/**
+ * Write text without a line break
+ * @param text Text to write
+ */
+void logSinkWrite(const char* text);
+
+/**
+ * Write text followed by a line break
+ * @param text Text to write
+ */
+void logSinkWriteLine(const char* text);
+
+#else
+
+#include <Arduino.h>
+
+inline void logSinkWrite(const char* text) { Serial.print(text); }
+inline void logSinkWriteLine(const char* text) { Serial.println(text); }
+
+#endif // NATIVE_HOST
+
+#endif // HAL_LOGSINK_H
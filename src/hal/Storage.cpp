@@ -0,0 +1,87 @@
+#include "Storage.h"
+#include <Preferences.h>
+#include <esp_partition.h>
+
+// ESP32 only - the host build uses native/NativeStorage.cpp (see build_src_filter)
+
+// ============================================================================
+// Blobs (NVS)
+// ============================================================================
+
+size_t storageGetSize(const char* space, const char* key)
+{
+    Preferences preferences;
+    if (!preferences.begin(space, true)) // Read-only; fails if the namespace was never written
+    {
+        return 0;
+    }
+    size_t size = preferences.getBytesLength(key);
+    preferences.end();
+    return size;
+}
+
+size_t storageGet(const char* space, const char* key, void* buffer, size_t size)
+{
+    Preferences preferences;
+    if (!preferences.begin(space, true))
+    {
+        return 0;
+    }
+    size_t stored = preferences.getBytesLength(key);
+    size_t read = (stored > 0 && stored <= size) ? preferences.getBytes(key, buffer, size) : 0;
+    preferences.end();
+    return read;
+}
+
+size_t storagePut(const char* space, const char* key, const void* data, size_t size)
+{
+    Preferences preferences;
+    if (!preferences.begin(space, false)) // Read-write
+    {
+        return 0;
+    }
+    size_t written = preferences.putBytes(key, data, size);
+    preferences.end();
+    return written;
+}
+
+// ============================================================================
+// Data Partition (spiffs)
+// ============================================================================
+
+static const esp_partition_t* findDataPartition()
+{
+    static const esp_partition_t* partition =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+    return partition;
+}
+
+size_t storageDataSize()
+{
+    const esp_partition_t* partition = findDataPartition();
+    return partition ? partition->size : 0;
+}
+
+bool storageReadData(size_t offset, void* buffer, size_t size)
+{
+    const esp_partition_t* partition = findDataPartition();
+    return partition != nullptr && esp_partition_read(partition, offset, buffer, size) == ESP_OK;
+}
+
+const uint8_t* storageMapData(size_t size)
+{
+    const esp_partition_t* partition = findDataPartition();
+    if (partition == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Mapped for the lifetime of the firmware, so the handle is never needed
+    const void* mapped = nullptr;
+    spi_flash_mmap_handle_t handle;
+    if (esp_partition_mmap(partition, 0, size, SPI_PARTITION_MMAP_DATA, &mapped, &handle) != ESP_OK)
+    {
+        return nullptr;
+    }
+    return (const uint8_t*)mapped;
+}
@@ -0,0 +1,65 @@
+#ifndef HAL_STORAGE_H
+#define HAL_STORAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// Storage HAL - Persistent blobs and the read-only data partition
+// ============================================================================
+// Blobs live in NVS (Preferences) on ESP32 and in files on the host
+// (directory $SPOJBOARD_NVS, default "nvs"). The data partition is the
+// spiffs partition on ESP32 and the file $SPOJBOARD_DATA on the host.
+// Not available on M4 (config storage there is FlashStorage in AppConfig).
+
+/**
+ * Size of a stored blob
+ * @param space Namespace (at most 15 characters, NVS limit)
+ * @param key Key (at most 15 characters)
+ * @return Size in bytes, 0 if absent
+ */
+size_t storageGetSize(const char* space, const char* key);
+
+/**
+ * Read a stored blob
+ * @param space Namespace
+ * @param key Key
+ * @param buffer Receives the blob
+ * @param size Size of buffer
+ * @return Bytes read, 0 if absent or larger than buffer
+ */
+size_t storageGet(const char* space, const char* key, void* buffer, size_t size);
+
+/**
+ * Store a blob, replacing any previous value
+ * @param space Namespace
+ * @param key Key
+ * @param data Blob to store
+ * @param size Size of data
+ * @return Bytes written (size on success)
+ */
+size_t storagePut(const char* space, const char* key, const void* data, size_t size);
+
+/**
+ * Size of the data partition
+ * @return Size in bytes, 0 if there is none
+ */
+size_t storageDataSize();
+
+/**
+ * Read from the data partition
+ * @param offset Byte offset from the partition start
+ * @param buffer Receives the data
+ * @param size Bytes to read
+ * @return false if the range is outside the partition
+ */
+bool storageReadData(size_t offset, void* buffer, size_t size);
+
+/**
+ * Map the start of the data partition read-only for the firmware's lifetime
+ * @param size Bytes to map
+ * @return Mapped data, nullptr on failure
+ */
+const uint8_t* storageMapData(size_t size);
+
+#endif // HAL_STORAGE_H
@@ -0,0 +1,7 @@
+#ifndef NATIVE_ADAFRUIT_I2CDEVICE_H
+#define NATIVE_ADAFRUIT_I2CDEVICE_H
+
+// Host Build - Adafruit_GFX.h includes Adafruit BusIO for its I2C display
+// drivers, which env:native leaves out (see scripts/native_gfx.py)
+
+#endif // NATIVE_ADAFRUIT_I2CDEVICE_H
@@ -0,0 +1,7 @@
+#ifndef NATIVE_ADAFRUIT_SPIDEVICE_H
+#define NATIVE_ADAFRUIT_SPIDEVICE_H
+
+// Host Build - Adafruit_GFX.h includes Adafruit BusIO for its SPI display
+// drivers, which env:native leaves out (see scripts/native_gfx.py)
+
+#endif // NATIVE_ADAFRUIT_SPIDEVICE_H
@@ -0,0 +1,15 @@
+#include <Arduino.h>
+
+#if defined(_WIN32) || (defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)))
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size)
+{
+    size_t length = strlen(src);
+    if (size > 0)
+    {
+        size_t copied = (length < size - 1) ? length : size - 1;
+        memcpy(dst, src, copied);
+        dst[copied] = '\0';
+    }
+    return length;
+}
+#endif
@@ -0,0 +1,161 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// ============================================================================
+// Host Build (env:native) - Arduino core types used by the portable modules
+// ============================================================================
+// Only what api/, utils/, display/, ArduinoJson's Arduino support and the
+// Adafruit GFX Library need: String, Print, Stream, strlcpy() and flat PROGMEM
+// access. Anything with hardware behind it (millis(), Serial,
+// WiFi, flash) is deliberately missing - portable code uses hal/ for that,
+// so a stray board call fails to compile instead of misbehaving on the host.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <string>
+#include "HostCompat.h"
+
+// ============================================================================
+// Flash access (one address space on the host)
+// ============================================================================
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_byte
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#endif
+#ifndef pgm_read_word
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#endif
+
+class __FlashStringHelper;  // Only named by Adafruit_GFX overloads
+
+// ============================================================================
+// String
+// ============================================================================
+
+class String
+{
+public:
+    String(const char* str = "") : value(str ? str : "") {}
+    String(const std::string& str) : value(str) {}
+    explicit String(int number) : value(std::to_string(number)) {}
+    explicit String(unsigned int number) : value(std::to_string(number)) {}
+    explicit String(long number) : value(std::to_string(number)) {}
+    explicit String(unsigned long number) : value(std::to_string(number)) {}
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return (unsigned int)value.size(); }
+    bool isEmpty() const { return value.empty(); }
+    bool reserve(unsigned int size) { value.reserve(size); return true; }
+
+    bool concat(const char* str) { value += str; return true; }
+    bool concat(char c) { value += c; return true; }
+    String& operator+=(const char* str) { value += str; return *this; }
+    String& operator+=(const String& str) { value += str.value; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+
+    char operator[](unsigned int index) const { return index < value.size() ? value[index] : '\0'; }
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* other) const { return value == (other ? other : ""); }
+    bool operator!=(const String& other) const { return value != other.value; }
+
+    bool equalsIgnoreCase(const String& other) const { return strcasecmp(c_str(), other.c_str()) == 0; }
+
+private:
+    std::string value;
+};
+
+// ============================================================================
+// Print
+// ============================================================================
+
+/**
+ * Text output on top of write(uint8_t), as used by Adafruit_GFX
+ */
+class Print
+{
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+        size_t count = 0;
+        while (size--)
+        {
+            count += write(*buffer++);
+        }
+        return count;
+    }
+
+    size_t write(const char* str)
+    {
+        size_t count = 0;
+        while (*str)
+        {
+            count += write((uint8_t)*str++);
+        }
+        return count;
+    }
+
+    size_t print(const char* str) { return write(str); }
+    size_t print(const String& str) { return write(str.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int number) { return print((long)number); }
+    size_t print(unsigned int number) { return print((unsigned long)number); }
+    size_t print(long number) { return write(std::to_string(number).c_str()); }
+    size_t print(unsigned long number) { return write(std::to_string(number).c_str()); }
+};
+
+// ============================================================================
+// Stream
+// ============================================================================
+
+/**
+ * Byte source. Unlike the Arduino core, readBytes() stops at the first
+ * read() that returns -1: a host stream's read() blocks (up to its own
+ * timeout) instead of returning -1 while data is still on the way.
+ */
+class Stream
+{
+public:
+    virtual ~Stream() = default;
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeoutMs) { timeout = timeoutMs; }
+    unsigned long getTimeout() const { return timeout; }
+
+    virtual size_t readBytes(char* buffer, size_t length)
+    {
+        size_t count = 0;
+        while (count < length)
+        {
+            int c = read();
+            if (c < 0)
+            {
+                break;
+            }
+            buffer[count++] = (char)c;
+        }
+        return count;
+    }
+
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+protected:
+    unsigned long timeout = 1000;
+};
+
+#endif // NATIVE_ARDUINO_H
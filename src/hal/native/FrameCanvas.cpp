@@ -0,0 +1,118 @@
+#include "FrameCanvas.h"
+
+FrameCanvas::FrameCanvas(int16_t w, int16_t h, bool doubleBuffered)
+    : Adafruit_GFX(w, h), pixels(new uint16_t[w * h]()), pixelWrites(0), brightness(255)
+{
+    front = doubleBuffered ? new uint16_t[w * h]() : pixels;
+}
+
+FrameCanvas::~FrameCanvas()
+{
+    if (front != pixels)
+    {
+        delete[] front;
+    }
+    delete[] pixels;
+}
+
+void FrameCanvas::flipDMABuffer()
+{
+    uint16_t* shown = front;
+    front = pixels;
+    pixels = shown;
+}
+
+void FrameCanvas::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+    {
+        return;
+    }
+    pixels[y * _width + x] = color;
+    pixelWrites++;
+}
+
+void FrameCanvas::fillScreen(uint16_t color)
+{
+    for (int i = 0; i < _width * _height; i++)
+    {
+        pixels[i] = color;
+    }
+    pixelWrites += _width * _height;
+}
+
+uint16_t FrameCanvas::getPixel(int16_t x, int16_t y) const
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+    {
+        return 0;
+    }
+    return front[y * _width + x];
+}
+
+void FrameCanvas::toRGB888(uint16_t color, uint8_t* rgb)
+{
+    // Replicate the high bits into the low ones so 0x1F maps to 0xFF
+    uint8_t r = (color >> 11) & 0x1F;
+    uint8_t g = (color >> 5) & 0x3F;
+    uint8_t b = color & 0x1F;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+bool FrameCanvas::writePPM(const char* path) const
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", _width, _height);
+    uint8_t rgb[3];
+    for (int i = 0; i < _width * _height; i++)
+    {
+        toRGB888(front[i], rgb);
+        fwrite(rgb, 1, sizeof(rgb), file);
+    }
+    return fclose(file) == 0;
+}
+
+int FrameCanvas::comparePPM(const char* path) const
+{
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return -1;
+    }
+
+    int width = 0;
+    int height = 0;
+    int maxValue = 0;
+    if (fscanf(file, "P6 %d %d %d", &width, &height, &maxValue) != 3 || width != _width || height != _height ||
+        maxValue != 255 || fgetc(file) == EOF)
+    {
+        fclose(file);
+        return -1;
+    }
+
+    int differences = 0;
+    uint8_t expected[3];
+    uint8_t actual[3];
+    for (int i = 0; i < _width * _height; i++)
+    {
+        if (fread(expected, 1, sizeof(expected), file) != sizeof(expected))
+        {
+            fclose(file);
+            return -1;
+        }
+        toRGB888(front[i], actual);
+        if (memcmp(expected, actual, sizeof(actual)) != 0)
+        {
+            differences++;
+        }
+    }
+    fclose(file);
+    return differences;
+}
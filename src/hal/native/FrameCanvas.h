@@ -0,0 +1,63 @@
+#ifndef FRAMECANVAS_H
+#define FRAMECANVAS_H
+
+#include <Adafruit_GFX.h>
+
+// ============================================================================
+// In-memory Panel (host build)
+// ============================================================================
+
+/**
+ * RGB565 framebuffer standing in for MatrixPanel_I2S_DMA as DisplayType on
+ * the host. Frames can be written as binary PPM (P6) and compared with a
+ * golden PPM; every pixel write is counted, so render cost can be tracked
+ * independently of the host CPU. Double-buffered, drawing goes to the back
+ * buffer and getPixel()/PPM read the front one, as on the panel.
+ */
+class FrameCanvas : public Adafruit_GFX
+{
+public:
+    FrameCanvas(int16_t w, int16_t h, bool doubleBuffered = false);
+    ~FrameCanvas();
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+
+    // MatrixPanel_I2S_DMA API used by DisplayManager; the PPM keeps full brightness
+    void setBrightness8(uint8_t value) { brightness = value; }
+    uint8_t getBrightness() const { return brightness; }
+    void flipDMABuffer();
+
+    uint16_t getPixel(int16_t x, int16_t y) const;
+
+    /**
+     * Pixel writes since the last resetPixelWrites() (fillScreen counts every pixel)
+     */
+    uint32_t getPixelWrites() const { return pixelWrites; }
+    void resetPixelWrites() { pixelWrites = 0; }
+
+    /**
+     * Write the frame as a binary PPM, RGB565 expanded to 8 bits per channel
+     * @return false if the file could not be written
+     */
+    bool writePPM(const char* path) const;
+
+    /**
+     * Compare the frame with a PPM written by writePPM()
+     * @return Number of differing pixels, or -1 if the file is unreadable or another size
+     */
+    int comparePPM(const char* path) const;
+
+private:
+    uint16_t* pixels;  // Drawn into
+    uint16_t* front;   // Shown (== pixels when single-buffered)
+    uint32_t pixelWrites;
+    uint8_t brightness;
+
+    FrameCanvas(const FrameCanvas&) = delete;
+    FrameCanvas& operator=(const FrameCanvas&) = delete;
+
+    static void toRGB888(uint16_t color, uint8_t* rgb);
+};
+
+#endif // FRAMECANVAS_H
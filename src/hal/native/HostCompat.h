@@ -0,0 +1,23 @@
+#ifndef HOSTCOMPAT_H
+#define HOSTCOMPAT_H
+
+// ============================================================================
+// Host Build - libc functions the boards' toolchains provide
+// ============================================================================
+// Force-included into every host translation unit (see env:native), since
+// the portable modules get these from <string.h> on newlib.
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(_WIN32) || (defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)))
+#ifdef __cplusplus
+extern "C" {
+#endif
+size_t strlcpy(char* dst, const char* src, size_t size);
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif // HOSTCOMPAT_H
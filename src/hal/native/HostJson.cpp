@@ -0,0 +1,31 @@
+#include "HostJson.h"
+
+// Members and elements below a value (each one takes a slot)
+static size_t countSlots(JsonVariantConst variant)
+{
+    size_t slots = 0;
+    if (variant.is<JsonObjectConst>())
+    {
+        for (JsonPairConst member : variant.as<JsonObjectConst>())
+        {
+            slots += 1 + countSlots(member.value());
+        }
+    }
+    else if (variant.is<JsonArrayConst>())
+    {
+        for (JsonVariantConst element : variant.as<JsonArrayConst>())
+        {
+            slots += 1 + countSlots(element);
+        }
+    }
+    return slots;
+}
+
+size_t hostJsonBoardUsage(const JsonDocument& doc, size_t hostBytes)
+{
+    if (JSON_OBJECT_SIZE(1) == HOST_JSON_BOARD_SLOT_SIZE)
+    {
+        return hostBytes;
+    }
+    return hostBytes - countSlots(doc.as<JsonVariantConst>()) * (JSON_OBJECT_SIZE(1) - HOST_JSON_BOARD_SLOT_SIZE);
+}
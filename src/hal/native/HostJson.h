@@ -0,0 +1,78 @@
+#ifndef HOSTJSON_H
+#define HOSTJSON_H
+
+// ============================================================================
+// Host Build - JsonDocument sized as on the boards
+// ============================================================================
+// Force-included after ArduinoJson (see env:native). ArduinoJson 6 keeps every
+// object member and array element in a slot of 16 bytes on the 32-bit boards
+// and 32 bytes with 64-bit pointers, so a document allocated with a provider's
+// JSON_BUFFER_SIZE would overflow on the host where the board would not.
+//
+// DynamicJsonDocument and StaticJsonDocument are redirected to the classes
+// below for every host translation unit. They take the board budget, allocate
+// twice that, and answer memoryUsage(), capacity() and overflowed() the way
+// the board would for the same content. The providers keep allocating
+// JSON_BUFFER_SIZE and reporting memoryUsage(); nothing in api/ knows.
+// Through a plain JsonDocument& the real (host) figures are still visible.
+
+#ifdef __cplusplus
+
+#include <ArduinoJson.h>
+
+// Slot size with 32-bit pointers (ESP32-S3, SAMD51)
+static const size_t HOST_JSON_BOARD_SLOT_SIZE = 16;
+
+/**
+ * Memory a document would use on the boards
+ * @param doc Parsed document
+ * @param hostBytes Its memoryUsage() on the host
+ * @return Host bytes with every slot charged at HOST_JSON_BOARD_SLOT_SIZE
+ */
+size_t hostJsonBoardUsage(const JsonDocument& doc, size_t hostBytes);
+
+/**
+ * Board-sized mixin for the host documents
+ * Slots at most double on the host and strings stay the same, so twice the
+ * board budget always holds whatever fits on the board.
+ */
+template <typename TDocument>
+class HostBoardDocument : public TDocument
+{
+public:
+    template <typename... TArgs>
+    explicit HostBoardDocument(size_t boardCapacity, TArgs... args)
+        : TDocument(args...), boardCapacity(boardCapacity)
+    {
+    }
+
+    size_t capacity() const { return boardCapacity; }
+    size_t memoryUsage() const { return hostJsonBoardUsage(*this, TDocument::memoryUsage()); }
+    bool overflowed() const { return TDocument::overflowed() || memoryUsage() > boardCapacity; }
+
+private:
+    size_t boardCapacity;
+};
+
+class HostDynamicJsonDocument : public HostBoardDocument<ArduinoJson::DynamicJsonDocument>
+{
+public:
+    explicit HostDynamicJsonDocument(size_t boardCapacity)
+        : HostBoardDocument<ArduinoJson::DynamicJsonDocument>(boardCapacity, 2 * boardCapacity)
+    {
+    }
+};
+
+template <size_t N>
+class HostStaticJsonDocument : public HostBoardDocument<ArduinoJson::StaticJsonDocument<2 * N>>
+{
+public:
+    HostStaticJsonDocument() : HostBoardDocument<ArduinoJson::StaticJsonDocument<2 * N>>(N) {}
+};
+
+#define DynamicJsonDocument HostDynamicJsonDocument
+#define StaticJsonDocument HostStaticJsonDocument
+
+#endif // __cplusplus
+
+#endif // HOSTJSON_H
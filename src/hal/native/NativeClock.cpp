@@ -0,0 +1,56 @@
+#include "../Clock.h"
+#include <chrono>
+#include <thread>
+
+// Host clock: steady_clock since the first call; manual clock after clockSetManual()
+
+static bool manual = false;
+static unsigned long long manualUs = 0;
+static time_t manualEpoch = 0;
+
+static unsigned long long elapsedUs()
+{
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return (unsigned long long)duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+unsigned long clockMillis()
+{
+    return (unsigned long)((manual ? manualUs : elapsedUs()) / 1000);
+}
+
+unsigned long clockMicros()
+{
+    return (unsigned long)(manual ? manualUs : elapsedUs());
+}
+
+void clockDelay(unsigned long ms)
+{
+    if (manual)
+    {
+        clockAdvance(ms);
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+time_t clockEpoch()
+{
+    return manual ? manualEpoch + (time_t)(manualUs / 1000000) : time(nullptr);
+}
+
+void clockSetManual(time_t epoch)
+{
+    manual = true;
+    manualUs = 0;
+    manualEpoch = epoch;
+}
+
+void clockAdvance(unsigned long ms)
+{
+    if (manual)
+    {
+        manualUs += (unsigned long long)ms * 1000;
+    }
+}
@@ -0,0 +1,142 @@
+#include "../../network/HttpConnectionManager.h"
+#include "../../utils/Logger.h"
+#include "ReplayHttpFetch.h"
+
+// Host build of HttpConnectionManager: same interface and counters, requests
+// go through the HttpFetch set with setTransport()
+
+static MemoryStream emptyBody;  // Body stream while no transport is set
+
+HttpConnectionManager& HttpConnectionManager::getInstance()
+{
+    static HttpConnectionManager instance;
+    return instance;
+}
+
+HttpConnectionManager::HttpConnectionManager() : transport(nullptr)
+{
+    baseUrl[0] = '\0';
+}
+
+const char* HttpConnectionManager::getHostName(Host host) const
+{
+    switch (host)
+    {
+        case HOST_GOLEMIO: return "api.golemio.cz";
+        case HOST_BVG: return "v6.bvg.transport.rest";
+        case HOST_OPEN_METEO: return "api.open-meteo.com";
+        case HOST_GTFS_RT: return connections[host].server[0] ? connections[host].server : "unknown";
+        default: return "unknown";
+    }
+}
+
+void HttpConnectionManager::setServer(Host host, const char* hostName)
+{
+    strlcpy(connections[host].server, hostName, sizeof(connections[host].server));
+}
+
+void HttpConnectionManager::setBaseUrl(const char* url)
+{
+    strlcpy(baseUrl, url, sizeof(baseUrl));
+}
+
+int HttpConnectionManager::get(Host host, const char* path, const char* const* headers, int headerPairs, int timeoutMs)
+{
+    Connection& conn = connections[host];
+    conn.stats.requests++;
+
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    if (transport != nullptr && baseUrl[0])
+    {
+        // Stand-in server: the transport gets "server[:port]" and /<host><path>
+        const char* scheme = strstr(baseUrl, "://");
+        const char* server = scheme ? scheme + 3 : baseUrl;
+        char standInPath[640];
+        snprintf(standInPath, sizeof(standInPath), "/%s%s", getHostName(host), path);
+        httpCode = transport->get(server, standInPath, headers, headerPairs, timeoutMs);
+    }
+    else if (transport != nullptr)
+    {
+        httpCode = transport->get(getHostName(host), path, headers, headerPairs, timeoutMs);
+    }
+
+    conn.stats.statusClasses[(httpCode >= 100 && httpCode < 600) ? httpCode / 100 : 0]++;
+    return httpCode;
+}
+
+Stream& HttpConnectionManager::getBodyStream(Host host)
+{
+    (void)host;
+    if (transport == nullptr)
+    {
+        return emptyBody;
+    }
+    return transport->getBody();
+}
+
+String HttpConnectionManager::getBodyString(Host host)
+{
+    String body;
+    Stream& stream = getBodyStream(host);
+    char buffer[256];
+    size_t count;
+    while ((count = stream.readBytes(buffer, sizeof(buffer) - 1)) > 0)
+    {
+        buffer[count] = '\0';
+        body += buffer;
+    }
+    return body;
+}
+
+int HttpConnectionManager::getBodySize(Host host)
+{
+    (void)host;
+    return transport ? transport->getBodySize() : -1;
+}
+
+void HttpConnectionManager::end(Host host)
+{
+    int size = getBodySize(host);
+    if (size > 0)
+    {
+        connections[host].stats.bodyBytes += size;
+    }
+    if (transport != nullptr)
+    {
+        transport->end(true);
+    }
+}
+
+void HttpConnectionManager::drop(Host host)
+{
+    int size = getBodySize(host);
+    if (size > 0)
+    {
+        connections[host].stats.bodyBytes += size;
+    }
+    if (transport != nullptr)
+    {
+        transport->end(false);
+    }
+}
+
+void HttpConnectionManager::closeIdle()
+{
+    // Connections belong to the transport
+}
+
+void HttpConnectionManager::logStats()
+{
+    for (int i = 0; i < HOST_COUNT; i++)
+    {
+        const HostStats& stats = connections[i].stats;
+        if (stats.requests == 0)
+            continue;
+
+        char msg[128];
+        snprintf(msg, sizeof(msg), "HTTP: %s requests=%lu bytes=%lu", getHostName((Host)i),
+                 (unsigned long)stats.requests, (unsigned long)stats.bodyBytes);
+        logTimestamp();
+        debugPrintln(msg);
+    }
+}
@@ -0,0 +1,16 @@
+#include "../LogSink.h"
+#include <stdio.h>
+
+// Host log sink: stdout, flushed per line so output interleaves with the caller's
+
+void logSinkWrite(const char* text)
+{
+    fputs(text, stdout);
+}
+
+void logSinkWriteLine(const char* text)
+{
+    fputs(text, stdout);
+    fputc('\n', stdout);
+    fflush(stdout);
+}
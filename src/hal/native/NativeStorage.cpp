@@ -0,0 +1,137 @@
+#include "../Storage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+// Host storage: one file per blob in $SPOJBOARD_NVS ("nvs" by default), the
+// data partition is the file $SPOJBOARD_DATA, read into memory on first use.
+
+// ============================================================================
+// Blobs
+// ============================================================================
+
+static void blobPath(char* path, size_t size, const char* space, const char* key)
+{
+    const char* dir = getenv("SPOJBOARD_NVS");
+    snprintf(path, size, "%s/%s.%s.bin", dir ? dir : "nvs", space, key);
+}
+
+static size_t fileSize(FILE* file)
+{
+    if (fseek(file, 0, SEEK_END) != 0)
+    {
+        return 0;
+    }
+    long size = ftell(file);
+    rewind(file);
+    return size > 0 ? (size_t)size : 0;
+}
+
+size_t storageGetSize(const char* space, const char* key)
+{
+    char path[256];
+    blobPath(path, sizeof(path), space, key);
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return 0;
+    }
+    size_t size = fileSize(file);
+    fclose(file);
+    return size;
+}
+
+size_t storageGet(const char* space, const char* key, void* buffer, size_t size)
+{
+    char path[256];
+    blobPath(path, sizeof(path), space, key);
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return 0;
+    }
+    size_t stored = fileSize(file);
+    size_t read = (stored > 0 && stored <= size) ? fread(buffer, 1, stored, file) : 0;
+    fclose(file);
+    return read;
+}
+
+size_t storagePut(const char* space, const char* key, const void* data, size_t size)
+{
+    const char* dir = getenv("SPOJBOARD_NVS");
+#if defined(_WIN32)
+    mkdir(dir ? dir : "nvs");
+#else
+    mkdir(dir ? dir : "nvs", 0755);
+#endif
+
+    char path[256];
+    blobPath(path, sizeof(path), space, key);
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return 0;
+    }
+    size_t written = fwrite(data, 1, size, file);
+    fclose(file);
+    return written;
+}
+
+// ============================================================================
+// Data Partition
+// ============================================================================
+
+static uint8_t* dataImage = nullptr;
+static size_t dataSize = 0;
+
+static bool loadData()
+{
+    static bool loaded = false;
+    if (loaded)
+    {
+        return dataImage != nullptr;
+    }
+    loaded = true;
+
+    const char* path = getenv("SPOJBOARD_DATA");
+    FILE* file = path ? fopen(path, "rb") : nullptr;
+    if (file == nullptr)
+    {
+        return false;
+    }
+    size_t size = fileSize(file);
+    dataImage = size > 0 ? (uint8_t*)malloc(size) : nullptr;  // Kept for the process lifetime, like a mapping
+    if (dataImage != nullptr && fread(dataImage, 1, size, file) == size)
+    {
+        dataSize = size;
+    }
+    else
+    {
+        free(dataImage);
+        dataImage = nullptr;
+    }
+    fclose(file);
+    return dataImage != nullptr;
+}
+
+size_t storageDataSize()
+{
+    return loadData() ? dataSize : 0;
+}
+
+bool storageReadData(size_t offset, void* buffer, size_t size)
+{
+    if (!loadData() || offset > dataSize || size > dataSize - offset)
+    {
+        return false;
+    }
+    memcpy(buffer, dataImage + offset, size);
+    return true;
+}
+
+const uint8_t* storageMapData(size_t size)
+{
+    return (loadData() && size <= dataSize) ? dataImage : nullptr;
+}
@@ -0,0 +1,7 @@
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+// Host Build - Print lives in Arduino.h; the Adafruit GFX Library includes it by this name
+#include "Arduino.h"
+
+#endif // NATIVE_PRINT_H
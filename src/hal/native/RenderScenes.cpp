@@ -0,0 +1,289 @@
+#include "RenderScenes.h"
+#include "../../display/DisplayManager.h"
+#include "../../api/WeatherAPI.h"
+#include "../../utils/TimeUtils.h"
+#include "../../utils/gfxlatin2.h"
+#include "../Clock.h"
+#include <chrono>
+#include <vector>
+
+// Host-side render checks: the screens DisplayManager can show, drawn from
+// fixed data so every run produces the same frames
+
+struct SampleDeparture
+{
+    const char* line;
+    const char* destination;  // UTF-8
+    int eta;
+    int stopIndex;
+    bool isScheduled;
+};
+
+struct SceneBoard
+{
+    Departure departures[MAX_DEPARTURES];
+    DepartureStrings strings;
+    int count;
+};
+
+static void fillBoard(SceneBoard& board, const SampleDeparture* samples, int count)
+{
+    board.strings.reset();
+    board.count = count;
+    for (int i = 0; i < count; i++)
+    {
+        char destination[MAX_DESTINATION_LENGTH];
+        utf8ToGfxLatin2(samples[i].destination, destination, sizeof(destination));
+
+        Departure& dep = board.departures[i];
+        dep = {};
+        dep.departureTime = getCurrentEpochTime() + samples[i].eta * 60;
+        dep.eta = samples[i].eta;
+        dep.stopIndex = samples[i].stopIndex;
+        dep.isScheduled = samples[i].isScheduled;
+        dep.lineId = board.strings.intern(samples[i].line, MAX_LINE_LENGTH);
+        dep.destinationId = board.strings.intern(destination, MAX_DESTINATION_LENGTH);
+    }
+}
+
+static const SampleDeparture REGULAR[] = {
+    {"A", "Depo Hostivař", 0, 0, false},
+    {"22", "Bílá Hora", 6, 1, false},
+    {"136", "Sídliště Čakovice", 12, -1, false},
+};
+
+// One minute later: the 10 s ETA recalculation turned over
+static const SampleDeparture REGULAR_NEXT_MINUTE[] = {
+    {"A", "Depo Hostivař", 0, 0, false},
+    {"22", "Bílá Hora", 5, 1, false},
+    {"136", "Sídliště Čakovice", 11, -1, false},
+};
+
+static const SampleDeparture REGULAR_MINUTE_AFTER[] = {
+    {"A", "Depo Hostivař", 0, 0, false},
+    {"22", "Bílá Hora", 4, 1, false},
+    {"136", "Sídliště Čakovice", 10, -1, false},
+};
+
+static const SampleDeparture CONDENSED[] = {
+    {"S9", "Praha-Čakovice přes Masarykovo n.", 3, 0, false},
+    {"910", "Divoká Šárka, Nové Butovice", 45, -1, false},
+    {"X-9", "Letiště Václava Havla", 75, 1, false},
+};
+
+static const SampleDeparture SCHEDULED[] = {
+    {"31", "Sídliště Libuš", 4, -1, true},
+    {"188", "Kačerov", 9, -1, true},
+};
+
+typedef void (*SceneDraw)(DisplayManager& display, const SceneBoard& board);
+
+struct Scene
+{
+    const char* name;
+    const SampleDeparture* samples;
+    int sampleCount;
+    int clockOffset;  // Seconds after the start time
+    SceneDraw draw;
+};
+
+static void drawBoard(DisplayManager& display, const SceneBoard& board)
+{
+    display.updateDisplay(board.departures, board.strings, board.count, 3, true, false, "", "", false, "",
+                          "Malostranská", true);
+}
+
+static void drawErrorBar(DisplayManager& display, const SceneBoard& board)
+{
+    display.updateDisplay(board.departures, board.strings, board.count, 3, true, false, "", "", true,
+                          "HTTP error: 503", "Malostranská", true);
+}
+
+static void drawOffline(DisplayManager& display, const SceneBoard& board)
+{
+    display.updateDisplay(board.departures, board.strings, board.count, 3, false, false, "", "", false, "",
+                          "Malostranská", true);
+}
+
+static void drawNoDepartures(DisplayManager& display, const SceneBoard& board)
+{
+    display.updateDisplay(board.departures, board.strings, 0, 3, true, false, "", "", false, "",
+                          "Malostranska", true);
+}
+
+static void drawSetupRequired(DisplayManager& display, const SceneBoard& board)
+{
+    display.updateDisplay(board.departures, board.strings, 0, 3, true, false, "", "", false, "", "", false);
+}
+
+static void drawAPMode(DisplayManager& display, const SceneBoard& board)
+{
+    display.updateDisplay(board.departures, board.strings, 0, 3, false, true, "SpojBoard-A1B2", "spojboard",
+                          false, "", "", false);
+}
+
+static void drawOTAProgress(DisplayManager& display, const SceneBoard& board)
+{
+    (void)board;
+    display.drawOTAProgress(642000, 1520000);
+}
+
+static void drawWeatherDebug(DisplayManager& display, const SceneBoard& board)
+{
+    (void)board;
+    display.drawWeatherDebug();
+}
+
+// In order: each scene's update is drawn after the scenes before it
+static const Scene SCENES[] = {
+    {"departures", REGULAR, 3, 0, drawBoard},
+    {"departures-next-minute", REGULAR_NEXT_MINUTE, 3, 60, drawBoard},
+    {"departures-same-minute", REGULAR_NEXT_MINUTE, 3, 70, drawBoard},
+    {"departures-minute-after", REGULAR_MINUTE_AFTER, 3, 120, drawBoard},
+    {"departures-condensed", CONDENSED, 3, 130, drawBoard},
+    {"departures-two-rows", REGULAR, 2, 130, drawBoard},
+    {"error-bar", REGULAR, 3, 130, drawErrorBar},
+    {"offline-timetable", SCHEDULED, 2, 130, drawOffline},
+    {"no-departures", nullptr, 0, 130, drawNoDepartures},
+    {"setup-required", nullptr, 0, 130, drawSetupRequired},
+    {"ap-mode", nullptr, 0, 130, drawAPMode},
+    {"ota-progress", nullptr, 0, 130, drawOTAProgress},
+    {"weather-debug", nullptr, 0, 130, drawWeatherDebug},
+};
+
+struct DrawStats
+{
+    long long minUs;
+    long long maxUs;
+    long long totalUs;
+    uint32_t pixelWrites;
+};
+
+// Draw a scene on the manual clock, so the status bar does not depend on how often it ran
+static void drawScene(DisplayManager& display, SceneBoard& board, const Scene& scene, time_t epoch)
+{
+    clockSetManual(epoch + scene.clockOffset);
+    fillBoard(board, scene.samples, scene.sampleCount);
+    scene.draw(display, board);
+}
+
+/**
+ * Time SCENES[index] drawn from a cleared panel (history == 0) or as an update
+ * after the first history scenes were shown in order, so a double-buffered
+ * panel holds in each buffer what it would have on the board. The canvas
+ * counts the pixels written by the last run.
+ */
+static DrawStats timeScene(DisplayManager& display, SceneBoard& board, int index, int history, time_t epoch,
+                           int repeat)
+{
+    using namespace std::chrono;
+    const Scene& scene = SCENES[index];
+    FrameCanvas* canvas = display.getDisplay();
+    DrawStats stats = {-1, 0, 0, 0};
+    for (int run = 0; run < repeat; run++)
+    {
+        display.invalidateFrame();
+        for (int i = 0; i < history; i++)
+        {
+            drawScene(display, board, SCENES[i], epoch);
+        }
+        clockSetManual(epoch + scene.clockOffset);
+        fillBoard(board, scene.samples, scene.sampleCount);
+
+        // Wall-clock timing: the manual clock does not advance while drawing
+        canvas->resetPixelWrites();
+        steady_clock::time_point start = steady_clock::now();
+        scene.draw(display, board);
+        long long elapsedUs = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+        stats.minUs = (stats.minUs < 0 || elapsedUs < stats.minUs) ? elapsedUs : stats.minUs;
+        stats.maxUs = (elapsedUs > stats.maxUs) ? elapsedUs : stats.maxUs;
+        stats.totalUs += elapsedUs;
+        stats.pixelWrites = canvas->getPixelWrites();
+    }
+    return stats;
+}
+
+int renderScenes(const char* outDir, const char* goldenDir, int repeat)
+{
+    time_t epoch = getCurrentEpochTime();
+
+    static Config config = {};
+    config.weatherEnabled = true;
+    config.brightness = 90;
+
+    static WeatherData weather = {};
+    weather.temperature = 18;
+    weather.weatherCode = 2;
+    weather.timestamp = epoch;
+
+    static DisplayManager display;
+    display.begin(config.brightness);
+    display.setConfig(&config);
+    display.setWeatherData(&weather);
+    FrameCanvas* canvas = display.getDisplay();
+    int pixelCount = canvas->width() * canvas->height();
+
+    static SceneBoard board;
+    int mismatches = 0;
+    int sceneCount = sizeof(SCENES) / sizeof(SCENES[0]);
+    for (int index = 0; index < sceneCount; index++)
+    {
+        const Scene& scene = SCENES[index];
+        DrawStats full = timeScene(display, board, index, 0, epoch, repeat);
+        std::vector<uint16_t> fullFrame(pixelCount);
+        for (int i = 0; i < pixelCount; i++)
+        {
+            fullFrame[i] = canvas->getPixel(i % canvas->width(), i / canvas->width());
+        }
+
+        // The update after the previous scenes must leave exactly the full redraw on the panel
+        char update[96] = "";
+        if (index > 0)
+        {
+            DrawStats stats = timeScene(display, board, index, index, epoch, repeat);
+            int differences = 0;
+            for (int i = 0; i < pixelCount; i++)
+            {
+                differences += fullFrame[i] != canvas->getPixel(i % canvas->width(), i / canvas->width());
+            }
+            if (differences > 0)
+            {
+                printf("%s: update from %s differs from a full redraw in %d pixel(s)\n", scene.name,
+                       SCENES[index - 1].name, differences);
+                mismatches++;
+            }
+            snprintf(update, sizeof(update), " | update %lld us, %lu px", stats.totalUs / repeat,
+                     (unsigned long)stats.pixelWrites);
+        }
+
+        char path[512];
+        const char* status = "";
+        if (outDir != nullptr)
+        {
+            snprintf(path, sizeof(path), "%s/%s.ppm", outDir, scene.name);
+            if (!canvas->writePPM(path))
+            {
+                fprintf(stderr, "Cannot write %s\n", path);
+            }
+        }
+        if (goldenDir != nullptr)
+        {
+            snprintf(path, sizeof(path), "%s/%s.ppm", goldenDir, scene.name);
+            int differences = canvas->comparePPM(path);
+            status = (differences == 0) ? "  golden ok" : (differences < 0) ? "  golden MISSING" : "  golden DIFFERS";
+            if (differences != 0)
+            {
+                mismatches++;
+            }
+            if (differences > 0)
+            {
+                printf("%s: %d pixel(s) differ from %s\n", scene.name, differences, path);
+            }
+        }
+
+        printf("Render %-24s full min %lld us, avg %lld us, max %lld us, %lu px%s%s\n", scene.name, full.minUs,
+               full.totalUs / repeat, full.maxUs, (unsigned long)full.pixelWrites, update, status);
+    }
+    return mismatches;
+}
@@ -0,0 +1,27 @@
+#ifndef RENDERSCENES_H
+#define RENDERSCENES_H
+
+// ============================================================================
+// Render Scenes (host build)
+// ============================================================================
+
+#include <time.h>
+
+// Status bar time of the reference screens (and of the golden images in test/golden/)
+static const time_t RENDER_EPOCH = 1790000000;
+
+/**
+ * Draw the reference screens (departure rows, status bar, error bar, AP mode,
+ * OTA progress, ...) through DisplayManager on a FrameCanvas, time each
+ * draw call and count the pixels it writes: once from a cleared panel and
+ * once as an update after the scenes before it (e.g. the next ETA minute).
+ * Run on a manual clock so the status bar is the same on every run.
+ * @param outDir Directory to write <scene>.ppm into (nullptr: don't write)
+ * @param goldenDir Directory with golden <scene>.ppm to compare against (nullptr: don't compare)
+ * @param repeat Draw calls timed per scene
+ * @return Number of scenes that differ from (or are missing in) goldenDir, or
+ *         whose update differs from the full redraw
+ */
+int renderScenes(const char* outDir, const char* goldenDir, int repeat);
+
+#endif // RENDERSCENES_H
@@ -0,0 +1,60 @@
+#include "ReplayHttpFetch.h"
+
+ReplayHttpFetch::ReplayHttpFetch() : responseCount(0), bodySize(-1)
+{
+}
+
+bool ReplayHttpFetch::setResponse(const char* server, int status, const uint8_t* body, size_t size)
+{
+    for (int i = 0; i < responseCount; i++)
+    {
+        if (strcmp(responses[i].server, server) == 0)
+        {
+            responses[i].status = status;
+            responses[i].body = body;
+            responses[i].size = size;
+            return true;
+        }
+    }
+
+    if (responseCount >= MAX_RESPONSES)
+    {
+        return false;
+    }
+    Response& response = responses[responseCount++];
+    strlcpy(response.server, server, sizeof(response.server));
+    response.status = status;
+    response.body = body;
+    response.size = size;
+    return true;
+}
+
+int ReplayHttpFetch::get(const char* server, const char* path, const char* const* headers, int headerPairs,
+                         int timeoutMs)
+{
+    (void)path;
+    (void)headers;
+    (void)headerPairs;
+    (void)timeoutMs;
+
+    for (int i = 0; i < responseCount; i++)
+    {
+        if (strcmp(responses[i].server, server) == 0)
+        {
+            body.begin(responses[i].body, responses[i].size);
+            bodySize = (int)responses[i].size;
+            return responses[i].status;
+        }
+    }
+
+    body.begin(nullptr, 0);
+    bodySize = -1;
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+}
+
+void ReplayHttpFetch::end(bool keepAlive)
+{
+    (void)keepAlive;
+    body.begin(nullptr, 0);
+    bodySize = -1;
+}
@@ -0,0 +1,86 @@
+#ifndef REPLAYHTTPFETCH_H
+#define REPLAYHTTPFETCH_H
+
+#include "../HttpFetch.h"
+
+// ============================================================================
+// Replay Transport (host build)
+// ============================================================================
+
+/**
+ * Stream over a byte buffer (not copied)
+ */
+class MemoryStream : public Stream
+{
+public:
+    MemoryStream() : data(nullptr), size(0), position(0) {}
+
+    void begin(const uint8_t* buffer, size_t length)
+    {
+        data = buffer;
+        size = length;
+        position = 0;
+    }
+
+    int available() override { return (int)(size - position); }
+    int read() override { return position < size ? data[position++] : -1; }
+    int peek() override { return position < size ? data[position] : -1; }
+
+    size_t readBytes(char* buffer, size_t length) override
+    {
+        size_t count = (length < size - position) ? length : size - position;
+        memcpy(buffer, data + position, count);
+        position += count;
+        return count;
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t position;
+};
+
+/**
+ * Answers every request from a table of recorded responses, one per server.
+ * Used by the host runner (--replay) to run the real parse paths on saved
+ * API responses without a network.
+ */
+class ReplayHttpFetch : public HttpFetch
+{
+public:
+    static constexpr int MAX_RESPONSES = 8;
+
+    ReplayHttpFetch();
+
+    /**
+     * Answer requests to a server with a fixed response
+     * @param server Host name the API code requests (e.g. "api.golemio.cz")
+     * @param status HTTP status to return
+     * @param body Response body (kept by pointer)
+     * @param size Size of body
+     * @return false if the table is full
+     */
+    bool setResponse(const char* server, int status, const uint8_t* body, size_t size);
+
+    int get(const char* server, const char* path, const char* const* headers, int headerPairs,
+            int timeoutMs) override;
+    Stream& getBody() override { return body; }
+    int getBodySize() override { return bodySize; }
+    void end(bool keepAlive) override;
+
+private:
+    struct Response
+    {
+        char server[64];
+        int status;
+        const uint8_t* body;
+        size_t size;
+    };
+
+    Response responses[MAX_RESPONSES];
+    int responseCount;
+    MemoryStream body;
+    int bodySize;
+};
+
+#endif // REPLAYHTTPFETCH_H
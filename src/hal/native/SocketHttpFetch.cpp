@@ -0,0 +1,225 @@
+#include "SocketHttpFetch.h"
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: SO_NOSIGPIPE is set on the socket instead
+#endif
+#endif
+
+SocketHttpFetch::SocketHttpFetch() : bodySize(-1)
+{
+}
+
+#if defined(_WIN32)
+
+// No socket transport on Windows - use --replay there
+int SocketHttpFetch::connectTo(const char* server, int timeoutMs)
+{
+    (void)server;
+    (void)timeoutMs;
+    return -1;
+}
+
+int SocketHttpFetch::get(const char* server, const char* path, const char* const* headers, int headerPairs,
+                         int timeoutMs)
+{
+    (void)server;
+    (void)path;
+    (void)headers;
+    (void)headerPairs;
+    (void)timeoutMs;
+    end(false);
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+}
+
+#else
+
+int SocketHttpFetch::connectTo(const char* server, int timeoutMs)
+{
+    // server is "host" or "host:port"
+    char host[64];
+    strlcpy(host, server, sizeof(host));
+    const char* port = "80";
+    char* colon = strrchr(host, ':');
+    if (colon != nullptr)
+    {
+        *colon = '\0';
+        port = colon + 1;
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host, port, &hints, &addresses) != 0)
+    {
+        return -1;
+    }
+
+    // Linux applies SO_SNDTIMEO to connect() as well
+    timeval timeout = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    int fd = -1;
+    for (addrinfo* address = addresses; address != nullptr && fd < 0; address = address->ai_next)
+    {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0)
+            continue;
+
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+        int noSigPipe = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+        if (connect(fd, address->ai_addr, address->ai_addrlen) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    return fd;
+}
+
+int SocketHttpFetch::get(const char* server, const char* path, const char* const* headers, int headerPairs,
+                         int timeoutMs)
+{
+    end(false);
+
+    int fd = connectTo(server, timeoutMs);
+    if (fd < 0)
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: " + server + "\r\n";
+    for (int i = 0; i < headerPairs; i++)
+    {
+        request += std::string(headers[i * 2]) + ": " + headers[i * 2 + 1] + "\r\n";
+    }
+    request += "Connection: close\r\n\r\n";
+
+    if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t)request.size())
+    {
+        close(fd);
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+
+    // Read to EOF; a reset or an idle timeout ends the response early
+    bool timedOut = false;
+    uint8_t buffer[4096];
+    for (;;)
+    {
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count > 0)
+        {
+            response.insert(response.end(), buffer, buffer + count);
+            continue;
+        }
+        timedOut = count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        break;
+    }
+    close(fd);
+
+    int httpCode = parseResponse();
+    if (httpCode == 0)
+    {
+        // No complete response head
+        end(false);
+        return timedOut ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_LOST;
+    }
+    return httpCode;
+}
+
+int SocketHttpFetch::parseResponse()
+{
+    static const char HEAD_END[] = "\r\n\r\n";
+    size_t limit = response.size() < MAX_HEAD ? response.size() : MAX_HEAD;
+    std::string head(response.begin(), response.begin() + limit);
+    size_t headEnd = head.find(HEAD_END);
+    int status = 0;
+    if (headEnd == std::string::npos || sscanf(head.c_str(), "HTTP/%*d.%*d %d", &status) != 1)
+    {
+        return 0;
+    }
+    head.resize(headEnd + 2);
+
+    // Header names are case-insensitive
+    bool chunked = false;
+    int contentLength = -1;
+    size_t lineStart = head.find("\r\n") + 2;
+    while (lineStart < head.size())
+    {
+        size_t lineEnd = head.find("\r\n", lineStart);
+        std::string line = head.substr(lineStart, lineEnd - lineStart);
+        const char* text = line.c_str();
+        if (strncasecmp(text, "Content-Length:", 15) == 0)
+        {
+            contentLength = atoi(text + 15);
+        }
+        else if (strncasecmp(text, "Transfer-Encoding:", 18) == 0 && strcasestr(text + 18, "chunked") != nullptr)
+        {
+            chunked = true;
+        }
+        lineStart = lineEnd + 2;
+    }
+
+    size_t bodyStart = headEnd + 4;
+    if (chunked)
+    {
+        decodeChunked(bodyStart);
+        body.begin(decoded.data(), decoded.size());
+        bodySize = -1;
+    }
+    else
+    {
+        body.begin(response.data() + bodyStart, response.size() - bodyStart);
+        bodySize = contentLength;
+    }
+    return status;
+}
+
+void SocketHttpFetch::decodeChunked(size_t offset)
+{
+    // hex size [;extension] CRLF, data, CRLF ... 0 CRLF; stops at the first short chunk
+    decoded.clear();
+    while (offset < response.size())
+    {
+        char* sizeEnd = nullptr;
+        std::string sizeLine(response.begin() + offset,
+                             response.begin() + std::min(offset + 64, response.size()));
+        unsigned long size = strtoul(sizeLine.c_str(), &sizeEnd, 16);
+        if (sizeEnd == sizeLine.c_str() || size == 0)
+            break;
+
+        size_t lineEnd = sizeLine.find("\r\n");
+        if (lineEnd == std::string::npos)
+            break;
+        offset += lineEnd + 2;
+
+        size_t available = response.size() - offset;
+        size_t count = size < available ? size : available;
+        decoded.insert(decoded.end(), response.begin() + offset, response.begin() + offset + count);
+        offset += count + 2;
+        if (count < size)
+            break;
+    }
+}
+
+#endif // _WIN32
+
+void SocketHttpFetch::end(bool keepAlive)
+{
+    (void)keepAlive;  // Every request has its own connection
+    response.clear();
+    decoded.clear();
+    body.begin(nullptr, 0);
+    bodySize = -1;
+}
@@ -0,0 +1,45 @@
+#ifndef SOCKETHTTPFETCH_H
+#define SOCKETHTTPFETCH_H
+
+#include "ReplayHttpFetch.h"
+#include <vector>
+
+// ============================================================================
+// Plain HTTP Transport (host build, POSIX sockets)
+// ============================================================================
+
+/**
+ * Sends each request over a new plain-HTTP connection (Connection: close),
+ * for running the host build against a local stand-in server
+ * (scripts/api_standin.py). No TLS: live services need https and are not
+ * reachable through this transport.
+ *
+ * get() reads the whole response before returning, so a slow body counts
+ * towards the fetch time but not the parse time. A body cut short by a
+ * reset or read timeout is returned as received, like the ESP32 stream.
+ */
+class SocketHttpFetch : public HttpFetch
+{
+public:
+    SocketHttpFetch();
+
+    int get(const char* server, const char* path, const char* const* headers, int headerPairs,
+            int timeoutMs) override;
+    Stream& getBody() override { return body; }
+    int getBodySize() override { return bodySize; }
+    void end(bool keepAlive) override;
+
+private:
+    static constexpr size_t MAX_HEAD = 8192;
+
+    std::vector<uint8_t> response;  // Raw bytes as received
+    std::vector<uint8_t> decoded;   // Body with chunked encoding removed
+    MemoryStream body;
+    int bodySize;
+
+    static int connectTo(const char* server, int timeoutMs);
+    int parseResponse();
+    void decodeChunked(size_t offset);
+};
+
+#endif // SOCKETHTTPFETCH_H
@@ -0,0 +1,260 @@
+// Host runner (env:native): runs one provider's real fetch and parse path on
+// a PC and prints the departures and timings. Unit tests bring their own
+// main(), so this one is left out of `pio test` builds.
+#if !defined(PIO_UNIT_TESTING)
+
+#include "../../api/GolemioAPI.h"
+#include "../../api/BvgAPI.h"
+#include "../../api/GtfsRtAPI.h"
+#include "../../api/WeatherAPI.h"
+#include "../../network/HttpConnectionManager.h"
+#include "../../utils/Logger.h"
+#include "../../utils/Metrics.h"
+#include "../../utils/TimeUtils.h"
+#include "../Clock.h"
+#include "ReplayHttpFetch.h"
+#include "RenderScenes.h"
+#include "SocketHttpFetch.h"
+#include <vector>
+
+static const char USAGE[] =
+    "Usage: program [options]\n"
+    "  --city NAME             Prague (default), Berlin or GTFS-RT\n"
+    "  --stops IDS             Comma-separated stop IDs of that city\n"
+    "  --key KEY               Golemio API key\n"
+    "  --feed URL              GTFS-Realtime feed URL\n"
+    "  --weather LAT,LON       Also fetch the weather\n"
+    "  --replay SERVER=FILE    Answer requests to SERVER with FILE (HTTP 200)\n"
+    "  --server URL            Send requests to a stand-in server (http://host:port)\n"
+    "  --clock EPOCH           Run on a manual clock from EPOCH (retries cost no time)\n"
+    "  --repeat N              Fetch (or draw each scene) N times and report min/avg/max\n"
+    "  --render DIR            Draw the reference screens into DIR/<scene>.ppm instead of fetching\n"
+    "  --golden DIR            Compare the reference screens with DIR/<scene>.ppm instead of fetching\n"
+    "\n"
+    "Exits with 3 if any JsonDocument overflowed its JSON_BUFFER_SIZE, and with 4\n"
+    "if a reference screen differs from its golden image or an incremental update\n"
+    "differs from a full redraw.\n";
+
+static std::vector<std::vector<uint8_t>> replayBodies;  // Kept alive for the transport
+
+static bool loadReplay(ReplayHttpFetch& transport, const char* spec)
+{
+    const char* separator = strchr(spec, '=');
+    if (separator == nullptr)
+    {
+        return false;
+    }
+
+    std::string server(spec, separator - spec);
+    FILE* file = fopen(separator + 1, "rb");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "Cannot open %s\n", separator + 1);
+        return false;
+    }
+    std::vector<uint8_t> body;
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        body.insert(body.end(), buffer, buffer + count);
+    }
+    fclose(file);
+
+    replayBodies.push_back(body);
+    const std::vector<uint8_t>& stored = replayBodies.back();
+    return transport.setResponse(server.c_str(), 200, stored.data(), stored.size());
+}
+
+// Peak JsonDocument use per provider; returns false if any document overflowed
+static bool printJsonStats()
+{
+    bool ok = true;
+    Metrics& metrics = Metrics::getInstance();
+    for (int d = 0; d < Metrics::JSON_DOC_COUNT; d++)
+    {
+        const JsonDocumentStats& stats = metrics.getJsonDocStats((Metrics::JsonDoc)d);
+        if (stats.documents == 0)
+            continue;
+
+        printf("JSON %s: %lu document(s), peak %lu/%lu bytes (%lu%%), %lu overflow(s)\n",
+               Metrics::getJsonDocName((Metrics::JsonDoc)d), (unsigned long)stats.documents,
+               (unsigned long)stats.peakBytes, (unsigned long)stats.capacity,
+               (unsigned long)(stats.capacity ? stats.peakBytes * 100UL / stats.capacity : 0),
+               (unsigned long)stats.overflows);
+        ok = ok && stats.overflows == 0;
+    }
+    return ok;
+}
+
+static void printResult(const TransitAPI::APIResult& result)
+{
+    printf("%s: %d departures%s%s\n", result.stopName, result.departureCount,
+           result.hasError ? " - error: " : "", result.hasError ? result.errorMsg : "");
+    for (int i = 0; i < result.departureCount; i++)
+    {
+        const Departure& dep = result.departures[i];
+        printf("  %-5s %-28s %3d min  stop %d%s\n", result.strings.get(dep.lineId),
+               result.strings.get(dep.destinationId), calculateETA(dep.departureTime), dep.stopIndex,
+               dep.isDelayed ? "  delayed" : "");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    static Config config = {};
+    strlcpy(config.city, "Prague", sizeof(config.city));
+    config.numDepartures = 3;
+    config.minDepartureTime = 0;
+    config.refreshInterval = 300;
+    config.configured = true;
+
+    static ReplayHttpFetch replay;
+    static SocketHttpFetch socketFetch;
+    int repeat = 1;
+    bool manualClock = false;
+    const char* renderDir = nullptr;
+    const char* goldenDir = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* option = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (value == nullptr)
+        {
+            fputs(USAGE, stderr);
+            return 2;
+        }
+        i++;
+
+        if (strcmp(option, "--city") == 0)
+        {
+            strlcpy(config.city, value, sizeof(config.city));
+        }
+        else if (strcmp(option, "--stops") == 0)
+        {
+            strlcpy(config.pragueStopIds, value, sizeof(config.pragueStopIds));
+            strlcpy(config.berlinStopIds, value, sizeof(config.berlinStopIds));
+            strlcpy(config.gtfsRtStopIds, value, sizeof(config.gtfsRtStopIds));
+        }
+        else if (strcmp(option, "--key") == 0)
+        {
+            strlcpy(config.pragueApiKey, value, sizeof(config.pragueApiKey));
+        }
+        else if (strcmp(option, "--feed") == 0)
+        {
+            strlcpy(config.gtfsRtFeedUrl, value, sizeof(config.gtfsRtFeedUrl));
+        }
+        else if (strcmp(option, "--weather") == 0)
+        {
+            config.weatherEnabled = sscanf(value, "%f,%f", &config.weatherLatitude, &config.weatherLongitude) == 2;
+        }
+        else if (strcmp(option, "--replay") == 0)
+        {
+            if (!loadReplay(replay, value))
+            {
+                fputs(USAGE, stderr);
+                return 2;
+            }
+            HttpConnectionManager::getInstance().setTransport(&replay);
+        }
+        else if (strcmp(option, "--server") == 0)
+        {
+            HttpConnectionManager::getInstance().setBaseUrl(value);
+            HttpConnectionManager::getInstance().setTransport(&socketFetch);
+        }
+        else if (strcmp(option, "--clock") == 0)
+        {
+            clockSetManual((time_t)strtoll(value, nullptr, 10));
+            manualClock = true;
+        }
+        else if (strcmp(option, "--render") == 0)
+        {
+            renderDir = value;
+        }
+        else if (strcmp(option, "--golden") == 0)
+        {
+            goldenDir = value;
+        }
+        else if (strcmp(option, "--repeat") == 0)
+        {
+            repeat = atoi(value) > 0 ? atoi(value) : 1;
+        }
+        else
+        {
+            fputs(USAGE, stderr);
+            return 2;
+        }
+    }
+
+    initLogger(&config);
+
+    if (renderDir != nullptr || goldenDir != nullptr)
+    {
+        if (!manualClock)
+        {
+            clockSetManual(RENDER_EPOCH);
+        }
+        return renderScenes(renderDir, goldenDir, repeat) > 0 ? 4 : 0;
+    }
+
+    static GolemioAPI golemioAPI;
+    static BvgAPI bvgAPI;
+    static GtfsRtAPI gtfsRtAPI;
+    TransitAPI* transitAPI = &golemioAPI;
+    if (strcmp(config.city, "Berlin") == 0)
+    {
+        transitAPI = &bvgAPI;
+    }
+    else if (strcmp(config.city, "GTFS-RT") == 0)
+    {
+        transitAPI = &gtfsRtAPI;
+    }
+
+    // APIResult holds the string table too - keep it off the stack like the firmware does
+    static TransitAPI::APIResult result;
+    unsigned long minUs = 0xFFFFFFFFUL;
+    unsigned long maxUs = 0;
+    unsigned long long totalUs = 0;
+    for (int run = 0; run < repeat; run++)
+    {
+        unsigned long startUs = clockMicros();
+        result = transitAPI->fetchDepartures(config);
+        unsigned long elapsedUs = clockMicros() - startUs;
+
+        minUs = (elapsedUs < minUs) ? elapsedUs : minUs;
+        maxUs = (elapsedUs > maxUs) ? elapsedUs : maxUs;
+        totalUs += elapsedUs;
+    }
+
+    printResult(result);
+    printf("Fetch: %d run(s), min %lu us, avg %llu us, max %lu us\n", repeat, minUs, totalUs / repeat, maxUs);
+    if (result.departureCount > 0)
+    {
+        printf("Fetch: avg %llu us per departure\n", totalUs / repeat / result.departureCount);
+    }
+
+    if (config.weatherEnabled)
+    {
+        WeatherAPI weatherAPI;
+        WeatherData weather = weatherAPI.fetchWeather(config.weatherLatitude, config.weatherLongitude);
+        if (weather.hasError)
+        {
+            printf("Weather: error: %s\n", weather.errorMsg);
+        }
+        else
+        {
+            printf("Weather: %d C, WMO code %d\n", weather.temperature, weather.weatherCode);
+        }
+    }
+
+    HttpConnectionManager::getInstance().logStats();
+    if (!printJsonStats())
+    {
+        fputs("JSON document overflow - raise the provider's JSON_BUFFER_SIZE\n", stderr);
+        return 3;
+    }
+    return result.hasError ? 1 : 0;
+}
+
+#endif // !PIO_UNIT_TESTING
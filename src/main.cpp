@@ -5,12 +5,20 @@
 #include "utils/TimeUtils.h"
 #include "utils/gfxlatin2.h"
 #include "utils/TelnetLogger.h"
+#include "utils/BootTimeline.h"
+#include "utils/Metrics.h"
 #include "config/AppConfig.h"
 #include "api/DepartureData.h"
 #include "api/GolemioAPI.h"
 #include "api/WeatherAPI.h"
+#include "api/FetchTask.h"
+#include "api/RefreshScheduler.h"
 #if !defined(MATRIX_PORTAL_M4)
 #include "api/BvgAPI.h"
+#include "api/GtfsRtAPI.h"
+#include "api/StaticSchedule.h"
+#include "api/DepartureSnapshot.h"
+#include "network/HttpConnectionManager.h"
 #endif
 #include "display/DisplayManager.h"
 #include "network/WiFiManager.h"
@@ -39,8 +47,10 @@ GolemioAPI golemioAPI;  // Prague transit API
 WeatherAPI weatherAPI;  // Weather forecast API
 #if !defined(MATRIX_PORTAL_M4)
 BvgAPI bvgAPI;          // Berlin transit API
+GtfsRtAPI gtfsRtAPI;    // Any GTFS-Realtime TripUpdates feed
 #endif
 TransitAPI* transitAPI = nullptr;  // Pointer to active API (selected at runtime)
+FetchTask fetchTask;    // Runs API fetches off the main loop
 
 // ============================================================================
 // Configuration Storage (structure defined in config/AppConfig.h)
@@ -51,12 +61,13 @@ Config config;
 // Departure Data (structure defined in api/DepartureData.h)
 // ============================================================================
 Departure departures[MAX_DEPARTURES];
+DepartureStrings departureStrings;  // Lines and destinations referenced by departures[]
 int departureCount = 0;
 
 // ============================================================================
 // State Variables
 // ============================================================================
-unsigned long lastApiCall = 0;
+RefreshScheduler refreshScheduler;  // Decides when the next departure fetch is due
 unsigned long lastDisplayUpdate = 0;
 unsigned long lastEtaRecalc = 0;  // For 10-second ETA recalculation
 unsigned long lastWeatherCall = 0;  // For weather API polling
@@ -65,7 +76,19 @@ bool apiError = false;
 char apiErrorMsg[64] = "";
 char stopName[64] = "";
 bool demoModeActive = false;  // Demo mode flag - stops API polling and display updates
+unsigned long lastLiveDataMs = 0;  // Last fetch that completed without error (0 = none yet)
 WeatherData weatherData = {0, 0, 0, true, ""};  // Initialize with hasError=true until first successful fetch
+bool snapshotPending = false;  // Board restored from NVS, waiting for a plausible clock
+bool firstFrameLogged = false; // Boot-to-first-departure-frame time already logged
+int firstFetchPhase = -1;      // Boot timeline phase of the initial fetch
+bool bootTimelinePending = false;  // Initial fetch done, log the timeline after its frame
+static constexpr unsigned long IP_SPLASH_MS = 1500;  // Minimum time the "WiFi Connected!" screen stays up
+unsigned long displayHoldUntilMs = 0;  // Status screen stays until then unless departures arrive
+
+// Loop latency tracking (time between successive loop() entries)
+unsigned long lastLoopStartUs = 0;
+unsigned long loopLatencyMaxUs = 0;    // Worst case since last STATUS log
+unsigned long loopLatencyWorstUs = 0;  // Worst case since boot
 
 // Network layer is now in network/ modules:
 // - WiFiManager: WiFi connection and AP mode
@@ -74,41 +97,182 @@ WeatherData weatherData = {0, 0, 0, true, ""};  // Initialize with hasError=true
 
 // Forward declarations
 bool isCityConfigured();
+const char* getActiveStopIds();
+#if !defined(MATRIX_PORTAL_M4)
+bool isLiveDataStale();
+void fillFromSchedule();
+uint32_t getActiveStopsKey();
+#endif
 
 // ============================================================================
-// API Status Callback - Updates display during retries
+// Fetch Results - Applies snapshots published by the fetch task
 // ============================================================================
-void onAPIStatus(const char* message)
+void applyDepartureResult(const TransitAPI::APIResult& result, bool isFinal)
 {
-    displayManager.drawStatus(message, "", COLOR_YELLOW);
-}
+    // Build the new board, then apply it to the cache as a trip delta
+    static Departure nextDepartures[MAX_DEPARTURES];
+    static DepartureStrings nextStrings;
+    const Departure* next = result.departures;
+    const DepartureStrings* nextStringTable = &result.strings;
+    int nextCount = result.departureCount;
+    uint32_t trimmedStops = 0;
+    // A failed single-stop refresh keeps that stop's rows until one succeeds -
+    // a brief API error must not blank it (the scheduler still backs it off below)
+    bool keepCache = result.refreshedStop >= 0 && result.hasError;
+    if (result.refreshedStop >= 0 && !keepCache)
+    {
+        // Single-stop refresh: swap that stop's entries, keep everyone else's
+        // (live data is back, so timetable fallback entries go)
+        int liveCount = 0;
+        for (int i = 0; i < departureCount; i++)
+        {
+            if (!departures[i].isScheduled)
+            {
+                nextDepartures[liveCount++] = departures[i];
+            }
+        }
+        nextStrings = departureStrings;
+        nextCount = replaceStopDepartures(nextDepartures, nextStrings, liveCount,
+                                          result.refreshedStop, result.departures, result.strings,
+                                          result.departureCount, trimmedStops);
+        next = nextDepartures;
+        nextStringTable = &nextStrings;
+    }
 
-// ============================================================================
-// Partial Results Callback - Updates display as each stop is queried
-// ============================================================================
-void onPartialResults(const Departure* partialDepartures, int count, const char* partialStopName)
-{
-    // Update global state with partial results
-    departureCount = count;
-    for (int i = 0; i < count; i++)
+    DepartureDelta delta = {0, 0, 0};
+    if (!keepCache)
     {
-        departures[i] = partialDepartures[i];
+        departureCount = applyDepartureDelta(departures, departureStrings, departureCount,
+                                             next, *nextStringTable, nextCount, delta);
     }
-    if (partialStopName && partialStopName[0])
+
+#if !defined(MATRIX_PORTAL_M4)
+    // A failed fetch leaves the board empty - put the timetable back right away
+    if (isFinal && result.hasError && StaticSchedule::getInstance().isAvailable() && isLiveDataStale())
     {
-        strlcpy(stopName, partialStopName, sizeof(stopName));
+        fillFromSchedule();
+    }
+#endif
+
+    bool wasError = apiError;
+    char previousStopName[sizeof(stopName)];
+    strlcpy(previousStopName, stopName, sizeof(previousStopName));
+
+    if (!isFinal)
+    {
+        // Partial results (after each stop) - keep previous stop name until one arrives
+        if (result.stopName[0])
+        {
+            strlcpy(stopName, result.stopName, sizeof(stopName));
+        }
+
+        // Clear any previous error since we have data
+        apiError = false;
+    }
+    else
+    {
+        // Single-stop results only carry a name for the first stop
+        if (result.refreshedStop < 0 || result.stopName[0])
+        {
+            strlcpy(stopName, result.stopName, sizeof(stopName));
+        }
+
+        if (firstFetchPhase >= 0)
+        {
+            BootTimeline::getInstance().end(firstFetchPhase);
+            firstFetchPhase = -1;
+            bootTimelinePending = true;
+        }
+
+        Metrics::getInstance().recordRefresh(result.refreshedStop < 0, !result.hasError);
+        apiError = result.hasError;
+        if (result.hasError)
+        {
+            strlcpy(apiErrorMsg, result.errorMsg, sizeof(apiErrorMsg));
+        }
+        else
+        {
+            lastLiveDataMs = millis();
+        }
+
+#if !defined(MATRIX_PORTAL_M4)
+        // Keep the last good board for the next boot (rate-limited inside)
+        struct tm timeinfo;
+        if (!result.hasError && getCurrentTime(&timeinfo))
+        {
+            saveDepartureSnapshot(departures, departureStrings, departureCount, stopName, weatherData,
+                                  getActiveStopsKey(), getCurrentEpochTime());
+        }
+#endif
+
+        // Plan the next fetches from the updated cache
+        time_t lastFetched = (result.departureCount > 0) ? result.departures[result.departureCount - 1].departureTime : 0;
+        refreshScheduler.onFetchCompleted(config, result.refreshedStop, result.hasError,
+                                          result.truncated, lastFetched, trimmedStops,
+                                          departures, departureCount, getCurrentEpochTime(), millis());
+
+        unsigned long nowMs = millis();
+        int nextTarget = refreshScheduler.getNextTarget(nowMs);
+        char planMsg[96];
+        snprintf(planMsg, sizeof(planMsg), "Refresh: next fetch (%s) in %lus (%s)",
+                 nextTarget == RefreshScheduler::ALL_STOPS ? "all stops" : "one stop",
+                 refreshScheduler.getSecondsUntilNextFetch(nowMs),
+                 RefreshScheduler::reasonToString(refreshScheduler.getReason(nowMs)));
+        logTimestamp();
+        debugPrintln(planMsg);
+    }
+
+    char deltaMsg[80];
+    snprintf(deltaMsg, sizeof(deltaMsg), "Departures: +%d added, -%d removed, %d changed",
+             delta.added, delta.removed, delta.changed);
+    logTimestamp();
+    debugPrintln(deltaMsg);
+
+    webServer.setDepartureDelta(delta, millis());
+
+    // Nothing visible changed - skip the redraw (ETA recalc still ticks the clock)
+    if (!delta.isEmpty() || apiError != wasError || (apiError && isFinal) ||
+        strcmp(stopName, previousStopName) != 0)
+    {
+        needsDisplayUpdate = true;
+    }
+}
+
+void applyFetchResults()
+{
+    // Static to keep the ~1KB snapshot off the loop stack
+    static TransitAPI::APIResult result;
+    bool isFinal = false;
+
+    if (fetchTask.takeDepartures(result, isFinal))
+    {
+        // Demo mode owns the departure cache - drop results from an in-flight fetch
+        if (!demoModeActive)
+        {
+            applyDepartureResult(result, isFinal);
+        }
     }
 
-    // Clear any previous error since we have data
-    apiError = false;
+    WeatherData newWeather;
+    if (fetchTask.takeWeather(newWeather))
+    {
+        weatherData = newWeather;
+        needsDisplayUpdate = true;
 
-    // Trigger immediate display update
-    displayManager.updateDisplay(departures, departureCount, config.numDepartures,
-                                 wifiManager.isConnected(), wifiManager.isAPMode(),
-                                 wifiManager.getAPSSID(), wifiManager.getAPPassword(),
-                                 apiError, apiErrorMsg,
-                                 stopName, isCityConfigured(),
-                                 demoModeActive);
+        if (weatherData.hasError)
+        {
+            logTimestamp();
+            debugPrint("Weather: Error - ");
+            debugPrintln(weatherData.errorMsg);
+        }
+        else
+        {
+            char msg[64];
+            snprintf(msg, sizeof(msg), "Weather: %d°C, code %d", weatherData.temperature, weatherData.weatherCode);
+            logTimestamp();
+            debugPrintln(msg);
+        }
+    }
 }
 
 // ============================================================================
@@ -138,7 +302,7 @@ void recalculateETAs()
             logTimestamp();
             char debugMsg[128];
             snprintf(debugMsg, sizeof(debugMsg), "  [%d] Line %s: depTime=%ld, diffSec=%d, eta=%d min",
-                     i, departures[i].line, (long)departures[i].departureTime, diffSec, eta);
+                     i, departureStrings.get(departures[i].lineId), (long)departures[i].departureTime, diffSec, eta);
             debugPrintln(debugMsg);
         }
 
@@ -162,7 +326,7 @@ void recalculateETAs()
                 logTimestamp();
                 char filterMsg[128];
                 snprintf(filterMsg, sizeof(filterMsg), "  Filtered: Line %s (eta=%d min, minEta=%d min, diffSec=%d)",
-                         departures[i].line, eta, minEta, diffSec);
+                         departureStrings.get(departures[i].lineId), eta, minEta, diffSec);
                 debugPrintln(filterMsg);
             }
         }
@@ -179,12 +343,12 @@ void recalculateETAs()
 
     departureCount = validCount;
 
-    // Resort departures by ETA after recalculation
+    // Keep departures ordered by departure time (single-stop refreshes merge into this order)
     if (departureCount > 1)
     {
         logTimestamp();
-        debugPrintln("ETA Recalc: Resorting departures by ETA");
-        qsort(departures, departureCount, sizeof(Departure), compareDepartures);
+        debugPrintln("ETA Recalc: Resorting departures by departure time");
+        sortDepartureRun(departures, departureCount);
 
         // Log final order (first 3)
         for (int i = 0; i < departureCount && i < 3; i++)
@@ -192,7 +356,7 @@ void recalculateETAs()
             logTimestamp();
             char sortMsg[96];
             snprintf(sortMsg, sizeof(sortMsg), "  After sort [%d]: Line %s, ETA=%d min",
-                     i, departures[i].line, departures[i].eta);
+                     i, departureStrings.get(departures[i].lineId), departures[i].eta);
             debugPrintln(sortMsg);
         }
     }
@@ -202,10 +366,171 @@ void recalculateETAs()
     needsDisplayUpdate = true;
 }
 
+#if !defined(MATRIX_PORTAL_M4)
+// ============================================================================
+// Timetable Fallback - Scheduled departures while live data is stale
+// ============================================================================
+bool isLiveDataStale()
+{
+    // Two missed refreshes (at least 2 minutes) without a successful fetch
+    unsigned long staleMs = 2UL * config.refreshInterval * 1000;
+    if (staleMs < 120000)
+        staleMs = 120000;
+
+    unsigned long since = (lastLiveDataMs == 0) ? millis() : millis() - lastLiveDataMs;
+    return since > staleMs;
+}
+
+void fillFromSchedule()
+{
+    struct tm timeinfo;
+    if (!getCurrentTime(&timeinfo))
+    {
+        return; // Can't place a timetable without the time
+    }
+    time_t now = getCurrentEpochTime();
+
+    // Live entries stay; the timetable continues each stop after its last live departure
+    static Departure next[MAX_DEPARTURES];
+    static DepartureStrings nextStrings;
+    static DepartureCollector collector;
+    static Departure run[MAX_DEPARTURES];
+    static DepartureStrings runStrings;
+    time_t liveUntil[StaticSchedule::MAX_STOPS] = {};
+
+    int liveCount = 0;
+    for (int i = 0; i < departureCount; i++)
+    {
+        if (departures[i].isScheduled)
+        {
+            continue;
+        }
+        next[liveCount++] = departures[i];
+        int stop = departures[i].stopIndex;
+        if (stop >= 0 && stop < StaticSchedule::MAX_STOPS && departures[i].departureTime > liveUntil[stop])
+        {
+            liveUntil[stop] = departures[i].departureTime;
+        }
+    }
+
+    collector.reset((config.minDepartureTime > 0) ? config.minDepartureTime : 0);
+    StaticSchedule::getInstance().collect(now, liveUntil, collector);
+    int runCount = collector.copySorted(run, runStrings);
+
+    // isScheduled tells which table an entry's string indices refer to
+    int nextCount = mergeDepartureRun(next, liveCount, MAX_DEPARTURES, run, runCount);
+    nextStrings.reset();
+    int scheduledCount = 0;
+    for (int i = 0; i < nextCount; i++)
+    {
+        scheduledCount += next[i].isScheduled ? 1 : 0;
+        const DepartureStrings& from = next[i].isScheduled ? runStrings : departureStrings;
+        next[i].lineId = nextStrings.intern(from.get(next[i].lineId), MAX_LINE_LENGTH);
+        next[i].destinationId = nextStrings.intern(from.get(next[i].destinationId), MAX_DESTINATION_LENGTH);
+    }
+
+    DepartureDelta delta;
+    departureCount = applyDepartureDelta(departures, departureStrings, departureCount,
+                                         next, nextStrings, nextCount, delta);
+    if (!delta.isEmpty())
+    {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "Schedule: Live data stale, %d of %d departures from timetable",
+                 scheduledCount, nextCount);
+        logTimestamp();
+        debugPrintln(msg);
+        needsDisplayUpdate = true;
+    }
+}
+
+// ============================================================================
+// Departure Snapshot - Last good board from NVS, shown before the first fetch
+// ============================================================================
+uint32_t getActiveStopsKey()
+{
+    return getSnapshotStopsKey(config.city, getActiveStopIds());
+}
+
+void loadSnapshot()
+{
+    if (!isCityConfigured())
+    {
+        return;
+    }
+
+    // Weather too - the display hides it once it is older than 30 minutes
+    time_t savedAt = 0;
+    snapshotPending = loadDepartureSnapshot(departures, departureStrings, departureCount,
+                                            stopName, sizeof(stopName), weatherData,
+                                            getActiveStopsKey(), savedAt);
+}
+
+// ETAs of the restored board need a plausible clock (RTC kept over a soft
+// reboot, or NTP). Returns true if there is something to show.
+bool activateSnapshot()
+{
+    struct tm timeinfo;
+    if (!snapshotPending || !getCurrentTime(&timeinfo))
+    {
+        return false;
+    }
+
+    snapshotPending = false;
+    recalculateETAs();  // Also drops what departed while the board was off
+    return departureCount > 0;
+}
+
+void dropSnapshot()
+{
+    if (!snapshotPending)
+    {
+        return;
+    }
+
+    snapshotPending = false;
+    departureCount = 0;
+    departureStrings.reset();
+    stopName[0] = '\0';
+    logTimestamp();
+    debugPrintln("Snapshot: No time to place the stored board, discarded");
+}
+#endif
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
 
+// Boot-to-first-useful-frame time, logged once
+void logFirstDepartureFrame(const char* source)
+{
+    if (firstFrameLogged)
+    {
+        return;
+    }
+
+    firstFrameLogged = true;
+    char msg[64];
+    snprintf(msg, sizeof(msg), "BOOT: First departure frame after %lu ms (%s)", millis(), source);
+    logTimestamp();
+    debugPrintln(msg);
+
+    BootTimeline::getInstance().mark("first frame");
+}
+
+// Stop ID list of the selected city
+const char* getActiveStopIds()
+{
+    if (strcmp(config.city, "Berlin") == 0)
+    {
+        return config.berlinStopIds;
+    }
+    else if (strcmp(config.city, "GTFS-RT") == 0)
+    {
+        return config.gtfsRtStopIds;
+    }
+    return config.pragueStopIds;
+}
+
 // Check if current city has valid API configuration
 bool isCityConfigured()
 {
@@ -219,6 +544,10 @@ bool isCityConfigured()
         // Berlin only needs stop IDs
         return strlen(config.berlinStopIds) > 0;
     }
+    else if (strcmp(config.city, "GTFS-RT") == 0)
+    {
+        return strlen(config.gtfsRtFeedUrl) > 0 && strlen(config.gtfsRtStopIds) > 0;
+    }
     else
     {
         // Prague needs both API key and stop IDs
@@ -227,7 +556,7 @@ bool isCityConfigured()
 }
 
 // ============================================================================
-// Weather API Fetch Wrapper
+// Weather API Fetch Wrapper - Queued on the fetch task
 // ============================================================================
 void fetchWeather()
 {
@@ -245,52 +574,27 @@ void fetchWeather()
     logTimestamp();
     debugPrintln("Weather: Fetching forecast...");
 
-    weatherData = weatherAPI.fetchWeather(config.weatherLatitude, config.weatherLongitude);
-
-    if (weatherData.hasError)
-    {
-        logTimestamp();
-        debugPrint("Weather: Error - ");
-        debugPrintln(weatherData.errorMsg);
-    }
-    else
-    {
-        char msg[64];
-        snprintf(msg, sizeof(msg), "Weather: %d°C, code %d", weatherData.temperature, weatherData.weatherCode);
-        logTimestamp();
-        debugPrintln(msg);
-    }
+    fetchTask.requestWeather(config.weatherLatitude, config.weatherLongitude);
 }
 
 // ============================================================================
-// API Fetch Wrapper - Uses TransitAPI interface (GolemioAPI or BvgAPI)
+// API Fetch Wrapper - Queued on the fetch task (GolemioAPI, BvgAPI or GtfsRtAPI)
 // ============================================================================
-void fetchDepartures()
+void fetchDepartures(int stopIndex)
 {
     if (!wifiManager.isConnected() || transitAPI == nullptr)
     {
         return;
     }
 
-    // Call API client
-    TransitAPI::APIResult result = transitAPI->fetchDepartures(config);
-
-    // Update global state with results
-    departureCount = result.departureCount;
-    for (int i = 0; i < result.departureCount; i++)
+    if (stopIndex == RefreshScheduler::ALL_STOPS)
     {
-        departures[i] = result.departures[i];
+        fetchTask.requestDepartures(config);
     }
-
-    strlcpy(stopName, result.stopName, sizeof(stopName));
-
-    apiError = result.hasError;
-    if (result.hasError)
+    else
     {
-        strlcpy(apiErrorMsg, result.errorMsg, sizeof(apiErrorMsg));
+        fetchTask.requestStopDepartures(config, stopIndex);
     }
-
-    needsDisplayUpdate = true;
 }
 
 // ============================================================================
@@ -315,13 +619,16 @@ void onConfigSave(const Config &newConfig, bool wifiChanged)
     else
     {
         // Trigger immediate API refresh
-        lastApiCall = 0;
+        refreshScheduler.forceRefresh();
+#if !defined(MATRIX_PORTAL_M4)
+        StaticSchedule::getInstance().setStops(getActiveStopIds());
+#endif
     }
 }
 
 void onRefresh()
 {
-    lastApiCall = 0; // Force immediate refresh
+    refreshScheduler.forceRefresh(); // Force immediate refresh
 }
 
 void onReboot()
@@ -330,7 +637,7 @@ void onReboot()
     systemRestart();
 }
 
-void onDemoStart(const Departure* demoDepartures, int demoCount)
+void onDemoStart(const Departure* demoDepartures, const DepartureStrings& demoStrings, int demoCount)
 {
     // Enter demo mode: stop API polling and display updates
     demoModeActive = true;
@@ -341,6 +648,7 @@ void onDemoStart(const Departure* demoDepartures, int demoCount)
     {
         departures[i] = demoDepartures[i];
     }
+    departureStrings = demoStrings;
 
     // Trigger display update with demo data
     needsDisplayUpdate = true;
@@ -353,7 +661,7 @@ void onDemoStop()
 {
     // Exit demo mode: resume normal operation
     demoModeActive = false;
-    lastApiCall = 0;  // Force immediate API refresh
+    refreshScheduler.forceRefresh();  // Force immediate API refresh
 
     logTimestamp();
     debugPrintln("Demo mode deactivated - resuming normal operation");
@@ -364,8 +672,11 @@ void onDemoStop()
 // ============================================================================
 void setup()
 {
+    BootTimeline& timeline = BootTimeline::getInstance();
+
+    // No settle delay: the banner may miss a late serial monitor, the
+    // boot timeline (status page, telnet) keeps the startup record
     Serial.begin(115200);
-    delay(1000);
 
     // Boot banner always prints to Serial (before logger init)
     Serial.println("\n╔═══════════════════════════════════════╗");
@@ -379,12 +690,25 @@ void setup()
 
     // Load configuration FIRST (needed for display brightness)
     Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Loading config...");
+    int phase = timeline.begin("config");
     loadConfig(config);
+    timeline.end(phase);
     Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Config loaded");
 
     // Initialize logger with config for debug mode checks (MUST be after loadConfig)
     initLogger(&config);
 
+    // Start associating now; display init and the snapshot frame run meanwhile
+    int wifiPhase = timeline.begin("wifi");
+    bool tryStation = strlen(config.wifiSsid) > 0;
+#if !defined(MATRIX_PORTAL_M4)
+    if (tryStation)
+    {
+        Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Connecting WiFi...");
+        wifiManager.beginSTA(config);
+    }
+#endif
+
     // Select transit API based on city configuration
     Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Selecting API...");
 #if defined(MATRIX_PORTAL_M4)
@@ -397,6 +721,11 @@ void setup()
         transitAPI = &bvgAPI;
         Serial.println("Using Berlin BVG API");
     }
+    else if (strcmp(config.city, "GTFS-RT") == 0)
+    {
+        transitAPI = &gtfsRtAPI;
+        Serial.println("Using GTFS-Realtime feed");
+    }
     else
     {
         transitAPI = &golemioAPI;
@@ -404,12 +733,30 @@ void setup()
     }
 #endif
 
-    // Set up API callbacks
-    transitAPI->setStatusCallback(onAPIStatus);
-    transitAPI->setPartialResultsCallback(onPartialResults);
+#if !defined(MATRIX_PORTAL_M4)
+    // Offline timetable for the configured stops, if one was flashed
+    phase = timeline.begin("timetable");
+    if (StaticSchedule::getInstance().begin())
+    {
+        StaticSchedule::getInstance().setStops(getActiveStopIds());
+    }
+    timeline.end(phase);
+#endif
+
+#if !defined(MATRIX_PORTAL_M4)
+    // Before the fetch task starts: the first weather fetch may precede the first departure fetch
+    HttpConnectionManager::getInstance().setBaseUrl(config.apiBaseUrl);
+#endif
+
+    // Start background fetch task (registers itself for partial results)
+    if (!fetchTask.begin(transitAPI, &weatherAPI))
+    {
+        debugPrintln("Fetch task failed to start!");
+    }
 
     // Initialize display with correct brightness from config
     Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Initializing display...");
+    phase = timeline.begin("display");
     if (!displayManager.begin(config.brightness))
     {
         debugPrintln("Display initialization failed!");
@@ -417,6 +764,7 @@ void setup()
     }
     displayManager.setConfig(&config);
     displayManager.setWeatherData(&weatherData);  // Pass weather data pointer to display manager
+    timeline.end(phase);
     Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Display ready");
     logMemory("display_init");
 
@@ -426,18 +774,54 @@ void setup()
     delay(10000);
 #endif
 
-    displayManager.drawStatus("Starting SpojBoard...", "FW v" FIRMWARE_RELEASE, COLOR_WHITE);
-    Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Connecting WiFi...");
+    // Last good board while WiFi, NTP and the first fetch are still to come
+    bool snapshotShown = false;
+#if !defined(MATRIX_PORTAL_M4)
+    phase = timeline.begin("snapshot");
+    loadSnapshot();
+    if (activateSnapshot())
+    {
+        int rows = (departureCount < config.numDepartures) ? departureCount : config.numDepartures;
+        displayManager.drawDemo(departures, departureStrings, rows);
+        snapshotShown = true;
+        logFirstDepartureFrame("snapshot");
+    }
+    timeline.end(phase);
+#endif
+
+    if (!snapshotShown)
+    {
+        displayManager.drawStatus("Starting SpojBoard...", "FW v" FIRMWARE_RELEASE, COLOR_WHITE);
+    }
+
+#if defined(MATRIX_PORTAL_M4)
+    // WiFiNINA's begin() blocks until associated, so it can't overlap the display start
+    if (tryStation)
+    {
+        Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Connecting WiFi...");
+        wifiManager.beginSTA(config);
+    }
+#endif
 
-    // Try to connect to WiFi (5 attempts × 500ms = 2.5s max)
-    bool wifiConnected = wifiManager.connectSTA(config, 5, 500);
+    // Association started above; about 5 s in total before falling back to AP mode
+    bool wifiConnected = tryStation && wifiManager.waitForSTA(50, 100);
     Serial.print("["); Serial.print(millis()); Serial.print("] BOOT: WiFi result: "); Serial.println(wifiConnected ? "connected" : "failed");
 
     // If noApFallback is true, keep retrying WiFi instead of falling back to AP
     while (!wifiConnected && config.noApFallback)
     {
         displayManager.drawStatus("WiFi Failed!", "Retrying...", COLOR_RED);
-        wifiConnected = wifiManager.connectSTA(config, 5, 500);
+        wifiConnected = wifiManager.connectSTA(config, 50, 100);
+    }
+    timeline.end(wifiPhase);
+
+    // NTP runs in the background from here on, overlapping the web server start
+    int ntpPhase = -1;
+    if (wifiConnected)
+    {
+        Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Starting NTP sync...");
+        ntpPhase = timeline.begin("ntp");
+        initTimeSync();
     }
 
     if (!wifiConnected)
@@ -467,9 +851,17 @@ void setup()
         char ipStr[32];
         IPAddress ip = WiFi.localIP();
         snprintf(ipStr, sizeof(ipStr), "IP: %d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
-        displayManager.drawStatus("WiFi Connected!", ipStr, COLOR_GREEN);
-        Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Showing IP (1.5s delay)...");
-        delay(1500);
+        if (snapshotShown)
+        {
+            // Keep the restored board up instead of the IP screen
+            Serial.print("["); Serial.print(millis()); Serial.print("] BOOT: WiFi connected, "); Serial.println(ipStr);
+        }
+        else
+        {
+            // Shown until the first departures arrive (at least IP_SPLASH_MS), boot goes on meanwhile
+            displayManager.drawStatus("WiFi Connected!", ipStr, COLOR_GREEN);
+            displayHoldUntilMs = millis() + IP_SPLASH_MS;
+        }
 
         // Start telnet logger if debug mode enabled
         if (config.debugMode)
@@ -482,12 +874,14 @@ void setup()
 
     // Initialize web server with callbacks
     Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Starting web server...");
+    phase = timeline.begin("web server");
     webServer.setCallbacks(onConfigSave, onRefresh, onReboot, onDemoStart, onDemoStop);
     webServer.setDisplayManager(&displayManager); // For OTA progress updates
     if (!webServer.begin())
     {
         debugPrintln("Web server failed to start!");
     }
+    timeline.end(phase);
     Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Web server ready");
 
     // Setup captive portal detection handlers (ESP32 only - M4 has no web server)
@@ -498,13 +892,16 @@ void setup()
     }
 #endif
 
-    // Setup NTP time if connected to WiFi
+    // Wait for the NTP sync started above (ETAs need the time)
     if (wifiManager.isConnected() && !wifiManager.isAPMode())
     {
-        Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Syncing NTP time...");
-        initTimeSync();
-
-        if (syncTime(10, 500))
+#if defined(MATRIX_PORTAL_M4)
+        bool synced = syncTime(10, 500);  // Each NTPClient attempt already waits for its reply
+#else
+        bool synced = syncTime(50, 100);  // SNTP polls, 5 s budget
+#endif
+        timeline.end(ntpPhase);
+        if (synced)
         {
             Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: NTP synced");
             char timeStr[32];
@@ -521,26 +918,34 @@ void setup()
             Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: NTP sync failed");
         }
 
-        // Initial API call if configured
+        // Initial API call if configured (runs on the fetch task; setup finishes meanwhile)
         if (isCityConfigured())
         {
-            Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Fetching initial departures...");
-            fetchDepartures();
-            Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Initial fetch complete");
-            lastApiCall = millis(); // Prevent immediate second call in loop()
+            Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Requesting initial departures...");
+            firstFetchPhase = timeline.begin("first fetch");
+            fetchDepartures(RefreshScheduler::ALL_STOPS);
+            refreshScheduler.onFetchStarted(config, RefreshScheduler::ALL_STOPS, millis()); // Prevent immediate second call in loop()
         }
 
         // Initial weather call if configured
         if (config.weatherEnabled && config.weatherLatitude != 0.0 && config.weatherLongitude != 0.0)
         {
-            Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Fetching initial weather...");
+            Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Requesting initial weather...");
             fetchWeather();
-            Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Weather fetch complete");
             lastWeatherCall = millis();
         }
     }
 
+#if !defined(MATRIX_PORTAL_M4)
+    // Restored board still waiting for the time: NTP made it plausible, or it goes
+    if (!activateSnapshot())
+    {
+        dropSnapshot();
+    }
+#endif
+
     needsDisplayUpdate = true;
+    timeline.mark("setup done");
     Serial.print("["); Serial.print(millis()); Serial.println("] BOOT: Setup complete!");
 }
 
@@ -549,6 +954,19 @@ void setup()
 // ============================================================================
 void loop()
 {
+    // Track worst-case time between loop() iterations
+    unsigned long loopStartUs = micros();
+    if (lastLoopStartUs != 0)
+    {
+        unsigned long loopLatencyUs = loopStartUs - lastLoopStartUs;
+        Metrics::getInstance().recordLoopLatency(loopLatencyUs);
+        if (loopLatencyUs > loopLatencyMaxUs)
+            loopLatencyMaxUs = loopLatencyUs;
+        if (loopLatencyUs > loopLatencyWorstUs)
+            loopLatencyWorstUs = loopLatencyUs;
+    }
+    lastLoopStartUs = loopStartUs;
+
     // Handle DNS for captive portal (AP mode only)
     if (wifiManager.isAPMode())
     {
@@ -570,6 +988,8 @@ void loop()
                           wifiManager.getAPSSID(), wifiManager.getAPPassword(), wifiManager.getAPClientCount(),
                           apiError, apiErrorMsg,
                           departureCount, stopName);
+    webServer.setRefreshStatus(RefreshScheduler::reasonToString(refreshScheduler.getReason(millis())),
+                               refreshScheduler.getSecondsUntilNextFetch(millis()));
 
     // Skip WiFi monitoring and API calls in AP mode
     if (wifiManager.isAPMode())
@@ -584,12 +1004,14 @@ void loop()
         if (needsDisplayUpdate || displayManager.needsRedraw())
         {
             needsDisplayUpdate = false;
-            displayManager.updateDisplay(departures, departureCount, config.numDepartures,
+            unsigned long renderStartUs = micros();
+            displayManager.updateDisplay(departures, departureStrings, departureCount, config.numDepartures,
                                          wifiManager.isConnected(), wifiManager.isAPMode(),
                                          wifiManager.getAPSSID(), wifiManager.getAPPassword(),
                                          apiError, apiErrorMsg,
                                          stopName, isCityConfigured(),
                                          demoModeActive);
+            Metrics::getInstance().recordRender(micros() - renderStartUs);
         }
 
         delay(10);
@@ -622,6 +1044,9 @@ void loop()
     }
     wasConnected = isConnected;
 
+    // Pick up results published by the fetch task
+    applyFetchResults();
+
     // Skip API polling and ETA recalculation in demo mode
     if (!demoModeActive)
     {
@@ -629,23 +1054,35 @@ void loop()
         if (wifiManager.isConnected() && isCityConfigured())
         {
             unsigned long now = millis();
-            unsigned long interval = (unsigned long)config.refreshInterval * 1000;
 
-            if (now - lastApiCall >= interval || lastApiCall == 0)
+            int target = refreshScheduler.nextDue(now);
+            if (target != RefreshScheduler::NONE)
             {
-                lastApiCall = now;
-                fetchDepartures();
+                refreshScheduler.onFetchStarted(config, target, now);
+                fetchDepartures(target);
             }
         }
 
         // Real-time ETA recalculation every 10 seconds (only when connected and have departures)
-        if (wifiManager.isConnected() && departureCount > 0)
+        // While live data is stale (also offline), the timetable tops the board up
+#if defined(MATRIX_PORTAL_M4)
+        bool useSchedule = false;
+#else
+        bool useSchedule = StaticSchedule::getInstance().isAvailable() && isCityConfigured() && isLiveDataStale();
+#endif
+        if ((wifiManager.isConnected() && departureCount > 0) || useSchedule)
         {
             unsigned long now = millis();
             if (now - lastEtaRecalc >= 10000 || lastEtaRecalc == 0)
             {
                 lastEtaRecalc = now;
                 recalculateETAs();
+#if !defined(MATRIX_PORTAL_M4)
+                if (useSchedule)
+                {
+                    fillFromSchedule();
+                }
+#endif
             }
         }
 
@@ -660,21 +1097,33 @@ void loop()
             {
                 lastWeatherCall = now;
                 fetchWeather();
-                needsDisplayUpdate = true;
             }
         }
     }
 
-    // Update display
-    if (needsDisplayUpdate || displayManager.needsRedraw())
+    // Update display (a boot status screen stays up for its minimum time unless departures arrive)
+    bool displayHeld = departureCount == 0 && (long)(millis() - displayHoldUntilMs) < 0;
+    if ((needsDisplayUpdate || displayManager.needsRedraw()) && !displayHeld)
     {
         needsDisplayUpdate = false;
-        displayManager.updateDisplay(departures, departureCount, config.numDepartures,
+        unsigned long renderStartUs = micros();
+        displayManager.updateDisplay(departures, departureStrings, departureCount, config.numDepartures,
                                      wifiManager.isConnected(), wifiManager.isAPMode(),
                                      wifiManager.getAPSSID(), wifiManager.getAPPassword(),
                                      apiError, apiErrorMsg,
                                      stopName, isCityConfigured(),
                                      demoModeActive);
+        Metrics::getInstance().recordRender(micros() - renderStartUs);
+        if (departureCount > 0 && isConnected && !demoModeActive)
+        {
+            logFirstDepartureFrame(lastLiveDataMs == 0 ? "snapshot" : "live");
+        }
+        if (bootTimelinePending)
+        {
+            bootTimelinePending = false;
+            BootTimeline::getInstance().mark("fetch frame");
+            BootTimeline::getInstance().log();
+        }
     }
 
     // Periodic display update (for time) - now handled by ETA recalc every 10s
@@ -685,14 +1134,16 @@ void loop()
     if (millis() - lastStatusLog >= 60000)
     {
         lastStatusLog = millis();
-        char statusMsg[128];
-        snprintf(statusMsg, sizeof(statusMsg), "STATUS: WiFi=%s | AP=%s | Deps=%d | Heap=%lu",
+        char statusMsg[160];
+        snprintf(statusMsg, sizeof(statusMsg), "STATUS: WiFi=%s | AP=%s | Deps=%d | Heap=%lu | Loop max=%luus worst=%luus",
                  wifiManager.isConnected() ? "OK" : "FAIL",
                  wifiManager.isAPMode() ? "ON" : "OFF",
                  departureCount,
-                 (unsigned long)getFreeHeap());
+                 (unsigned long)getFreeHeap(),
+                 loopLatencyMaxUs, loopLatencyWorstUs);
         logTimestamp();
         debugPrintln(statusMsg);
+        loopLatencyMaxUs = 0;
     }
 
     // Let idle task run
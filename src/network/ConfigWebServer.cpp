@@ -5,6 +5,11 @@
 
 #include "../utils/Logger.h"
 #include "../display/DisplayManager.h"
+#include "HttpConnectionManager.h"
+#include "../api/DestinationShortener.h"
+#include "../utils/gfxlatin2.h"
+#include "../utils/BootTimeline.h"
+#include "../utils/Metrics.h"
 #include <string.h>
 #include <WiFi.h>
 #include <Update.h>
@@ -77,6 +82,8 @@ ConfigWebServer::ConfigWebServer()
       wifiConnected(false), apModeActive(false),
       apSSID(""), apPassword(""), apClientCount(0),
       apiError(false), apiErrorMsg(""), departureCount(0), stopName(""),
+      nextRefreshReason(nullptr), nextRefreshSeconds(0),
+      lastDelta(), lastDeltaMs(0), unchangedRefreshes(0),
       onSaveCallback(nullptr), onRefreshCallback(nullptr), onRebootCallback(nullptr),
       onDemoStartCallback(nullptr), onDemoStopCallback(nullptr)
 {
@@ -149,6 +156,8 @@ bool ConfigWebServer::begin()
                { handleScreenOn(); });
     server->on("/off", HTTP_GET, [this]()
                { handleScreenOff(); });
+    server->on("/metrics", HTTP_GET, [this]()
+               { handleMetrics(); });
     server->onNotFound([this]()
                        { handleNotFound(); });
 
@@ -220,6 +229,25 @@ void ConfigWebServer::updateState(const Config *config,
     stopName = stop;
 }
 
+void ConfigWebServer::setRefreshStatus(const char *reason, unsigned long secondsUntilNext)
+{
+    nextRefreshReason = reason;
+    nextRefreshSeconds = secondsUntilNext;
+}
+
+void ConfigWebServer::setDepartureDelta(const DepartureDelta &delta, unsigned long nowMs)
+{
+    if (delta.isEmpty())
+    {
+        unchangedRefreshes++;
+        return;
+    }
+
+    lastDelta = delta;
+    lastDeltaMs = nowMs;
+    unchangedRefreshes = 0;
+}
+
 void ConfigWebServer::handleRoot()
 {
     if (currentConfig == nullptr)
@@ -266,9 +294,14 @@ void ConfigWebServer::handleRoot()
     if (!apModeActive)
     {
         // Display current city's configuration status
-        bool isPrague = (strcmp(currentConfig->city, "Berlin") != 0);
-        bool hasApiKey = isPrague ? (strlen(currentConfig->pragueApiKey) > 0) : true; // Berlin doesn't need API key
-        bool hasStops = isPrague ? (strlen(currentConfig->pragueStopIds) > 0) : (strlen(currentConfig->berlinStopIds) > 0);
+        bool isFeed = (strcmp(currentConfig->city, "GTFS-RT") == 0);
+        bool isPrague = !isFeed && (strcmp(currentConfig->city, "Berlin") != 0);
+        bool hasApiKey = isPrague ? (strlen(currentConfig->pragueApiKey) > 0)
+                         : isFeed ? (strlen(currentConfig->gtfsRtFeedUrl) > 0)
+                                  : true; // Berlin doesn't need API key
+        bool hasStops = isPrague ? (strlen(currentConfig->pragueStopIds) > 0)
+                        : isFeed ? (strlen(currentConfig->gtfsRtStopIds) > 0)
+                                 : (strlen(currentConfig->berlinStopIds) > 0);
 
         if (hasApiKey && hasStops)
         {
@@ -281,10 +314,28 @@ void ConfigWebServer::handleRoot()
                 html += "<div class='status ok'>API OK - " + String(departureCount) + " departures</div>";
             }
 
+            if (nextRefreshReason)
+            {
+                html += "<p><strong>Next Refresh:</strong> in " + String(nextRefreshSeconds) + " s (" +
+                        String(nextRefreshReason) + ")</p>";
+            }
+
+            if (lastDeltaMs != 0)
+            {
+                html += "<p><strong>Last Board Change:</strong> " + String((millis() - lastDeltaMs) / 1000) +
+                        " s ago (+" + String(lastDelta.added) + " / -" + String(lastDelta.removed) + " / " +
+                        String(lastDelta.changed) + " changed), " + String(unchangedRefreshes) +
+                        " unchanged refresh(es) since</p>";
+            }
+
             if (isPrague)
             {
                 html += "<p><strong>Prague API Key:</strong> Configured (hidden)</p>";
             }
+            else if (isFeed)
+            {
+                html += "<p><strong>GTFS-RT Feed:</strong> " + String(currentConfig->gtfsRtFeedUrl) + "</p>";
+            }
             else
             {
                 html += "<p><strong>Berlin API:</strong> No authentication required</p>";
@@ -294,6 +345,10 @@ void ConfigWebServer::handleRoot()
         {
             html += "<div class='status warn'>Prague API Key not configured</div>";
         }
+        else if (!hasApiKey && isFeed)
+        {
+            html += "<div class='status warn'>GTFS-RT feed URL not configured</div>";
+        }
         else if (!hasStops)
         {
             html += "<div class='status warn'>Stop IDs not configured</div>";
@@ -307,10 +362,32 @@ void ConfigWebServer::handleRoot()
 
     html += "<p><strong>Free Memory:</strong> " + String(ESP.getFreeHeap()) + " bytes</p>";
 
+    // Keep-alive reuse per API host (handshakes / requests)
+    HttpConnectionManager &connections = HttpConnectionManager::getInstance();
+    for (int h = 0; h < HttpConnectionManager::HOST_COUNT; h++)
+    {
+        HttpConnectionManager::Host host = (HttpConnectionManager::Host)h;
+        const HttpConnectionManager::HostStats stats = connections.getStats(host);
+        if (stats.requests == 0)
+        {
+            continue;
+        }
+        html += "<p><strong>" + String(connections.getHostName(host)) + ":</strong> " +
+                String(stats.handshakes) + " TLS handshakes / " + String(stats.requests) + " requests</p>";
+    }
+
     // Format firmware version with build ID (8 hex chars)
     char buildIdStr[10];
     snprintf(buildIdStr, sizeof(buildIdStr), "%08x", BUILD_ID);
     html += "<p><strong>Firmware:</strong> Release " + String(FIRMWARE_RELEASE) + " (" + String(buildIdStr) + ")</p>";
+
+    // Startup phases (ms since power-on)
+    static char timeline[BootTimeline::MAX_PHASES * 48];
+    if (BootTimeline::getInstance().format(timeline, sizeof(timeline)) > 0)
+    {
+        html += "<p><strong>Boot Timeline:</strong></p><pre style='font-size: 12px; margin: 0;'>" +
+                String(timeline) + "</pre>";
+    }
     html += "</div>";
 
     // Configuration form
@@ -335,9 +412,12 @@ void ConfigWebServer::handleRoot()
     // City selector
     html += "<label>Transit City</label>";
     html += "<select name='city' id='citySelect' onchange='switchCity()' required>";
-    bool isPrague = (strcmp(currentConfig->city, "Berlin") != 0);
+    bool isBerlin = (strcmp(currentConfig->city, "Berlin") == 0);
+    bool isFeed = (strcmp(currentConfig->city, "GTFS-RT") == 0);
+    bool isPrague = !isBerlin && !isFeed;
     html += "<option value='Prague'" + String(isPrague ? " selected" : "") + ">Prague (PID/Golemio)</option>";
-    html += "<option value='Berlin'" + String(isPrague ? "" : " selected") + ">Berlin (BVG)</option>";
+    html += "<option value='Berlin'" + String(isBerlin ? " selected" : "") + ">Berlin (BVG)</option>";
+    html += "<option value='GTFS-RT'" + String(isFeed ? " selected" : "") + ">Other (GTFS-Realtime feed)</option>";
     html += "</select>";
     html += "<p class='info'>Select your transit network. Device will restart after changing city.</p>";
 
@@ -345,6 +425,9 @@ void ConfigWebServer::handleRoot()
     html += "<input type='hidden' id='pragueApiKeyData' value='" + String(currentConfig->pragueApiKey) + "'>";
     html += "<input type='hidden' id='pragueStopsData' value='" + String(currentConfig->pragueStopIds) + "'>";
     html += "<input type='hidden' id='berlinStopsData' value='" + String(currentConfig->berlinStopIds) + "'>";
+    html += "<input type='hidden' id='pragueAbbrevData' value='" + String(currentConfig->pragueAbbreviations) + "'>";
+    html += "<input type='hidden' id='berlinAbbrevData' value='" + String(currentConfig->berlinAbbreviations) + "'>";
+    html += "<input type='hidden' id='gtfsRtStopsData' value='" + String(currentConfig->gtfsRtStopIds) + "'>";
 
     // API Key field (Prague only)
     html += "<div id='apiKeySection'>";
@@ -366,23 +449,44 @@ void ConfigWebServer::handleRoot()
     }
     html += "</div>";
 
+    // Feed URL field (GTFS-RT only)
+    html += "<div id='feedUrlSection'>";
+    html += "<label>GTFS-Realtime TripUpdates URL</label>";
+    html += "<input type='text' name='feedurl' id='feedUrlInput' maxlength='" + String(sizeof(currentConfig->gtfsRtFeedUrl) - 1) + "' value='" + String(currentConfig->gtfsRtFeedUrl) + "' placeholder='https://example.org/gtfs-rt/TripUpdates.pb'>";
+    html += "<p class='info'>HTTPS URL of the agency's protobuf TripUpdates feed. The whole feed is downloaded on every refresh.</p>";
+    html += "</div>";
+
     html += "<label>Stop ID(s)</label>";
-    html += "<input type='text' name='stops' id='stopsInput' value='" + String(isPrague ? currentConfig->pragueStopIds : currentConfig->berlinStopIds) + "' required placeholder='e.g., U693Z2P (Prague) or 900013102 (Berlin)'>";
+    html += "<input type='text' name='stops' id='stopsInput' value='" + String(isPrague ? currentConfig->pragueStopIds : isFeed ? currentConfig->gtfsRtStopIds : currentConfig->berlinStopIds) + "' required placeholder='e.g., U693Z2P (Prague) or 900013102 (Berlin)'>";
     html += "<p class='info' id='stopHelp'>";
     if (isPrague)
     {
         html += "Comma-separated PID stop IDs (e.g., U693Z2P). Find IDs at <a href='https://data.pid.cz/stops/json/stops.json' target='_blank'>PID data</a>";
     }
+    else if (isFeed)
+    {
+        html += "Comma-separated stop_id values from the agency's static GTFS stops.txt";
+    }
     else
     {
         html += "Comma-separated numeric BVG stop IDs (e.g., 900013102). Find IDs at <a href='https://v6.bvg.transport.rest/' target='_blank'>BVG API</a>";
     }
     html += "</p>";
 
+    // Abbreviations (Prague and Berlin; feed labels are IDs)
+    html += "<div id='abbrevSection'>";
+    html += "<label>Destination Abbreviations</label>";
+    html += "<input type='text' name='abbrev' id='abbrevInput' maxlength='255' value='" + String(isBerlin ? currentConfig->berlinAbbreviations : currentConfig->pragueAbbreviations) + "' placeholder='e.g., Hauptbahnhof=Hbf,Krankenhaus=KH'>";
+    html += "<p class='info'>Optional comma-separated search=replace pairs, applied on top of the built-in ones for the selected city (e.g., Nádraží=Nádr.). An empty replacement removes the text.</p>";
+    html += "</div>";
+
     html += "<div class='grid'>";
-    html += "<div><label>Refresh Interval (sec)</label>";
+    html += "<div><label>Refresh Interval (sec, max when adaptive)</label>";
     html += "<input type='number' name='refresh' value='" + String(currentConfig->refreshInterval) + "' min='10' max='300'></div>";
 
+    html += "<div><label>Min Refresh Interval (sec, adaptive only)</label>";
+    html += "<input type='number' name='minrefresh' value='" + String(currentConfig->minRefreshInterval) + "' min='10' max='300'></div>";
+
     html += "<div><label>Number of Departures to Display (1-3 rows)</label>";
     html += "<input type='number' name='numdeps' value='" + String(currentConfig->numDepartures) + "' min='1' max='3'></div>";
 
@@ -392,7 +496,12 @@ void ConfigWebServer::handleRoot()
     html += "<div><label>Display Brightness (0-255)</label>";
     html += "<input type='number' name='brightness' value='" + String(currentConfig->brightness) + "' min='0' max='255'></div>";
 
+    html += "<div style='margin-top:10px;'><label><input type='checkbox' name='adaptive' " + String(currentConfig->adaptiveRefresh ? "checked" : "") + "> Adaptive Refresh (fetch when the cached departures run low)</label></div>";
     html += "<div style='margin-top:10px;'><label><input type='checkbox' name='debugmode' " + String(currentConfig->debugMode ? "checked" : "") + "> Enable Debug Mode (Telnet on port 23)</label></div>";
+
+    html += "<label>API Server Override (testing)</label>";
+    html += "<input type='text' name='apibase' maxlength='" + String(sizeof(currentConfig->apiBaseUrl) - 1) + "' value='" + String(currentConfig->apiBaseUrl) + "' placeholder='e.g. http://192.168.1.10:8080'>";
+    html += "<p class='info'>Leave empty for the live services. When set, every API request goes to this stand-in server (scripts/api_standin.py) as /&lt;host&gt;/&lt;path&gt;.</p>";
     html += "</div>";
 
     // Weather section (only show when not in AP mode)
@@ -695,17 +804,28 @@ function switchCity() {
     const apiKeyInput = document.getElementById('apiKeyInput');
     const stopsInput = document.getElementById('stopsInput');
     const stopHelp = document.getElementById('stopHelp');
+    const abbrevInput = document.getElementById('abbrevInput');
+    const feedUrlSection = document.getElementById('feedUrlSection');
+    const abbrevSection = document.getElementById('abbrevSection');
 
     // Save current visible stopIds to hidden field BEFORE switching
     // (currentDisplayedCity contains the city we're switching FROM)
     if (currentDisplayedCity === 'Prague') {
         // Currently showing Prague, save Prague stops
         document.getElementById('pragueStopsData').value = stopsInput.value;
+        document.getElementById('pragueAbbrevData').value = abbrevInput.value;
+    } else if (currentDisplayedCity === 'GTFS-RT') {
+        document.getElementById('gtfsRtStopsData').value = stopsInput.value;
     } else {
         // Currently showing Berlin, save Berlin stops
         document.getElementById('berlinStopsData').value = stopsInput.value;
+        document.getElementById('berlinAbbrevData').value = abbrevInput.value;
     }
 
+    // Feed URL only for GTFS-RT, abbreviations for the named cities
+    feedUrlSection.style.display = (newCity === 'GTFS-RT') ? 'block' : 'none';
+    abbrevSection.style.display = (newCity === 'GTFS-RT') ? 'none' : 'block';
+
     // Now load the new city's data
     if (newCity === 'Prague') {
         // Show API key for Prague
@@ -714,6 +834,7 @@ function switchCity() {
         // Load Prague stops from hidden field
         stopsInput.value = document.getElementById('pragueStopsData').value;
         stopsInput.placeholder = 'e.g., U693Z2P';
+        abbrevInput.value = document.getElementById('pragueAbbrevData').value;
 
         // Reset API key input field (don't expose saved key, just show placeholder)
         const pragueApiKey = document.getElementById('pragueApiKeyData').value;
@@ -722,6 +843,14 @@ function switchCity() {
 
         // Update help text
         stopHelp.innerHTML = 'Comma-separated PID stop IDs (e.g., U693Z2P). Find IDs at <a href="https://data.pid.cz/stops/json/stops.json" target="_blank">PID data</a>';
+    } else if (newCity === 'GTFS-RT') {
+        // The feed URL takes the place of the API key
+        apiKeySection.style.display = 'none';
+
+        stopsInput.value = document.getElementById('gtfsRtStopsData').value;
+        stopsInput.placeholder = 'e.g., 1234,1235';
+
+        stopHelp.innerHTML = 'Comma-separated stop_id values from the agency\'s static GTFS stops.txt';
     } else {
         // Hide API key for Berlin
         apiKeySection.style.display = 'none';
@@ -729,6 +858,7 @@ function switchCity() {
         // Load Berlin stops from hidden field
         stopsInput.value = document.getElementById('berlinStopsData').value;
         stopsInput.placeholder = 'e.g., 900013102';
+        abbrevInput.value = document.getElementById('berlinAbbrevData').value;
 
         // Update help text
         stopHelp.innerHTML = 'Comma-separated numeric BVG stop IDs (e.g., 900013102). Find IDs at <a href="https://v6.bvg.transport.rest/" target="_blank">BVG API</a>';
@@ -854,7 +984,7 @@ void ConfigWebServer::handleSave()
     {
         String newCity = server->arg("city");
         // Validate city value
-        if (newCity == "Berlin" || newCity == "Prague")
+        if (newCity == "Berlin" || newCity == "Prague" || newCity == "GTFS-RT")
         {
             if (newCity != newConfig.city)
             {
@@ -885,9 +1015,10 @@ void ConfigWebServer::handleSave()
     {
         String stops = server->arg("stops");
 
-        // Validate maximum number of stops (with 1s delay per stop, 12 stops = 12s+ query time)
+        // Validate maximum number of Berlin stops (with 1s delay per stop, 12 stops = 12s+ query time)
+        // Prague stops are batched into one request per 12 stops, so any number fits
         int numStops = countStops(stops.c_str());
-        if (numStops > 12)
+        if (selectedCity == "Berlin" && numStops > 12)
         {
             server->send(400, "text/plain",
                 "Error: Too many stops configured (max 12). Please reduce the number of stops.\n"
@@ -906,6 +1037,51 @@ void ConfigWebServer::handleSave()
         {
             strlcpy(newConfig.berlinStopIds, stops.c_str(), sizeof(newConfig.berlinStopIds));
         }
+        else if (selectedCity == "GTFS-RT")
+        {
+            strlcpy(newConfig.gtfsRtStopIds, stops.c_str(), sizeof(newConfig.gtfsRtStopIds));
+        }
+    }
+    if (server->hasArg("feedurl") && selectedCity == "GTFS-RT")
+    {
+        String feedUrl = server->arg("feedurl");
+        feedUrl.trim();
+
+        // Feeds are fetched over TLS only; the path must fit the request line
+        if (!feedUrl.startsWith("https://") || feedUrl.length() >= sizeof(newConfig.gtfsRtFeedUrl))
+        {
+            server->send(400, "text/plain",
+                "Error: The GTFS-Realtime feed URL must start with https:// and be at most " +
+                String(sizeof(newConfig.gtfsRtFeedUrl) - 1) + " characters long.");
+            logTimestamp();
+            debugPrintln("Config save failed: invalid feed URL");
+            return;
+        }
+        strlcpy(newConfig.gtfsRtFeedUrl, feedUrl.c_str(), sizeof(newConfig.gtfsRtFeedUrl));
+    }
+    if (server->hasArg("abbrev"))
+    {
+        String abbrev = server->arg("abbrev");
+
+        if (DestinationShortener::countEntries(abbrev.c_str()) < 0)
+        {
+            server->send(400, "text/plain",
+                "Error: Invalid destination abbreviations. Use comma-separated search=replace pairs,\n"
+                "e.g. Hauptbahnhof=Hbf,Krankenhaus=KH");
+            logTimestamp();
+            debugPrintln("Config save failed: malformed abbreviations");
+            return;
+        }
+
+        // Save to city-specific field
+        if (selectedCity == "Prague")
+        {
+            strlcpy(newConfig.pragueAbbreviations, abbrev.c_str(), sizeof(newConfig.pragueAbbreviations));
+        }
+        else if (selectedCity == "Berlin")
+        {
+            strlcpy(newConfig.berlinAbbreviations, abbrev.c_str(), sizeof(newConfig.berlinAbbreviations));
+        }
     }
     if (server->hasArg("refresh"))
     {
@@ -915,6 +1091,14 @@ void ConfigWebServer::handleSave()
         if (newConfig.refreshInterval > 300)
             newConfig.refreshInterval = 300;
     }
+    if (server->hasArg("minrefresh"))
+    {
+        newConfig.minRefreshInterval = server->arg("minrefresh").toInt();
+        if (newConfig.minRefreshInterval < 10)
+            newConfig.minRefreshInterval = 10;
+        if (newConfig.minRefreshInterval > newConfig.refreshInterval)
+            newConfig.minRefreshInterval = newConfig.refreshInterval;
+    }
     if (server->hasArg("numdeps"))
     {
         newConfig.numDepartures = server->arg("numdeps").toInt();
@@ -940,8 +1124,32 @@ void ConfigWebServer::handleSave()
             newConfig.brightness = 255;
     }
 
+    if (server->hasArg("apibase"))
+    {
+        String apiBase = server->arg("apibase");
+        apiBase.trim();
+        while (apiBase.endsWith("/"))
+        {
+            apiBase.remove(apiBase.length() - 1);
+        }
+
+        if (apiBase.length() > 0 &&
+            ((!apiBase.startsWith("http://") && !apiBase.startsWith("https://")) ||
+             apiBase.length() >= sizeof(newConfig.apiBaseUrl)))
+        {
+            server->send(400, "text/plain",
+                "Error: The API server override must start with http:// or https:// and be at most " +
+                String(sizeof(newConfig.apiBaseUrl) - 1) + " characters long.");
+            logTimestamp();
+            debugPrintln("Config save failed: invalid API server override");
+            return;
+        }
+        strlcpy(newConfig.apiBaseUrl, apiBase.c_str(), sizeof(newConfig.apiBaseUrl));
+    }
+
     // Debug mode checkbox (unchecked = not present in POST data)
     newConfig.debugMode = server->hasArg("debugmode");
+    newConfig.adaptiveRefresh = server->hasArg("adaptive");
 
     // Weather configuration
     newConfig.weatherEnabled = server->hasArg("weather_enabled");
@@ -1554,7 +1762,9 @@ void ConfigWebServer::handleStartDemo()
     String body = server->arg("plain");
 
     // Simple JSON parsing for departures array
-    Departure demoDepartures[3];
+    Departure demoDepartures[3] = {};
+    static DepartureStrings demoStrings;
+    demoStrings.reset();
     int demoCount = 0;
 
     // Extract departure data from JSON (manual parsing for simplicity)
@@ -1598,12 +1808,17 @@ void ConfigWebServer::handleStartDemo()
             hasAC = acValue.indexOf("true") >= 0;
         }
 
-        // Copy to departure structure
-        strlcpy(demoDepartures[demoCount].line, lineValue.c_str(), sizeof(demoDepartures[demoCount].line));
-        strlcpy(demoDepartures[demoCount].destination, destValue.c_str(), sizeof(demoDepartures[demoCount].destination));
+        // Copy to departure structure (strings in the display encoding, as the APIs store them)
+        char lineText[MAX_LINE_LENGTH];
+        char destText[MAX_DESTINATION_LENGTH];
+        utf8ToGfxLatin2(lineValue.c_str(), lineText, sizeof(lineText));
+        utf8ToGfxLatin2(destValue.c_str(), destText, sizeof(destText));
+        demoDepartures[demoCount].lineId = demoStrings.intern(lineText, MAX_LINE_LENGTH);
+        demoDepartures[demoCount].destinationId = demoStrings.intern(destText, MAX_DESTINATION_LENGTH);
         demoDepartures[demoCount].eta = etaValue.toInt();
         demoDepartures[demoCount].hasAC = hasAC;
         demoDepartures[demoCount].isDelayed = false;
+        demoDepartures[demoCount].isScheduled = false;
         demoDepartures[demoCount].delayMinutes = 0;
         demoDepartures[demoCount].departureTime = 0;  // Not used in demo mode
 
@@ -1622,13 +1837,13 @@ void ConfigWebServer::handleStartDemo()
     // Call callback to activate demo mode
     if (onDemoStartCallback != nullptr)
     {
-        onDemoStartCallback(demoDepartures, demoCount);
+        onDemoStartCallback(demoDepartures, demoStrings, demoCount);
     }
 
     // Show demo on display immediately
     if (displayManager != nullptr)
     {
-        displayManager->drawDemo(demoDepartures, demoCount, "Demo Mode");
+        displayManager->drawDemo(demoDepartures, demoStrings, demoCount);
     }
 
     logTimestamp();
@@ -1672,4 +1887,204 @@ void ConfigWebServer::handleScreenOff()
     server->send(200, "text/plain", "OK");
 }
 
+// ============================================================================
+// Prometheus Metrics
+// ============================================================================
+
+static void appendMetricHeader(String &out, const char *name, const char *type, const char *help)
+{
+    char line[160];
+    snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    out += line;
+}
+
+// One histogram series; labels is "" or e.g. "stop=\"0\"," (trailing comma), scale converts to seconds
+static void appendHistogram(String &out, const char *name, const char *labels,
+                            const LatencyHistogram &histogram, double scale)
+{
+    char line[160];
+    uint32_t cumulative = 0;
+    for (int i = 0; i < histogram.getBoundCount(); i++)
+    {
+        cumulative += histogram.getBucket(i);
+        snprintf(line, sizeof(line), "%s_bucket{%sle=\"%g\"} %lu\n", name, labels,
+                 histogram.getBound(i) * scale, (unsigned long)cumulative);
+        out += line;
+    }
+    cumulative += histogram.getBucket(histogram.getBoundCount());
+    snprintf(line, sizeof(line), "%s_bucket{%sle=\"+Inf\"} %lu\n", name, labels, (unsigned long)cumulative);
+    out += line;
+
+    // Labels without the trailing comma for _sum / _count
+    char plain[48];
+    strlcpy(plain, labels, sizeof(plain));
+    size_t length = strlen(plain);
+    if (length > 0)
+    {
+        plain[length - 1] = '\0';
+    }
+    const char *open = length > 0 ? "{" : "";
+    const char *close = length > 0 ? "}" : "";
+    snprintf(line, sizeof(line), "%s_sum%s%s%s %.6f\n%s_count%s%s%s %lu\n",
+             name, open, plain, close, histogram.getSum() * scale,
+             name, open, plain, close, (unsigned long)histogram.getCount());
+    out += line;
+}
+
+static void appendValue(String &out, const char *name, const char *labels, unsigned long value)
+{
+    char line[160];
+    if (labels[0])
+    {
+        snprintf(line, sizeof(line), "%s{%s} %lu\n", name, labels, value);
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "%s %lu\n", name, value);
+    }
+    out += line;
+}
+
+void ConfigWebServer::handleMetrics()
+{
+    Metrics &metrics = Metrics::getInstance();
+    String out;
+    out.reserve(7168);
+    char labels[96];
+
+    appendMetricHeader(out, "spojboard_fetch_duration_seconds", "histogram",
+                       "Departure query duration incl. retries and parse, per stop index (all = one request for several stops)");
+    for (int series = 0; series < Metrics::FETCH_SERIES; series++)
+    {
+        const LatencyHistogram &histogram = metrics.getFetchLatency(series);
+        if (histogram.getCount() == 0)
+        {
+            continue;
+        }
+        if (series == Metrics::SERIES_ALL)
+            strlcpy(labels, "stop=\"all\",", sizeof(labels));
+        else if (series == Metrics::SERIES_OTHER)
+            strlcpy(labels, "stop=\"other\",", sizeof(labels));
+        else
+            snprintf(labels, sizeof(labels), "stop=\"%d\",", series);
+        appendHistogram(out, "spojboard_fetch_duration_seconds", labels, histogram, 0.001);
+    }
+
+    appendMetricHeader(out, "spojboard_parse_duration_seconds", "histogram",
+                       "Response body parse duration (streamed, includes receive time)");
+    appendHistogram(out, "spojboard_parse_duration_seconds", "", metrics.getParseLatency(), 0.001);
+
+    appendMetricHeader(out, "spojboard_render_duration_seconds", "histogram", "updateDisplay() duration");
+    appendHistogram(out, "spojboard_render_duration_seconds", "", metrics.getRenderLatency(), 0.000001);
+
+    appendMetricHeader(out, "spojboard_frame_pixels", "histogram",
+                       "Pixels redrawn per frame (le=0: nothing changed; full redraw = 4096)");
+    appendHistogram(out, "spojboard_frame_pixels", "", metrics.getFramePixels(), 1.0);
+    appendMetricHeader(out, "spojboard_frame_full_redraws_total", "counter",
+                       "Frames that cleared and redrew the whole panel");
+    appendValue(out, "spojboard_frame_full_redraws_total", "", metrics.getFullRedrawCount());
+
+    appendMetricHeader(out, "spojboard_loop_latency_seconds", "histogram", "Time between loop() iterations");
+    appendHistogram(out, "spojboard_loop_latency_seconds", "", metrics.getLoopLatency(), 0.000001);
+
+    appendMetricHeader(out, "spojboard_refreshes_total", "counter", "Applied departure refreshes");
+    for (int all = 0; all < 2; all++)
+    {
+        for (int ok = 0; ok < 2; ok++)
+        {
+            snprintf(labels, sizeof(labels), "kind=\"%s\",result=\"%s\"", all ? "all" : "stop", ok ? "ok" : "error");
+            appendValue(out, "spojboard_refreshes_total", labels, metrics.getRefreshCount(all, ok));
+        }
+    }
+
+    // JsonDocument use per provider, for sizing JSON_BUFFER_SIZE from data
+    appendMetricHeader(out, "spojboard_json_documents_total", "counter", "JsonDocuments parsed (one allocation each)");
+    for (int d = 0; d < Metrics::JSON_DOC_COUNT; d++)
+    {
+        snprintf(labels, sizeof(labels), "doc=\"%s\"", Metrics::getJsonDocName((Metrics::JsonDoc)d));
+        appendValue(out, "spojboard_json_documents_total", labels, metrics.getJsonDocStats((Metrics::JsonDoc)d).documents);
+    }
+    appendMetricHeader(out, "spojboard_json_overflows_total", "counter", "JsonDocuments that ran out of capacity");
+    for (int d = 0; d < Metrics::JSON_DOC_COUNT; d++)
+    {
+        snprintf(labels, sizeof(labels), "doc=\"%s\"", Metrics::getJsonDocName((Metrics::JsonDoc)d));
+        appendValue(out, "spojboard_json_overflows_total", labels, metrics.getJsonDocStats((Metrics::JsonDoc)d).overflows);
+    }
+    appendMetricHeader(out, "spojboard_json_peak_bytes", "gauge", "Highest JsonDocument memoryUsage() since boot");
+    for (int d = 0; d < Metrics::JSON_DOC_COUNT; d++)
+    {
+        const JsonDocumentStats &stats = metrics.getJsonDocStats((Metrics::JsonDoc)d);
+        if (stats.documents > 0)
+        {
+            snprintf(labels, sizeof(labels), "doc=\"%s\"", Metrics::getJsonDocName((Metrics::JsonDoc)d));
+            appendValue(out, "spojboard_json_peak_bytes", labels, stats.peakBytes);
+        }
+    }
+    appendMetricHeader(out, "spojboard_json_capacity_bytes", "gauge", "JsonDocument capacity (JSON_BUFFER_SIZE)");
+    for (int d = 0; d < Metrics::JSON_DOC_COUNT; d++)
+    {
+        const JsonDocumentStats &stats = metrics.getJsonDocStats((Metrics::JsonDoc)d);
+        if (stats.documents > 0)
+        {
+            snprintf(labels, sizeof(labels), "doc=\"%s\"", Metrics::getJsonDocName((Metrics::JsonDoc)d));
+            appendValue(out, "spojboard_json_capacity_bytes", labels, stats.capacity);
+        }
+    }
+
+    // Per-host HTTP counters
+    static const char *STATUS_CLASSES[] = {"error", "1xx", "2xx", "3xx", "4xx", "5xx"};
+    HttpConnectionManager &connections = HttpConnectionManager::getInstance();
+    appendMetricHeader(out, "spojboard_http_responses_total", "counter",
+                       "HTTP responses by status class (error = no response)");
+    for (int h = 0; h < HttpConnectionManager::HOST_COUNT; h++)
+    {
+        HttpConnectionManager::Host host = (HttpConnectionManager::Host)h;
+        const HttpConnectionManager::HostStats stats = connections.getStats(host);
+        for (int c = 0; c < 6 && stats.requests > 0; c++)
+        {
+            snprintf(labels, sizeof(labels), "host=\"%s\",code=\"%s\"", connections.getHostName(host), STATUS_CLASSES[c]);
+            appendValue(out, "spojboard_http_responses_total", labels, stats.statusClasses[c]);
+        }
+    }
+    appendMetricHeader(out, "spojboard_http_body_bytes_total", "counter", "HTTP response body bytes received");
+    for (int h = 0; h < HttpConnectionManager::HOST_COUNT; h++)
+    {
+        HttpConnectionManager::Host host = (HttpConnectionManager::Host)h;
+        const HttpConnectionManager::HostStats stats = connections.getStats(host);
+        if (stats.requests > 0)
+        {
+            snprintf(labels, sizeof(labels), "host=\"%s\"", connections.getHostName(host));
+            appendValue(out, "spojboard_http_body_bytes_total", labels, stats.bodyBytes);
+        }
+    }
+    appendMetricHeader(out, "spojboard_tls_handshakes_total", "counter", "New TLS connections");
+    for (int h = 0; h < HttpConnectionManager::HOST_COUNT; h++)
+    {
+        HttpConnectionManager::Host host = (HttpConnectionManager::Host)h;
+        const HttpConnectionManager::HostStats stats = connections.getStats(host);
+        if (stats.requests > 0)
+        {
+            snprintf(labels, sizeof(labels), "host=\"%s\"", connections.getHostName(host));
+            appendValue(out, "spojboard_tls_handshakes_total", labels, stats.handshakes);
+        }
+    }
+
+    // Gauges
+    appendMetricHeader(out, "spojboard_heap_free_bytes", "gauge", "Free heap");
+    appendValue(out, "spojboard_heap_free_bytes", "", ESP.getFreeHeap());
+    appendMetricHeader(out, "spojboard_heap_min_free_bytes", "gauge", "Lowest free heap since boot");
+    appendValue(out, "spojboard_heap_min_free_bytes", "", ESP.getMinFreeHeap());
+    appendMetricHeader(out, "spojboard_heap_largest_block_bytes", "gauge", "Largest allocatable heap block");
+    appendValue(out, "spojboard_heap_largest_block_bytes", "", ESP.getMaxAllocHeap());
+    appendMetricHeader(out, "spojboard_departures", "gauge", "Departures in the cache");
+    appendValue(out, "spojboard_departures", "", departureCount);
+    appendMetricHeader(out, "spojboard_wifi_rssi_dbm", "gauge", "WiFi signal strength");
+    snprintf(labels, sizeof(labels), "spojboard_wifi_rssi_dbm %d\n", wifiConnected ? (int)WiFi.RSSI() : 0);
+    out += labels;
+    appendMetricHeader(out, "spojboard_uptime_seconds", "counter", "Time since boot");
+    appendValue(out, "spojboard_uptime_seconds", "", millis() / 1000);
+
+    server->send(200, "text/plain; version=0.0.4", out);
+}
+
 #endif // !MATRIX_PORTAL_M4
@@ -23,7 +23,8 @@ public:
     typedef void (*ConfigSaveCallback)(const Config& newConfig, bool wifiChanged);
     typedef void (*RefreshCallback)();
     typedef void (*RebootCallback)();
-    typedef void (*DemoStartCallback)(const Departure* demoDepartures, int demoCount);
+    typedef void (*DemoStartCallback)(const Departure* demoDepartures, const DepartureStrings& demoStrings,
+                                      int demoCount);
     typedef void (*DemoStopCallback)();
 
     ConfigWebServer() : server(80), displayManager(nullptr), currentConfig(nullptr) {}
@@ -85,6 +86,10 @@ public:
     void updateState(const Config* cfg, bool, bool, const char*, const char*, int,
                     bool, const char*, int, const char*) { currentConfig = cfg; }
 
+    void setRefreshStatus(const char*, unsigned long) {}
+
+    void setDepartureDelta(const DepartureDelta&, unsigned long) {}
+
     void* getServer() { return nullptr; }
 
 private:
@@ -115,7 +120,8 @@ public:
     typedef void (*ConfigSaveCallback)(const Config& newConfig, bool wifiChanged);
     typedef void (*RefreshCallback)();
     typedef void (*RebootCallback)();
-    typedef void (*DemoStartCallback)(const Departure* demoDepartures, int demoCount);
+    typedef void (*DemoStartCallback)(const Departure* demoDepartures, const DepartureStrings& demoStrings,
+                                      int demoCount);
     typedef void (*DemoStopCallback)();
 
     ConfigWebServer();
@@ -136,6 +142,21 @@ public:
                     bool apiError, const char* apiErrorMsg,
                     int departureCount, const char* stopName);
 
+    /**
+     * Set next scheduled departure fetch for the status page
+     * @param reason Why the fetch was scheduled (static string)
+     * @param secondsUntilNext Seconds until the fetch is due
+     */
+    void setRefreshStatus(const char* reason, unsigned long secondsUntilNext);
+
+    /**
+     * Record the trip delta of the latest departure update for the status page
+     * Empty deltas only count as unchanged refreshes
+     * @param delta Added, removed and changed trips
+     * @param nowMs Current millis()
+     */
+    void setDepartureDelta(const DepartureDelta& delta, unsigned long nowMs);
+
     WebServerType* getServer() { return server; }
 
 private:
@@ -155,6 +176,11 @@ private:
     const char* apiErrorMsg;
     int departureCount;
     const char* stopName;
+    const char* nextRefreshReason;
+    unsigned long nextRefreshSeconds;
+    DepartureDelta lastDelta;          // Last non-empty departure delta
+    unsigned long lastDeltaMs;         // When lastDelta was applied (0 = never)
+    unsigned long unchangedRefreshes;  // Updates with an empty delta since lastDelta
 
     // Callbacks
     ConfigSaveCallback onSaveCallback;
@@ -179,6 +205,7 @@ private:
     void handleStopDemo();
     void handleScreenOn();
     void handleScreenOff();
+    void handleMetrics();
     void handleNotFound();
 
     // OTA progress callbacks
@@ -1,5 +1,6 @@
 #include "GitHubOTA.h"
 #include "../utils/Logger.h"
+#include "../utils/Metrics.h"
 #include <Update.h>
 #include <WiFi.h>
 
@@ -165,6 +166,8 @@ GitHubOTA::ReleaseInfo GitHubOTA::checkForUpdate(const char* currentRelease)
 
     DynamicJsonDocument doc(JSON_BUFFER_SIZE);
     DeserializationError error = deserializeJson(doc, payload);
+    Metrics::getInstance().recordJsonDocument(Metrics::JSON_DOC_GITHUB, doc.memoryUsage(), JSON_BUFFER_SIZE,
+                                              doc.overflowed() || error == DeserializationError::NoMemory);
 
     if (error)
     {
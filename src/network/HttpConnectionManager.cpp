@@ -0,0 +1,376 @@
+#include "HttpConnectionManager.h"
+#include "../utils/Logger.h"
+
+// ============================================================================
+// ChunkedStream
+// ============================================================================
+
+ChunkedStream::ChunkedStream()
+    : source(nullptr), remaining(0), finished(false), bodyBytes(0)
+{
+    // read() already waits on the source; -1 means the body ended (or the source
+    // timed out), so readBytes() must not wait again at the end of every body
+    setTimeout(0);
+}
+
+void ChunkedStream::begin(Stream& body)
+{
+    source = &body;
+    remaining = 0;
+    finished = false;
+    bodyBytes = 0;
+}
+
+void ChunkedStream::skipLine()
+{
+    // Consume up to and including the next LF (timed reads honour the stream timeout)
+    uint8_t c;
+    while (source->readBytes(&c, 1) == 1 && c != '\n')
+    {
+    }
+}
+
+bool ChunkedStream::readChunkHeader()
+{
+    // Chunk header: hex size, optional ";extension", CRLF
+    long size = 0;
+    bool haveDigit = false;
+    uint8_t c;
+    while (source->readBytes(&c, 1) == 1)
+    {
+        int digit = -1;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+
+        if (digit >= 0)
+        {
+            size = (size << 4) | digit;
+            haveDigit = true;
+            continue;
+        }
+
+        if (c != '\n')
+        {
+            skipLine(); // Extension or CR - skip rest of header line
+        }
+        break;
+    }
+
+    if (!haveDigit)
+    {
+        return false; // Timeout or malformed header
+    }
+
+    if (size == 0)
+    {
+        // Last chunk: skip optional trailers up to the terminating empty line
+        finished = true;
+        uint8_t t;
+        while (source->readBytes(&t, 1) == 1)
+        {
+            if (t == '\n')
+                break;          // Empty line - end of body
+            if (t != '\r')
+                skipLine();     // Trailer header
+        }
+        return true;
+    }
+
+    remaining = size;
+    return true;
+}
+
+int ChunkedStream::available()
+{
+    if (finished)
+        return 0;
+    int avail = source->available();
+    if (remaining > 0 && avail > remaining)
+        return (int)remaining;
+    return avail;
+}
+
+int ChunkedStream::read()
+{
+    if (finished)
+        return -1;
+
+    if (remaining == 0 && (!readChunkHeader() || finished))
+        return -1;
+
+    uint8_t c;
+    if (source->readBytes(&c, 1) != 1)
+        return -1;
+
+    bodyBytes++;
+    if (--remaining == 0)
+    {
+        skipLine(); // CRLF after chunk data
+    }
+    return c;
+}
+
+int ChunkedStream::peek()
+{
+    if (finished)
+        return -1;
+
+    if (remaining == 0 && (!readChunkHeader() || finished))
+        return -1;
+
+    return source->peek();
+}
+
+void ChunkedStream::drain()
+{
+    while (read() >= 0)
+    {
+    }
+}
+
+// ============================================================================
+// HttpConnectionManager
+// ============================================================================
+
+HttpConnectionManager& HttpConnectionManager::getInstance()
+{
+    static HttpConnectionManager instance;
+    return instance;
+}
+
+HttpConnectionManager::HttpConnectionManager() : plainHttp(false)
+{
+    baseUrl[0] = '\0';
+    for (int i = 0; i < HOST_COUNT; i++)
+    {
+        // Same trust model as HTTPClient::begin(url) without a CA certificate
+        connections[i].client.setInsecure();
+        connections[i].http.setReuse(true);
+    }
+}
+
+const char* HttpConnectionManager::getHostName(Host host) const
+{
+    switch (host)
+    {
+        case HOST_GOLEMIO: return "api.golemio.cz";
+        case HOST_BVG: return "v6.bvg.transport.rest";
+        case HOST_OPEN_METEO: return "api.open-meteo.com";
+        case HOST_GTFS_RT: return connections[host].server[0] ? connections[host].server : "unknown";
+        default: return "unknown";
+    }
+}
+
+void HttpConnectionManager::setServer(Host host, const char* hostName)
+{
+    Connection& conn = connections[host];
+    if (strncmp(conn.server, hostName, sizeof(conn.server)) == 0)
+    {
+        return;
+    }
+
+    // A kept-alive socket belongs to the old server
+    conn.http.end();
+    socketOf(conn).stop();
+    strlcpy(conn.server, hostName, sizeof(conn.server));
+}
+
+void HttpConnectionManager::setBaseUrl(const char* url)
+{
+    if (strncmp(baseUrl, url, sizeof(baseUrl)) == 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < HOST_COUNT; i++)
+    {
+        connections[i].http.end();
+        connections[i].client.stop();
+        connections[i].plainClient.stop();
+    }
+    strlcpy(baseUrl, url, sizeof(baseUrl));
+    plainHttp = strncmp(baseUrl, "http://", 7) == 0;
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "HTTP: API requests go to %s", baseUrl[0] ? baseUrl : "the live services");
+    logTimestamp();
+    debugPrintln(msg);
+}
+
+int HttpConnectionManager::send(Connection& conn, Host host, const char* path,
+                                const char* const* headers, int headerPairs)
+{
+    char url[640];
+    if (baseUrl[0])
+    {
+        snprintf(url, sizeof(url), "%s/%s%s", baseUrl, getHostName(host), path);
+    }
+    else
+    {
+        snprintf(url, sizeof(url), "https://%s%s", getHostName(host), path);
+    }
+
+    // HTTPClient::begin() keeps an established connection to the same host
+    conn.http.begin(socketOf(conn), url);
+    for (int i = 0; i < headerPairs; i++)
+    {
+        conn.http.addHeader(headers[i * 2], headers[i * 2 + 1]);
+    }
+
+    static const char* collected[] = {"Transfer-Encoding"};
+    conn.http.collectHeaders(collected, 1);
+
+    return conn.http.GET();
+}
+
+int HttpConnectionManager::get(Host host, const char* path, const char* const* headers, int headerPairs, int timeoutMs)
+{
+    Connection& conn = connections[host];
+    WiFiClient& socket = socketOf(conn);
+
+    // Server has almost certainly closed a socket idle this long - start fresh
+    if (socket.connected() && millis() - conn.lastUsed > KEEPALIVE_IDLE_MS)
+    {
+        socket.stop();
+    }
+
+    conn.http.setTimeout(timeoutMs);
+    conn.chunkedActive = false;
+
+    bool reused = socket.connected();
+    if (!reused)
+    {
+        conn.stats.handshakes++;
+    }
+    conn.stats.requests++;
+
+    int httpCode = send(conn, host, path, headers, headerPairs);
+
+    // A reused socket may have been closed by the server while idle - reconnect once
+    if (httpCode < 0 && reused)
+    {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "HTTP: Reused connection to %s failed (%d), reconnecting",
+                 getHostName(host), httpCode);
+        logTimestamp();
+        debugPrintln(msg);
+
+        socket.stop();
+        conn.stats.reconnects++;
+        conn.stats.handshakes++;
+        httpCode = send(conn, host, path, headers, headerPairs);
+    }
+
+    conn.lastUsed = millis();
+    conn.stats.statusClasses[(httpCode >= 100 && httpCode < 600) ? httpCode / 100 : 0]++;
+
+    if (httpCode > 0 && conn.http.header("Transfer-Encoding").equalsIgnoreCase("chunked"))
+    {
+        conn.chunkedActive = true;
+        conn.chunked.begin(socket);
+    }
+
+    return httpCode;
+}
+
+Stream& HttpConnectionManager::getBodyStream(Host host)
+{
+    Connection& conn = connections[host];
+    if (conn.chunkedActive)
+    {
+        return conn.chunked;
+    }
+    return conn.http.getStream();
+}
+
+String HttpConnectionManager::getBodyString(Host host)
+{
+    Connection& conn = connections[host];
+    String body = conn.http.getString();
+
+    // HTTPClient::getString() decodes chunked bodies itself, terminating chunk
+    // included - the decoder must not drain the socket again in end()
+    if (conn.chunkedActive)
+    {
+        conn.chunkedActive = false;
+        conn.stats.bodyBytes += body.length();
+    }
+    return body;
+}
+
+int HttpConnectionManager::getBodySize(Host host)
+{
+    Connection& conn = connections[host];
+    return conn.chunkedActive ? -1 : conn.http.getSize();
+}
+
+void HttpConnectionManager::countBody(Connection& conn)
+{
+    // Chunked bodies are counted as decoded; otherwise Content-Length (read or drained)
+    if (conn.chunkedActive)
+    {
+        conn.stats.bodyBytes += conn.chunked.getBodyBytes();
+    }
+    else if (conn.http.getSize() > 0)
+    {
+        conn.stats.bodyBytes += conn.http.getSize();
+    }
+}
+
+void HttpConnectionManager::end(Host host)
+{
+    Connection& conn = connections[host];
+
+    // Read through the terminating chunk so the next response starts cleanly
+    if (conn.chunkedActive)
+    {
+        conn.chunked.drain();
+    }
+    countBody(conn);
+    conn.chunkedActive = false;
+
+    // With reuse enabled, end() drains buffered bytes and keeps the socket open
+    conn.http.end();
+    conn.lastUsed = millis();
+}
+
+void HttpConnectionManager::drop(Host host)
+{
+    Connection& conn = connections[host];
+    countBody(conn);
+    conn.chunkedActive = false;
+    conn.http.end();
+    socketOf(conn).stop();
+}
+
+void HttpConnectionManager::closeIdle()
+{
+    unsigned long now = millis();
+    for (int i = 0; i < HOST_COUNT; i++)
+    {
+        Connection& conn = connections[i];
+        WiFiClient& socket = socketOf(conn);
+        if (socket.connected() && now - conn.lastUsed > KEEPALIVE_IDLE_MS)
+        {
+            socket.stop();
+        }
+    }
+}
+
+void HttpConnectionManager::logStats()
+{
+    for (int i = 0; i < HOST_COUNT; i++)
+    {
+        const HostStats& stats = connections[i].stats;
+        if (stats.requests == 0)
+            continue;
+
+        char msg[128];
+        snprintf(msg, sizeof(msg), "HTTP: %s handshakes=%lu requests=%lu reconnects=%lu",
+                 getHostName((Host)i), (unsigned long)stats.handshakes,
+                 (unsigned long)stats.requests, (unsigned long)stats.reconnects);
+        logTimestamp();
+        debugPrintln(msg);
+    }
+}
@@ -0,0 +1,237 @@
+#ifndef HTTPCONNECTIONMANAGER_H
+#define HTTPCONNECTIONMANAGER_H
+
+// ESP32 and host only - M4 uses WiFiNINA sockets directly (see build_src_filter)
+#include <Arduino.h>
+#if defined(NATIVE_HOST)
+#include "../hal/HttpFetch.h"
+#else
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#endif
+
+#if !defined(NATIVE_HOST)
+// ============================================================================
+// Chunked Transfer Decoding Stream
+// ============================================================================
+
+/**
+ * Decodes an HTTP/1.1 chunked body on the fly.
+ * HTTPClient::getStream() returns the raw socket, so streaming parsers need
+ * this to read keep-alive responses that use Transfer-Encoding: chunked.
+ */
+class ChunkedStream : public Stream
+{
+public:
+    ChunkedStream();
+
+    /**
+     * Reset decoder state for a new response body
+     * @param body Socket the chunked body is read from
+     */
+    void begin(Stream& body);
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t) override { return 0; }
+
+    /**
+     * Consume the rest of the body including the terminating chunk,
+     * leaving the connection ready for the next request
+     */
+    void drain();
+
+    /**
+     * Body bytes decoded since begin()
+     */
+    uint32_t getBodyBytes() const { return bodyBytes; }
+
+private:
+    Stream* source;
+    long remaining;   // Bytes left in the current chunk
+    bool finished;    // Terminating zero-length chunk seen
+    uint32_t bodyBytes;
+
+    bool readChunkHeader();
+    void skipLine();
+};
+#endif // !NATIVE_HOST
+
+// ============================================================================
+// HTTP Connection Manager
+// ============================================================================
+
+/**
+ * Keeps one keep-alive TLS connection per API host and reuses it for requests
+ * that follow within KEEPALIVE_IDLE_MS: the stops and retries of one refresh,
+ * and refreshes that fall due close together (adaptive or per-stop deadlines
+ * near minRefreshInterval). Refreshes further apart - the default
+ * refreshInterval is 300s - start a new connection and pay a full handshake:
+ * the servers drop idle sockets after ~75s, and WiFiClientSecure offers no
+ * hook for TLS session resumption. A request on a reused connection that
+ * fails at the transport level (server closed the idle socket) is
+ * transparently retried once on a fresh connection.
+ *
+ * Per-host counters of TLS handshakes vs. requests served show the reuse ratio;
+ * status classes and body bytes feed /metrics.
+ * Requests must all come from one task (the fetch task). The counters are
+ * volatile 32-bit words written only by that task, so the web server may
+ * read them from the main loop through getStats().
+ *
+ * The host build (hal/native/NativeHttp.cpp) keeps this interface but sends
+ * every request through the HttpFetch set with setTransport().
+ */
+class HttpConnectionManager
+{
+public:
+    enum Host
+    {
+        HOST_GOLEMIO = 0,  // api.golemio.cz
+        HOST_BVG,          // v6.bvg.transport.rest
+        HOST_OPEN_METEO,   // api.open-meteo.com
+        HOST_GTFS_RT,      // GTFS-Realtime feed server from the config (see setServer())
+        HOST_COUNT
+    };
+
+    // Each counter is a single aligned word, so a read never sees half an update
+    struct HostStats
+    {
+        volatile uint32_t handshakes;  // New TLS connections established
+        volatile uint32_t requests;    // Requests sent (including those on reused connections)
+        volatile uint32_t reconnects;  // Reused connections found dead and re-established
+        volatile uint32_t statusClasses[6];  // Responses by status / 100 (1xx-5xx); [0] = no response (transport error)
+        volatile uint32_t bodyBytes;         // Response body bytes received
+    };
+
+    static HttpConnectionManager& getInstance();
+
+    /**
+     * Send a GET request on the host's persistent connection
+     * @param host Target host
+     * @param path Request path including query string (e.g. "/v2/pid/departureboards?ids=...")
+     * @param headers Flat array of header name/value pairs (may be nullptr)
+     * @param headerPairs Number of name/value pairs in headers
+     * @param timeoutMs Read timeout in milliseconds
+     * @return HTTP status code, or negative HTTPClient error code
+     */
+    int get(Host host, const char* path, const char* const* headers, int headerPairs, int timeoutMs);
+
+    /**
+     * Get a stream positioned at the start of the response body
+     * Decodes chunked transfer encoding transparently
+     */
+    Stream& getBodyStream(Host host);
+
+    /**
+     * Read the whole response body into a String (small bodies only)
+     */
+    String getBodyString(Host host);
+
+    /**
+     * Finish the current request, keeping the connection open for reuse
+     * Any unread body data is drained first
+     */
+    void end(Host host);
+
+    /**
+     * Finish the current request and close the connection
+     * Use after errors that may leave the stream in an unknown state
+     */
+    void drop(Host host);
+
+    /**
+     * Close connections that have been idle longer than KEEPALIVE_IDLE_MS
+     * Frees ~40KB of TLS buffers per connection once the server would have closed it anyway
+     */
+    void closeIdle();
+
+    /**
+     * Set the server of a host whose name comes from the config (HOST_GTFS_RT)
+     * Closes the open connection if the server changed
+     * @param host Host slot
+     * @param hostName Server name without scheme or path (e.g. "gtfsrt.example.org")
+     */
+    void setServer(Host host, const char* hostName);
+
+    /**
+     * Send every host's requests to a stand-in server instead of the live
+     * service: https://<host><path> becomes <baseUrl>/<host><path>
+     * (see scripts/api_standin.py). Closes open connections if it changed.
+     * @param baseUrl "http://" or "https://" URL without trailing slash, or "" for the live services
+     */
+    void setBaseUrl(const char* baseUrl);
+
+    /**
+     * Content-Length of the last response, or -1 if unknown (chunked)
+     */
+    int getBodySize(Host host);
+
+    /**
+     * Copy of a host's counters, safe to take from another task
+     * Counters are read one by one while the fetch task may be mid-request,
+     * so e.g. requests can be one ahead of statusClasses.
+     */
+    HostStats getStats(Host host) const { return connections[host].stats; }
+    const char* getHostName(Host host) const;
+
+    /**
+     * Log handshakes vs. requests for every host
+     */
+    void logStats();
+
+#if defined(NATIVE_HOST)
+    /**
+     * Set the transport for all hosts (host build only)
+     * @param fetch Transport, or nullptr to fail every request with HTTPC_ERROR_CONNECTION_REFUSED
+     */
+    void setTransport(HttpFetch* fetch) { transport = fetch; }
+#endif
+
+private:
+    HttpConnectionManager();
+    HttpConnectionManager(const HttpConnectionManager&) = delete;
+    HttpConnectionManager& operator=(const HttpConnectionManager&) = delete;
+
+    static constexpr unsigned long KEEPALIVE_IDLE_MS = 70000;  // Just under nginx's default 75s keep-alive timeout (shorter than a refresh interval)
+    static constexpr int MAX_SERVER_NAME = 64;
+    static constexpr int MAX_BASE_URL = 64;
+
+    char baseUrl[MAX_BASE_URL];  // Stand-in server, empty for the live services
+
+#if defined(NATIVE_HOST)
+    struct Connection
+    {
+        HostStats stats;
+        char server[MAX_SERVER_NAME];  // Set by setServer(), empty for built-in hosts
+
+        Connection() : stats() { server[0] = '\0'; }
+    };
+
+    HttpFetch* transport;
+    Connection connections[HOST_COUNT];
+#else
+    struct Connection
+    {
+        WiFiClientSecure client;
+        WiFiClient plainClient;  // Used instead of client for an http:// base URL
+        HTTPClient http;
+        ChunkedStream chunked;  // Decoder over the socket for chunked bodies
+        bool chunkedActive;     // Current response body is chunked
+        unsigned long lastUsed;
+        HostStats stats;
+        char server[MAX_SERVER_NAME];  // Set by setServer(), empty for built-in hosts
+
+        Connection() : chunkedActive(false), lastUsed(0), stats() { server[0] = '\0'; }
+    };
+
+    Connection connections[HOST_COUNT];
+    bool plainHttp;  // baseUrl is http:// - requests go over plainClient
+
+    WiFiClient& socketOf(Connection& conn) { return plainHttp ? conn.plainClient : conn.client; }
+    int send(Connection& conn, Host host, const char* path, const char* const* headers, int headerPairs);
+    void countBody(Connection& conn);
+#endif // NATIVE_HOST
+};
+
+#endif // HTTPCONNECTIONMANAGER_H
@@ -14,6 +14,12 @@ WiFiManager::WiFiManager()
 }
 
 bool WiFiManager::connectSTA(const Config& config, int maxAttempts, int delayMs)
+{
+    beginSTA(config);
+    return waitForSTA(maxAttempts, delayMs);
+}
+
+void WiFiManager::beginSTA(const Config& config)
 {
     char msg[96];
     snprintf(msg, sizeof(msg), "WiFi: Connecting to %s", config.wifiSsid);
@@ -26,20 +32,22 @@ bool WiFiManager::connectSTA(const Config& config, int maxAttempts, int delayMs)
     {
         logTimestamp();
         debugPrintln("WiFi: Module not found!");
-        return false;
+        return;
     }
 
     // Start connection
     WiFi.begin(config.wifiSsid, config.wifiPassword);
 #else
-    // ESP32 - disconnect and reset WiFi first
-    WiFi.disconnect(true);
-    delay(500);
+    // ESP32 - drop any previous association; the driver associates in the background
     WiFi.mode(WIFI_STA);
-    delay(2000);
+    WiFi.disconnect();
     WiFi.begin(config.wifiSsid, config.wifiPassword);
 #endif
+}
 
+bool WiFiManager::waitForSTA(int maxAttempts, int delayMs)
+{
+    char msg[96];
     int attempts = 0;
     while (WiFi.status() != WL_CONNECTED && attempts < maxAttempts)
     {
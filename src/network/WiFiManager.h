@@ -32,6 +32,21 @@ public:
      */
     bool connectSTA(const Config& config, int maxAttempts = 20, int delayMs = 500);
 
+    /**
+     * Start connecting in Station mode without waiting (ESP32 associates in
+     * the background; other boot work can run meanwhile)
+     * @param config Configuration with WiFi credentials
+     */
+    void beginSTA(const Config& config);
+
+    /**
+     * Wait for a connection started by beginSTA()
+     * @param maxAttempts Maximum status checks
+     * @param delayMs Delay between checks in milliseconds
+     * @return true if connected
+     */
+    bool waitForSTA(int maxAttempts = 20, int delayMs = 500);
+
     /**
      * Start Access Point mode with auto-generated credentials
      * @return true if AP mode started successfully
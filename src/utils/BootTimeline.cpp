@@ -0,0 +1,98 @@
+#include "BootTimeline.h"
+#include "Logger.h"
+#include "../hal/Clock.h"
+
+BootTimeline& BootTimeline::getInstance()
+{
+    static BootTimeline instance;
+    return instance;
+}
+
+BootTimeline::BootTimeline() : count(0)
+{
+}
+
+int BootTimeline::begin(const char* name)
+{
+    if (count >= MAX_PHASES)
+    {
+        return -1;
+    }
+
+    Phase& phase = phases[count];
+    phase.name = name;
+    phase.startMs = clockMillis();
+    phase.endMs = phase.startMs;
+    phase.running = true;
+    return count++;
+}
+
+void BootTimeline::end(int id)
+{
+    if (id < 0 || id >= count || !phases[id].running)
+    {
+        return;
+    }
+
+    phases[id].endMs = clockMillis();
+    phases[id].running = false;
+}
+
+void BootTimeline::mark(const char* name)
+{
+    end(begin(name));
+}
+
+static int formatPhase(char* buffer, size_t size, const BootTimeline::Phase& phase)
+{
+    if (phase.running)
+    {
+        return snprintf(buffer, size, "%-14s %6lu ms (running)", phase.name, phase.startMs);
+    }
+    if (phase.endMs == phase.startMs)
+    {
+        return snprintf(buffer, size, "%-14s %6lu ms", phase.name, phase.startMs);
+    }
+    return snprintf(buffer, size, "%-14s %6lu-%lu ms (%lu ms)", phase.name, phase.startMs, phase.endMs,
+                    phase.endMs - phase.startMs);
+}
+
+size_t BootTimeline::format(char* buffer, size_t size) const
+{
+    size_t used = 0;
+    if (size > 0)
+    {
+        buffer[0] = '\0';
+    }
+
+    for (int i = 0; i < count && used + 1 < size; i++)
+    {
+        int written = formatPhase(buffer + used, size - used, phases[i]);
+        if (written < 0)
+        {
+            break;
+        }
+        used += (size_t)written;
+        if (used + 1 >= size)
+        {
+            return size - 1; // Truncated
+        }
+        buffer[used++] = '\n';
+        buffer[used] = '\0';
+    }
+    return used;
+}
+
+void BootTimeline::log() const
+{
+    logTimestamp();
+    debugPrintln("BOOT: Timeline");
+    for (int i = 0; i < count; i++)
+    {
+        char line[64];
+        formatPhase(line, sizeof(line), phases[i]);
+        logTimestamp();
+        debugPrint("  ");
+        debugPrintln(line);
+    }
+}
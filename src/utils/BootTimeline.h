@@ -0,0 +1,73 @@
+#ifndef BOOTTIMELINE_H
+#define BOOTTIMELINE_H
+
+#include <stddef.h>
+
+// ============================================================================
+// Boot Timeline - Start/end of each startup phase
+// ============================================================================
+
+/**
+ * Records when each boot phase started and ended (millis()), so a slow
+ * startup can be read off the status page or a telnet session instead of
+ * a serial capture. Phases may overlap (WiFi association runs while the
+ * display starts up). Used from the main task only.
+ */
+class BootTimeline
+{
+public:
+    static constexpr int MAX_PHASES = 16;
+
+    struct Phase
+    {
+        const char* name;      // String literal
+        unsigned long startMs;
+        unsigned long endMs;   // Equal to startMs for a mark
+        bool running;
+    };
+
+    static BootTimeline& getInstance();
+
+    /**
+     * Start a phase
+     * @param name Phase name (string literal, kept by pointer)
+     * @return Phase ID for end(), -1 if the timeline is full
+     */
+    int begin(const char* name);
+
+    /**
+     * End a phase (ignored if already ended or id is -1)
+     * @param id Phase ID from begin()
+     */
+    void end(int id);
+
+    /**
+     * Record a point in time (e.g. the first departure frame)
+     * @param name Mark name (string literal)
+     */
+    void mark(const char* name);
+
+    int getCount() const { return count; }
+    const Phase& getPhase(int id) const { return phases[id]; }
+
+    /**
+     * Format the timeline, one phase per line: "name start-end ms (duration ms)"
+     * @param buffer Output buffer
+     * @param size Size of buffer
+     * @return Length written (truncated to fit)
+     */
+    size_t format(char* buffer, size_t size) const;
+
+    /**
+     * Log every phase via debugPrintln()
+     */
+    void log() const;
+
+private:
+    BootTimeline();
+
+    Phase phases[MAX_PHASES];
+    int count;
+};
+
+#endif // BOOTTIMELINE_H
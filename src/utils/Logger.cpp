@@ -1,10 +1,14 @@
 #include "Logger.h"
 #include "TelnetLogger.h"
 #include "../config/AppConfig.h"
+#include "../hal/Clock.h"
+#include "../hal/LogSink.h"
 
 // Platform-specific includes for network diagnostics
 #if defined(MATRIX_PORTAL_M4)
     #include <WiFiNINA.h>
+#elif defined(NATIVE_HOST)
+    #include "../hal/HttpFetch.h"
 #else
     #include <WiFi.h>
     #include <HTTPClient.h>
@@ -21,8 +25,8 @@ void initLogger(const Config* cfg)
 void logTimestamp()
 {
     char timestamp[24];
-    sprintf(timestamp, "[%010lu] ", millis());
-    Serial.print(timestamp);
+    sprintf(timestamp, "[%010lu] ", clockMillis());
+    logSinkWrite(timestamp);
 
     // Mirror to telnet if debug enabled AND telnet is active
     if (g_config && g_config->debugMode && TelnetLogger::getInstance().isActive())
@@ -34,21 +38,21 @@ void logTimestamp()
 void logMemory(const char *location)
 {
     logTimestamp();
-    Serial.print("MEM@");
-    Serial.print(location);
+    logSinkWrite("MEM@");
+    logSinkWrite(location);
 #if defined(MATRIX_PORTAL_M4)
     // M4 doesn't have heap monitoring
-    Serial.println(": (not available on M4)");
+    logSinkWriteLine(": (not available on M4)");
+#elif defined(NATIVE_HOST)
+    logSinkWriteLine(": (not available on host)");
 #else
-    Serial.print(": Free=");
-    Serial.print(ESP.getFreeHeap());
-    Serial.print(" Min=");
-    Serial.println(ESP.getMinFreeHeap());
+    char buf[128];
+    snprintf(buf, sizeof(buf), ": Free=%u Min=%u", ESP.getFreeHeap(), ESP.getMinFreeHeap());
+    logSinkWriteLine(buf);
 
     // Mirror to telnet if debug enabled AND telnet is active
     if (g_config && g_config->debugMode && TelnetLogger::getInstance().isActive())
     {
-        char buf[128];
         snprintf(buf, sizeof(buf), "MEM@%s: Free=%u Min=%u\n",
                  location, ESP.getFreeHeap(), ESP.getMinFreeHeap());
         TelnetLogger::getInstance().print(buf);
@@ -59,7 +63,7 @@ void logMemory(const char *location)
 void debugPrint(const char* message)
 {
     // Always print to Serial
-    Serial.print(message);
+    logSinkWrite(message);
 
     // Mirror to telnet ONLY if debug mode enabled AND telnet is active
     if (g_config && g_config->debugMode && TelnetLogger::getInstance().isActive())
@@ -71,7 +75,7 @@ void debugPrint(const char* message)
 void debugPrintln(const char* message)
 {
     // Always print to Serial
-    Serial.println(message);
+    logSinkWriteLine(message);
 
     // Mirror to telnet ONLY if debug mode enabled AND telnet is active
     if (g_config && g_config->debugMode && TelnetLogger::getInstance().isActive())
@@ -154,6 +158,8 @@ void logNetworkDiagnostics()
 
     snprintf(buf, sizeof(buf), "NET: WiFi=%s RSSI=%lddBm(%s)",
              statusStr, rssi, rssiQuality);
+#elif defined(NATIVE_HOST)
+    snprintf(buf, sizeof(buf), "NET: Host network");
 #else
     // ESP32
     int status = WiFi.status();
@@ -0,0 +1,135 @@
+#include "Metrics.h"
+#include "Logger.h"
+#include <stdio.h>
+
+// Bucket upper bounds
+static const uint32_t FETCH_BOUNDS_MS[] = {100, 250, 500, 1000, 2500, 5000, 10000, 30000};
+static const uint32_t PARSE_BOUNDS_MS[] = {10, 25, 50, 100, 250, 500, 1000, 5000};
+static const uint32_t RENDER_BOUNDS_US[] = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+static const uint32_t LOOP_BOUNDS_US[] = {1000, 5000, 10000, 25000, 50000, 100000, 250000, 1000000};
+static const uint32_t FRAME_BOUNDS_PIXELS[] = {0, 100, 250, 500, 1000, 2000, 4096};  // 4096: whole 128x32 panel
+
+template <typename T, int N>
+static constexpr int countOf(const T (&)[N]) { return N; }
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+LatencyHistogram::LatencyHistogram() : bounds(nullptr), boundCount(0), count(0), sum(0)
+{
+    for (int i = 0; i <= MAX_BOUNDS; i++)
+    {
+        buckets[i] = 0;
+    }
+}
+
+void LatencyHistogram::setBounds(const uint32_t* upperBounds, int size)
+{
+    bounds = upperBounds;
+    boundCount = (size > MAX_BOUNDS) ? MAX_BOUNDS : size;
+}
+
+void LatencyHistogram::record(uint32_t value)
+{
+    // Linear scan: at most 8 compares, bounds are ascending
+    int bucket = 0;
+    while (bucket < boundCount && value > bounds[bucket])
+    {
+        bucket++;
+    }
+
+    buckets[bucket] = buckets[bucket] + 1;
+    sum = sum + value;
+    count = count + 1;
+}
+
+// ============================================================================
+// Metrics
+// ============================================================================
+
+Metrics& Metrics::getInstance()
+{
+    static Metrics instance;
+    return instance;
+}
+
+Metrics::Metrics()
+{
+    for (int i = 0; i < FETCH_SERIES; i++)
+    {
+        fetchLatency[i].setBounds(FETCH_BOUNDS_MS, countOf(FETCH_BOUNDS_MS));
+    }
+    parseLatency.setBounds(PARSE_BOUNDS_MS, countOf(PARSE_BOUNDS_MS));
+    renderLatency.setBounds(RENDER_BOUNDS_US, countOf(RENDER_BOUNDS_US));
+    loopLatency.setBounds(LOOP_BOUNDS_US, countOf(LOOP_BOUNDS_US));
+    framePixels.setBounds(FRAME_BOUNDS_PIXELS, countOf(FRAME_BOUNDS_PIXELS));
+    fullRedraws = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        refreshes[i][0] = 0;
+        refreshes[i][1] = 0;
+    }
+
+    for (int i = 0; i < JSON_DOC_COUNT; i++)
+    {
+        jsonDocs[i] = {0, 0, 0, 0};
+    }
+}
+
+const char* Metrics::getJsonDocName(JsonDoc doc)
+{
+    switch (doc)
+    {
+        case JSON_DOC_GOLEMIO: return "golemio";
+        case JSON_DOC_BVG: return "bvg";
+        case JSON_DOC_WEATHER: return "weather";
+        case JSON_DOC_GITHUB: return "github";
+        default: return "unknown";
+    }
+}
+
+void Metrics::recordFetch(int stopIndex, uint32_t ms)
+{
+    int series = (stopIndex < 0) ? SERIES_ALL : (stopIndex < STOP_SERIES) ? stopIndex : SERIES_OTHER;
+    fetchLatency[series].record(ms);
+}
+
+void Metrics::recordFrame(uint32_t pixels, bool fullRedraw)
+{
+    framePixels.record(pixels);
+    if (fullRedraw)
+    {
+        fullRedraws = fullRedraws + 1;
+    }
+}
+
+void Metrics::recordRefresh(bool allStops, bool ok)
+{
+    volatile uint32_t& counter = refreshes[allStops ? 1 : 0][ok ? 1 : 0];
+    counter = counter + 1;
+}
+
+bool Metrics::recordJsonDocument(JsonDoc doc, uint32_t usedBytes, uint32_t capacity, bool overflowed)
+{
+    JsonDocumentStats& stats = jsonDocs[doc];
+    stats.documents = stats.documents + 1;
+    stats.capacity = capacity;
+    if (usedBytes > stats.peakBytes)
+    {
+        stats.peakBytes = usedBytes;
+    }
+
+    if (overflowed)
+    {
+        stats.overflows = stats.overflows + 1;
+
+        char msg[112];
+        snprintf(msg, sizeof(msg), "JSON: ERROR %s document overflowed (%lu/%lu bytes) - raise JSON_BUFFER_SIZE",
+                 getJsonDocName(doc), (unsigned long)usedBytes, (unsigned long)capacity);
+        logTimestamp();
+        debugPrintln(msg);
+    }
+    return overflowed;
+}
@@ -0,0 +1,170 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// Runtime Metrics - Counters and histograms for the /metrics endpoint
+// ============================================================================
+
+/**
+ * Fixed-bucket histogram (Prometheus style) of a latency in any unit.
+ *
+ * Lock-free by construction: every histogram has a single writer (the fetch
+ * task or the main loop) and all fields are aligned 32-bit words, so a
+ * reader never sees a torn value - at worst a sample that has reached the
+ * bucket but not yet the count. The sum wraps after 2^32 units, which
+ * Prometheus' rate() treats as a counter reset.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int MAX_BOUNDS = 8;
+
+    LatencyHistogram();
+
+    /**
+     * Set the bucket upper bounds (call once, before recording)
+     * @param upperBounds Ascending upper bounds, kept by pointer
+     * @param size Number of bounds (at most MAX_BOUNDS; +Inf is implicit)
+     */
+    void setBounds(const uint32_t* upperBounds, int size);
+
+    /**
+     * Count one sample
+     * @param value Sample in the histogram's unit
+     */
+    void record(uint32_t value);
+
+    int getBoundCount() const { return boundCount; }
+    uint32_t getBound(int i) const { return bounds[i]; }
+    uint32_t getBucket(int i) const { return buckets[i]; }  // Not cumulative; i == getBoundCount() is +Inf
+    uint32_t getCount() const { return count; }
+    uint32_t getSum() const { return sum; }
+
+private:
+    const uint32_t* bounds;
+    int boundCount;
+    volatile uint32_t buckets[MAX_BOUNDS + 1];
+    volatile uint32_t count;
+    volatile uint32_t sum;
+};
+
+/**
+ * Use of one provider's JsonDocument against its fixed capacity. Same
+ * single-writer rules as LatencyHistogram.
+ */
+struct JsonDocumentStats
+{
+    volatile uint32_t documents;   // Documents parsed (one heap allocation each)
+    volatile uint32_t peakBytes;   // Highest memoryUsage() seen
+    volatile uint32_t capacity;    // JSON_BUFFER_SIZE of the last document
+    volatile uint32_t overflows;   // Documents that ran out of capacity
+};
+
+/**
+ * Process-wide telemetry, cheap enough to stay on permanently (a few word
+ * increments per event, no locks, no allocation). Exposed as Prometheus
+ * text by ConfigWebServer on /metrics; HTTP status counters live with the
+ * per-host stats in HttpConnectionManager.
+ */
+class Metrics
+{
+public:
+    static constexpr int STOP_SERIES = 8;      // Stops 0-7 get their own fetch latency series
+    static constexpr int SERIES_OTHER = STOP_SERIES;      // Single-stop queries of stops 8+
+    static constexpr int SERIES_ALL = STOP_SERIES + 1;    // Queries covering several stops (batch, feed)
+    static constexpr int FETCH_SERIES = STOP_SERIES + 2;
+
+    // Providers with a fixed-capacity JsonDocument
+    enum JsonDoc
+    {
+        JSON_DOC_GOLEMIO,
+        JSON_DOC_BVG,
+        JSON_DOC_WEATHER,
+        JSON_DOC_GITHUB,
+        JSON_DOC_COUNT
+    };
+
+    static Metrics& getInstance();
+
+    /**
+     * Get the label of a JsonDocument series ("golemio", "bvg", ...)
+     */
+    static const char* getJsonDocName(JsonDoc doc);
+
+    /**
+     * Count a finished stop query (request, retries and parse)
+     * @param stopIndex Index of the queried stop, or -1 for a multi-stop query
+     * @param ms Duration in milliseconds
+     */
+    void recordFetch(int stopIndex, uint32_t ms);
+
+    /**
+     * Count the parse of one response body (streamed, so it includes receive time)
+     * @param ms Duration in milliseconds
+     */
+    void recordParse(uint32_t ms) { parseLatency.record(ms); }
+
+    /**
+     * Count one parsed JsonDocument. An overflow is logged as an error: the
+     * parse dropped data, so the provider's JSON_BUFFER_SIZE is too small.
+     * @param doc Provider the document belongs to
+     * @param usedBytes memoryUsage() after the parse
+     * @param capacity Capacity the document was created with
+     * @param overflowed overflowed() or a NoMemory parse error
+     * @return overflowed, for chaining into the caller's error handling
+     */
+    bool recordJsonDocument(JsonDoc doc, uint32_t usedBytes, uint32_t capacity, bool overflowed);
+
+    /**
+     * Count one updateDisplay() call
+     * @param us Duration in microseconds
+     */
+    void recordRender(uint32_t us) { renderLatency.record(us); }
+
+    /**
+     * Count one frame painted by DisplayManager
+     * @param pixels Area cleared and redrawn (0 if nothing changed, 4096 for a full redraw)
+     * @param fullRedraw The whole panel was cleared and redrawn
+     */
+    void recordFrame(uint32_t pixels, bool fullRedraw);
+
+    /**
+     * Count the time between two loop() entries
+     * @param us Duration in microseconds
+     */
+    void recordLoopLatency(uint32_t us) { loopLatency.record(us); }
+
+    /**
+     * Count an applied departure refresh
+     * @param allStops Full refresh (false: single stop)
+     * @param ok Fetch completed without error
+     */
+    void recordRefresh(bool allStops, bool ok);
+
+    const LatencyHistogram& getFetchLatency(int series) const { return fetchLatency[series]; }
+    const LatencyHistogram& getParseLatency() const { return parseLatency; }
+    const LatencyHistogram& getRenderLatency() const { return renderLatency; }
+    const LatencyHistogram& getLoopLatency() const { return loopLatency; }
+    const LatencyHistogram& getFramePixels() const { return framePixels; }
+    uint32_t getFullRedrawCount() const { return fullRedraws; }
+    uint32_t getRefreshCount(bool allStops, bool ok) const { return refreshes[allStops ? 1 : 0][ok ? 1 : 0]; }
+    const JsonDocumentStats& getJsonDocStats(JsonDoc doc) const { return jsonDocs[doc]; }
+
+private:
+    Metrics();
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    LatencyHistogram fetchLatency[FETCH_SERIES];  // Written by the fetch task
+    LatencyHistogram parseLatency;                // Written by the fetch task
+    LatencyHistogram renderLatency;               // Written by loop()
+    LatencyHistogram loopLatency;                 // Written by loop()
+    LatencyHistogram framePixels;                 // Written by loop() (pixels, not time)
+    volatile uint32_t fullRedraws;                // Written by loop()
+    volatile uint32_t refreshes[2][2];            // [allStops][ok], written by loop()
+    JsonDocumentStats jsonDocs[JSON_DOC_COUNT];   // Written by the fetch task (GitHub: web server)
+};
+
+#endif // METRICS_H
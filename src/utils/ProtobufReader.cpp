@@ -0,0 +1,222 @@
+#include "ProtobufReader.h"
+#include <string.h>
+
+ProtobufReader::ProtobufReader(Stream& source, long length)
+    : source(source), remaining(length), bufferLength(0), bufferPos(0), position(0), error(false)
+{
+}
+
+bool ProtobufReader::fill()
+{
+    if (remaining == 0)
+    {
+        return false;
+    }
+
+    int want = BUFFER_SIZE;
+    if (remaining > 0 && remaining < want)
+    {
+        want = (int)remaining;
+    }
+
+    int got = source.readBytes(buffer, want);
+    if (got <= 0)
+    {
+        return false;
+    }
+
+    if (remaining > 0)
+    {
+        remaining -= got;
+    }
+    bufferLength = got;
+    bufferPos = 0;
+    return true;
+}
+
+bool ProtobufReader::readByte(uint8_t& value)
+{
+    if (bufferPos >= bufferLength && !fill())
+    {
+        return false;
+    }
+    value = buffer[bufferPos++];
+    position++;
+    return true;
+}
+
+bool ProtobufReader::skipBytes(uint32_t count)
+{
+    while (count > 0)
+    {
+        if (bufferPos >= bufferLength && !fill())
+        {
+            error = true;
+            return false;
+        }
+        uint32_t chunk = bufferLength - bufferPos;
+        if (chunk > count)
+        {
+            chunk = count;
+        }
+        bufferPos += chunk;
+        position += chunk;
+        count -= chunk;
+    }
+    return true;
+}
+
+bool ProtobufReader::nextField(uint32_t end, uint32_t& field, uint8_t& wireType)
+{
+    if (error)
+    {
+        return false;
+    }
+
+    if (end != UNBOUNDED && position >= end)
+    {
+        if (position > end)
+        {
+            error = true; // Nested value overran its parent
+        }
+        return false;
+    }
+
+    // The top-level message simply ends with the stream
+    if (end == UNBOUNDED && bufferPos >= bufferLength && !fill())
+    {
+        return false;
+    }
+
+    uint64_t tag;
+    if (!readVarint(tag))
+    {
+        return false;
+    }
+
+    field = (uint32_t)(tag >> 3);
+    wireType = (uint8_t)(tag & 0x07);
+    if (field == 0)
+    {
+        error = true;
+        return false;
+    }
+    return true;
+}
+
+bool ProtobufReader::readVarint(uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t b;
+        if (!readByte(b))
+        {
+            error = true;
+            return false;
+        }
+        value |= (uint64_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    error = true; // More than 10 bytes
+    return false;
+}
+
+bool ProtobufReader::enterMessage(uint32_t& end)
+{
+    uint64_t length;
+    if (!readVarint(length))
+    {
+        return false;
+    }
+
+    if (length > UNBOUNDED - 1 - position)
+    {
+        error = true;
+        return false;
+    }
+    end = position + (uint32_t)length;
+    return true;
+}
+
+bool ProtobufReader::readString(char* out, size_t outSize)
+{
+    uint64_t length;
+    if (!readVarint(length))
+    {
+        return false;
+    }
+
+    if (length > UNBOUNDED - 1 - position)
+    {
+        error = true;
+        return false;
+    }
+
+    size_t keep = (outSize > 0) ? outSize - 1 : 0;
+    if (keep > length)
+    {
+        keep = (size_t)length;
+    }
+
+    size_t copied = 0;
+    while (copied < keep)
+    {
+        if (bufferPos >= bufferLength && !fill())
+        {
+            error = true;
+            if (outSize > 0)
+            {
+                out[copied] = '\0';
+            }
+            return false;
+        }
+        size_t chunk = bufferLength - bufferPos;
+        if (chunk > keep - copied)
+        {
+            chunk = keep - copied;
+        }
+        memcpy(out + copied, buffer + bufferPos, chunk);
+        bufferPos += chunk;
+        position += chunk;
+        copied += chunk;
+    }
+
+    if (outSize > 0)
+    {
+        out[copied] = '\0';
+    }
+    return skipBytes((uint32_t)(length - keep));
+}
+
+bool ProtobufReader::skipField(uint8_t wireType)
+{
+    uint64_t value;
+    switch (wireType)
+    {
+        case WIRE_VARINT:
+            return readVarint(value);
+        case WIRE_FIXED64:
+            return skipBytes(8);
+        case WIRE_LENGTH:
+            if (!readVarint(value))
+            {
+                return false;
+            }
+            if (value > UNBOUNDED - 1 - position)
+            {
+                error = true;
+                return false;
+            }
+            return skipBytes((uint32_t)value);
+        case WIRE_FIXED32:
+            return skipBytes(4);
+        default:
+            error = true; // Groups (deprecated) and invalid types
+            return false;
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef PROTOBUFREADER_H
+#define PROTOBUFREADER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// ============================================================================
+// Streaming Protobuf Decoder
+// ============================================================================
+
+/**
+ * Pull decoder for the protobuf wire format, reading straight from a Stream.
+ *
+ * Nothing is allocated and no schema is needed: the caller walks a message
+ * with nextField() and reads or skips each value. Nested messages are
+ * entered with enterMessage(), which returns the position where the nested
+ * message ends; passing that to nextField() bounds the inner loop:
+ *
+ *   uint32_t end;
+ *   if (reader.enterMessage(end))
+ *       while (reader.nextField(end, field, wireType)) { ... }
+ *
+ * Input is read in BUFFER_SIZE blocks. Any malformed input (truncated
+ * varint, nested length past its parent, stream timeout) sets the error
+ * flag and ends every loop.
+ */
+class ProtobufReader
+{
+public:
+    enum WireType
+    {
+        WIRE_VARINT = 0,
+        WIRE_FIXED64 = 1,
+        WIRE_LENGTH = 2,  // Strings, bytes and nested messages
+        WIRE_FIXED32 = 5
+    };
+
+    static constexpr uint32_t UNBOUNDED = 0xFFFFFFFF;  // nextField() end for the top-level message
+
+    /**
+     * @param source Stream positioned at the start of the encoded message
+     * @param length Encoded size if known (e.g. Content-Length), or -1 to read until the stream ends
+     */
+    ProtobufReader(Stream& source, long length);
+
+    /**
+     * Read the next field header of a message
+     * @param end End position of the message (from enterMessage(), or UNBOUNDED)
+     * @param field Receives the field number
+     * @param wireType Receives the wire type
+     * @return false at the end of the message or on error
+     */
+    bool nextField(uint32_t end, uint32_t& field, uint8_t& wireType);
+
+    /**
+     * Read a varint value (int32/int64/uint32/uint64/bool/enum)
+     * Negative int32/int64 values come back as their two's complement
+     */
+    bool readVarint(uint64_t& value);
+
+    /**
+     * Read the length of a nested message
+     * @param end Receives the position where the nested message ends
+     */
+    bool enterMessage(uint32_t& end);
+
+    /**
+     * Read a string or bytes field
+     * Characters that do not fit are skipped; out is always terminated
+     * @param out Output buffer
+     * @param outSize Size of out
+     */
+    bool readString(char* out, size_t outSize);
+
+    /**
+     * Skip the value of the current field
+     * @param wireType Wire type from nextField()
+     */
+    bool skipField(uint8_t wireType);
+
+    /**
+     * Bytes consumed so far
+     */
+    uint32_t getPosition() const { return position; }
+
+    bool hasError() const { return error; }
+
+private:
+    static constexpr int BUFFER_SIZE = 256;
+
+    Stream& source;
+    long remaining;         // Bytes left in the stream, -1 if unknown
+    uint8_t buffer[BUFFER_SIZE];
+    int bufferLength;
+    int bufferPos;
+    uint32_t position;
+    bool error;
+
+    bool fill();
+    bool readByte(uint8_t& value);
+    bool skipBytes(uint32_t count);
+};
+
+#endif // PROTOBUFREADER_H
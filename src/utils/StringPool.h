@@ -0,0 +1,103 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// Interned String Table
+// ============================================================================
+
+/**
+ * Fixed-capacity table of interned strings.
+ *
+ * Each distinct string is stored once in a flat character pool and referred
+ * to by a one-byte index, so records repeating the same line or headsign
+ * only carry that index. Strings are never removed individually - the whole
+ * table is reset (or rebuilt) at once.
+ *
+ * @tparam MaxStrings Maximum number of distinct strings (< 255)
+ * @tparam PoolBytes Character pool size, including terminators
+ */
+template <int MaxStrings, int PoolBytes>
+class StringPool
+{
+    static_assert(MaxStrings > 0 && MaxStrings < 255, "indices are one byte, 0xFF is reserved");
+    static_assert(PoolBytes > 0 && PoolBytes <= 65535, "offsets are 16-bit");
+
+public:
+    static constexpr uint8_t NONE = 0xFF;  // intern() result when the table is full
+
+    StringPool() : count(0), used(0) {}
+
+    /**
+     * Drop all strings (indices handed out so far become invalid)
+     */
+    void reset()
+    {
+        count = 0;
+        used = 0;
+    }
+
+    /**
+     * Look up or add a string
+     * @param str String to intern (nullptr is treated as "")
+     * @param maxSize Field size: at most maxSize - 1 characters are kept, like strlcpy()
+     * @return Index of the string, or NONE if the table is full
+     */
+    uint8_t intern(const char* str, int maxSize)
+    {
+        if (str == nullptr)
+        {
+            str = "";
+        }
+
+        int len = 0;
+        while (len < maxSize - 1 && str[len] != '\0')
+        {
+            len++;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            if (lengths[i] == len && memcmp(pool + offsets[i], str, len) == 0)
+            {
+                return (uint8_t)i;
+            }
+        }
+
+        if (count >= MaxStrings || used + len + 1 > PoolBytes)
+        {
+            return NONE;
+        }
+
+        memcpy(pool + used, str, len);
+        pool[used + len] = '\0';
+        offsets[count] = (uint16_t)used;
+        lengths[count] = (uint8_t)len;
+        used += len + 1;
+        return (uint8_t)count++;
+    }
+
+    /**
+     * Get an interned string
+     * @param index Index returned by intern()
+     * @return The string, or "" for an invalid index
+     */
+    const char* get(uint8_t index) const
+    {
+        return (index < count) ? pool + offsets[index] : "";
+    }
+
+    int size() const { return count; }
+    int bytesUsed() const { return used; }
+
+private:
+    char pool[PoolBytes];
+    uint16_t offsets[MaxStrings];
+    uint8_t lengths[MaxStrings];
+    int count;
+    int used;
+};
+
+#endif // STRINGPOOL_H
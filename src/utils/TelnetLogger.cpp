@@ -1,13 +1,15 @@
 #include "TelnetLogger.h"
 
-// TelnetLogger is stubbed in header for M4, only compile implementation for ESP32
-#if !defined(MATRIX_PORTAL_M4)
+// TelnetLogger is stubbed in header for M4 and the host, only compile implementation for ESP32
+#if !defined(MATRIX_PORTAL_M4) && !defined(NATIVE_HOST)
 
 #include "Logger.h"
+#include "BootTimeline.h"
 #include <Arduino.h>
 
 TelnetLogger::TelnetLogger() : active(false)
 {
+    lock = xSemaphoreCreateRecursiveMutex();
 }
 
 TelnetLogger& TelnetLogger::getInstance()
@@ -27,6 +29,13 @@ bool TelnetLogger::begin(uint16_t port)
     telnet.onConnect([](String ip) {
         Serial.print("Telnet: Client connected from ");
         Serial.println(ip);
+
+        // Boot happened before anyone could connect - replay its timeline
+        static char timeline[BootTimeline::MAX_PHASES * 48];
+        BootTimeline::getInstance().format(timeline, sizeof(timeline));
+        TelnetLogger& logger = TelnetLogger::getInstance();
+        logger.telnet.println("Boot timeline:");
+        logger.telnet.print(timeline);
     });
 
     telnet.onDisconnect([](String ip) {
@@ -55,23 +64,35 @@ void TelnetLogger::loop()
 {
     if (active)
     {
+        xSemaphoreTakeRecursive(lock, portMAX_DELAY);
         telnet.loop();
+        xSemaphoreGiveRecursive(lock);
     }
 }
 
 void TelnetLogger::print(const char* message)
 {
-    if (active && hasClients())
+    if (active)
     {
-        telnet.print(message);
+        xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+        if (hasClients())
+        {
+            telnet.print(message);
+        }
+        xSemaphoreGiveRecursive(lock);
     }
 }
 
 void TelnetLogger::println(const char* message)
 {
-    if (active && hasClients())
+    if (active)
     {
-        telnet.println(message);
+        xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+        if (hasClients())
+        {
+            telnet.println(message);
+        }
+        xSemaphoreGiveRecursive(lock);
     }
 }
 
@@ -96,4 +117,4 @@ void TelnetLogger::end()
     }
 }
 
-#endif // !MATRIX_PORTAL_M4
+#endif // !MATRIX_PORTAL_M4 && !NATIVE_HOST
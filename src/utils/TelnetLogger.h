@@ -7,8 +7,8 @@
 // Telnet Logger - Remote serial monitoring over WiFi
 // ============================================================================
 
-#if defined(MATRIX_PORTAL_M4)
-// Stub implementation for M4 - telnet not supported
+#if defined(MATRIX_PORTAL_M4) || defined(NATIVE_HOST)
+// Stub implementation for M4 and the host build - telnet not supported
 class TelnetLogger
 {
 public:
@@ -33,10 +33,13 @@ private:
 #else
 // Full ESP32 implementation
 #include <ESPTelnet.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 /**
  * Singleton telnet logger for remote debugging
  * Mirrors Serial output to telnet clients when debug mode is enabled
+ * Thread-safe: the fetch task logs from the network core while loop() services clients
  */
 class TelnetLogger
 {
@@ -92,8 +95,9 @@ private:
 
     ESPTelnet telnet;
     bool active;
+    SemaphoreHandle_t lock;  // Recursive mutex guarding telnet I/O
 };
 
-#endif // MATRIX_PORTAL_M4
+#endif // MATRIX_PORTAL_M4 || NATIVE_HOST
 
 #endif // TELNETLOGGER_H
@@ -1,6 +1,7 @@
 #include "TimeUtils.h"
 #include "Logger.h"
-#include <Arduino.h>
+#include "../hal/Clock.h"
+#include "../hal/LogSink.h"
 
 #if defined(MATRIX_PORTAL_M4)
 // M4 uses NTPClient library with WiFiNINA
@@ -9,131 +10,195 @@
 #include <NTPClient.h>
 
 static WiFiUDP ntpUDP;
-// Use only CET offset (3600) - no DST in winter. TODO: proper DST handling
-static NTPClient timeClient(ntpUDP, NTP_SERVER, GMT_OFFSET_SEC);
+// Kept in UTC; local time comes from the DST table below
+static NTPClient timeClient(ntpUDP, NTP_SERVER, 0);
 static bool timeInitialized = false;
 #endif
 
+// ============================================================================
+// Calendar Arithmetic
+// ============================================================================
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's days_from_civil).
+// Written as single-expression constexpr functions so the DST table is built by the compiler.
+static constexpr long floorEra(long shiftedYear)
+{
+    return (shiftedYear >= 0 ? shiftedYear : shiftedYear - 399) / 400;
+}
+
+static constexpr long daysFromEra(long era, long yearOfEra, long dayOfYear)
+{
+    return era * 146097 + yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear - 719468;
+}
+
+static constexpr long daysFromShiftedYear(long shiftedYear, long dayOfYear)
+{
+    return daysFromEra(floorEra(shiftedYear), shiftedYear - floorEra(shiftedYear) * 400, dayOfYear);
+}
+
+static constexpr long daysFromCivil(int year, int month, int day)
+{
+    // Years start in March, so the leap day is the last day of the (shifted) year
+    return daysFromShiftedYear(year - (month <= 2), (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1);
+}
+
+// ============================================================================
+// Local Time (CET/CEST)
+// ============================================================================
+
+// EU rule: summer time from 01:00 UTC on the last Sunday of March until
+// 01:00 UTC on the last Sunday of October.
+static constexpr uint32_t DST_SWITCH_UTC_SEC = 3600;
+
+static constexpr uint32_t lastSundaySwitch(int year, int month)
+{
+    // March and October both have 31 days; 1970-01-01 was a Thursday
+    return (uint32_t)(daysFromCivil(year, month, 31) - (daysFromCivil(year, month, 31) + 4) % 7) * 86400u +
+           DST_SWITCH_UTC_SEC;
+}
+
+struct DstPeriod
+{
+    uint32_t start; // UTC instant summer time begins
+    uint32_t end;   // UTC instant it ends
+};
+
+#define DST_YEAR(y) {lastSundaySwitch((y), 3), lastSundaySwitch((y), 10)}
+#define DST_DECADE(d) DST_YEAR(d), DST_YEAR(d + 1), DST_YEAR(d + 2), DST_YEAR(d + 3), DST_YEAR(d + 4), \
+                      DST_YEAR(d + 5), DST_YEAR(d + 6), DST_YEAR(d + 7), DST_YEAR(d + 8), DST_YEAR(d + 9)
+
+static constexpr int DST_FIRST_YEAR = 2020;
+static constexpr int DST_YEARS = 40;
+static constexpr DstPeriod DST_TABLE[DST_YEARS] = {
+    DST_DECADE(2020), DST_DECADE(2030), DST_DECADE(2040), DST_DECADE(2050)};
+
+#undef DST_DECADE
+#undef DST_YEAR
+
+static constexpr uint32_t DST_TABLE_START = (uint32_t)daysFromCivil(DST_FIRST_YEAR, 1, 1) * 86400u;
+static constexpr uint32_t DST_TABLE_END = (uint32_t)daysFromCivil(DST_FIRST_YEAR + DST_YEARS, 1, 1) * 86400u;
+static constexpr uint32_t SECONDS_PER_AVERAGE_YEAR = 31556952; // 365.2425 days
+
+static_assert(DST_TABLE[6].start == 1774746000 && DST_TABLE[6].end == 1792890000,
+              "2026: 29 March 01:00 UTC - 25 October 01:00 UTC");
+
+long getUtcOffset(time_t utc)
+{
+    bool summer;
+    if (utc >= (time_t)DST_TABLE_START && utc < (time_t)DST_TABLE_END)
+    {
+        // Dividing by the average year length can land on the neighbouring year
+        // only within a day of New Year, where neither year's period applies anyway
+        int index = (int)((uint32_t)(utc - DST_TABLE_START) / SECONDS_PER_AVERAGE_YEAR);
+        if (index >= DST_YEARS)
+        {
+            index = DST_YEARS - 1;
+        }
+        summer = (uint32_t)utc >= DST_TABLE[index].start && (uint32_t)utc < DST_TABLE[index].end;
+    }
+    else
+    {
+        // Outside the table: apply the rule directly
+        struct tm utcTime;
+        gmtime_r(&utc, &utcTime);
+        int year = utcTime.tm_year + 1900;
+        summer = utc >= (time_t)lastSundaySwitch(year, 3) && utc < (time_t)lastSundaySwitch(year, 10);
+    }
+    return summer ? GMT_OFFSET_SEC + DAYLIGHT_OFFSET_SEC : GMT_OFFSET_SEC;
+}
+
+void utcToLocalTime(time_t utc, struct tm* timeinfo)
+{
+    long offset = getUtcOffset(utc);
+    time_t local = utc + offset;
+    gmtime_r(&local, timeinfo);
+    timeinfo->tm_isdst = (offset != GMT_OFFSET_SEC);
+}
+
+// ============================================================================
+// Time Synchronization
+// ============================================================================
+
+// Clock readings before this are unsynced (same threshold as getLocalTime())
+static constexpr time_t MIN_SYNCED_EPOCH = 1451606400; // 2016-01-01
+
 void initTimeSync()
 {
 #if defined(MATRIX_PORTAL_M4)
     timeClient.begin();
+#elif defined(NATIVE_HOST)
+    // Host clock is already set
 #else
-    configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, NTP_SERVER);
+    // System clock and TZ stay UTC; local time comes from the DST table
+    configTime(0, 0, NTP_SERVER);
 #endif
 }
 
 bool syncTime(int maxAttempts, int delayMs)
 {
     logTimestamp();
-    Serial.println("Syncing time...");
+    logSinkWriteLine("Syncing time...");
 
-#if defined(MATRIX_PORTAL_M4)
     int attempts = 0;
+#if defined(MATRIX_PORTAL_M4)
     while (!timeClient.update() && attempts < maxAttempts)
     {
-        delay(delayMs);
+        clockDelay(delayMs);
         attempts++;
     }
-
-    if (attempts >= maxAttempts)
-    {
-        logTimestamp();
-        Serial.println("Time sync failed!");
-        return false;
-    }
-
-    timeInitialized = true;
-
-    // Log the synced time
-    logTimestamp();
-    Serial.print("Time synced: ");
-    Serial.println(timeClient.getFormattedTime());
-
-    return true;
 #else
-    struct tm timeinfo;
-    int attempts = 0;
-
-    while (!getLocalTime(&timeinfo) && attempts < maxAttempts)
+    // SNTP runs in the background; just poll the clock (getLocalTime() would
+    // add its own 5 s wait to every attempt)
+    while (getCurrentEpochTime() < MIN_SYNCED_EPOCH && attempts < maxAttempts)
     {
-        delay(delayMs);
+        clockDelay(delayMs);
         attempts++;
     }
+#endif
 
     if (attempts >= maxAttempts)
     {
         logTimestamp();
-        Serial.println("Time sync failed!");
+        logSinkWriteLine("Time sync failed!");
         return false;
     }
 
+#if defined(MATRIX_PORTAL_M4)
+    timeInitialized = true;
+#endif
+
+    // Log the synced time
     char timeStr[32];
-    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    getFormattedTime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S");
     logTimestamp();
-    Serial.print("Time synced: ");
-    Serial.println(timeStr);
+    logSinkWrite("Time synced: ");
+    logSinkWriteLine(timeStr);
 
     return true;
-#endif
 }
 
 bool getFormattedTime(char* buffer, size_t size, const char* format)
 {
-#if defined(MATRIX_PORTAL_M4)
-    if (!timeInitialized)
-    {
-        return false;
-    }
-
-    // Update NTP client to get fresh time
-    timeClient.update();
-
-    // Convert epoch time to tm struct
-    time_t epochTime = timeClient.getEpochTime();
-    struct tm* timeinfo = localtime(&epochTime);
-
-    if (timeinfo == nullptr)
-    {
-        return false;
-    }
-
-    strftime(buffer, size, format, timeinfo);
-    return true;
-#else
     struct tm timeinfo;
-    if (!getLocalTime(&timeinfo))
+    if (!getCurrentTime(&timeinfo))
     {
         return false;
     }
 
     strftime(buffer, size, format, &timeinfo);
     return true;
-#endif
 }
 
 bool getCurrentTime(struct tm* timeinfo)
 {
-#if defined(MATRIX_PORTAL_M4)
-    if (!timeInitialized)
+    time_t now = getCurrentEpochTime();
+    if (now < MIN_SYNCED_EPOCH)
     {
-        return false;
-    }
-
-    timeClient.update();
-    time_t epochTime = timeClient.getEpochTime();
-    struct tm* t = localtime(&epochTime);
-
-    if (t == nullptr)
-    {
-        return false;
+        return false; // Not synced yet
     }
 
-    *timeinfo = *t;
+    utcToLocalTime(now, timeinfo);
     return true;
-#else
-    return getLocalTime(timeinfo);
-#endif
 }
 
 time_t getCurrentEpochTime()
@@ -145,9 +210,114 @@ time_t getCurrentEpochTime()
     }
     timeClient.update();
     return timeClient.getEpochTime();
+#elif defined(NATIVE_HOST)
+    return clockEpoch();
 #else
     time_t now;
     time(&now);
     return now;
 #endif
 }
+
+// ============================================================================
+// Timestamp Parsing
+// ============================================================================
+
+// Read exactly `digits` decimal digits, advancing the pointer
+static bool readDigits(const char*& p, int digits, int* value)
+{
+    int result = 0;
+    for (int i = 0; i < digits; i++)
+    {
+        if (p[i] < '0' || p[i] > '9')
+        {
+            return false;
+        }
+        result = result * 10 + (p[i] - '0');
+    }
+    p += digits;
+    *value = result;
+    return true;
+}
+
+bool parseISO8601(const char* timestamp, time_t* epoch)
+{
+    if (timestamp == nullptr || epoch == nullptr)
+    {
+        return false;
+    }
+
+    const char* p = timestamp;
+    int year, month, day, hour, minute, second;
+    if (!readDigits(p, 4, &year) || *p++ != '-' ||
+        !readDigits(p, 2, &month) || *p++ != '-' ||
+        !readDigits(p, 2, &day) || (*p != 'T' && *p != 't' && *p != ' ') ||
+        !readDigits(++p, 2, &hour) || *p++ != ':' ||
+        !readDigits(p, 2, &minute) || *p++ != ':' ||
+        !readDigits(p, 2, &second))
+    {
+        return false;
+    }
+
+    static const uint8_t DAYS_IN_MONTH[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12 || day < 1 || day > DAYS_IN_MONTH[month - 1] ||
+        hour > 23 || minute > 59 || second > 60)
+    {
+        return false;
+    }
+    bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (month == 2 && day == 29 && !leapYear)
+    {
+        return false;
+    }
+
+    // Fractional seconds are dropped
+    if (*p == '.' || *p == ',')
+    {
+        p++;
+        while (*p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+
+    long offsetSec = 0;
+    if (*p == 'Z' || *p == 'z')
+    {
+        p++;
+    }
+    else if (*p == '+' || *p == '-')
+    {
+        int sign = (*p++ == '-') ? -1 : 1;
+        int offsetHours;
+        int offsetMinutes = 0;
+        if (!readDigits(p, 2, &offsetHours))
+        {
+            return false;
+        }
+        bool hasMinutes = (*p >= '0' && *p <= '9');
+        if (*p == ':')
+        {
+            p++;
+            hasMinutes = true;
+        }
+        if (hasMinutes && !readDigits(p, 2, &offsetMinutes))
+        {
+            return false;
+        }
+        if (offsetHours > 23 || offsetMinutes > 59)
+        {
+            return false;
+        }
+        offsetSec = sign * (offsetHours * 3600L + offsetMinutes * 60L);
+    }
+
+    if (*p != '\0')
+    {
+        return false;
+    }
+
+    long days = daysFromCivil(year, month, day);
+    *epoch = (time_t)days * 86400 + hour * 3600L + minute * 60L + second - offsetSec;
+    return true;
+}
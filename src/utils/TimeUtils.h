@@ -10,7 +10,9 @@
 // NTP Server
 #define NTP_SERVER "pool.ntp.org"
 
-// Timezone: CET/CEST (Prague)
+// Timezone: CET/CEST (Prague, Berlin)
+// The clock runs in UTC; local time follows a compile-time table of EU
+// summer time transitions (see getUtcOffset())
 #define GMT_OFFSET_SEC 3600      // CET = UTC+1
 #define DAYLIGHT_OFFSET_SEC 3600 // CEST = UTC+2
 
@@ -20,7 +22,7 @@
 
 /**
  * Initialize NTP time synchronization
- * Configures NTP client with Prague timezone (CET/CEST)
+ * Configures the NTP client for UTC
  */
 void initTimeSync();
 
@@ -42,7 +44,7 @@ bool syncTime(int maxAttempts = 10, int delayMs = 500);
 bool getFormattedTime(char* buffer, size_t size, const char* format = "%Y-%m-%d %H:%M:%S");
 
 /**
- * Get current local time
+ * Get current local time (CET/CEST)
  * @param timeinfo Pointer to tm struct to fill
  * @return true if successful, false if time not set
  */
@@ -55,4 +57,41 @@ bool getCurrentTime(struct tm* timeinfo);
  */
 time_t getCurrentEpochTime();
 
+// ============================================================================
+// Local Time Conversion
+// ============================================================================
+
+/**
+ * Offset of local time from UTC at an instant
+ * O(1) lookup in a constexpr table of transitions for 2020-2059 (the rule is
+ * evaluated directly outside that range); no libc TZ parsing.
+ * @param utc Seconds since 1970-01-01 00:00 UTC
+ * @return GMT_OFFSET_SEC, plus DAYLIGHT_OFFSET_SEC during summer time
+ */
+long getUtcOffset(time_t utc);
+
+/**
+ * Convert a UTC instant to local broken-down time
+ * @param utc Seconds since 1970-01-01 00:00 UTC
+ * @param timeinfo Receives local time (tm_isdst set during summer time)
+ */
+void utcToLocalTime(time_t utc, struct tm* timeinfo);
+
+// ============================================================================
+// Timestamp Parsing
+// ============================================================================
+
+/**
+ * Parse an ISO 8601 timestamp to UTC epoch seconds
+ * Fixed format "YYYY-MM-DDTHH:MM:SS", optionally followed by fractional
+ * seconds and a zone designator ("Z", "+hh:mm", "+hhmm" or "+hh", also
+ * with '-'). A timestamp without a designator is taken as UTC.
+ * Integer arithmetic only - no sscanf(), mktime() or TZ rule lookups, so it
+ * is cheap enough for every departure in the parse loop.
+ * @param timestamp Timestamp text (e.g. "2026-01-11T14:30:00+01:00")
+ * @param epoch Receives seconds since 1970-01-01 00:00 UTC
+ * @return false if the text does not match the format or a field is out of range
+ */
+bool parseISO8601(const char* timestamp, time_t* epoch);
+
 #endif // TIMEUTILS_H
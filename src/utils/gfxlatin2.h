@@ -15,6 +15,15 @@
 #ifndef GFXLATIN2_H
 #define GFXLATIN2_H
 
+#include <stddef.h>
+
+// Convert a UTF-8 encoded string to a GFX Latin 2 encoded string.
+// Table-driven and reentrant (no shared decoder state). The output is never
+// longer than the input, so out may be the same buffer as in. Characters
+// missing from the font are dropped (or shown as 0x7F if showUnmapped is set).
+// Returns the length of the converted string, truncated to outSize - 1 bytes.
+size_t utf8ToGfxLatin2(const char* in, char* out, size_t outSize);
+
 // Convert a UTF-8 encoded String object to a GFX Latin 1 encoded String
 String utf8tocp(String s);
 
@@ -0,0 +1,52 @@
+#ifndef TEST_BENCH_H
+#define TEST_BENCH_H
+
+// ============================================================================
+// Microbenchmark Helpers (host test suites)
+// ============================================================================
+
+#include <unity.h>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+// Results are folded in here so the compiler cannot drop the timed work
+inline volatile uint32_t benchSink = 0;
+
+/**
+ * Time a piece of code and report the fastest of several rounds per call
+ * Printed as an INFO line of the running test. Timings are for comparing
+ * changes on one machine, so suites assert results, never speed.
+ * @param name Label of the measurement
+ * @param calls Calls per round
+ * @param fn Code under test, called `calls` times per round
+ * @return Nanoseconds per call of the fastest round
+ */
+template <class Fn>
+double benchRun(const char* name, long calls, Fn fn)
+{
+    static constexpr int ROUNDS = 5;
+
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < calls; i++)
+        {
+            fn();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (round == 0 || ns < best)
+        {
+            best = ns;
+        }
+    }
+
+    double perCall = best / calls;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%-40s %12.1f ns/call", name, perCall);
+    TEST_MESSAGE(msg);
+    return perCall;
+}
+
+#endif // TEST_BENCH_H
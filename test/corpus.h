@@ -0,0 +1,78 @@
+#ifndef TEST_CORPUS_H
+#define TEST_CORPUS_H
+
+// ============================================================================
+// Recorded API Responses (test/corpus/)
+// ============================================================================
+
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/**
+ * Read a file of the payload corpus
+ * `pio test` runs suites from the project directory, so the path is relative
+ * to it. A missing file fails the running test.
+ * @param name File name inside test/corpus/ (e.g. "golemio-rush.json")
+ * @return File contents
+ */
+inline std::vector<uint8_t> loadCorpus(const char* name)
+{
+    std::string path = std::string("test/corpus/") + name;
+    std::vector<uint8_t> data;
+    FILE* file = fopen(path.c_str(), "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, path.c_str());
+
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + count);
+    }
+    fclose(file);
+    return data;
+}
+
+/**
+ * When and for what the corpus was recorded (test/corpus/corpus.json, written
+ * by scripts/capture_corpus.py)
+ */
+struct CorpusInfo
+{
+    bool captured;               // false: hand-written placeholders, not live responses
+    time_t capturedAt;           // Clock for replaying the responses
+    std::string golemioQuiet;    // Stop IDs as entered in the web UI
+    std::string golemioRush;
+    std::string bvgQuiet;
+    std::string bvgRush;
+    float latitude;
+    float longitude;
+};
+
+/**
+ * Read test/corpus/corpus.json
+ * @return The recording's time and stops
+ */
+inline CorpusInfo loadCorpusInfo()
+{
+    std::vector<uint8_t> data = loadCorpus("corpus.json");
+    DynamicJsonDocument doc(1024);
+    DeserializationError error = deserializeJson(doc, (const char*)data.data(), data.size());
+    TEST_ASSERT_FALSE_MESSAGE(error, "test/corpus/corpus.json");
+
+    CorpusInfo info;
+    info.captured = strcmp(doc["source"] | "", "captured") == 0;
+    info.capturedAt = (time_t)(doc["captured"] | 0L);
+    info.golemioQuiet = doc["golemio"]["quiet"] | "";
+    info.golemioRush = doc["golemio"]["rush"] | "";
+    info.bvgQuiet = doc["bvg"]["quiet"] | "";
+    info.bvgRush = doc["bvg"]["rush"] | "";
+    info.latitude = doc["weather"]["latitude"] | 0.0f;
+    info.longitude = doc["weather"]["longitude"] | 0.0f;
+    return info;
+}
+
+#endif // TEST_CORPUS_H
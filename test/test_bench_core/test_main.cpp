@@ -0,0 +1,188 @@
+// Microbenchmarks of the per-fetch departure pipeline: collecting, merging,
+// diffing, shortening and converting one board's worth of departures
+
+#include <unity.h>
+#include "../bench.h"
+#include "../../src/api/DepartureCollector.h"
+#include "../../src/api/DepartureData.h"
+#include "../../src/api/DestinationShortener.h"
+#include "../../src/utils/TimeUtils.h"
+
+static const time_t BASE_TIME = 1790000000;
+static const int STOPS = 12;
+
+static const char* const HEADSIGNS[] = {
+    "Nádraží Hostivař", "Sídliště Čimice", "Nemocnice Motol", "Václavské náměstí", "Kobylisy",
+    "S+U Hauptbahnhof", "Alexanderplatz (Berlin)", "Hermannstraße", "Flughafen BER", "Zoologischer Garten",
+    "Ostbahnhof", "Spandau"};
+static const int HEADSIGN_COUNT = sizeof(HEADSIGNS) / sizeof(HEADSIGNS[0]);
+
+// 12 stops x 12 departures, each stop's run in time order, stops interleaved
+static Departure offers[STOPS * MAX_DEPARTURES];
+static DepartureCollector collector;
+static Departure board[MAX_DEPARTURES];
+static DepartureStrings boardStrings;
+
+void setUp(void)
+{
+    for (int stop = 0; stop < STOPS; stop++)
+    {
+        for (int i = 0; i < MAX_DEPARTURES; i++)
+        {
+            Departure& dep = offers[stop * MAX_DEPARTURES + i];
+            dep = Departure();
+            dep.departureTime = BASE_TIME + (i * 4 + stop % 4) * 60 + stop;
+            dep.eta = (int16_t)((dep.departureTime - BASE_TIME) / 60);
+            dep.stopIndex = (int8_t)stop;
+            dep.tripKey = (uint32_t)(stop * 1000 + i + 1);
+        }
+    }
+}
+
+void tearDown(void) {}
+
+void test_bench_collect_144_departures(void)
+{
+    benchRun("collector: 144 offers -> top 12", 2000, []()
+    {
+        collector.reset(0);
+        for (int i = 0; i < STOPS * MAX_DEPARTURES; i++)
+        {
+            collector.add(offers[i]);
+        }
+        benchSink = benchSink + collector.copySorted(board, boardStrings);
+    });
+
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, collector.size());
+}
+
+void test_bench_collect_with_labels(void)
+{
+    benchRun("collector: 144 offers with labels", 500, []()
+    {
+        collector.reset(0);
+        for (int i = 0; i < STOPS * MAX_DEPARTURES; i++)
+        {
+            Departure dep = offers[i];
+            collector.setLabels(dep, "22", HEADSIGNS[i % HEADSIGN_COUNT]);
+            collector.add(dep);
+        }
+        benchSink = benchSink + collector.copySorted(board, boardStrings);
+    });
+
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, collector.size());
+}
+
+void test_bench_replace_stop_departures(void)
+{
+    static Departure cache[MAX_DEPARTURES];
+    static DepartureStrings cacheStrings;
+    static DepartureStrings runStrings;
+    runStrings.reset();
+    const Departure* run = &offers[5 * MAX_DEPARTURES];
+    static Departure labelled[MAX_DEPARTURES];
+    for (int i = 0; i < MAX_DEPARTURES; i++)
+    {
+        labelled[i] = run[i];
+        labelled[i].lineId = runStrings.intern("S7", MAX_LINE_LENGTH);
+        labelled[i].destinationId = runStrings.intern(HEADSIGNS[i % HEADSIGN_COUNT], MAX_DESTINATION_LENGTH);
+    }
+
+    uint32_t trimmedStops = 0;
+    int count = 0;
+    benchRun("replaceStopDepartures: 12 + 12", 20000, [&]()
+    {
+        // Start from the same full board each call
+        memcpy(cache, labelled, sizeof(cache));
+        for (int i = 0; i < MAX_DEPARTURES; i++)
+        {
+            cache[i].stopIndex = 0;
+        }
+        cacheStrings = runStrings;
+        count = replaceStopDepartures(cache, cacheStrings, MAX_DEPARTURES, 5, labelled, runStrings,
+                                      MAX_DEPARTURES, trimmedStops);
+        benchSink = benchSink + count;
+    });
+
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, count);
+}
+
+void test_bench_apply_departure_delta(void)
+{
+    static Departure cache[MAX_DEPARTURES];
+    static DepartureStrings cacheStrings;
+    static Departure next[MAX_DEPARTURES];
+    static DepartureStrings nextStrings;
+
+    nextStrings.reset();
+    for (int i = 0; i < MAX_DEPARTURES; i++)
+    {
+        next[i] = offers[i * STOPS % (STOPS * MAX_DEPARTURES)];
+        next[i].lineId = nextStrings.intern("9", MAX_LINE_LENGTH);
+        next[i].destinationId = nextStrings.intern(HEADSIGNS[i], MAX_DESTINATION_LENGTH);
+    }
+
+    DepartureDelta delta = {0, 0, 0};
+    benchRun("applyDepartureDelta: 12 vs 12, 2 changed", 50000, [&]()
+    {
+        memcpy(cache, next, sizeof(cache));
+        cache[3].delayMinutes = 2;
+        cache[7].departureTime += 60;
+        cacheStrings = nextStrings;
+        applyDepartureDelta(cache, cacheStrings, MAX_DEPARTURES, next, nextStrings, MAX_DEPARTURES, delta);
+        benchSink = benchSink + delta.changed;
+    });
+
+    TEST_ASSERT_EQUAL_UINT8(2, delta.changed);
+    TEST_ASSERT_EQUAL_UINT8(0, delta.added);
+}
+
+void test_bench_shorten_destinations(void)
+{
+    DestinationShortener& shortener = DestinationShortener::getInstance();
+    shortener.configure(DestinationShortener::CITY_BERLIN, "Flughafen=Flugh.,Garten=Gt.");
+
+    char out[MAX_DESTINATION_LENGTH];
+    benchRun("DestinationShortener::shorten x12", 20000, [&]()
+    {
+        for (int i = 0; i < HEADSIGN_COUNT; i++)
+        {
+            shortener.shorten(HEADSIGNS[i], out, sizeof(out));
+            benchSink = benchSink + (uint8_t)out[0];
+        }
+    });
+
+    shortener.shorten("S+U Hauptbahnhof", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("Hbf", out);
+}
+
+void test_bench_parse_timestamps(void)
+{
+    static const char* const TIMESTAMPS[] = {
+        "2026-01-11T14:30:00+01:00", "2026-01-11T13:31:00.000Z", "2026-07-13T14:00:00+02:00",
+        "2026-10-25T02:59:59+02:00"};
+
+    time_t epoch = 0;
+    benchRun("parseISO8601 x4", 200000, [&]()
+    {
+        for (const char* timestamp : TIMESTAMPS)
+        {
+            parseISO8601(timestamp, &epoch);
+            benchSink = benchSink + (uint32_t)epoch;
+        }
+    });
+
+    TEST_ASSERT_EQUAL_INT64(1792889999, epoch);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_collect_144_departures);
+    RUN_TEST(test_bench_collect_with_labels);
+    RUN_TEST(test_bench_replace_stop_departures);
+    RUN_TEST(test_bench_apply_departure_delta);
+    RUN_TEST(test_bench_shorten_destinations);
+    RUN_TEST(test_bench_parse_timestamps);
+    return UNITY_END();
+}
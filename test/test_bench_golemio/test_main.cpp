@@ -0,0 +1,163 @@
+// Golemio response parsing before and after stream-parsing with a field filter:
+// peak bytes held per response and parse time on the recorded payloads
+
+#include <unity.h>
+#include "../bench.h"
+#include "../corpus.h"
+#include "../../src/api/GolemioAPI.h"
+#include "../../src/network/HttpConnectionManager.h"
+#include "../../src/utils/Metrics.h"
+#include "../../src/hal/Clock.h"
+#include "../../src/hal/native/ReplayHttpFetch.h"
+
+static const size_t BUFFERED_JSON_BUFFER_SIZE = 12288;  // GolemioAPI's document before the filter
+static const size_t STREAMED_JSON_BUFFER_SIZE = 12288;  // GolemioAPI's filtered document
+
+static CorpusInfo corpus;
+static std::vector<uint8_t> quiet;
+static std::vector<uint8_t> rush;
+
+// Same fields as GolemioAPI::parseDepartureStream(); test_filter_matches_provider
+// fails if the two drift apart
+static StaticJsonDocument<512> filter;
+
+void setUp(void)
+{
+    if (quiet.empty())
+    {
+        corpus = loadCorpusInfo();
+        quiet = loadCorpus("golemio-quiet.json");
+        rush = loadCorpus("golemio-rush.json");
+    }
+    clockSetManual(corpus.capturedAt);
+    if (filter.isNull())
+    {
+        filter["stops"][0]["stop_id"] = true;
+        filter["stops"][0]["stop_name"] = true;
+
+        JsonObject depFilter = filter["departures"].createNestedObject();
+        depFilter["route"]["short_name"] = true;
+        depFilter["trip"]["id"] = true;
+        depFilter["trip"]["headsign"] = true;
+        depFilter["trip"]["is_air_conditioned"] = true;
+        depFilter["departure_timestamp"]["predicted"] = true;
+        depFilter["departure_timestamp"]["scheduled"] = true;
+        depFilter["delay"]["minutes"] = true;
+        depFilter["stop"]["id"] = true;
+    }
+}
+
+void tearDown(void) {}
+
+/**
+ * Before: the body is read into a String in 512-byte chunks (the M4 path; the
+ * ESP32 used getString()) and the whole response is deserialized
+ * @return Board bytes held at once: the String plus the document
+ */
+static size_t parseBuffered(const std::vector<uint8_t>& body, DynamicJsonDocument& doc)
+{
+    MemoryStream stream;
+    stream.begin(body.data(), body.size());
+
+    String payload;
+    payload.reserve(body.size() + 1);
+    char buffer[512];
+    size_t bytesRead;
+    while ((bytesRead = stream.readBytes(buffer, sizeof(buffer) - 1)) > 0)
+    {
+        buffer[bytesRead] = '\0';
+        payload += buffer;
+    }
+
+    doc.clear();
+    DeserializationError error = deserializeJson(doc, payload);
+    TEST_ASSERT_FALSE(error);
+    return payload.length() + 1 + doc.memoryUsage();
+}
+
+/**
+ * After: the filtered document is deserialized straight from the stream
+ * @return Board bytes held at once: the document
+ */
+static size_t parseStreamed(const std::vector<uint8_t>& body, DynamicJsonDocument& doc)
+{
+    MemoryStream stream;
+    stream.begin(body.data(), body.size());
+
+    doc.clear();
+    DeserializationError error = deserializeJson(doc, stream, DeserializationOption::Filter(filter));
+    TEST_ASSERT_FALSE(error);
+    return doc.memoryUsage();
+}
+
+static void compare(const char* name, const std::vector<uint8_t>& body)
+{
+    // Room beyond the old buffer so the full DOM can be measured even where it overflowed
+    static DynamicJsonDocument buffered(4 * BUFFERED_JSON_BUFFER_SIZE);
+    static DynamicJsonDocument streamed(STREAMED_JSON_BUFFER_SIZE);
+    char label[64];
+
+    size_t bufferedBytes = parseBuffered(body, buffered);
+    size_t streamedBytes = parseStreamed(body, streamed);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%s: %lu body bytes, peak %lu bytes buffered (DOM %lu/%lu), %lu streamed", name,
+             (unsigned long)body.size(), (unsigned long)bufferedBytes, (unsigned long)buffered.memoryUsage(),
+             (unsigned long)BUFFERED_JSON_BUFFER_SIZE, (unsigned long)streamedBytes);
+    TEST_MESSAGE(msg);
+
+    snprintf(label, sizeof(label), "%s buffered + full DOM", name);
+    benchRun(label, 200, [&]()
+    {
+        benchSink = benchSink + (uint32_t)parseBuffered(body, buffered);
+    });
+    snprintf(label, sizeof(label), "%s streamed + filter", name);
+    benchRun(label, 200, [&]()
+    {
+        benchSink = benchSink + (uint32_t)parseStreamed(body, streamed);
+    });
+
+    // The document alone no longer holds the raw body, let alone the String copy
+    TEST_ASSERT_LESS_THAN(bufferedBytes / 2, streamedBytes);
+}
+
+void test_filter_matches_provider(void)
+{
+    static ReplayHttpFetch replay;
+    HttpConnectionManager::getInstance().setTransport(&replay);
+
+    static Config config = {};
+    strlcpy(config.city, "Prague", sizeof(config.city));
+    strlcpy(config.pragueApiKey, "corpus", sizeof(config.pragueApiKey));
+    strlcpy(config.pragueStopIds, corpus.golemioRush.c_str(), sizeof(config.pragueStopIds));
+    config.numDepartures = 3;
+    config.refreshInterval = 300;
+    config.configured = true;
+
+    // The suite's first Golemio fetch, so the peak is this document's size
+    static GolemioAPI api;
+    replay.setResponse("api.golemio.cz", 200, rush.data(), rush.size());
+    api.fetchDepartures(config);
+
+    static DynamicJsonDocument doc(STREAMED_JSON_BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_INT(parseStreamed(rush, doc),
+                          Metrics::getInstance().getJsonDocStats(Metrics::JSON_DOC_GOLEMIO).peakBytes);
+}
+
+void test_bench_quiet_stop(void)
+{
+    compare("quiet stop", quiet);
+}
+
+void test_bench_rush_hour_hub(void)
+{
+    compare("rush-hour hub", rush);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_filter_matches_provider);
+    RUN_TEST(test_bench_quiet_stop);
+    RUN_TEST(test_bench_rush_hour_hub);
+    return UNITY_END();
+}
@@ -0,0 +1,134 @@
+// Building the board from 1-12 stops: re-sorting everything collected with
+// qsort after every stop (the old partial-results path) against merging each
+// stop's run with mergeDepartureRun, and the DepartureCollector the providers use
+
+#include <unity.h>
+#include "../bench.h"
+#include "../../src/api/DepartureCollector.h"
+#include "../../src/api/DepartureData.h"
+#include <stdlib.h>
+
+static const time_t BASE_TIME = 1790000000;
+static const int MAX_STOPS = 12;
+
+// Each stop's run in time order, stops interleaved in time
+static Departure runs[MAX_STOPS][MAX_DEPARTURES];
+
+void setUp(void)
+{
+    for (int stop = 0; stop < MAX_STOPS; stop++)
+    {
+        for (int i = 0; i < MAX_DEPARTURES; i++)
+        {
+            Departure& dep = runs[stop][i];
+            dep = Departure();
+            dep.departureTime = BASE_TIME + (i * 5 + stop * 7 % 5) * 60 + stop;
+            dep.eta = (int16_t)((dep.departureTime - BASE_TIME) / 60);
+            dep.stopIndex = (int8_t)stop;
+            dep.tripKey = (uint32_t)(stop * 1000 + i + 1);
+        }
+    }
+}
+
+void tearDown(void) {}
+
+// Old path: append the stop, qsort everything collected, copy the top to the board
+static int boardByQsort(int stops, Departure* board)
+{
+    static Departure collected[MAX_STOPS * MAX_DEPARTURES];
+    int collectedCount = 0;
+    int boardCount = 0;
+    for (int stop = 0; stop < stops; stop++)
+    {
+        memcpy(&collected[collectedCount], runs[stop], sizeof(runs[stop]));
+        collectedCount += MAX_DEPARTURES;
+        qsort(collected, collectedCount, sizeof(Departure), compareDepartures);
+
+        boardCount = (collectedCount < MAX_DEPARTURES) ? collectedCount : MAX_DEPARTURES;
+        memcpy(board, collected, boardCount * sizeof(Departure));
+    }
+    return boardCount;
+}
+
+static int boardByMerge(int stops, Departure* board)
+{
+    int boardCount = 0;
+    for (int stop = 0; stop < stops; stop++)
+    {
+        boardCount = mergeDepartureRun(board, boardCount, MAX_DEPARTURES, runs[stop], MAX_DEPARTURES);
+    }
+    return boardCount;
+}
+
+// Providers: offer every departure, copy the sorted board after each stop (partial results)
+static int boardByCollector(int stops, Departure* board)
+{
+    static DepartureCollector collector;
+    static DepartureStrings strings;
+    int boardCount = 0;
+    collector.reset(0);
+    for (int stop = 0; stop < stops; stop++)
+    {
+        for (int i = 0; i < MAX_DEPARTURES; i++)
+        {
+            collector.add(runs[stop][i]);
+        }
+        boardCount = collector.copySorted(board, strings);
+    }
+    return boardCount;
+}
+
+void test_all_paths_build_the_same_board(void)
+{
+    Departure expected[MAX_DEPARTURES];
+    Departure board[MAX_DEPARTURES];
+    for (int stops = 1; stops <= MAX_STOPS; stops++)
+    {
+        int count = boardByQsort(stops, expected);
+        TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, count);
+
+        TEST_ASSERT_EQUAL_INT(count, boardByMerge(stops, board));
+        for (int i = 0; i < count; i++)
+        {
+            TEST_ASSERT_EQUAL_INT64(expected[i].departureTime, board[i].departureTime);
+        }
+
+        TEST_ASSERT_EQUAL_INT(count, boardByCollector(stops, board));
+        for (int i = 0; i < count; i++)
+        {
+            TEST_ASSERT_EQUAL_INT64(expected[i].departureTime, board[i].departureTime);
+        }
+    }
+}
+
+void test_bench_board_from_stops(void)
+{
+    Departure board[MAX_DEPARTURES];
+    char label[64];
+    for (int stops = 1; stops <= MAX_STOPS; stops++)
+    {
+        snprintf(label, sizeof(label), "%2d stop(s): qsort after each stop", stops);
+        benchRun(label, 2000, [&]()
+        {
+            benchSink = benchSink + boardByQsort(stops, board);
+        });
+        snprintf(label, sizeof(label), "%2d stop(s): mergeDepartureRun", stops);
+        benchRun(label, 2000, [&]()
+        {
+            benchSink = benchSink + boardByMerge(stops, board);
+        });
+        snprintf(label, sizeof(label), "%2d stop(s): DepartureCollector", stops);
+        benchRun(label, 2000, [&]()
+        {
+            benchSink = benchSink + boardByCollector(stops, board);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_all_paths_build_the_same_board);
+    RUN_TEST(test_bench_board_from_stops);
+    return UNITY_END();
+}
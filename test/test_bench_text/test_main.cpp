@@ -0,0 +1,196 @@
+// UTF-8 to GFX Latin 2 conversion before and after the table-driven converter,
+// on Prague and Berlin headsigns
+
+#include <Arduino.h>
+#include <unity.h>
+#include "../bench.h"
+#include "../../src/utils/gfxlatin2.h"
+#include "../../src/utils/decodeutf8.h"
+#include "../../src/api/DepartureData.h"
+
+static const char* const PRAGUE_HEADSIGNS[] = {
+    "Nádraží Hostivař", "Sídliště Čimice", "Nemocnice Motol", "Václavské náměstí", "Kobylisy",
+    "Sídliště Řepy", "Želivského", "Palmovka", "Nádraží Holešovice", "Ďáblice", "Černý Most",
+    "Zličín"};
+
+static const char* const BERLIN_HEADSIGNS[] = {
+    "S+U Hauptbahnhof", "S+U Alexanderplatz (Berlin)", "Hermannstraße", "Flughafen BER",
+    "S+U Zoologischer Garten", "Ostbahnhof", "Rathaus Spandau", "Müggelheim, Odernheimer Straße",
+    "Köpenick, Schloßplatz", "U Hermannplatz", "Grünau", "Märkisches Viertel, Wilhelmsruher Damm"};
+
+static const int HEADSIGN_COUNT = sizeof(PRAGUE_HEADSIGNS) / sizeof(PRAGUE_HEADSIGNS[0]);
+static_assert(sizeof(BERLIN_HEADSIGNS) == sizeof(PRAGUE_HEADSIGNS), "same number of headsigns per city");
+
+// ============================================================================
+// Reference: the converter before utf8ToGfxLatin2 (decodeUTF8 state machine
+// plus a switch over the Latin 2 code points, strlen() on every byte)
+// ============================================================================
+
+static uint16_t legacyRecode(uint8_t b)
+{
+    uint16_t ucs2 = decodeUTF8(b);
+    if (ucs2 > 0x7F)
+    {
+        switch (ucs2)
+        {
+            case 0x0104: return 0xA1;  // Ą
+            case 0x02D8: return 0xA2;  // ˘
+            case 0x0141: return 0xA3;  // Ł
+            case 0x013D: return 0xA5;  // Ľ
+            case 0x015A: return 0xA6;  // Ś
+            case 0x0160: return 0xA9;  // Š
+            case 0x015E: return 0xAA;  // Ş
+            case 0x0164: return 0xAB;  // Ť
+            case 0x0179: return 0xAC;  // Ź
+            case 0x017D: return 0xAE;  // Ž
+            case 0x017B: return 0xAF;  // Ż
+            case 0x0105: return 0xB1;  // ą
+            case 0x02DB: return 0xB2;  // ˛
+            case 0x0142: return 0xB3;  // ł
+            case 0x013E: return 0xB5;  // ľ
+            case 0x015B: return 0xB6;  // ś
+            case 0x02C7: return 0xB7;  // ˇ
+            case 0x0161: return 0xB9;  // š
+            case 0x015F: return 0xBA;  // ş
+            case 0x0165: return 0xBB;  // ť
+            case 0x017A: return 0xBC;  // ź
+            case 0x02DD: return 0xBD;  // ˝
+            case 0x017E: return 0xBE;  // ž
+            case 0x017C: return 0xBF;  // ż
+            case 0x0154: return 0xC0;  // Ŕ
+            case 0x0102: return 0xC3;  // Ă
+            case 0x0139: return 0xC5;  // Ĺ
+            case 0x0106: return 0xC6;  // Ć
+            case 0x010C: return 0xC8;  // Č
+            case 0x0118: return 0xCA;  // Ę
+            case 0x011A: return 0xCC;  // Ě
+            case 0x00DF: return 0xCF;  // ß
+            case 0x1E9E: return 0xCF;  // ẞ
+            case 0x010E: return 0xDF;  // Ď
+            case 0x0110: return 0xD0;  // Đ
+            case 0x0143: return 0xD1;  // Ń
+            case 0x0147: return 0xD2;  // Ň
+            case 0x0150: return 0xD5;  // Ő
+            case 0x0158: return 0xD8;  // Ř
+            case 0x016E: return 0xD9;  // Ů
+            case 0x0170: return 0xDB;  // Ű
+            case 0x0162: return 0xDE;  // Ţ
+            case 0x0155: return 0xE0;  // ŕ
+            case 0x0103: return 0xE3;  // ă
+            case 0x013A: return 0xE5;  // ĺ
+            case 0x0107: return 0xE6;  // ć
+            case 0x010D: return 0xE8;  // č
+            case 0x0119: return 0xEA;  // ę
+            case 0x011B: return 0xEC;  // ě
+            case 0x010F: return 0xEF;  // ď
+            case 0x0111: return 0xF0;  // đ
+            case 0x0144: return 0xF1;  // ń
+            case 0x0148: return 0xF2;  // ň
+            case 0x0151: return 0xF5;  // ő
+            case 0x0159: return 0xF8;  // ř
+            case 0x016F: return 0xF9;  // ů
+            case 0x0171: return 0xFB;  // ű
+            case 0x0163: return 0xFE;  // ţ
+            case 0x02D9: return 0xFF;  // ˙
+        }
+    }
+    return ucs2;
+}
+
+static void legacyUtf8tocp(char* s)
+{
+    int k = 0;
+    uint16_t ucs2;
+    resetUTF8decoder();
+    for (int i = 0; i < (int)strlen(s); i++)
+    {
+        ucs2 = legacyRecode(s[i]);
+        if (0x20 <= ucs2 && ucs2 <= 0x7F)
+        {
+            s[k++] = (char)ucs2;
+        }
+        else if (0xA0 <= ucs2 && ucs2 <= 0xFF)
+        {
+            s[k++] = (char)(ucs2 - 32);
+        }
+        else if (showUnmapped && 0xFF < ucs2 && ucs2 < 0xFFFF)
+        {
+            s[k++] = (char)127;
+        }
+    }
+    s[k] = 0;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void assertSameAsLegacy(const char* const* headsigns)
+{
+    for (int i = 0; i < HEADSIGN_COUNT; i++)
+    {
+        char expected[MAX_DESTINATION_LENGTH * 2];
+        char converted[MAX_DESTINATION_LENGTH * 2];
+        strlcpy(expected, headsigns[i], sizeof(expected));
+        legacyUtf8tocp(expected);
+        utf8ToGfxLatin2(headsigns[i], converted, sizeof(converted));
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, converted, headsigns[i]);
+    }
+}
+
+// Both convert in place, as the departure parsers did with the old converter
+static void benchConverters(const char* city, const char* const* headsigns)
+{
+    char buffer[MAX_DESTINATION_LENGTH * 2];
+    char label[64];
+
+    snprintf(label, sizeof(label), "%s x%d: decodeUTF8 + switch", city, HEADSIGN_COUNT);
+    benchRun(label, 20000, [&]()
+    {
+        for (int i = 0; i < HEADSIGN_COUNT; i++)
+        {
+            strlcpy(buffer, headsigns[i], sizeof(buffer));
+            legacyUtf8tocp(buffer);
+            benchSink = benchSink + (uint8_t)buffer[0];
+        }
+    });
+
+    snprintf(label, sizeof(label), "%s x%d: utf8ToGfxLatin2", city, HEADSIGN_COUNT);
+    benchRun(label, 20000, [&]()
+    {
+        for (int i = 0; i < HEADSIGN_COUNT; i++)
+        {
+            strlcpy(buffer, headsigns[i], sizeof(buffer));
+            benchSink = benchSink + (uint32_t)utf8ToGfxLatin2(buffer, buffer, sizeof(buffer));
+        }
+    });
+}
+
+void test_prague_same_as_legacy(void)
+{
+    assertSameAsLegacy(PRAGUE_HEADSIGNS);
+}
+
+void test_berlin_same_as_legacy(void)
+{
+    assertSameAsLegacy(BERLIN_HEADSIGNS);
+}
+
+void test_bench_prague_headsigns(void)
+{
+    benchConverters("Prague", PRAGUE_HEADSIGNS);
+}
+
+void test_bench_berlin_headsigns(void)
+{
+    benchConverters("Berlin", BERLIN_HEADSIGNS);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_prague_same_as_legacy);
+    RUN_TEST(test_berlin_same_as_legacy);
+    RUN_TEST(test_bench_prague_headsigns);
+    RUN_TEST(test_bench_berlin_headsigns);
+    return UNITY_END();
+}
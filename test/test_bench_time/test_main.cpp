@@ -0,0 +1,173 @@
+// ISO 8601 departure times: a round-trip sweep over generated timestamps in the
+// formats Golemio and BVG send, and parseISO8601 against the sscanf + mktime
+// parsing it replaced
+
+#include <unity.h>
+#include "../bench.h"
+#include "../../src/utils/TimeUtils.h"
+#include <stdlib.h>
+
+static const time_t SWEEP_STEP = 397;  // Seconds; prime, so every minute and second offset is reached
+
+static time_t parse(const char* timestamp)
+{
+    time_t epoch = -1;
+    TEST_ASSERT_TRUE_MESSAGE(parseISO8601(timestamp, &epoch), timestamp);
+    return epoch;
+}
+
+// ============================================================================
+// Reference: sscanf() of the wall-clock fields, then mktime() in the board's
+// time zone. The offset in the string is ignored. This runs with the full
+// CET/CEST rules in TZ, the best case for this approach.
+// ============================================================================
+
+static bool legacyParse(const char* timestamp, time_t* epoch)
+{
+    int year, month, day, hour, minute, second;
+    if (sscanf(timestamp, "%d-%d-%dT%d:%d:%d", &year, &month, &day, &hour, &minute, &second) != 6)
+    {
+        return false;
+    }
+
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    tm.tm_isdst = -1;
+    *epoch = mktime(&tm);
+    return true;
+}
+
+static void formatLocal(time_t utc, const char* fraction, char* out, size_t size)
+{
+    long offset = getUtcOffset(utc);
+    time_t local = utc + offset;
+    struct tm t;
+    gmtime_r(&local, &t);
+    snprintf(out, size, "%04d-%02d-%02dT%02d:%02d:%02d%s+%02d:00", t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+             t.tm_hour, t.tm_min, t.tm_sec, fraction, (int)(offset / 3600));
+}
+
+void setUp(void)
+{
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+}
+
+void tearDown(void) {}
+
+void test_round_trip_sweep(void)
+{
+    // 2020-2059: the years of the DST table, about 3.2 million timestamps
+    time_t start = parse("2020-01-01T00:00:00Z");
+    time_t end = parse("2060-01-01T00:00:00Z");
+
+    char golemio[64];
+    char bvg[64];
+    char utc[64];
+    long count = 0;
+    for (time_t t = start; t < end; t += SWEEP_STEP)
+    {
+        formatLocal(t, ".000", golemio, sizeof(golemio));
+        formatLocal(t, "", bvg, sizeof(bvg));
+        struct tm u;
+        gmtime_r(&t, &u);
+        snprintf(utc, sizeof(utc), "%04d-%02d-%02dT%02d:%02d:%02dZ", u.tm_year + 1900, u.tm_mon + 1, u.tm_mday,
+                 u.tm_hour, u.tm_min, u.tm_sec);
+
+        time_t parsed;
+        if (!parseISO8601(golemio, &parsed) || parsed != t)
+        {
+            TEST_FAIL_MESSAGE(golemio);
+        }
+        if (!parseISO8601(bvg, &parsed) || parsed != t)
+        {
+            TEST_FAIL_MESSAGE(bvg);
+        }
+        if (!parseISO8601(utc, &parsed) || parsed != t)
+        {
+            TEST_FAIL_MESSAGE(utc);
+        }
+        count++;
+    }
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%ld timestamps x 3 formats round-tripped", count);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_GREATER_THAN(3000000, count);
+}
+
+void test_legacy_differs_only_in_repeated_hour(void)
+{
+    // Ignoring the offset, the old parser can only guess in the hour that
+    // occurs twice when summer time ends; everywhere else it must agree.
+    // mktime() is slow, so this covers 2024-2029 only.
+    time_t start = parse("2024-01-01T00:00:00Z");
+    time_t end = parse("2030-01-01T00:00:00Z");
+
+    char bvg[64];
+    long differences = 0;
+    for (time_t t = start; t < end; t += SWEEP_STEP)
+    {
+        formatLocal(t, "", bvg, sizeof(bvg));
+        time_t legacy;
+        TEST_ASSERT_TRUE(legacyParse(bvg, &legacy));
+        if (legacy == t)
+        {
+            continue;
+        }
+
+        // 00:00-01:59 UTC on the last Sunday of October is 02:00-02:59 local twice
+        struct tm u;
+        gmtime_r(&t, &u);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(9, u.tm_mon, bvg);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(0, u.tm_wday, bvg);
+        TEST_ASSERT_LESS_THAN(2, u.tm_hour);
+        differences++;
+    }
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "sscanf + mktime wrong for %ld timestamps", differences);
+    TEST_MESSAGE(msg);
+}
+
+void test_bench_parse_old_and_new(void)
+{
+    static const char* const TIMESTAMPS[] = {
+        "2026-01-11T14:30:00+01:00", "2026-01-11T14:31:00.000+01:00", "2026-07-13T14:00:00+02:00",
+        "2026-10-25T02:59:59+02:00"};
+
+    time_t epoch = 0;
+    benchRun("sscanf + mktime x4", 20000, [&]()
+    {
+        for (const char* timestamp : TIMESTAMPS)
+        {
+            legacyParse(timestamp, &epoch);
+            benchSink = benchSink + (uint32_t)epoch;
+        }
+    });
+    benchRun("parseISO8601 x4", 20000, [&]()
+    {
+        for (const char* timestamp : TIMESTAMPS)
+        {
+            parseISO8601(timestamp, &epoch);
+            benchSink = benchSink + (uint32_t)epoch;
+        }
+    });
+
+    TEST_ASSERT_EQUAL_INT64(1792889999, epoch);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_sweep);
+    RUN_TEST(test_legacy_differs_only_in_repeated_hour);
+    RUN_TEST(test_bench_parse_old_and_new);
+    return UNITY_END();
+}
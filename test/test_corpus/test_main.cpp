@@ -0,0 +1,264 @@
+// Provider parse paths on the recorded payload corpus (test/corpus/, see
+// scripts/capture_corpus.py): every quiet, rush-hour and truncated response
+// must fit its provider's JSON_BUFFER_SIZE, and the oversized ones must be
+// reported as overflows
+
+#include <unity.h>
+#include "../bench.h"
+#include "../corpus.h"
+#include "../../src/api/GolemioAPI.h"
+#include "../../src/api/BvgAPI.h"
+#include "../../src/api/WeatherAPI.h"
+#include "../../src/network/HttpConnectionManager.h"
+#include "../../src/utils/Metrics.h"
+#include "../../src/hal/Clock.h"
+#include "../../src/hal/native/ReplayHttpFetch.h"
+
+static const char GOLEMIO_SERVER[] = "api.golemio.cz";
+static const char BVG_SERVER[] = "v6.bvg.transport.rest";
+static const char WEATHER_SERVER[] = "api.open-meteo.com";
+
+static CorpusInfo corpus;
+static ReplayHttpFetch replay;
+static std::vector<uint8_t> body;  // Kept alive for the transport
+static Config config;
+
+// APIResult holds the string table too - keep it off the stack like the firmware does
+static TransitAPI::APIResult result;
+
+void setUp(void)
+{
+    if (corpus.capturedAt == 0)
+    {
+        corpus = loadCorpusInfo();
+    }
+    clockSetManual(corpus.capturedAt);
+
+    config = {};
+    strlcpy(config.city, "Prague", sizeof(config.city));
+    strlcpy(config.pragueApiKey, "corpus", sizeof(config.pragueApiKey));
+    config.numDepartures = 3;
+    config.minDepartureTime = 0;
+    config.refreshInterval = 300;
+    config.configured = true;
+
+    HttpConnectionManager::getInstance().setTransport(&replay);
+}
+
+void tearDown(void) {}
+
+static void replayCorpus(const char* server, const char* name)
+{
+    body = loadCorpus(name);
+    replay.setResponse(server, 200, body.data(), body.size());
+}
+
+/**
+ * Runs one fetch and checks what it did to the provider's document statistics
+ * @return true if the fetch recorded an overflow
+ */
+template <class Fetch>
+static bool fetchOverflowed(Metrics::JsonDoc doc, const char* name, Fetch fetch)
+{
+    JsonDocumentStats before = Metrics::getInstance().getJsonDocStats(doc);
+    fetch();
+    const JsonDocumentStats& after = Metrics::getInstance().getJsonDocStats(doc);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(before.documents + 1, after.documents, name);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%-24s %6lu bytes, suite peak %lu/%lu", name, (unsigned long)body.size(),
+             (unsigned long)after.peakBytes, (unsigned long)after.capacity);
+    TEST_MESSAGE(msg);
+    return after.overflows != before.overflows;
+}
+
+static void fetchGolemio(const char* name, const std::string& stopIds)
+{
+    static GolemioAPI api;
+    strlcpy(config.pragueStopIds, stopIds.c_str(), sizeof(config.pragueStopIds));
+    replayCorpus(GOLEMIO_SERVER, name);
+    result = api.fetchDepartures(config);
+}
+
+static void fetchBvg(const char* name, const std::string& stopId)
+{
+    static BvgAPI api;
+    strlcpy(config.city, "Berlin", sizeof(config.city));
+    strlcpy(config.berlinStopIds, stopId.c_str(), sizeof(config.berlinStopIds));
+    replayCorpus(BVG_SERVER, name);
+    result = api.fetchDepartures(config);
+}
+
+static WeatherData fetchWeather(const char* name)
+{
+    replayCorpus(WEATHER_SERVER, name);
+    return WeatherAPI().fetchWeather(corpus.latitude, corpus.longitude);
+}
+
+static void assertBoardSorted()
+{
+    TEST_ASSERT_LESS_OR_EQUAL(MAX_DEPARTURES, result.departureCount);
+    for (int i = 1; i < result.departureCount; i++)
+    {
+        TEST_ASSERT_LESS_OR_EQUAL(result.departures[i].departureTime, result.departures[i - 1].departureTime);
+    }
+}
+
+void test_corpus_source(void)
+{
+    TEST_ASSERT_GREATER_THAN(0, corpus.capturedAt);
+    if (!corpus.captured)
+    {
+        TEST_MESSAGE("test/corpus/ holds hand-written placeholders - run scripts/capture_corpus.py");
+    }
+}
+
+// ============================================================================
+// Golemio (Prague)
+// ============================================================================
+
+void test_golemio_quiet(void)
+{
+    TEST_ASSERT_FALSE(fetchOverflowed(Metrics::JSON_DOC_GOLEMIO, "golemio-quiet.json",
+                                      []() { fetchGolemio("golemio-quiet.json", corpus.golemioQuiet); }));
+    TEST_ASSERT_FALSE(result.hasError);
+    assertBoardSorted();
+}
+
+void test_golemio_rush_hour(void)
+{
+    // All platforms of one station in one batched request
+    TEST_ASSERT_FALSE(fetchOverflowed(Metrics::JSON_DOC_GOLEMIO, "golemio-rush.json",
+                                      []() { fetchGolemio("golemio-rush.json", corpus.golemioRush); }));
+    TEST_ASSERT_FALSE(result.hasError);
+    TEST_ASSERT_GREATER_THAN(0, result.departureCount);
+    assertBoardSorted();
+}
+
+void test_golemio_truncated(void)
+{
+    TEST_ASSERT_FALSE(fetchOverflowed(Metrics::JSON_DOC_GOLEMIO, "golemio-truncated.json",
+                                      []() { fetchGolemio("golemio-truncated.json", corpus.golemioRush); }));
+    TEST_ASSERT_TRUE(result.hasError);
+    TEST_ASSERT_EQUAL_INT(0, result.departureCount);
+}
+
+void test_golemio_oversized_is_reported(void)
+{
+    TEST_ASSERT_TRUE(fetchOverflowed(Metrics::JSON_DOC_GOLEMIO, "golemio-oversized.json",
+                                     []() { fetchGolemio("golemio-oversized.json", corpus.golemioRush); }));
+}
+
+// ============================================================================
+// BVG (Berlin)
+// ============================================================================
+
+void test_bvg_quiet(void)
+{
+    TEST_ASSERT_FALSE(fetchOverflowed(Metrics::JSON_DOC_BVG, "bvg-quiet.json",
+                                      []() { fetchBvg("bvg-quiet.json", corpus.bvgQuiet); }));
+    TEST_ASSERT_FALSE(result.hasError);
+    assertBoardSorted();
+}
+
+void test_bvg_rush_hour(void)
+{
+    TEST_ASSERT_FALSE(fetchOverflowed(Metrics::JSON_DOC_BVG, "bvg-rush.json",
+                                      []() { fetchBvg("bvg-rush.json", corpus.bvgRush); }));
+    TEST_ASSERT_FALSE(result.hasError);
+    TEST_ASSERT_GREATER_THAN(0, result.departureCount);
+    assertBoardSorted();
+}
+
+void test_bvg_truncated(void)
+{
+    TEST_ASSERT_FALSE(fetchOverflowed(Metrics::JSON_DOC_BVG, "bvg-truncated.json",
+                                      []() { fetchBvg("bvg-truncated.json", corpus.bvgRush); }));
+    TEST_ASSERT_TRUE(result.hasError);
+}
+
+void test_bvg_oversized_is_reported(void)
+{
+    TEST_ASSERT_TRUE(fetchOverflowed(Metrics::JSON_DOC_BVG, "bvg-oversized.json",
+                                     []() { fetchBvg("bvg-oversized.json", corpus.bvgRush); }));
+}
+
+// ============================================================================
+// Open-Meteo
+// ============================================================================
+
+void test_weather(void)
+{
+    WeatherData weather;
+    TEST_ASSERT_FALSE(fetchOverflowed(Metrics::JSON_DOC_WEATHER, "weather.json",
+                                      [&]() { weather = fetchWeather("weather.json"); }));
+    TEST_ASSERT_FALSE(weather.hasError);
+    TEST_ASSERT_INT_WITHIN(60, 0, weather.temperature);
+    TEST_ASSERT_INT_WITHIN(50, 49, weather.weatherCode);  // WMO codes 0-99
+}
+
+void test_weather_truncated(void)
+{
+    WeatherData weather;
+    TEST_ASSERT_FALSE(fetchOverflowed(Metrics::JSON_DOC_WEATHER, "weather-truncated.json",
+                                      [&]() { weather = fetchWeather("weather-truncated.json"); }));
+    TEST_ASSERT_TRUE(weather.hasError);
+}
+
+void test_weather_oversized_is_reported(void)
+{
+    TEST_ASSERT_TRUE(fetchOverflowed(Metrics::JSON_DOC_WEATHER, "weather-oversized.json",
+                                     []() { fetchWeather("weather-oversized.json"); }));
+}
+
+// ============================================================================
+// Parse time
+// ============================================================================
+
+void test_bench_parse_rush_hour(void)
+{
+    strlcpy(config.pragueStopIds, corpus.golemioRush.c_str(), sizeof(config.pragueStopIds));
+    static GolemioAPI golemio;
+    replayCorpus(GOLEMIO_SERVER, "golemio-rush.json");
+    double golemioNs = benchRun("Golemio rush hour fetch", 20, []()
+    {
+        result = golemio.fetchDepartures(config);
+    });
+    TEST_ASSERT_GREATER_THAN(0, result.departureCount);
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%-40s %12.1f ns/departure", "Golemio rush hour fetch",
+             golemioNs / result.departureCount);
+    TEST_MESSAGE(msg);
+
+    static BvgAPI bvg;
+    strlcpy(config.city, "Berlin", sizeof(config.city));
+    strlcpy(config.berlinStopIds, corpus.bvgRush.c_str(), sizeof(config.berlinStopIds));
+    replayCorpus(BVG_SERVER, "bvg-rush.json");
+    double bvgNs = benchRun("BVG rush hour fetch", 20, []()
+    {
+        result = bvg.fetchDepartures(config);
+    });
+    TEST_ASSERT_GREATER_THAN(0, result.departureCount);
+    snprintf(msg, sizeof(msg), "%-40s %12.1f ns/departure", "BVG rush hour fetch", bvgNs / result.departureCount);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_corpus_source);
+    RUN_TEST(test_golemio_quiet);
+    RUN_TEST(test_golemio_rush_hour);
+    RUN_TEST(test_golemio_truncated);
+    RUN_TEST(test_golemio_oversized_is_reported);
+    RUN_TEST(test_bvg_quiet);
+    RUN_TEST(test_bvg_rush_hour);
+    RUN_TEST(test_bvg_truncated);
+    RUN_TEST(test_bvg_oversized_is_reported);
+    RUN_TEST(test_weather);
+    RUN_TEST(test_weather_truncated);
+    RUN_TEST(test_weather_oversized_is_reported);
+    RUN_TEST(test_bench_parse_rush_hour);
+    return UNITY_END();
+}
@@ -0,0 +1,399 @@
+// Departure collection, merging and trip-identity deltas (api/DepartureCollector, api/DepartureData)
+
+#include <unity.h>
+#include "../../src/api/DepartureCollector.h"
+#include "../../src/api/DepartureData.h"
+
+static const time_t BASE_TIME = 1790000000;
+
+static Departure makeDeparture(time_t departureTime, int stopIndex, uint32_t tripKey = 0)
+{
+    Departure dep = {};
+    dep.departureTime = departureTime;
+    dep.eta = (int16_t)((departureTime - BASE_TIME) / 60);
+    dep.stopIndex = (int8_t)stopIndex;
+    dep.tripKey = tripKey;
+    return dep;
+}
+
+static void setLabels(Departure& dep, DepartureStrings& strings, const char* line, const char* destination)
+{
+    dep.lineId = strings.intern(line, MAX_LINE_LENGTH);
+    dep.destinationId = strings.intern(destination, MAX_DESTINATION_LENGTH);
+}
+
+static void assertSorted(const Departure* deps, int count)
+{
+    for (int i = 1; i < count; i++)
+    {
+        TEST_ASSERT_TRUE(deps[i - 1].departureTime <= deps[i].departureTime);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ============================================================================
+// DepartureCollector
+// ============================================================================
+
+static DepartureCollector collector;
+static Departure out[MAX_DEPARTURES];
+static DepartureStrings outStrings;
+
+void test_collector_keeps_soonest_departures(void)
+{
+    collector.reset(0);
+
+    // 40 departures in a scrambled order (17 is coprime to 40)
+    for (int i = 0; i < 40; i++)
+    {
+        int minute = (i * 17) % 40;
+        collector.add(makeDeparture(BASE_TIME + minute * 60, 0));
+    }
+
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, collector.size());
+    TEST_ASSERT_EQUAL_INT(40, collector.getOfferedCount());
+    TEST_ASSERT_TRUE(collector.isTruncated());
+
+    int count = collector.copySorted(out, outStrings);
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, count);
+    for (int i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(i, out[i].eta);
+    }
+}
+
+void test_collector_rejects_departures_below_min_eta(void)
+{
+    collector.reset(5);
+
+    TEST_ASSERT_FALSE(collector.add(makeDeparture(BASE_TIME + 4 * 60, 0)));
+    TEST_ASSERT_TRUE(collector.add(makeDeparture(BASE_TIME + 5 * 60, 0)));
+    TEST_ASSERT_TRUE(collector.add(makeDeparture(BASE_TIME + 9 * 60, 1)));
+
+    TEST_ASSERT_EQUAL_INT(2, collector.size());
+    TEST_ASSERT_EQUAL_INT(3, collector.getOfferedCount());
+    TEST_ASSERT_FALSE(collector.isTruncated());
+}
+
+void test_collector_rejects_later_departure_when_full(void)
+{
+    collector.reset(0);
+    for (int i = 0; i < MAX_DEPARTURES; i++)
+    {
+        TEST_ASSERT_TRUE(collector.add(makeDeparture(BASE_TIME + i * 60, 0)));
+    }
+
+    TEST_ASSERT_FALSE(collector.isTruncated());
+    TEST_ASSERT_FALSE(collector.add(makeDeparture(BASE_TIME + 60 * 60, 0)));
+    TEST_ASSERT_TRUE(collector.isTruncated());
+
+    collector.reset(0);
+    collector.markSourceCapped();
+    TEST_ASSERT_TRUE(collector.isTruncated());
+}
+
+void test_collector_converts_labels_to_gfx_latin2(void)
+{
+    collector.reset(0);
+
+    Departure dep = makeDeparture(BASE_TIME + 120, 0);
+    TEST_ASSERT_TRUE(collector.setLabels(dep, "22", "Nádraží Hostivař"));
+    collector.add(dep);
+
+    // A destination longer than the field is cut to MAX_DESTINATION_LENGTH - 1 bytes
+    Departure longDep = makeDeparture(BASE_TIME + 60, 1);
+    TEST_ASSERT_TRUE(collector.setLabels(longDep, "S41", "Ringbahn über Südkreuz, Gesundbrunnen, Westkreuz"));
+    collector.add(longDep);
+
+    int count = collector.copySorted(out, outStrings);
+    TEST_ASSERT_EQUAL_INT(2, count);
+    TEST_ASSERT_EQUAL_STRING("S41", outStrings.get(out[0].lineId));
+    TEST_ASSERT_EQUAL_INT(MAX_DESTINATION_LENGTH - 1, (int)strlen(outStrings.get(out[0].destinationId)));
+    TEST_ASSERT_EQUAL_STRING("22", outStrings.get(out[1].lineId));
+    TEST_ASSERT_EQUAL_STRING("N\xC1" "dra\x9E\xCD Hostiva\xD8", outStrings.get(out[1].destinationId));
+}
+
+void test_collector_compacts_string_table_of_evicted_departures(void)
+{
+    collector.reset(0);
+
+    // Far more distinct destinations than the parse table holds; later
+    // departures arrive first so every add evicts an earlier label
+    char destination[MAX_DESTINATION_LENGTH];
+    for (int i = 300; i > 0; i--)
+    {
+        Departure dep = makeDeparture(BASE_TIME + i * 60, 0);
+        snprintf(destination, sizeof(destination), "Destination %d", i);
+        TEST_ASSERT_TRUE(collector.setLabels(dep, "X", destination));
+        collector.add(dep);
+    }
+
+    int count = collector.copySorted(out, outStrings);
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, count);
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(destination, sizeof(destination), "Destination %d", i + 1);
+        TEST_ASSERT_EQUAL_STRING(destination, outStrings.get(out[i].destinationId));
+        TEST_ASSERT_EQUAL_STRING("X", outStrings.get(out[i].lineId));
+    }
+}
+
+// ============================================================================
+// mergeDepartureRun / replaceStopDepartures
+// ============================================================================
+
+void test_sort_departure_run_orders_by_time(void)
+{
+    Departure run[5] = {
+        makeDeparture(BASE_TIME + 300, 0), makeDeparture(BASE_TIME + 60, 0), makeDeparture(BASE_TIME + 240, 0),
+        makeDeparture(BASE_TIME + 60, 1), makeDeparture(BASE_TIME, 0)};
+
+    sortDepartureRun(run, 5);
+    assertSorted(run, 5);
+    TEST_ASSERT_EQUAL_INT(0, run[1].stopIndex);  // Stable: equal times keep their order
+    TEST_ASSERT_EQUAL_INT(1, run[2].stopIndex);
+}
+
+void test_merge_interleaves_sorted_runs(void)
+{
+    Departure top[8] = {makeDeparture(BASE_TIME + 60, 0), makeDeparture(BASE_TIME + 180, 0),
+                        makeDeparture(BASE_TIME + 300, 0)};
+    Departure run[3] = {makeDeparture(BASE_TIME + 0, 1), makeDeparture(BASE_TIME + 180, 1),
+                        makeDeparture(BASE_TIME + 240, 1)};
+
+    int count = mergeDepartureRun(top, 3, 8, run, 3);
+
+    TEST_ASSERT_EQUAL_INT(6, count);
+    assertSorted(top, count);
+    TEST_ASSERT_EQUAL_INT(1, top[0].stopIndex);
+    TEST_ASSERT_EQUAL_INT(0, top[2].stopIndex);  // Tie at +180: the entry already in top comes first
+    TEST_ASSERT_EQUAL_INT(1, top[3].stopIndex);
+}
+
+void test_merge_trims_to_capacity(void)
+{
+    Departure top[4] = {makeDeparture(BASE_TIME + 60, 0), makeDeparture(BASE_TIME + 120, 0),
+                        makeDeparture(BASE_TIME + 600, 0), makeDeparture(BASE_TIME + 700, 0)};
+    Departure run[3] = {makeDeparture(BASE_TIME + 30, 1), makeDeparture(BASE_TIME + 90, 1),
+                        makeDeparture(BASE_TIME + 900, 1)};
+
+    int count = mergeDepartureRun(top, 4, 4, run, 3);
+
+    TEST_ASSERT_EQUAL_INT(4, count);
+    TEST_ASSERT_EQUAL_INT64(BASE_TIME + 30, top[0].departureTime);
+    TEST_ASSERT_EQUAL_INT64(BASE_TIME + 60, top[1].departureTime);
+    TEST_ASSERT_EQUAL_INT64(BASE_TIME + 90, top[2].departureTime);
+    TEST_ASSERT_EQUAL_INT64(BASE_TIME + 120, top[3].departureTime);
+
+    // A run entirely later than a full top leaves it untouched
+    Departure late[2] = {makeDeparture(BASE_TIME + 2000, 2), makeDeparture(BASE_TIME + 3000, 2)};
+    count = mergeDepartureRun(top, 4, 4, late, 2);
+    TEST_ASSERT_EQUAL_INT(4, count);
+    TEST_ASSERT_EQUAL_INT64(BASE_TIME + 120, top[3].departureTime);
+}
+
+void test_replace_stop_departures_keeps_other_stops(void)
+{
+    static Departure cache[MAX_DEPARTURES];
+    static DepartureStrings cacheStrings;
+    static Departure run[MAX_DEPARTURES];
+    static DepartureStrings runStrings;
+    cacheStrings.reset();
+    runStrings.reset();
+
+    // Cache: stops 0 and 1 alternating, one minute apart
+    int count = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        cache[count] = makeDeparture(BASE_TIME + i * 60, i % 2);
+        setLabels(cache[count], cacheStrings, i % 2 ? "B" : "A", i % 2 ? "Old B" : "Stop A");
+        count++;
+    }
+
+    // Fresh run for stop 1: seven departures, every 30 s
+    for (int i = 0; i < 7; i++)
+    {
+        run[i] = makeDeparture(BASE_TIME + 30 + i * 30, 1);
+        setLabels(run[i], runStrings, "B", "New B");
+    }
+
+    uint32_t trimmedStops = 0xFFFFFFFF;
+    count = replaceStopDepartures(cache, cacheStrings, count, 1, run, runStrings, 7, trimmedStops);
+
+    // 4 entries of stop 0 + 7 new ones of stop 1; nothing trimmed
+    TEST_ASSERT_EQUAL_INT(11, count);
+    TEST_ASSERT_EQUAL_UINT32(0, trimmedStops);
+    assertSorted(cache, count);
+
+    int stop0 = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (cache[i].stopIndex == 0)
+        {
+            stop0++;
+            TEST_ASSERT_EQUAL_STRING("Stop A", cacheStrings.get(cache[i].destinationId));
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_STRING("New B", cacheStrings.get(cache[i].destinationId));
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(4, stop0);
+
+    // The old stop 1 headsign is no longer referenced and is dropped from the table
+    TEST_ASSERT_EQUAL_INT(4, cacheStrings.size());
+}
+
+void test_replace_stop_departures_reports_trimmed_stops(void)
+{
+    static Departure cache[MAX_DEPARTURES];
+    static DepartureStrings cacheStrings;
+    static Departure run[MAX_DEPARTURES];
+    static DepartureStrings runStrings;
+    cacheStrings.reset();
+    runStrings.reset();
+
+    // Full cache: stop 0 early, stop 2 late
+    for (int i = 0; i < MAX_DEPARTURES; i++)
+    {
+        cache[i] = makeDeparture(BASE_TIME + i * 60, i < 6 ? 0 : 2);
+        setLabels(cache[i], cacheStrings, "1", "Somewhere");
+    }
+
+    // Stop 1 brings three departures before everything of stop 2
+    for (int i = 0; i < 3; i++)
+    {
+        run[i] = makeDeparture(BASE_TIME + 330 + i, 1);
+        setLabels(run[i], runStrings, "2", "Elsewhere");
+    }
+
+    uint32_t trimmedStops = 0;
+    int count = replaceStopDepartures(cache, cacheStrings, MAX_DEPARTURES, 1, run, runStrings, 3, trimmedStops);
+
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, count);
+    TEST_ASSERT_EQUAL_UINT32(1u << 2, trimmedStops);
+    assertSorted(cache, count);
+    TEST_ASSERT_EQUAL_INT(2, cache[count - 1].stopIndex);
+    TEST_ASSERT_EQUAL_INT64(BASE_TIME + 8 * 60, cache[count - 1].departureTime);
+}
+
+// ============================================================================
+// applyDepartureDelta
+// ============================================================================
+
+void test_delta_matches_trips_by_key_and_stop(void)
+{
+    static Departure cache[MAX_DEPARTURES];
+    static DepartureStrings cacheStrings;
+    static Departure next[MAX_DEPARTURES];
+    static DepartureStrings nextStrings;
+    cacheStrings.reset();
+    nextStrings.reset();
+
+    uint32_t tripA = hashTripId("trip-a");
+    uint32_t tripB = hashTripId("trip-b");
+    uint32_t tripC = hashTripId("trip-c");
+
+    // Trip A serves stops 0 and 1; trip B leaves from stop 0
+    cache[0] = makeDeparture(BASE_TIME + 60, 0, tripA);
+    cache[1] = makeDeparture(BASE_TIME + 120, 0, tripB);
+    cache[2] = makeDeparture(BASE_TIME + 180, 1, tripA);
+    for (int i = 0; i < 3; i++)
+    {
+        setLabels(cache[i], cacheStrings, "9", "Spojovací");
+    }
+
+    // Trip A at stop 0 is delayed, B is gone, A at stop 1 unchanged, C is new
+    next[0] = makeDeparture(BASE_TIME + 120, 0, tripA);
+    next[0].isDelayed = true;
+    next[0].delayMinutes = 1;
+    next[1] = makeDeparture(BASE_TIME + 180, 1, tripA);
+    next[2] = makeDeparture(BASE_TIME + 240, 0, tripC);
+    for (int i = 0; i < 3; i++)
+    {
+        setLabels(next[i], nextStrings, "9", "Spojovací");
+    }
+
+    DepartureDelta delta;
+    int count = applyDepartureDelta(cache, cacheStrings, 3, next, nextStrings, 3, delta);
+
+    TEST_ASSERT_EQUAL_INT(3, count);
+    TEST_ASSERT_EQUAL_UINT8(1, delta.added);
+    TEST_ASSERT_EQUAL_UINT8(1, delta.removed);
+    TEST_ASSERT_EQUAL_UINT8(1, delta.changed);
+    TEST_ASSERT_FALSE(delta.isEmpty());
+    TEST_ASSERT_EQUAL_MEMORY(next, cache, 3 * sizeof(Departure));
+    TEST_ASSERT_EQUAL_STRING("Spojovací", cacheStrings.get(cache[2].destinationId));
+
+    // Applying the same list again is empty
+    count = applyDepartureDelta(cache, cacheStrings, count, next, nextStrings, 3, delta);
+    TEST_ASSERT_TRUE(delta.isEmpty());
+}
+
+void test_delta_without_trip_key_matches_identical_only(void)
+{
+    static Departure cache[MAX_DEPARTURES];
+    static DepartureStrings cacheStrings;
+    static Departure next[MAX_DEPARTURES];
+    static DepartureStrings nextStrings;
+    cacheStrings.reset();
+    nextStrings.reset();
+
+    cache[0] = makeDeparture(BASE_TIME + 60, 0);
+    setLabels(cache[0], cacheStrings, "S1", "Wannsee");
+
+    // Same line at a new time cannot be told apart from another trip: removed + added
+    next[0] = makeDeparture(BASE_TIME + 120, 0);
+    setLabels(next[0], nextStrings, "S1", "Wannsee");
+
+    DepartureDelta delta;
+    applyDepartureDelta(cache, cacheStrings, 1, next, nextStrings, 1, delta);
+    TEST_ASSERT_EQUAL_UINT8(1, delta.added);
+    TEST_ASSERT_EQUAL_UINT8(1, delta.removed);
+    TEST_ASSERT_EQUAL_UINT8(0, delta.changed);
+
+    // An identical keyless departure matches
+    applyDepartureDelta(cache, cacheStrings, 1, next, nextStrings, 1, delta);
+    TEST_ASSERT_TRUE(delta.isEmpty());
+}
+
+void test_hash_trip_id_reserves_zero(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, hashTripId(nullptr));
+    TEST_ASSERT_EQUAL_UINT32(0, hashTripId(""));
+    TEST_ASSERT_EQUAL_UINT32(hashTripId("1_123_260111"), hashTripId("1_123_260111"));
+    TEST_ASSERT_NOT_EQUAL(hashTripId("1_123_260111"), hashTripId("1_124_260111"));
+}
+
+void test_split_stop_ids(void)
+{
+    char buffer[] = "U693Z2P, U693Z1P,,U1072Z1P";
+    const char* ids[4];
+
+    TEST_ASSERT_EQUAL_INT(3, splitStopIds(buffer, ids, 4));
+    TEST_ASSERT_EQUAL_STRING("U693Z2P", ids[0]);
+    TEST_ASSERT_EQUAL_STRING("U693Z1P", ids[1]);
+    TEST_ASSERT_EQUAL_STRING("U1072Z1P", ids[2]);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_collector_keeps_soonest_departures);
+    RUN_TEST(test_collector_rejects_departures_below_min_eta);
+    RUN_TEST(test_collector_rejects_later_departure_when_full);
+    RUN_TEST(test_collector_converts_labels_to_gfx_latin2);
+    RUN_TEST(test_collector_compacts_string_table_of_evicted_departures);
+    RUN_TEST(test_sort_departure_run_orders_by_time);
+    RUN_TEST(test_merge_interleaves_sorted_runs);
+    RUN_TEST(test_merge_trims_to_capacity);
+    RUN_TEST(test_replace_stop_departures_keeps_other_stops);
+    RUN_TEST(test_replace_stop_departures_reports_trimmed_stops);
+    RUN_TEST(test_delta_matches_trips_by_key_and_stop);
+    RUN_TEST(test_delta_without_trip_key_matches_identical_only);
+    RUN_TEST(test_hash_trip_id_reserves_zero);
+    RUN_TEST(test_split_stop_ids);
+    return UNITY_END();
+}
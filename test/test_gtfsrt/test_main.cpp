@@ -0,0 +1,180 @@
+// GTFS-Realtime TripUpdates decoding (api/GtfsRtAPI, utils/ProtobufReader) on
+// test/corpus/gtfsrt-rush.pb: 12 departures from the platforms of Anděl in a
+// feed with the rest of the network, a canceled, a deleted and a skipping trip.
+// Also compares bytes on the wire and parse time with the Golemio JSON path
+// on golemio-rush.json.
+
+#include <unity.h>
+#include "../bench.h"
+#include "../corpus.h"
+#include "../../src/api/GtfsRtAPI.h"
+#include "../../src/api/GolemioAPI.h"
+#include "../../src/api/DepartureCollector.h"
+#include "../../src/network/HttpConnectionManager.h"
+#include "../../src/utils/ProtobufReader.h"
+#include "../../src/utils/gfxlatin2.h"
+#include "../../src/hal/Clock.h"
+#include "../../src/hal/native/ReplayHttpFetch.h"
+
+// 2026-01-11 13:30:00 UTC, 40 seconds before the feed's first departure
+static const time_t CORPUS_TIME = 1768138200;
+
+// Platforms of Anděl, in the order of the configured stops
+static const char* const STOP_IDS[] = {
+    "U1040Z1P", "U1040Z2P", "U1040Z3P", "U1040Z4P", "U1040Z5P", "U1040Z6P",
+    "U1040Z7P", "U1040Z8P", "U1040Z9P", "U1040Z10P", "U1040Z11P", "U1040Z12P"};
+static const int STOP_COUNT = sizeof(STOP_IDS) / sizeof(STOP_IDS[0]);
+
+static std::vector<uint8_t> feed;
+static DepartureCollector collector;
+static Departure board[MAX_DEPARTURES];
+static DepartureStrings boardStrings;
+
+void setUp(void)
+{
+    clockSetManual(CORPUS_TIME);
+    if (feed.empty())
+    {
+        feed = loadCorpus("gtfsrt-rush.pb");
+    }
+}
+
+void tearDown(void) {}
+
+static int decode(size_t length, int onlyStop, time_t now)
+{
+    MemoryStream stream;
+    stream.begin(feed.data(), length);
+    ProtobufReader reader(stream, (long)length);
+    collector.reset(0);
+    return GtfsRtAPI::parseFeed(reader, STOP_IDS, STOP_COUNT, onlyStop, now, collector);
+}
+
+static const char* gfx(const char* utf8)
+{
+    static char converted[MAX_DESTINATION_LENGTH];
+    utf8ToGfxLatin2(utf8, converted, sizeof(converted));
+    return converted;
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+void test_decode_rush_hour_feed(void)
+{
+    // Canceled, deleted and skipped calls at configured stops don't count
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, decode(feed.size(), -1, CORPUS_TIME));
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, collector.copySorted(board, boardStrings));
+
+    // The feed's calls at Anděl, soonest first
+    TEST_ASSERT_EQUAL_INT64(1768138240, board[0].departureTime);
+    TEST_ASSERT_EQUAL_STRING("B", boardStrings.get(board[0].lineId));
+    TEST_ASSERT_EQUAL_STRING(gfx("Zličín"), boardStrings.get(board[0].destinationId));
+    TEST_ASSERT_EQUAL_INT(0, board[0].stopIndex);
+    TEST_ASSERT_EQUAL_INT(0, board[0].eta);
+
+    TEST_ASSERT_EQUAL_STRING("B", boardStrings.get(board[3].lineId));
+    TEST_ASSERT_EQUAL_STRING(gfx("Černý Most"), boardStrings.get(board[3].destinationId));
+    TEST_ASSERT_EQUAL_INT(3, board[3].stopIndex);
+    TEST_ASSERT_TRUE(board[3].isDelayed);
+    TEST_ASSERT_EQUAL_INT(3, board[3].delayMinutes);
+
+    TEST_ASSERT_EQUAL_INT64(1768138712, board[11].departureTime);
+    TEST_ASSERT_EQUAL_STRING("167", boardStrings.get(board[11].lineId));
+    TEST_ASSERT_EQUAL_STRING(gfx("Na Knížecí"), boardStrings.get(board[11].destinationId));
+    TEST_ASSERT_EQUAL_INT(7, board[11].stopIndex);
+
+    for (int i = 1; i < MAX_DEPARTURES; i++)
+    {
+        TEST_ASSERT_LESS_OR_EQUAL(board[i].departureTime, board[i - 1].departureTime);
+    }
+}
+
+void test_decode_single_stop(void)
+{
+    TEST_ASSERT_EQUAL_INT(1, decode(feed.size(), 3, CORPUS_TIME));
+    TEST_ASSERT_EQUAL_INT(1, collector.copySorted(board, boardStrings));
+    TEST_ASSERT_EQUAL_STRING("B", boardStrings.get(board[0].lineId));
+    TEST_ASSERT_EQUAL_INT(3, board[0].stopIndex);
+}
+
+void test_decode_drops_departed(void)
+{
+    // Matched calls are still counted, departed ones never reach the collector
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, decode(feed.size(), -1, 1768138400));
+    TEST_ASSERT_EQUAL_INT(7, collector.copySorted(board, boardStrings));
+    TEST_ASSERT_GREATER_OR_EQUAL(1768138400, board[0].departureTime);
+}
+
+void test_decode_truncated_feed(void)
+{
+    // Every cut either fails or yields a prefix of the entities, never more
+    int failed = 0;
+    for (size_t length = 1; length < feed.size(); length++)
+    {
+        int matched = decode(length, -1, CORPUS_TIME);
+        TEST_ASSERT_LESS_OR_EQUAL(MAX_DEPARTURES, matched);
+        TEST_ASSERT_LESS_OR_EQUAL(MAX_DEPARTURES, collector.size());
+        failed += (matched < 0);
+    }
+    TEST_ASSERT_GREATER_THAN((int)feed.size() * 9 / 10, failed);
+}
+
+// ============================================================================
+// Against the Golemio JSON path
+// ============================================================================
+
+void test_bench_against_golemio_json(void)
+{
+    CorpusInfo corpus = loadCorpusInfo();
+    std::vector<uint8_t> json = loadCorpus("golemio-rush.json");
+    clockSetManual(corpus.capturedAt);
+
+    static ReplayHttpFetch replay;
+    replay.setResponse("api.golemio.cz", 200, json.data(), json.size());
+    HttpConnectionManager::getInstance().setTransport(&replay);
+
+    static Config config = {};
+    strlcpy(config.city, "Prague", sizeof(config.city));
+    strlcpy(config.pragueApiKey, "corpus", sizeof(config.pragueApiKey));
+    strlcpy(config.pragueStopIds, corpus.golemioRush.c_str(), sizeof(config.pragueStopIds));
+    config.numDepartures = 3;
+    config.refreshInterval = 300;
+    config.configured = true;
+
+    static GolemioAPI golemio;
+    static TransitAPI::APIResult result;
+    double jsonNs = benchRun("Golemio JSON fetch + parse", 20, []()
+    {
+        result = golemio.fetchDepartures(config);
+    });
+    TEST_ASSERT_GREATER_THAN(0, result.departureCount);
+
+    int departures = 0;
+    double protobufNs = benchRun("GTFS-RT parseFeed", 200, [&]()
+    {
+        decode(feed.size(), -1, CORPUS_TIME);
+        departures = collector.size();
+    });
+    TEST_ASSERT_EQUAL_INT(MAX_DEPARTURES, departures);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "Golemio JSON: %lu bytes, %d departures, %.1f ns/departure", (unsigned long)json.size(),
+             result.departureCount, jsonNs / result.departureCount);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "GTFS-RT feed: %lu bytes (63 trips), %d departures, %.1f ns/departure",
+             (unsigned long)feed.size(), departures, protobufNs / departures);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_decode_rush_hour_feed);
+    RUN_TEST(test_decode_single_stop);
+    RUN_TEST(test_decode_drops_departed);
+    RUN_TEST(test_decode_truncated_feed);
+    RUN_TEST(test_bench_against_golemio_json);
+    return UNITY_END();
+}
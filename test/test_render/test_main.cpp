@@ -0,0 +1,27 @@
+// Reference screens against the golden images in test/golden/ (hal/native/RenderScenes)
+//
+// After an intended change to what DisplayManager draws, regenerate the images
+// with `.pio/build/native/program --render test/golden` and commit them with
+// the change.
+
+#include <unity.h>
+#include "../../src/hal/Clock.h"
+#include "../../src/hal/native/RenderScenes.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_scenes_match_golden_images(void)
+{
+    // Every scene must match its image, and every update over the scenes
+    // before it must leave the same frame as a full redraw
+    clockSetManual(RENDER_EPOCH);
+    TEST_ASSERT_EQUAL_INT(0, renderScenes(nullptr, "test/golden", 1));
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_scenes_match_golden_images);
+    return UNITY_END();
+}
@@ -0,0 +1,170 @@
+// UTF-8 to GFX Latin 2 conversion and destination shortening
+// (utils/gfxlatin2, api/DestinationShortener)
+
+#include <Arduino.h>
+#include <unity.h>
+#include "../../src/utils/gfxlatin2.h"
+#include "../../src/utils/decodeutf8.h"
+#include "../../src/api/DestinationShortener.h"
+#include "../../src/api/DepartureData.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void assertConverted(const char* expected, const char* utf8)
+{
+    char out[64];
+    size_t length = utf8ToGfxLatin2(utf8, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, out, utf8);
+    TEST_ASSERT_EQUAL_INT(strlen(expected), length);
+}
+
+static void assertShortened(const char* expected, const char* destination)
+{
+    char out[MAX_DESTINATION_LENGTH];
+    DestinationShortener::getInstance().shorten(destination, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, out, destination);
+}
+
+// ============================================================================
+// utf8ToGfxLatin2
+// ============================================================================
+
+void test_convert_ascii_unchanged(void)
+{
+    assertConverted("Sidliste Petriny 22", "Sidliste Petriny 22");
+    assertConverted("", "");
+}
+
+void test_convert_czech_and_german_letters(void)
+{
+    // Latin-1 range is shifted down by 32, Latin Extended-A comes from the table
+    assertConverted("\xB8" "e\xC8" "ick\xC1", "Řečická");
+    assertConverted("\xD8\xCC\xCD\xC8", "řěíč");
+    assertConverted("\xB9\xD9", "Ůů");
+    assertConverted("M\xDC" "ggelsee", "Müggelsee");
+    assertConverted("Stra\xAF" "e", "Straße");
+    assertConverted("GRO\xAF", "GROẞ");  // Capital sharp s shares the glyph
+}
+
+void test_convert_drops_unmapped_characters(void)
+{
+    assertConverted("Metro C", "Metro \xF0\x9F\x9A\x87" "C");  // 4-byte emoji
+    assertConverted("Kyiv ", "Kyiv Київ");
+    assertConverted("-", "\xE2\x80\x93-");  // En dash is not in the font
+
+    showUnmapped = true;
+    assertConverted("\x7F", "\xE2\x80\x93");
+    showUnmapped = false;
+}
+
+void test_convert_resyncs_on_invalid_utf8(void)
+{
+    assertConverted("ab", "a\x80" "b");          // Stray continuation byte
+    assertConverted("ab", "a\xC3" "b");          // Lead byte without its continuation
+    assertConverted("a\xC1", "a\xE2\x82" "\xC3\xA1");  // Cut 3-byte sequence, then á
+}
+
+void test_convert_truncates_to_buffer(void)
+{
+    char out[5];
+    TEST_ASSERT_EQUAL_INT(4, utf8ToGfxLatin2("Žižkov", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("\x8Ei\x9Ek", out);
+
+    TEST_ASSERT_EQUAL_INT(0, utf8ToGfxLatin2("abc", out, 0));
+    TEST_ASSERT_EQUAL_INT(0, utf8ToGfxLatin2("abc", out, 1));
+    TEST_ASSERT_EQUAL_STRING("", out);
+}
+
+void test_convert_in_place(void)
+{
+    char text[] = "Nádraží Braník";
+    size_t length = utf8ToGfxLatin2(text, text, sizeof(text));
+    TEST_ASSERT_EQUAL_INT(14, length);
+    TEST_ASSERT_EQUAL_STRING("N\xC1" "dra\x9E\xCD Bran\xCD" "k", text);
+}
+
+// ============================================================================
+// DestinationShortener
+// ============================================================================
+
+void test_shorten_prague_built_ins(void)
+{
+    DestinationShortener& shortener = DestinationShortener::getInstance();
+    shortener.configure(DestinationShortener::CITY_PRAGUE, "");
+
+    assertShortened("Nádr. Holešovice", "Nádraží Holešovice");
+    assertShortened("Sídl. Ďáblice", "Sídliště Ďáblice");
+    assertShortened("Nem. Motol", "Nemocnice Motol");
+    assertShortened("Kobylisy", "Kobylisy");
+
+    // Berlin words are not active for Prague
+    assertShortened("Hauptbahnhof", "Hauptbahnhof");
+}
+
+void test_shorten_berlin_leftmost_longest(void)
+{
+    DestinationShortener& shortener = DestinationShortener::getInstance();
+    shortener.configure(DestinationShortener::CITY_BERLIN, "");
+
+    assertShortened("Hbf", "S+U Hauptbahnhof");                 // Not "Hauptbhf"
+    assertShortened("Ostbhf", "Ostbahnhof (Berlin)");
+    assertShortened("Alexanderpl.", "S+U Alexanderplatz (Berlin)");
+    assertShortened("Hermannstr.", "Hermannstraße");
+    assertShortened("Bhf Zoo", "Bahnhof Zoo");
+}
+
+void test_shorten_user_dictionary_overrides_built_ins(void)
+{
+    DestinationShortener& shortener = DestinationShortener::getInstance();
+    int builtIns;
+
+    shortener.configure(DestinationShortener::CITY_BERLIN, "");
+    builtIns = shortener.getPatternCount();
+
+    // An entry for a built-in word replaces it; one without '=' is ignored
+    shortener.configure(DestinationShortener::CITY_BERLIN, "Hauptbahnhof=HB, Flughafen BER=BER,Terminal ");
+    TEST_ASSERT_EQUAL_INT(builtIns + 1, shortener.getPatternCount());
+    assertShortened("HB", "S+U Hauptbahnhof");
+    assertShortened("BER 1-2", "Flughafen BER 1-2");
+
+    shortener.configure(DestinationShortener::CITY_BERLIN, "Zoo=");  // Empty replacement deletes
+    assertShortened("Bhf ", "Bahnhof Zoo");
+}
+
+void test_shorten_truncates_at_character_boundary(void)
+{
+    DestinationShortener& shortener = DestinationShortener::getInstance();
+    shortener.configure(DestinationShortener::CITY_PRAGUE, "");
+
+    // "Nádr. Č" needs 9 bytes with the terminator; Č is not split
+    char out[8];
+    shortener.shorten("Nádraží Černý Most", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("Nádr. ", out);
+}
+
+void test_count_dictionary_entries(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, DestinationShortener::countEntries(""));
+    TEST_ASSERT_EQUAL_INT(2, DestinationShortener::countEntries("Hauptbahnhof=Hbf, Krankenhaus=KH"));
+    TEST_ASSERT_EQUAL_INT(1, DestinationShortener::countEntries("Zoo=,"));
+    TEST_ASSERT_EQUAL_INT(-1, DestinationShortener::countEntries("Hauptbahnhof"));
+    TEST_ASSERT_EQUAL_INT(-1, DestinationShortener::countEntries("a=b,=c"));
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_convert_ascii_unchanged);
+    RUN_TEST(test_convert_czech_and_german_letters);
+    RUN_TEST(test_convert_drops_unmapped_characters);
+    RUN_TEST(test_convert_resyncs_on_invalid_utf8);
+    RUN_TEST(test_convert_truncates_to_buffer);
+    RUN_TEST(test_convert_in_place);
+    RUN_TEST(test_shorten_prague_built_ins);
+    RUN_TEST(test_shorten_berlin_leftmost_longest);
+    RUN_TEST(test_shorten_user_dictionary_overrides_built_ins);
+    RUN_TEST(test_shorten_truncates_at_character_boundary);
+    RUN_TEST(test_count_dictionary_entries);
+    return UNITY_END();
+}
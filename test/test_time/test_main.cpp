@@ -0,0 +1,166 @@
+// ISO 8601 parsing and the DST transition table (utils/TimeUtils)
+
+#include <unity.h>
+#include "../../src/utils/TimeUtils.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static time_t parse(const char* timestamp)
+{
+    time_t epoch = -1;
+    TEST_ASSERT_TRUE_MESSAGE(parseISO8601(timestamp, &epoch), timestamp);
+    return epoch;
+}
+
+// ============================================================================
+// parseISO8601
+// ============================================================================
+
+void test_parse_utc_and_offsets(void)
+{
+    // 2026-01-11 13:30:00 UTC
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11T13:30:00Z"));
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11T13:30:00"));
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11T14:30:00+01:00"));
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11T14:30:00+0100"));
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11T14:30:00+01"));
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11T08:00:00-05:30"));
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11 13:30:00z"));
+
+    // Fractional seconds are dropped (Golemio sends milliseconds)
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11T14:30:00.999+01:00"));
+    TEST_ASSERT_EQUAL_INT64(1768138200, parse("2026-01-11T13:30:00,5Z"));
+}
+
+void test_parse_calendar_edges(void)
+{
+    TEST_ASSERT_EQUAL_INT64(0, parse("1970-01-01T00:00:00Z"));
+    TEST_ASSERT_EQUAL_INT64(951782400, parse("2000-02-29T00:00:00Z"));
+    TEST_ASSERT_EQUAL_INT64(1709164800, parse("2024-02-29T00:00:00Z"));
+    TEST_ASSERT_EQUAL_INT64(1798761599, parse("2026-12-31T23:59:59Z"));
+
+    // Offsets crossing midnight and the year boundary
+    TEST_ASSERT_EQUAL_INT64(1798761600, parse("2027-01-01T01:00:00+01:00"));
+    TEST_ASSERT_EQUAL_INT64(1798761600, parse("2026-12-31T22:00:00-02:00"));
+
+    // Summer time offset (BVG sends local time with its offset)
+    TEST_ASSERT_EQUAL_INT64(1783944000, parse("2026-07-13T14:00:00+02:00"));
+}
+
+void test_parse_rejects_malformed_timestamps(void)
+{
+    const char* invalid[] = {
+        "",
+        "2026-01-11",
+        "2026-01-11T14:30",
+        "2026-1-11T14:30:00Z",
+        "2026-01-11X14:30:00Z",
+        "2026-13-01T00:00:00Z",
+        "2026-00-01T00:00:00Z",
+        "2026-04-31T00:00:00Z",
+        "2025-02-29T00:00:00Z",
+        "2100-02-29T00:00:00Z",
+        "2026-01-11T24:00:00Z",
+        "2026-01-11T14:60:00Z",
+        "2026-01-11T14:30:00+1",
+        "2026-01-11T14:30:00+01:0",
+        "2026-01-11T14:30:00+24:00",
+        "2026-01-11T14:30:00Zjunk",
+        "2026-01-11T14:30:00 ",
+    };
+
+    time_t epoch = 12345;
+    for (const char* timestamp : invalid)
+    {
+        TEST_ASSERT_FALSE_MESSAGE(parseISO8601(timestamp, &epoch), timestamp);
+    }
+    TEST_ASSERT_FALSE(parseISO8601(nullptr, &epoch));
+    TEST_ASSERT_FALSE(parseISO8601("2026-01-11T13:30:00Z", nullptr));
+    TEST_ASSERT_EQUAL_INT64(12345, epoch);
+}
+
+// ============================================================================
+// DST table
+// ============================================================================
+
+void test_dst_transitions_2026(void)
+{
+    // 29 March 01:00 UTC and 25 October 01:00 UTC
+    TEST_ASSERT_EQUAL_INT(GMT_OFFSET_SEC, getUtcOffset(1774745999));
+    TEST_ASSERT_EQUAL_INT(GMT_OFFSET_SEC + DAYLIGHT_OFFSET_SEC, getUtcOffset(1774746000));
+    TEST_ASSERT_EQUAL_INT(GMT_OFFSET_SEC + DAYLIGHT_OFFSET_SEC, getUtcOffset(1792889999));
+    TEST_ASSERT_EQUAL_INT(GMT_OFFSET_SEC, getUtcOffset(1792890000));
+
+    struct tm local;
+    utcToLocalTime(1774745999, &local);
+    TEST_ASSERT_EQUAL_INT(1, local.tm_hour);
+    TEST_ASSERT_EQUAL_INT(59, local.tm_min);
+    TEST_ASSERT_EQUAL_INT(0, local.tm_isdst);
+
+    utcToLocalTime(1774746000, &local);
+    TEST_ASSERT_EQUAL_INT(3, local.tm_hour);
+    TEST_ASSERT_EQUAL_INT(0, local.tm_min);
+    TEST_ASSERT_EQUAL_INT(1, local.tm_isdst);
+
+    // The repeated hour in October: 00:59:59 UTC is 02:59:59 CEST, 01:00 UTC is 02:00 CET
+    utcToLocalTime(1792889999, &local);
+    TEST_ASSERT_EQUAL_INT(2, local.tm_hour);
+    TEST_ASSERT_EQUAL_INT(1, local.tm_isdst);
+    utcToLocalTime(1792890000, &local);
+    TEST_ASSERT_EQUAL_INT(2, local.tm_hour);
+    TEST_ASSERT_EQUAL_INT(0, local.tm_isdst);
+}
+
+void test_dst_table_follows_eu_rule(void)
+{
+    // Hour by hour across the table (2020-2059) and a year on each side,
+    // where getUtcOffset() evaluates the rule directly: the offset may only
+    // change at 01:00 UTC on the last Sunday of March (to summer time) and of
+    // October (back to winter time), and must change there every year.
+    time_t start = parse("2019-01-01T00:00:00Z");
+    time_t end = parse("2061-01-01T00:00:00Z");
+
+    long previous = getUtcOffset(start);
+    int springSwitches = 0;
+    int autumnSwitches = 0;
+    for (time_t utc = start + 3600; utc < end; utc += 3600)
+    {
+        long offset = getUtcOffset(utc);
+        if (offset == previous)
+        {
+            continue;
+        }
+
+        struct tm t;
+        gmtime_r(&utc, &t);
+        TEST_ASSERT_EQUAL_INT(0, t.tm_wday);
+        TEST_ASSERT_EQUAL_INT(1, t.tm_hour);
+        TEST_ASSERT_GREATER_OR_EQUAL(25, t.tm_mday);  // Last Sunday of a 31-day month
+        if (offset > previous)
+        {
+            TEST_ASSERT_EQUAL_INT(2, t.tm_mon);
+            springSwitches++;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_INT(9, t.tm_mon);
+            autumnSwitches++;
+        }
+        previous = offset;
+    }
+
+    TEST_ASSERT_EQUAL_INT(42, springSwitches);
+    TEST_ASSERT_EQUAL_INT(42, autumnSwitches);
+}
+
+int main(int argc, char** argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_utc_and_offsets);
+    RUN_TEST(test_parse_calendar_edges);
+    RUN_TEST(test_parse_rejects_malformed_timestamps);
+    RUN_TEST(test_dst_transitions_2026);
+    RUN_TEST(test_dst_table_follows_eu_rule);
+    return UNITY_END();
+}